@@ -20,6 +20,8 @@
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "sdkconfig.h"
+#include "led_fx.h"
+#include "gpio_group.h"
 
 /*
 ===========================
@@ -31,21 +33,40 @@
 #define LED_B_IO 		19
 #define LED_USER_IO     5
 
-/*
-===========================
-任务句柄
-=========================== 
-*/
-TaskHandle_t led_flow_task_handle;
-TaskHandle_t led_toggle_task_handle;
+//灯效通道
+#define LED_FX_CH_R     0x01
+#define LED_FX_CH_G     0x02
+#define LED_FX_CH_B     0x04
+#define LED_FX_CH_RGB   (LED_FX_CH_R | LED_FX_CH_G | LED_FX_CH_B)
+#define LED_FX_CH_USER  0x08
 
 /*
 ===========================
-函数声明
+全局变量定义
 =========================== 
 */
-void led_flow_task();
-void led_toggle_task();
+//灯效通道对应的IO，RGB低电平点亮
+static const gpio_num_t g_led_fx_io[] = {LED_R_IO, LED_G_IO, LED_B_IO, LED_USER_IO};
+//4个灯作为一组，16种亮灭组合的寄存器掩码预先算好
+static GpioGroup_t g_led_group;
+static GpioGroup_Masks_t g_led_masks[1 << 4];
+static uint8_t g_led_pattern = 0;
+
+//流水灯:红绿蓝依次点亮100ms
+static const uint8_t g_fx_flow[] = {
+    LED_FX_LOOP(0),
+    LED_FX_SET(LED_FX_CH_RGB, 0), LED_FX_SET(LED_FX_CH_R, 255), LED_FX_WAIT(100),
+    LED_FX_SET(LED_FX_CH_RGB, 0), LED_FX_SET(LED_FX_CH_G, 255), LED_FX_WAIT(100),
+    LED_FX_SET(LED_FX_CH_RGB, 0), LED_FX_SET(LED_FX_CH_B, 255), LED_FX_WAIT(100),
+    LED_FX_LOOP_END(),
+};
+//用户灯:亮灭各500ms
+static const uint8_t g_fx_toggle[] = {
+    LED_FX_LOOP(0),
+    LED_FX_SET(LED_FX_CH_USER, 255), LED_FX_WAIT(500),
+    LED_FX_SET(LED_FX_CH_USER, 0), LED_FX_WAIT(500),
+    LED_FX_LOOP_END(),
+};
 
 /*
 * esp32 led配置
@@ -54,101 +75,77 @@ void led_toggle_task();
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/17, 初始化版本\n
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 配置为GPIO组并预算掩码表\n
 */
 void led_init(void)
 {
-	//选择IO
-    gpio_pad_select_gpio(LED_R_IO);
-    gpio_pad_select_gpio(LED_G_IO);
-    gpio_pad_select_gpio(LED_B_IO);
-    gpio_pad_select_gpio(LED_USER_IO);
-    //设置IO为输出
-    gpio_set_direction(LED_R_IO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(LED_G_IO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(LED_B_IO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(LED_USER_IO, GPIO_MODE_OUTPUT);
+    //RGB低电平点亮(反相)，用户灯高电平点亮
+    GpioGroup_Init(&g_led_group, g_led_fx_io, sizeof(g_led_fx_io) / sizeof(g_led_fx_io[0]),
+        LED_FX_CH_RGB);
+    GpioGroup_BuildTable(&g_led_group, g_led_masks, sizeof(g_led_masks) / sizeof(g_led_masks[0]));
+    GpioGroup_Apply(&g_led_masks[0]);
 }
 
-
-
 /*
- * 应用程序的函数入口
- * @param[in]   无
- * @retval      无              
- * @par         修改日志 
- *               Ver0.0.1:
-                     Caesar, 2019/10/17, 初始化版本\n
+* 灯效通道输出:GPIO只有亮灭，亮度非0即点亮；只记录，由led_fx_commit统一写出
+* @param[in]   ch      通道
+* @param[in]   level   亮度
+* @param[in]   arg     无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 只记录图样\n
 */
-void app_main()
+static void led_fx_output(uint8_t ch, uint8_t level, void *arg)
 {
-    //led初始化
-	led_init();
-	//创建led流水灯任务
-	xTaskCreate(led_flow_task, "led_flow_task", 1024*2, NULL, configMAX_PRIORITIES, led_flow_task_handle);
-	//创建led翻转任务
-	xTaskCreate(led_toggle_task, "led_toggle_task", 1024*2, NULL, configMAX_PRIORITIES-1, led_toggle_task_handle);
+    if (level)
+    {
+        g_led_pattern |= 1 << ch;
+    }
+    else
+    {
+        g_led_pattern &= ~(1 << ch);
+    }
 }
 
-
 /*
-* led流水灯任务
-* @param[in]   无
+* 灯效提交:一次写W1TS/W1TC，所有灯同时变化
+* @param[in]   arg     无
 * @retval      无
 * @note        修改日志 
 *               Ver0.0.1:
-                    Caesar, 2019/10/17, 初始化版本\n 
+                    Caesar, 2026/10/19, 初始化版本\n
 */
-void led_flow_task()
+static void led_fx_commit(void *arg)
 {
-    static uint8_t led_state = 1;
-    while (1) {
-        switch(led_state)
-        {
-            case 1:
-                //只点亮红灯
-                gpio_set_level(LED_R_IO, 0);
-                gpio_set_level(LED_G_IO, 1);
-                gpio_set_level(LED_B_IO, 1);
-                break;
-            case 2:
-                //只点亮绿灯
-                gpio_set_level(LED_R_IO, 1);
-                gpio_set_level(LED_G_IO, 0);
-                gpio_set_level(LED_B_IO, 1);
-                break;
-            case 3:
-                //只点亮蓝灯
-                gpio_set_level(LED_R_IO, 1);
-                gpio_set_level(LED_G_IO, 1);
-                gpio_set_level(LED_B_IO, 0);
-                break;
-            default:
-                break;
-        }
-        if(led_state < 3){
-            led_state ++;
-        }
-        else{
-            led_state = 1;
-        }
-        vTaskDelay(100 / portTICK_PERIOD_MS);
-    } 
+    GpioGroup_Apply(&g_led_masks[g_led_pattern]);
 }
 
+
+
 /*
-* led翻转任务
-* @param[in]   无
-* @retval      无
-* @note        修改日志 
-*               Ver0.0.1:
-                    Caesar, 2019/10/17, 初始化版本\n  
+ * 应用程序的函数入口
+ * @param[in]   无
+ * @retval      无              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2019/10/17, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 流水灯和翻转灯改为灯效字节码，共用一个定时器，不再各占一个任务\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 各灯状态经GPIO组一次写出\n
 */
-void led_toggle_task()
+void app_main()
 {
-    while (1) {
-        gpio_set_level(LED_USER_IO, 1);
-        vTaskDelay(500 / portTICK_PERIOD_MS);
-        gpio_set_level(LED_USER_IO, 0);
-        vTaskDelay(500 / portTICK_PERIOD_MS);
-    } 
-}
\ No newline at end of file
+    //led初始化
+	led_init();
+	LedFx_Init(sizeof(g_led_fx_io) / sizeof(g_led_fx_io[0]), led_fx_output, NULL);
+	LedFx_SetCommit(led_fx_commit);
+	//流水灯
+	LedFx_Start(g_fx_flow, sizeof(g_fx_flow), NULL);
+	//用户灯翻转
+	LedFx_Start(g_fx_toggle, sizeof(g_fx_toggle), NULL);
+}
@@ -26,6 +26,11 @@
 #include "driver/periph_ctrl.h"
 #include "driver/timer.h"
 #include "esp_timer.h"
+#include "led_fx.h"
+#include "gpio_group.h"
+#include "key_input.h"
+#include "key_gesture.h"
+#include "timer_wheel.h"
 
 /*
 ===========================
@@ -40,24 +45,38 @@
 
 #define KEY_IO          34
 
+//用户灯2闪烁:每FW_PERIOD_MS熄灭FW_OFF_MS
+#define FW_PERIOD_MS    1000
+#define FW_OFF_MS       300
+#define FW_STATS_RUNS   10          //每隔多少个周期打印一次定时统计
+
+//灯效通道
+#define LED_FX_CH_R     0x01
+#define LED_FX_CH_G     0x02
+#define LED_FX_CH_B     0x04
+#define LED_FX_CH_RGB   (LED_FX_CH_R | LED_FX_CH_G | LED_FX_CH_B)
+
 /*
 ===========================
 任务句柄
 =========================== 
 */
-TaskHandle_t led_flow_task_handle;
 TaskHandle_t led_toggle_task_handle;
+TaskHandle_t fw_stats_task_handle = NULL;
 
-//定时器句柄
-esp_timer_handle_t fw_timer_handle = 0;
+//用户灯2闪烁:周期定时器熄灭，链式单次定时器点亮
+static TimerWheel_Timer_t g_fw_timer;
+static TimerWheel_Timer_t g_fw_on_timer;
+//最近一次熄灭的时刻，由fw定时器记录、统计任务打印
+static volatile int64_t g_fw_tick;
 
 /*
 ===========================
 函数声明
 =========================== 
 */
-void led_flow_task();
 void led_toggle_task();
+void fw_stats_task();
 
 /*
 ===========================
@@ -65,7 +84,26 @@ void led_toggle_task();
 =========================== 
 */
 unsigned char led_user_status = 0;
-unsigned char key_status[2];
+//按键(低电平为按下)
+static const gpio_num_t g_key_io[] = {KEY_IO};
+//按键手势:单击翻转用户灯，双击暂停/恢复流水灯，长按连发打印次数
+static KeyGesture_t g_key_gesture;
+static uint8_t g_fx_flow_id = 0;
+
+//灯效通道对应的IO(RGB，低电平点亮)
+static const gpio_num_t g_led_fx_io[] = {LED_R_IO, LED_G_IO, LED_B_IO};
+//RGB作为一组，8种亮灭组合的寄存器掩码预先算好
+static GpioGroup_t g_led_group;
+static GpioGroup_Masks_t g_led_masks[1 << 3];
+static uint8_t g_led_pattern = 0;
+//流水灯:红绿蓝依次点亮100ms
+static const uint8_t g_fx_flow[] = {
+    LED_FX_LOOP(0),
+    LED_FX_SET(LED_FX_CH_RGB, 0), LED_FX_SET(LED_FX_CH_R, 255), LED_FX_WAIT(100),
+    LED_FX_SET(LED_FX_CH_RGB, 0), LED_FX_SET(LED_FX_CH_G, 255), LED_FX_WAIT(100),
+    LED_FX_SET(LED_FX_CH_RGB, 0), LED_FX_SET(LED_FX_CH_B, 255), LED_FX_WAIT(100),
+    LED_FX_LOOP_END(),
+};
 
 /*
 * esp32 led配置
@@ -74,23 +112,61 @@ unsigned char key_status[2];
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/17, 初始化版本\n 
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, RGB配置为GPIO组并预算掩码表\n
 */
 void led_init(void)
 {
+    //RGB低电平点亮(反相)，作为一组同时写出
+    GpioGroup_Init(&g_led_group, g_led_fx_io, sizeof(g_led_fx_io) / sizeof(g_led_fx_io[0]),
+        LED_FX_CH_RGB);
+    GpioGroup_BuildTable(&g_led_group, g_led_masks, sizeof(g_led_masks) / sizeof(g_led_masks[0]));
+    GpioGroup_Apply(&g_led_masks[0]);
 	//选择IO
-    gpio_pad_select_gpio(LED_R_IO);
-    gpio_pad_select_gpio(LED_G_IO);
-    gpio_pad_select_gpio(LED_B_IO);
     gpio_pad_select_gpio(LED_USER_IO);
     gpio_pad_select_gpio(LED_USER2_IO);
     //设置IO为输出
-    gpio_set_direction(LED_R_IO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(LED_G_IO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(LED_B_IO, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_USER_IO, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_USER2_IO, GPIO_MODE_OUTPUT);
 }
 
+/*
+* 灯效通道输出:GPIO只有亮灭，亮度非0即点亮；只记录，由led_fx_commit统一写出
+* @param[in]   ch      通道
+* @param[in]   level   亮度
+* @param[in]   arg     无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 只记录图样\n
+*/
+static void led_fx_output(uint8_t ch, uint8_t level, void *arg)
+{
+    if (level)
+    {
+        g_led_pattern |= 1 << ch;
+    }
+    else
+    {
+        g_led_pattern &= ~(1 << ch);
+    }
+}
+
+/*
+* 灯效提交:一次写W1TS/W1TC，RGB同时变化
+* @param[in]   arg     无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n
+*/
+static void led_fx_commit(void *arg)
+{
+    GpioGroup_Apply(&g_led_masks[g_led_pattern]);
+}
+
 /*
 * esp32 key配置
 * @param[in]   无
@@ -98,87 +174,84 @@ void led_init(void)
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/17, 初始化版本\n 
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 改为边沿中断+定时器消抖，事件进队列\n
 */
 void key_init(void)
 {
-	//选择IO
-    gpio_pad_select_gpio(KEY_IO);
-    //设置IO为输入
-    gpio_set_direction(KEY_IO, GPIO_MODE_INPUT);
+    KeyInput_Init(g_key_io, sizeof(g_key_io) / sizeof(g_key_io[0]), 0x01, KEY_INPUT_DEBOUNCE_MS);
 }
 
-void key_read(void)
+/*
+* 用户灯2点亮(时间轮回调，不阻塞)
+* @param[in]   timer   定时器
+* @param[in]   arg     无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n
+*/
+static void fw_on_timer_cb(TimerWheel_Timer_t *timer, void *arg)
 {
-    if(gpio_get_level(KEY_IO)==0)//按键按下
-    {
-        //等待松手，最傻的办法
-        while(gpio_get_level(KEY_IO)==0);
-        if (led_user_status==1)
-        {
-            led_user_status = 0;
-            gpio_set_level(LED_USER_IO, 0);//不亮
-        }
-        else
-        {
-            led_user_status = 1;
-            gpio_set_level(LED_USER_IO, 1);//亮
-        }
-
-    }
+	gpio_set_level(LED_USER2_IO, 1);
 }
 
-void key_read_filter(void)
-{
-    //按键识别
-    if(gpio_get_level(KEY_IO)==0){
-        key_status[0] = 0;
-    }
-    else{
-       key_status[0] = 1; 
-    }
-    if(key_status[0]!=key_status[1]) {
-        key_status[1] = key_status[0];
-        if(key_status[1]==0){//按键按下
-/*            if (led_user_status==1){
-                led_user_status = 0;
-                gpio_set_level(LED_USER_IO, 0);//不亮
-            }else{
-                led_user_status = 1;
-                gpio_set_level(LED_USER_IO, 1);//亮
-            }
+/*
+* 周期定时器(时间轮回调，不阻塞):熄灭用户灯2，FW_OFF_MS后由链式定时器点亮，
+* 记下时刻并通知统计任务，回调里不打印
+* @param[in]   timer   定时器
+* @param[in]   arg     无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本，原回调中的vTaskDelay改为链式定时器\n
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 打印移到统计任务，回调只记录时刻并通知\n
 */
-        }else{//按键松手
-            if (led_user_status==1){
-                led_user_status = 0;
-                gpio_set_level(LED_USER_IO, 0);//不亮
-            }else{
-                led_user_status = 1;
-                gpio_set_level(LED_USER_IO, 1);//亮
-            }
-        }
-    }
-}
-
-void fw_timer_cb(void *arg) 
+static void fw_timer_cb(TimerWheel_Timer_t *timer, void *arg)
 {
 	//获取时间戳
-	int64_t tick = esp_timer_get_time();
-	printf("timer cnt = %lld \r\n", tick);
-/*
-	if (tick > 50000000) //50秒结束
+	g_fw_tick = esp_timer_get_time();
+
+	gpio_set_level(LED_USER2_IO, 0);
+	TimerWheel_Start(&g_fw_on_timer, FW_OFF_MS, 0);
+
+	if (fw_stats_task_handle)
 	{
-		//定时器暂停、删除
-		esp_timer_stop(fw_timer_handle);
-		esp_timer_delete(fw_timer_handle);
-		printf("timer stop and delete!!! \r\n");
-		//重启
-		esp_restart();
+		xTaskNotifyGive(fw_stats_task_handle);
 	}
+}
+
+/*
+* fw定时器统计任务:每次通知打印熄灭时刻，每FW_STATS_RUNS次打印一次
+* 本定时器的延迟/抖动和时间轮的唤醒延迟
+* @param[in]   无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n
 */
-	gpio_set_level(LED_USER2_IO, 0);
-	vTaskDelay(300 / portTICK_PERIOD_MS);
-	gpio_set_level(LED_USER2_IO, 1);
-	vTaskDelay(300 / portTICK_PERIOD_MS);
+void fw_stats_task()
+{
+	TimerWheel_TimerStats_t fw;
+	TimerWheel_Stats_t wheel;
+	uint32_t runs = 0;
+
+	while (1) {
+		runs += ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		printf("timer cnt = %lld \r\n", g_fw_tick);
+		if (runs < FW_STATS_RUNS)
+		{
+			continue;
+		}
+		runs = 0;
+		TimerWheel_GetTimerStats(&g_fw_timer, &fw, 1);
+		TimerWheel_GetStats(&wheel, 1);
+		printf("fw timer: late avg %u us, max %u us, jitter max %u us, skipped %u\r\n",
+			fw.runs ? (unsigned)(fw.late_sum / fw.runs) : 0, fw.late_max, fw.jitter_max, fw.skipped);
+		printf("timer wheel: wakes %u, wake late max %u us, callback max %u us, slow %u\r\n",
+			wheel.wakes, wheel.wake_late_max, wheel.cb_max, wheel.slow_cbs);
+	}
 }
 
 
@@ -190,6 +263,18 @@ void fw_timer_cb(void *arg)
  * @par         修改日志 
  *               Ver0.0.1:
                      Caesar, 2019/10/17, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 流水灯改为灯效字节码，不再占一个任务\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, RGB状态经GPIO组一次写出\n
+ *               Ver0.0.4:
+                     Caesar, 2026/10/19, 按键改为中断驱动\n
+ *               Ver0.0.5:
+                     Caesar, 2026/10/19, 记下流水灯id，供双击暂停/恢复\n
+ *               Ver0.0.6:
+                     Caesar, 2026/10/19, fw定时器改用时间轮\n
+ *               Ver0.0.7:
+                     Caesar, 2026/10/19, 创建fw定时器统计任务\n
 */
 void app_main()
 {
@@ -198,91 +283,107 @@ void app_main()
     //key初始化
     key_init();
 
-    //定时器结构体初始化
-	esp_timer_create_args_t fw_timer = 
-	{ 
-		.callback = &fw_timer_cb, 	//回调函数
-		.arg = NULL, 				//参数
-		.name = "fw_timer" 			//定时器名称
-	};
-
-	//定时器创建、启动
-	esp_err_t err = esp_timer_create(&fw_timer, &fw_timer_handle);
-	err = esp_timer_start_periodic(fw_timer_handle, 1000 * 1000);//1秒回调
+    //fw定时器的打印在统计任务中进行，先于定时器创建
+	xTaskCreate(fw_stats_task, "fw_stats_task", 1024*2, NULL, tskIDLE_PRIORITY + 1, &fw_stats_task_handle);
+    //应用定时器都挂在时间轮上，共用一个esp_timer
+	TimerWheel_Init();
+	TimerWheel_Setup(&g_fw_timer, fw_timer_cb, NULL);
+	TimerWheel_Setup(&g_fw_on_timer, fw_on_timer_cb, NULL);
+	esp_err_t err = TimerWheel_Start(&g_fw_timer, FW_PERIOD_MS, FW_PERIOD_MS);//1秒回调
 	if(err == ESP_OK)
 	{
 		printf("fw timer create and start ok!\r\n");
 	}
 
-	//创建led流水灯任务
-	xTaskCreate(led_flow_task, "led_flow_task", 1024*2, NULL, configMAX_PRIORITIES, led_flow_task_handle);
+	//流水灯由灯效解释器的定时器驱动，不占任务
+	LedFx_Init(sizeof(g_led_fx_io) / sizeof(g_led_fx_io[0]), led_fx_output, NULL);
+	LedFx_SetCommit(led_fx_commit);
+	LedFx_Start(g_fx_flow, sizeof(g_fx_flow), &g_fx_flow_id);
 	//创建led翻转任务
 	xTaskCreate(led_toggle_task, "led_toggle_task", 1024*2, NULL, configMAX_PRIORITIES-1, led_toggle_task_handle);
 }
 
 
+
 /*
-* led流水灯任务
-* @param[in]   无
+* 按键手势回调(led翻转任务中执行)
+* @param[in]   event   手势
+* @param[in]   arg     无
 * @retval      无
 * @note        修改日志 
 *               Ver0.0.1:
-                    Caesar, 2019/10/17, 初始化版本\n   
+                    Caesar, 2026/10/19, 初始化版本\n
 */
-void led_flow_task()
+static void key_gesture_cb(const KeyGesture_Event_t *event, void *arg)
 {
-    static uint8_t led_state = 1;
-    while (1) {
-        switch(led_state)
-        {
-            case 1:
-                //只点亮红灯
-                gpio_set_level(LED_R_IO, 0);
-                gpio_set_level(LED_G_IO, 1);
-                gpio_set_level(LED_B_IO, 1);
-                break;
-            case 2:
-                //只点亮绿灯
-                gpio_set_level(LED_R_IO, 1);
-                gpio_set_level(LED_G_IO, 0);
-                gpio_set_level(LED_B_IO, 1);
-                break;
-            case 3:
-                //只点亮蓝灯
-                gpio_set_level(LED_R_IO, 1);
-                gpio_set_level(LED_G_IO, 1);
-                gpio_set_level(LED_B_IO, 0);
-                break;
-            default:
-                break;
-        }
-        if(led_state < 3){
-            led_state ++;
-        }
-        else{
-            led_state = 1;
-        }
-        vTaskDelay(100 / portTICK_PERIOD_MS);
-    } 
+    switch (event->type)
+    {
+        case KEY_GESTURE_CLICK:
+            led_user_status = !led_user_status;
+            gpio_set_level(LED_USER_IO, led_user_status);
+            break;
+        case KEY_GESTURE_DOUBLE_CLICK:
+            if (LedFx_Running(g_fx_flow_id))
+            {
+                LedFx_Stop(g_fx_flow_id);
+            }
+            else
+            {
+                LedFx_Start(g_fx_flow, sizeof(g_fx_flow), &g_fx_flow_id);
+            }
+            break;
+        case KEY_GESTURE_LONG_PRESS:
+            printf("key long press\r\n");
+            break;
+        case KEY_GESTURE_REPEAT:
+            printf("key repeat %d\r\n", event->count);
+            break;
+        default:
+            break;
+    }
 }
 
 /*
-* led翻转任务
+* led翻转任务:按键事件交给手势识别，等待时间取识别器的下一个期限
 * @param[in]   无
 * @retval      无
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/17, 初始化版本\n 
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 阻塞在按键事件队列上，不再每10ms轮询\n
+*               Ver0.0.3:
+                    Caesar, 2026/10/19, 改为手势识别，单击翻转用户灯\n
+*               Ver0.0.4:
+                    Caesar, 2026/10/19, 手势按事件的边沿时刻计时，不受任务调度延迟影响\n
 */
 void led_toggle_task()
 {
+    KeyInput_Event_t event;
+    TickType_t wait;
+    int32_t next = -1;
+    uint32_t now, last = 0;
+
+    KeyGesture_Init(&g_key_gesture, sizeof(g_key_io) / sizeof(g_key_io[0]), NULL, key_gesture_cb, NULL);
     while (1) {
- /*       gpio_set_level(LED_USER_IO, 1);
-        vTaskDelay(500 / portTICK_PERIOD_MS);
-        gpio_set_level(LED_USER_IO, 0);
-        vTaskDelay(500 / portTICK_PERIOD_MS);
-        */
-        key_read_filter();
-        vTaskDelay(10 / portTICK_PERIOD_MS);
+        //没有待定的手势时一直等按键
+        wait = (next < 0) ? portMAX_DELAY : (next + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+        if (!KeyInput_Read(&event, wait))
+        {
+            last = esp_timer_get_time() / 1000;
+            next = KeyGesture_Poll(&g_key_gesture, last);
+            continue;
+        }
+        //输入延迟:从第一个边沿到任务拿到事件
+        printf("key %d %s, latency %d us\r\n", event.key, event.type == KEY_EVENT_PRESS ? "press" : "release",
+            (int)(esp_timer_get_time() - event.time_us));
+        //按边沿时刻计时；消抖期间可能已经按更晚的时刻Poll过，识别器的时间不能倒退
+        now = event.time_us / 1000;
+        if ((int32_t)(now - last) < 0)
+        {
+            now = last;
+        }
+        last = now;
+        next = KeyGesture_Feed(&g_key_gesture, event.key, event.type == KEY_EVENT_PRESS, now);
     } 
 }
\ No newline at end of file
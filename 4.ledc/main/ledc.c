@@ -26,22 +26,34 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/ledc.h"
-#include <stdio.h>
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "driver/ledc.h"
+#include "led_fade.h"
+#include "led_lut.h"
+#include "led_color.h"
+#include "led_swpwm.h"
 
 /*
 ===========================
 宏定义
 =========================== 
 */
-#define LEDC_MAX_DUTY         	(8191)	//2的13次方-1(13位ledc)
 #define LEDC_FADE_TIME    		(1000)	//渐变时间(ms)
+#define LED_BREATHE_TIMES		(2)		//开机呼吸次数
+#define LED_WARM_KELVIN			(2700)	//暖白色温(K)
+#define LED_WARM_TIME			(2000)	//暖白显示时间(ms)
+#define LED_SWEEP_FRAME_MS		(20)	//色相渐变帧间隔(ms)
+#define LED_SWEEP_TIME			(6000)	//色相转一圈的时间(ms)
 
 #define LED_R_IO    2
 #define LED_G_IO    18
 #define LED_B_IO    19
+#define LED_USER_IO     5
+#define LED_USER2_IO    4
+
+//用户灯没有LEDC通道，用软件PWM
+#define LED_USER_PWM_FREQ		(1000)	//频率(Hz)
+#define LED_USER_PWM_BITS		(10)	//占空比位数
+#define LED_USER_MAX_DUTY		(1 << LED_USER_PWM_BITS)
+#define LED_USER_FADE_TIME		(1500)	//用户灯渐变时间(ms)
 
 /*
 ===========================
@@ -50,6 +62,24 @@
 */
 //ledc配置结构体
 ledc_channel_config_t 	g_ledc_ch_R,g_ledc_ch_G,g_ledc_ch_B;
+//RGB三个通道作为一组同步渐变
+LedFade_Group_t			g_led_fade;
+//13位占空比的CIE明度曲线，编译期生成
+static const uint32_t	g_led_cie[LED_LUT_LEVELS] = LED_LUT_CIE(13);
+//呼吸灯关键帧(亮度级):三色同时渐亮，再同时渐灭
+LedFade_Key_t			g_led_breathe_keys[] = {
+	{ .duty = {LED_LUT_LEVELS - 1, LED_LUT_LEVELS - 1, LED_LUT_LEVELS - 1}, .time_ms = LEDC_FADE_TIME },
+	{ .duty = {0, 0, 0}, .time_ms = LEDC_FADE_TIME },
+};
+//用户灯(软件PWM通道0、1)
+static const gpio_num_t	g_led_user_io[] = {LED_USER_IO, LED_USER2_IO};
+
+/*
+===========================
+任务句柄
+=========================== 
+*/
+TaskHandle_t led_user_task_handle;
 	
 /*
 ===========================
@@ -64,6 +94,12 @@ ledc_channel_config_t 	g_ledc_ch_R,g_ledc_ch_G,g_ledc_ch_B;
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/17, 初始化版本\n 
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 用led_fade代替LEDC渐变服务\n  
+*               Ver0.0.3:
+                    Caesar, 2026/10/19, 按CIE明度曲线渐变\n  
+*               Ver0.0.4:
+                    Caesar, 2026/10/19, 用户灯改为软件PWM\n  
 */
 void ledc_init(void)
 {
@@ -100,8 +136,66 @@ void ledc_init(void)
 	g_ledc_ch_B.timer_sel  = LEDC_TIMER_0;			//选择定时器
 	ledc_channel_config(&g_ledc_ch_B);				//配置PWM
 	
-	//注册LEDC服务:相当于使能
-	ledc_fade_func_install(0);
+	//注册渐变中断(代替ledc_fade_func_install)，RGB登记为一组
+	LedFade_Init();
+	LedFade_AddGroup(&g_led_fade, LEDC_HIGH_SPEED_MODE, LEDC_TIMER_0,
+		(const ledc_channel_t[]){ LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2 }, 3);
+	//按感知亮度渐变，线性占空比在亮端几乎看不出变化
+	LedFade_SetCurve(&g_led_fade, g_led_cie, LED_LUT_LEVELS);
+
+	//用户灯:定时器中断软件PWM，高电平点亮
+	LedSwPwm_Init(g_led_user_io, sizeof(g_led_user_io) / sizeof(g_led_user_io[0]), 0,
+		LED_USER_PWM_FREQ, LED_USER_PWM_BITS);
+}
+
+/*
+* led_user_task:两个用户灯交替渐亮渐灭，每轮打印一次软件PWM中断统计
+* @param[in]   arg   无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n  
+*/
+static void led_user_task(void *arg)
+{
+	LedSwPwm_Stats_t stats;
+
+	while(1)
+	{
+		//调用方式与ledc_set_fade_with_time/ledc_fade_start相同
+		LedSwPwm_SetFadeWithTime(0, LED_USER_MAX_DUTY, LED_USER_FADE_TIME);
+		LedSwPwm_FadeStart(0, LEDC_FADE_NO_WAIT);
+		LedSwPwm_SetFadeWithTime(1, 0, LED_USER_FADE_TIME);
+		LedSwPwm_FadeStart(1, LEDC_FADE_WAIT_DONE);
+		LedSwPwm_SetFadeWithTime(0, 0, LED_USER_FADE_TIME);
+		LedSwPwm_FadeStart(0, LEDC_FADE_NO_WAIT);
+		LedSwPwm_SetFadeWithTime(1, LED_USER_MAX_DUTY, LED_USER_FADE_TIME);
+		LedSwPwm_FadeStart(1, LEDC_FADE_WAIT_DONE);
+
+		LedSwPwm_GetStats(&stats);
+		LedSwPwm_ResetStats();
+		printf("swpwm isr: %u times, %u edges(%u spin, %u miss), avg %u cycles, max %u cycles, late max %u ticks\r\n",
+			stats.isr_count, stats.edge_count, stats.spin_count, stats.miss_count,
+			stats.isr_count ? (unsigned)(stats.cycles_sum / stats.isr_count) : 0, stats.cycles_max, stats.late_max);
+	}
+}
+
+/*
+* void led_set_rgb(const LedColor_Rgb_t *rgb):按CIE明度曲线输出颜色
+* @param[in]   rgb   颜色，各通道作为亮度级
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n  
+*/
+static void led_set_rgb(const LedColor_Rgb_t *rgb)
+{
+	ledc_set_duty(g_ledc_ch_R.speed_mode, g_ledc_ch_R.channel, g_led_cie[rgb->r]);
+	ledc_set_duty(g_ledc_ch_G.speed_mode, g_ledc_ch_G.channel, g_led_cie[rgb->g]);
+	ledc_set_duty(g_ledc_ch_B.speed_mode, g_ledc_ch_B.channel, g_led_cie[rgb->b]);
+	ledc_update_duty(g_ledc_ch_R.speed_mode, g_ledc_ch_R.channel);
+	ledc_update_duty(g_ledc_ch_G.speed_mode, g_ledc_ch_G.channel);
+	ledc_update_duty(g_ledc_ch_B.speed_mode, g_ledc_ch_B.channel);
 }
 
 /*
@@ -111,72 +205,35 @@ void ledc_init(void)
  * @par         修改日志 
  *               Ver0.0.1:
                      Caesar, 2019/10/17, 初始化版本\n   
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 三色同步渐变交给led_fade，不再逐通道启动+延时\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 呼吸后显示暖白，再循环色相渐变\n
+ *               Ver0.0.4:
+                     Caesar, 2026/10/19, 用户灯由软件PWM交替渐变\n
 */
 void app_main()
 {    
+	LedColor_Sweep_t sweep;
+	LedColor_Rgb_t rgb;
+
 	ledc_init();
-    while(1)
+	xTaskCreate(led_user_task, "led_user_task", 1024*2, NULL, configMAX_PRIORITIES-2, &led_user_task_handle);
+	//呼吸LED_BREATHE_TIMES次，帧之间由渐变结束中断衔接，不需要任务参与
+	LedFade_Play(&g_led_fade, g_led_breathe_keys, sizeof(g_led_breathe_keys) / sizeof(g_led_breathe_keys[0]),
+		LED_BREATHE_TIMES);
+	LedFade_Wait(&g_led_fade, portMAX_DELAY);
+
+	//暖白
+	LedColor_Kelvin(LED_WARM_KELVIN, 255, &rgb);
+	led_set_rgb(&rgb);
+	vTaskDelay(LED_WARM_TIME / portTICK_PERIOD_MS);
+
+	//色相渐变:每帧只做增量计算
+	LedColor_SweepInit(&sweep, 0, LED_COLOR_HUE_MAX, LED_SWEEP_TIME / LED_SWEEP_FRAME_MS, 255, 255);
+	while(1)
 	{
-		//ledc 红灯渐变至100%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_R.speed_mode,
-                    g_ledc_ch_R.channel, 
-					LEDC_MAX_DUTY,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_R.speed_mode,
-				g_ledc_ch_R.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 绿灯渐变至100%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_G.speed_mode,
-                    g_ledc_ch_G.channel, 
-					LEDC_MAX_DUTY,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_G.speed_mode,
-				g_ledc_ch_G.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 蓝灯渐变至100%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_B.speed_mode,
-                    g_ledc_ch_B.channel, 
-					LEDC_MAX_DUTY,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_B.speed_mode,
-				g_ledc_ch_B.channel, 
-				LEDC_FADE_NO_WAIT);
-		//延时LEDC_FADE_TIME，给LEDC控制时间
-        vTaskDelay(LEDC_FADE_TIME / portTICK_PERIOD_MS);
-		
-
-		//ledc 红灯 渐变至0%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_R.speed_mode,
-                    g_ledc_ch_R.channel, 
-					0,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_R.speed_mode,
-				g_ledc_ch_R.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 绿灯渐变至0%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_G.speed_mode,
-                    g_ledc_ch_G.channel, 
-					0,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_G.speed_mode,
-				g_ledc_ch_G.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 蓝灯渐变至0%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_B.speed_mode,
-                    g_ledc_ch_B.channel, 
-					0,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_B.speed_mode,
-				g_ledc_ch_B.channel, 
-				LEDC_FADE_NO_WAIT);
-		//延时LEDC_FADE_TIME，给LEDC控制时间
-        vTaskDelay(LEDC_FADE_TIME / portTICK_PERIOD_MS);
-		
+		led_set_rgb(LedColor_SweepNext(&sweep));
+		vTaskDelay(LED_SWEEP_FRAME_MS / portTICK_PERIOD_MS);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,380 @@
+/*
+* @file         bh1750.c
+* @brief        BH1750光照传感器连续测量驱动
+* @details      采样由i2c_sched调度任务驱动，不占用esp_timer任务做阻塞的i2c传输:
+*               连续模式下传感器自己循环转换，只设置一次模式，之后按周期读，每次只有一次读传输；
+*               单次模式每个周期下发测量指令，转换完成后读取
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "bh1750.h"
+#include "string.h"
+#include "esp_timer.h"
+/*
+===========================
+全局变量定义
+===========================
+*/
+static I2CBus_Device_t *g_bh1750_dev = NULL;
+static BH1750_Config_t g_bh1750_cfg;
+static I2CSched_Sensor_t *g_bh1750_sensor = NULL;
+static volatile bool g_bh1750_running = 0;
+static uint32_t g_bh1750_seq = 0;
+static BH1750_Stats_t g_bh1750_stats;
+static portMUX_TYPE g_bh1750_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 向BH1750写一条指令
+ * @param[in]   op   指令
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 经i2c_bus发送\n
+ */
+static esp_err_t bh1750_write_cmd(uint8_t op)
+{
+    return I2CBus_Write(g_bh1750_dev, NULL, 0, &op, 1, 0);
+}
+
+/**
+ * 读取最近一次转换结果
+ * @param[out]  raw   原始计数
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 经i2c_bus读取\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 读取失败时不改写raw\n
+ */
+static esp_err_t bh1750_read_raw(uint16_t *raw)
+{
+    uint8_t data[2];
+    esp_err_t ret = I2CBus_Read(g_bh1750_dev, data, sizeof(data));
+
+    if (ret == ESP_OK)
+    {
+        *raw = (uint16_t)(data[0] << 8 | data[1]);
+    }
+    return ret;
+}
+
+/**
+ * 自动调速的探测:上电后未启动测量时数据寄存器不变，连续两次读回必须一致
+ * @param[in]   dev   传感器
+ * @param[in]   arg   无
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_RESPONSE  两次读回不一致
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t bh1750_probe(I2CBus_Device_t *dev, void *arg)
+{
+    uint16_t a, b;
+    esp_err_t ret = bh1750_read_raw(&a);
+
+    if (ret == ESP_OK)
+    {
+        ret = bh1750_read_raw(&b);
+    }
+    if (ret == ESP_OK && a != b)
+    {
+        ret = ESP_ERR_INVALID_RESPONSE;
+    }
+    return ret;
+}
+
+/**
+ * 原始计数换算为0.001lx，默认测量时间寄存器(MTreg=69)下 lux = raw/1.2，H2模式再除2
+ * @param[in]   raw    原始计数
+ * @param[in]   mode   测量模式
+ * @retval      光照度(0.001lx)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 支持单次测量模式\n
+ */
+static uint32_t bh1750_raw_to_mlux(uint16_t raw, BH1750_MODE_t mode)
+{
+    uint32_t mlux = (uint32_t)raw * 2500 / 3;
+    return (mode == BH1750_MODE_CONT_H2 || mode == BH1750_MODE_ONCE_H2) ? mlux / 2 : mlux;
+}
+
+/**
+ * 调度器的读取回调:读取一个样本并交给回调/队列，停止后不再读取
+ * @param[in]   arg   无
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 只由调度器调用，BH1750_Stop后跳过\n
+ */
+static esp_err_t bh1750_sample(void *arg)
+{
+    BH1750_Sample_t sample;
+    bool dropped = 0;
+    esp_err_t ret;
+
+    (void)arg;
+    if (!g_bh1750_running)
+    {
+        return ESP_OK;
+    }
+    ret = bh1750_read_raw(&sample.raw);
+    if (ret != ESP_OK)
+    {
+        portENTER_CRITICAL(&g_bh1750_stats_mux);
+        g_bh1750_stats.errors ++;
+        portEXIT_CRITICAL(&g_bh1750_stats_mux);
+        return ret;
+    }
+    sample.time_us = esp_timer_get_time();
+    sample.seq = g_bh1750_seq ++;
+    sample.mlux = bh1750_raw_to_mlux(sample.raw, g_bh1750_cfg.mode);
+
+    if (g_bh1750_cfg.callback)
+    {
+        g_bh1750_cfg.callback(&sample, g_bh1750_cfg.arg);
+    }
+    if (g_bh1750_cfg.queue && xQueueSend(g_bh1750_cfg.queue, &sample, 0) != pdTRUE)
+    {
+        dropped = 1;
+    }
+
+    portENTER_CRITICAL(&g_bh1750_stats_mux);
+    g_bh1750_stats.samples ++;
+    g_bh1750_stats.dropped += dropped;
+    portEXIT_CRITICAL(&g_bh1750_stats_mux);
+    return ESP_OK;
+}
+
+/**
+ * 调度器的启动回调:单次模式下发测量指令
+ * @param[in]   arg   无
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, BH1750_Stop后跳过\n
+ */
+static esp_err_t bh1750_sched_start(void *arg)
+{
+    (void)arg;
+    if (!g_bh1750_running)
+    {
+        return ESP_OK;
+    }
+    return bh1750_write_cmd(g_bh1750_cfg.mode);
+}
+
+/**
+ * 在i2c_bus上登记传感器并唤醒
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c错误(传感器未连接时为ESP_FAIL)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 端口由i2c_bus管理\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 上电后自动探测可靠的最高i2c时钟\n
+ */
+esp_err_t BH1750_Init(void)
+{
+    esp_err_t ret = I2CBus_Init(I2C_MASTER_NUM, I2C_SDA_IO, I2C_SCL_IO, I2C_MASTER_FREQ_HZ);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    //读传输很短且要求准时，高优先级，可以插入到OLED刷新的块之间
+    if (g_bh1750_dev == NULL)
+    {
+        g_bh1750_dev = I2CBus_AddDevice(I2C_MASTER_NUM, BH1750_SENSOR_ADDR, "bh1750", I2C_BUS_PRIO_HIGH);
+    }
+    if (g_bh1750_dev == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    ret = bh1750_write_cmd(BH1750_CMD_POWER_ON);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return (I2CBus_AutoTune(g_bh1750_dev, BH1750_MAX_FREQ_HZ, bh1750_probe, NULL) != 0) ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * 模式对应的最长转换时间(数据手册max值)
+ * @param[in]   mode   测量模式
+ * @retval      转换时间(ms)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 支持单次测量模式\n
+ */
+uint32_t BH1750_ConversionMs(BH1750_MODE_t mode)
+{
+    return (mode == BH1750_MODE_CONT_L || mode == BH1750_MODE_ONCE_L) ? 24 : 180;
+}
+
+/**
+ * 启动i2c_sched调度任务并把传感器挂上去，调用者不阻塞；
+ * 调度表不能删除传感器，BH1750_Stop后再启动沿用原来的表项和周期，只能更换回调和队列
+ * @param[in]   config   配置，内容会被拷贝
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_STATE  已经启动
+ *              - ESP_ERR_INVALID_ARG    停止后再启动时模式与第一次不同
+ *              - ESP_FAIL               i2c错误或调度表满
+ *              - 其它  调度任务启动错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 改由i2c_sched驱动，单次模式每周期测量后读取\n
+ */
+esp_err_t BH1750_Start(const BH1750_Config_t *config)
+{
+    esp_err_t ret;
+
+    if (g_bh1750_running)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (g_bh1750_sensor == NULL)
+    {
+        ret = I2CSched_Start();
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+        return (BH1750_AddToScheduler(config) != NULL) ? ESP_OK : ESP_FAIL;
+    }
+
+    if (config->mode != g_bh1750_cfg.mode)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    g_bh1750_cfg.callback = config->callback;
+    g_bh1750_cfg.arg = config->arg;
+    g_bh1750_cfg.queue = config->queue;
+    //连续模式掉电后要重新设置模式，单次模式由调度器每周期下发
+    if (!(g_bh1750_cfg.mode & 0x20) && bh1750_write_cmd(g_bh1750_cfg.mode) != ESP_OK)
+    {
+        return ESP_FAIL;
+    }
+    g_bh1750_running = 1;
+    return ESP_OK;
+}
+
+/**
+ * 停止采样并让传感器掉电，调度表中的表项保留，采样回调不再读写传感器
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 改由i2c_sched驱动\n
+ */
+esp_err_t BH1750_Stop(void)
+{
+    g_bh1750_running = 0;
+    return bh1750_write_cmd(BH1750_CMD_POWER_DOWN);
+}
+
+/**
+ * 挂到i2c_sched调度器上(调度任务由调用者启动，BH1750_Start会一起启动)；
+ * 单次模式每个周期下发测量指令、转换完成后读取，转换期间传感器不占总线、测完自动掉电；
+ * 连续模式只在这里设置一次模式，调度器按周期读取
+ * @param[in]   config   配置，内容会被拷贝
+ * @retval
+ *              调度表中的传感器，已经挂上、i2c错误或调度表满时为NULL
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 只能挂一次，记录表项供BH1750_Start/Stop使用\n
+ */
+I2CSched_Sensor_t *BH1750_AddToScheduler(const BH1750_Config_t *config)
+{
+    I2CSched_Config_t sc;
+    uint32_t conv_ms = BH1750_ConversionMs(config->mode);
+    bool once = (config->mode & 0x20) != 0;
+
+    if (g_bh1750_sensor)
+    {
+        return NULL;
+    }
+    g_bh1750_cfg = *config;
+    if (g_bh1750_cfg.period_ms <= conv_ms)
+    {
+        g_bh1750_cfg.period_ms = conv_ms + (once ? 1 : 0);
+    }
+    if (!once && bh1750_write_cmd(g_bh1750_cfg.mode) != ESP_OK)
+    {
+        return NULL;
+    }
+
+    memset(&sc, 0, sizeof(sc));
+    sc.name = "bh1750";
+    sc.period_us = g_bh1750_cfg.period_ms * 1000;
+    sc.conv_us = once ? conv_ms * 1000 : 0;
+    sc.start = once ? bh1750_sched_start : NULL;
+    sc.read = bh1750_sample;
+    //先置运行标志，调度器添加后立即释放第一次采样
+    g_bh1750_running = 1;
+    g_bh1750_sensor = I2CSched_Add(&sc);
+    if (g_bh1750_sensor == NULL)
+    {
+        g_bh1750_running = 0;
+    }
+    return g_bh1750_sensor;
+}
+
+/**
+ * 读取统计
+ * @param[out]  stats   统计结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void BH1750_GetStats(BH1750_Stats_t *stats)
+{
+    portENTER_CRITICAL(&g_bh1750_stats_mux);
+    *stats = g_bh1750_stats;
+    portEXIT_CRITICAL(&g_bh1750_stats_mux);
+}
@@ -0,0 +1,89 @@
+/*
+* @file         bh1750.h
+* @brief        BH1750光照传感器连续测量驱动
+* @details      由i2c_sched调度任务按周期采样:连续模式只设置一次模式后定时读取，
+*               单次模式每周期测量、转换完成后读取；样本通过回调或队列交给应用，
+*               不需要专门的任务阻塞等待转换
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef BH1750_H
+#define BH1750_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "i2c_bus.h"
+#include "i2c_sched.h"
+/*
+===========================
+宏定义
+===========================
+*/
+//I2C
+#define I2C_SCL_IO                  33                  //SCL->IO33
+#define I2C_SDA_IO                  32                  //SDA->IO32
+#define I2C_MASTER_NUM              I2C_NUM_1           //I2C_1
+#define I2C_MASTER_FREQ_HZ          100000              //I2C端口默认时钟(端口已由其它驱动初始化时以其为准)
+#define BH1750_MAX_FREQ_HZ          400000              //数据手册支持的最高时钟，启动时在此范围内自动调速
+
+//BH1750
+#define BH1750_SENSOR_ADDR          0x23                //ADDR脚接地时的从机地址
+#define BH1750_CMD_POWER_DOWN       0x00
+#define BH1750_CMD_POWER_ON         0x01
+
+//测量模式(指令码)
+typedef enum {
+	BH1750_MODE_CONT_H   = 0x10,    /*!< 连续高分辨率 1lx，最长转换180ms */
+	BH1750_MODE_CONT_H2  = 0x11,    /*!< 连续高分辨率2 0.5lx，最长转换180ms */
+	BH1750_MODE_CONT_L   = 0x13,    /*!< 连续低分辨率 4lx，最长转换24ms */
+	BH1750_MODE_ONCE_H   = 0x20,    /*!< 单次高分辨率，转换后自动掉电 */
+	BH1750_MODE_ONCE_H2  = 0x21,    /*!< 单次高分辨率2 */
+	BH1750_MODE_ONCE_L   = 0x23,    /*!< 单次低分辨率 */
+} BH1750_MODE_t;
+
+//一个样本
+typedef struct {
+	uint32_t seq;                   /*!< 样本序号 */
+	int64_t  time_us;               /*!< 读取时刻(esp_timer_get_time) */
+	uint16_t raw;                   /*!< 原始计数 */
+	uint32_t mlux;                  /*!< 光照度，单位0.001lx */
+} BH1750_Sample_t;
+
+//样本回调，在i2c_sched调度任务中执行，不能阻塞
+typedef void (*BH1750_Callback_t)(const BH1750_Sample_t *sample, void *arg);
+
+//连续测量配置
+typedef struct {
+	BH1750_MODE_t mode;
+	uint32_t period_ms;             /*!< 采样周期，0或不大于最长转换时间时按最长转换时间
+	                                     (单次模式须大于转换时间，按转换时间+1ms) */
+	BH1750_Callback_t callback;     /*!< 可为NULL */
+	void *arg;
+	QueueHandle_t queue;            /*!< 元素为BH1750_Sample_t，满时丢弃新样本，可为NULL */
+} BH1750_Config_t;
+
+//统计
+typedef struct {
+	uint32_t samples;               /*!< 读取成功的样本数 */
+	uint32_t errors;                /*!< i2c读取失败次数 */
+	uint32_t dropped;               /*!< 队列满丢弃的样本数 */
+} BH1750_Stats_t;
+
+
+esp_err_t BH1750_Init(void);
+uint32_t BH1750_ConversionMs(BH1750_MODE_t mode);
+esp_err_t BH1750_Start(const BH1750_Config_t *config);
+esp_err_t BH1750_Stop(void);
+I2CSched_Sensor_t *BH1750_AddToScheduler(const BH1750_Config_t *config);
+void BH1750_GetStats(BH1750_Stats_t *stats);
+
+#endif
@@ -20,37 +20,30 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/ledc.h"
-#include "driver/i2c.h"
+#include "led_fade.h"
+#include "led_lut.h"
+#include "bh1750.h"
+#include "sample_ring.h"
+#include "sensor_pipe.h"
+#include "i2c_diag.h"
 
 /*
 ===========================
 宏定义
 =========================== 
 */
-#define LEDC_MAX_DUTY         	(8191)	//2的13次方-1(13位ledc)
 #define LEDC_FADE_TIME    		(1000)	//渐变时间(ms)
 
 #define LED_R_IO    2
 #define LED_G_IO    18
 #define LED_B_IO    19
 
-//I2C 
-#define I2C_SCL_IO          		33                  //SCL->IO33
-#define I2C_SDA_IO          		32                  //SDA->IO32
-#define I2C_MASTER_NUM      		I2C_NUM_1           //I2C_1
-#define I2C_MASTER_FREQ_HZ  		100000           	//I2C主机时钟频率
-#define I2C_MASTER_TX_BUF_DISABLE  	0            		//I2C主机不需要tx buffer
-#define I2C_MASTER_RX_BUF_DISABLE  	0            		//I2C主机不需要rx buffer
-#define WRITE_BIT           		I2C_MASTER_WRITE    //写:0
-#define READ_BIT            		I2C_MASTER_READ     //读:1
-#define ACK_CHECK_EN        		0x1                 //主机检查从机的ACK
-#define ACK_CHECK_DIS       		0x0                 //主机不检查从机的ACK
-#define ACK_VAL             		0x0                 //应答
-#define NACK_VAL            		0x1                 //不应答
-
 //BH1750
-#define BH1750_SENSOR_ADDR          0x23             	//BH1750 sensor从机地址
-#define BH1750_CMD_START            0x23             	//BH1750设置测量模式指令
+#define SENSOR_PERIOD_MS            200                 //采样周期
+#define SENSOR_EVENT_QUEUE_LEN      4                   //光照事件队列深度
+#define LUX_CHANGE_MLX              5000                //变化超过5lx才通知
+#define LUX_DARK_MLX                20000               //低于20lx认为变暗
+#define LUX_BRIGHT_MLX              40000               //高于40lx认为变亮
 
 /*
 ===========================
@@ -59,6 +52,22 @@
 */
 //ledc配置结构体
 ledc_channel_config_t 	g_ledc_ch_R,g_ledc_ch_G,g_ledc_ch_B;
+//RGB三个通道作为一组同步渐变
+LedFade_Group_t			g_led_fade;
+//13位占空比的CIE明度曲线，编译期生成
+static const uint32_t	g_led_cie[LED_LUT_LEVELS] = LED_LUT_CIE(13);
+//呼吸灯关键帧(亮度级):三色同时渐亮，再同时渐灭
+LedFade_Key_t			g_led_breathe_keys[] = {
+	{ .duty = {LED_LUT_LEVELS - 1, LED_LUT_LEVELS - 1, LED_LUT_LEVELS - 1}, .time_ms = LEDC_FADE_TIME },
+	{ .duty = {0, 0, 0}, .time_ms = LEDC_FADE_TIME },
+};
+//光照样本(单位0.001lx)，采样回调写入，显示/网络/日志等各自读取
+SampleRing_t			g_lux_ring;
+//光照处理流水线:中值去尖峰+卡尔曼平滑+迟滞/变化检测
+SensorPipe_t			g_lux_pipe;
+QueueHandle_t			g_lux_event_queue;
+//传感器无应答时的总线诊断结果
+I2CDiag_Result_t		g_i2c_diag;
 
 /*
 ===========================
@@ -89,6 +98,10 @@ void i2c_sensor_task();
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/18, 初始化版本\n   
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 用led_fade代替LEDC渐变服务\n  
+*               Ver0.0.3:
+                    Caesar, 2026/10/19, 按CIE明度曲线渐变\n  
 */
 void ledc_init(void)
 {
@@ -125,70 +138,14 @@ void ledc_init(void)
 	g_ledc_ch_B.timer_sel  = LEDC_TIMER_0;			//选择定时器
 	ledc_channel_config(&g_ledc_ch_B);				//配置PWM
 	
-	//注册LEDC服务:相当于使能
-	ledc_fade_func_install(0);
-}
-
-/**
- * @brief test code to write esp-i2c-slave
- *
- * 1. set mode
- * _________________________________________________________________
- * | start | slave_addr + wr_bit + ack | write 1 byte + ack  | stop |
- * --------|---------------------------|---------------------|------|
- * 2. wait more than 24 ms
- * 3. read data
- * ______________________________________________________________________________________
- * | start | slave_addr + rd_bit + ack | read 1 byte + ack  | read 1 byte + nack | stop |
- * --------|---------------------------|--------------------|--------------------|------|
- */
-static esp_err_t i2c_master_sensor_test(i2c_port_t i2c_num, uint8_t* data_h, uint8_t* data_l)
-{
-    int ret;
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, BH1750_SENSOR_ADDR << 1 | WRITE_BIT, ACK_CHECK_EN);
-    i2c_master_write_byte(cmd, BH1750_CMD_START, ACK_CHECK_EN);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
-    if (ret != ESP_OK) {
-        return ret;
-    }
-    vTaskDelay(30 / portTICK_RATE_MS);
-    cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, BH1750_SENSOR_ADDR << 1 | READ_BIT, ACK_CHECK_EN);
-    i2c_master_read_byte(cmd, data_h, ACK_VAL);
-    i2c_master_read_byte(cmd, data_l, NACK_VAL);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(i2c_num, cmd, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
-    return ret;
+	//注册渐变中断(代替ledc_fade_func_install)，RGB登记为一组
+	LedFade_Init();
+	LedFade_AddGroup(&g_led_fade, LEDC_HIGH_SPEED_MODE, LEDC_TIMER_0,
+		(const ledc_channel_t[]){ LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2 }, 3);
+	//按感知亮度渐变，线性占空比在亮端几乎看不出变化
+	LedFade_SetCurve(&g_led_fade, g_led_cie, LED_LUT_LEVELS);
 }
 
-/**
- * @brief i2c master initialization
- */
-static void i2c_master_init()
-{
-    int i2c_master_port = I2C_MASTER_NUM;
-    i2c_config_t conf;
-    conf.mode = I2C_MODE_MASTER;
-    conf.sda_io_num = I2C_SDA_IO;
-    conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.scl_io_num = I2C_SCL_IO;
-    conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.master.clk_speed = I2C_MASTER_FREQ_HZ;
-    i2c_param_config(i2c_master_port, &conf);
-    i2c_driver_install(i2c_master_port, conf.mode,
-                       I2C_MASTER_RX_BUF_DISABLE,
-                       I2C_MASTER_TX_BUF_DISABLE, 0);
-}
-
-
-
-
 /*
  * 应用程序的函数入口
  * @param[in]   无
@@ -212,101 +169,114 @@ void app_main()
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/18, 初始化版本\n    
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 三色同步渐变交给led_fade，启动后任务退出\n  
 */
 void led_breathe_task()
 {
 	ledc_init();
-	while(1){
-		//ledc 红灯渐变至100%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_R.speed_mode,
-                    g_ledc_ch_R.channel, 
-					LEDC_MAX_DUTY,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_R.speed_mode,
-				g_ledc_ch_R.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 绿灯渐变至100%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_G.speed_mode,
-                    g_ledc_ch_G.channel, 
-					LEDC_MAX_DUTY,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_G.speed_mode,
-				g_ledc_ch_G.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 蓝灯渐变至100%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_B.speed_mode,
-                    g_ledc_ch_B.channel, 
-					LEDC_MAX_DUTY,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_B.speed_mode,
-				g_ledc_ch_B.channel, 
-				LEDC_FADE_NO_WAIT);
-		//延时LEDC_FADE_TIME，给LEDC控制时间
-        vTaskDelay(LEDC_FADE_TIME / portTICK_PERIOD_MS);
-		
+	//两帧循环播放，帧之间由渐变结束中断衔接，不需要任务参与
+	LedFade_Play(&g_led_fade, g_led_breathe_keys, sizeof(g_led_breathe_keys) / sizeof(g_led_breathe_keys[0]), 0);
+	vTaskDelete(NULL);
+}
 
-		//ledc 红灯 渐变至0%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_R.speed_mode,
-                    g_ledc_ch_R.channel, 
-					0,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_R.speed_mode,
-				g_ledc_ch_R.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 绿灯渐变至0%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_G.speed_mode,
-                    g_ledc_ch_G.channel, 
-					0,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_G.speed_mode,
-				g_ledc_ch_G.channel, 
-				LEDC_FADE_NO_WAIT);
-		//ledc 蓝灯渐变至0%，时间LEDC_FADE_TIME
-		ledc_set_fade_with_time(g_ledc_ch_B.speed_mode,
-                    g_ledc_ch_B.channel, 
-					0,
-                    LEDC_FADE_TIME);
-		//渐变开始
-		ledc_fade_start(g_ledc_ch_B.speed_mode,
-				g_ledc_ch_B.channel, 
-				LEDC_FADE_NO_WAIT);
-		//延时LEDC_FADE_TIME，给LEDC控制时间
-        vTaskDelay(LEDC_FADE_TIME / portTICK_PERIOD_MS);
-	}
+/*
+* 光照事件回调(调度任务中执行):只在有明显变化时投递给打印任务
+* @param[in]   event    事件
+* @param[in]   arg      无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n  
+*/
+static void lux_event_cb(const SensorEvent_t *event, void *arg)
+{
+	xQueueSend(g_lux_event_queue, event, 0);
+}
+
+/*
+* 采样回调(调度任务中执行):经处理流水线后写入环形缓冲区，不阻塞
+* @param[in]   sample   样本
+* @param[in]   arg      无
+* @retval      无
+* @note        修改日志 
+*               Ver0.0.1:
+                    Caesar, 2026/10/19, 初始化版本\n  
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 先经过定点处理流水线\n  
+*/
+static void sensor_sample_cb(const BH1750_Sample_t *sample, void *arg)
+{
+	int32_t lux = SensorPipe_Process(&g_lux_pipe, sample->time_us, (int32_t)sample->mlux);
+	SampleRing_Push(&g_lux_ring, sample->time_us, lux);
 }
 
 /*
-* i2c驱动bh1750任务
+* i2c驱动bh1750任务:传感器由i2c_sched调度读取，本任务只在光照明显变化时被唤醒
 * @param[in]   无
 * @retval      无
 * @note        修改日志 
 *               Ver0.0.1:
                     Caesar, 2019/10/18, 初始化版本\n  
+*               Ver0.0.2:
+                    Caesar, 2026/10/19, 改为连续测量模式，不再单次测量+延时等待\n  
+*               Ver0.0.3:
+                    Caesar, 2026/10/19, 由i2c_sched调度单次测量\n  
+*               Ver0.0.4:
+                    Caesar, 2026/10/19, 样本存入环形缓冲区，打印流式统计\n  
+*               Ver0.0.5:
+                    Caesar, 2026/10/19, 等待处理流水线的变化事件，不再定时轮询\n  
+*               Ver0.0.6:
+                    Caesar, 2026/10/19, 传感器无应答时打印总线诊断\n  
+*               Ver0.0.7:
+                    Caesar, 2026/10/19, 用BH1750_Start启动调度采样\n  
 */
 void i2c_sensor_task()
 {
-	int ret;
-    uint8_t sensor_data_h, sensor_data_l;
-	i2c_master_init();
-	while(1){
-		ret = i2c_master_sensor_test( I2C_MASTER_NUM, &sensor_data_h, &sensor_data_l);
-        if(ret == ESP_ERR_TIMEOUT) {
-            printf("I2C timeout\n");
-        } else if(ret == ESP_OK) {
-            printf("*******************\n");
-            printf("MASTER READ SENSOR( BH1750 )\n");
-            printf("*******************\n");
-            printf("data_h: %02x\n", sensor_data_h);
-            printf("data_l: %02x\n", sensor_data_l);
-            printf("sensor val: %.2f\n", (sensor_data_h << 8 | sensor_data_l) / 1.2);
-        } else {
-            printf("No ack, sensor not connected...skip...\n");
-        }
+	esp_err_t ret;
+	int scanned = 0;
+	BH1750_Config_t cfg;
+	SensorEvent_t event;
+	SampleStats_t stats;
+
+	g_lux_event_queue = xQueueCreate(SENSOR_EVENT_QUEUE_LEN, sizeof(SensorEvent_t));
+	SampleRing_Init(&g_lux_ring);
+	SensorPipe_Init(&g_lux_pipe);
+	SensorPipe_AddMedian(&g_lux_pipe, 3);
+	SensorPipe_AddKalman(&g_lux_pipe, 1000LL * 1000, 4000LL * 4000);   //过程噪声1lx 测量噪声4lx(方差，单位0.001lx)
+	SensorPipe_SetHysteresis(&g_lux_pipe, LUX_DARK_MLX, LUX_BRIGHT_MLX);
+	SensorPipe_SetChangeDelta(&g_lux_pipe, LUX_CHANGE_MLX);
+	SensorPipe_SetCallback(&g_lux_pipe, lux_event_cb, NULL);
+
+	//传感器未连接时每500ms重试一次，总线诊断只在第一次失败时打印
+	while (1) {
+		ret = BH1750_Init();
+		if (ret == ESP_OK) {
+			cfg.mode = BH1750_MODE_ONCE_H;  //单次测量，测完自动掉电
+			cfg.period_ms = SENSOR_PERIOD_MS;
+			cfg.callback = sensor_sample_cb;
+			cfg.arg = NULL;
+			cfg.queue = NULL;
+			ret = BH1750_Start(&cfg);
+		}
+		if (ret == ESP_OK) {
+			break;
+		}
+		printf("No ack, sensor not connected...retry...\n");
+		//扫描总线，区分总线被拉死、传感器不在线和总线变慢
+		if (!scanned && I2CDiag_Scan(I2C_MASTER_NUM, &g_i2c_diag) == ESP_OK) {
+			I2CDiag_Print(&g_i2c_diag);
+		}
+		scanned = 1;
 		vTaskDelay(500 / portTICK_RATE_MS);
 	}
+	while(1){
+		xQueueReceive(g_lux_event_queue, &event, portMAX_DELAY);
+		printf("lux: %d.%03d%s%s\n", event.value / 1000, event.value % 1000,
+			(event.flags & SENSOR_EVENT_RISE) ? " bright" : "",
+			(event.flags & SENSOR_EVENT_FALL) ? " dark" : "");
+		if (SampleRing_GetCurrent(&g_lux_ring, SAMPLE_RING_LEVEL_1MIN, &stats)) {
+			printf("1min n:%u min:%d max:%d mean:%d\n", stats.count, stats.min, stats.max, (int)stats.mean);
+		}
+	}
 }
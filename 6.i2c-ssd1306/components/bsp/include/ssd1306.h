@@ -21,6 +21,7 @@
 #include "freertos/task.h"
 #include "driver/i2c.h"
 #include "fonts.h"
+#include "ssd1306_transport.h"
 /*
 ===========================
 宏定义
@@ -30,6 +31,8 @@
 #define I2C_OLED_MASTER_SCL_IO          33               /*!< gpio number for I2C master clock */
 #define I2C_OLED_MASTER_SDA_IO          32               /*!< gpio number for I2C master data  */
 #define I2C_OLED_MASTER_NUM             I2C_NUM_1        /*!< I2C port number for master dev */
+#define I2C_OLED_MASTER_FREQ_HZ         400000           /*!< I2C master clock frequency */
+#define I2C_OLED_MASTER_MAX_FREQ_HZ     1000000          /*!< 自动调速上限(数据手册为400kHz，多数模块可以更快，由探测把关) */
 #define WRITE_BIT                       I2C_MASTER_WRITE /*!< I2C master write */
 #define READ_BIT                        I2C_MASTER_READ  /*!< I2C master read */
 #define ACK_CHECK_EN                    0x1              /*!< I2C master will check ack from slave*/
@@ -41,6 +44,9 @@
 #define OLED_WRITE_ADDR    				0x78
 #define SSD1306_WIDTH  					128
 #define SSD1306_HEIGHT 					64
+#define SSD1306_PAGES  					(SSD1306_HEIGHT / 8)
+#define SSD1306_VIEWPORT_DEPTH			4				//视口栈深度(含整屏)
+#define SSD1306_MAX_PAGES				(SSD1306_WIDTH / 8)	//90/270度时逻辑画布的页数
 #define WRITE_CMD      				 	0X00
 #define WRITE_DATA     			 		0X40
 
@@ -73,24 +79,59 @@
 #define SET26_INV_DIS            0xA6                     // Disable Inverse Display On (0xa6/a7) 
 #define TURN_ON_CMD              0xAF                     //--turn on oled panel
 
-//显示1，擦除0
+//显示1，擦除0，异或2(再画一次恢复原样)
 typedef enum {
 	SSD1306_COLOR_BLACK = 0x00, /*!< Black color, no pixel */
-	SSD1306_COLOR_WHITE = 0x01  /*!< Pixel is set. Color depends on LCD */
+	SSD1306_COLOR_WHITE = 0x01, /*!< Pixel is set. Color depends on LCD */
+	SSD1306_COLOR_XOR   = 0x02  /*!< Pixel is toggled, drawing twice restores it. Text background is left untouched */
 } SSD1306_COLOR_t;
 
+//显示方向(顺时针)
+typedef enum {
+	SSD1306_ROTATION_0 = 0,
+	SSD1306_ROTATION_90,
+	SSD1306_ROTATION_180,
+	SSD1306_ROTATION_270
+} SSD1306_ROTATION_t;
+
+//视口:裁剪区和局部坐标原点(逻辑画布绝对坐标)
+typedef struct {
+	int16_t x0;				/*!< 裁剪区左上角，闭区间，x0>x1表示空 */
+	int16_t y0;
+	int16_t x1;				/*!< 裁剪区右下角 */
+	int16_t y1;
+	int16_t ox;				/*!< 局部坐标原点 */
+	int16_t oy;
+} SSD1306_Viewport_t;
+
 typedef struct {
 	uint16_t CurrentX;
 	uint16_t CurrentY;
 	uint8_t Inverted;
 	uint8_t Initialized;
+	uint16_t Width;			/*!< 逻辑画布宽度，随旋转变化 */
+	uint16_t Height;		/*!< 逻辑画布高度，随旋转变化 */
+	uint8_t Rotation;		/*!< @ref SSD1306_ROTATION_t */
 } SSD1306_t;
 
 
-void SSD1306_Init(void);
+esp_err_t SSD1306_Init(void);
+esp_err_t SSD1306_InitWithTransport(const SSD1306_Transport_t *transport);
 void SSD1306_UpdateScreen(void);
+esp_err_t SSD1306_FlushFrame(const uint8_t *frame);
+void SSD1306_SetAutoUpdate(bool enable);
+void SSD1306_SetRotation(SSD1306_ROTATION_t rotation);
+void SSD1306_InvertDisplay(bool invert);
+const SSD1306_Transport_t *SSD1306_GetTransport(void);
+uint16_t SSD1306_GetWidth(void);
+uint16_t SSD1306_GetHeight(void);
+void SSD1306_Fill(SSD1306_COLOR_t color);
 void SSD1306_Clear(void);
 void SSD1306_All_On(void);
+void SSD1306_ResetViewport(void);
+esp_err_t SSD1306_PushViewport(int16_t x, int16_t y, uint16_t w, uint16_t h);
+esp_err_t SSD1306_PushClip(int16_t x, int16_t y, uint16_t w, uint16_t h);
+void SSD1306_PopViewport(void);
 void SSD1306_GotoXY(uint16_t x, uint16_t y); 
 void SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color);
 char SSD1306_DrawChar(uint16_t x,uint16_t y,char ch, FontDef_t* Font, SSD1306_COLOR_t color);
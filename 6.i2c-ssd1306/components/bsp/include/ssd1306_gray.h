@@ -0,0 +1,51 @@
+/*
+* @file         ssd1306_gray.h
+* @brief        OLED时间抖动4级灰度
+* @details      两个位平面按2:1的时间比例轮流刷新到屏幕:高位平面(g_oled_buffer)
+*               显示2个子帧，低位平面显示1个子帧，亮度 = (2*高位+低位)/3
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef SSD1306_GRAY_H
+#define SSD1306_GRAY_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include "ssd1306.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define SSD1306_GRAY_LEVELS             4                //灰度级数0~3
+#define SSD1306_GRAY_SUBFRAMES          3                //一个灰度周期的子帧数
+#define SSD1306_GRAY_DEFAULT_HZ         60               //默认灰度周期频率，低于50Hz肉眼可见闪烁
+#define SSD1306_GRAY_TASK_STACK         (1024*2)         //刷新任务栈大小
+#define SSD1306_GRAY_TASK_PRIO          (configMAX_PRIORITIES-2)
+
+//灰度刷新统计
+typedef struct {
+	uint32_t cycle_hz;              /*!< 灰度周期频率 */
+	uint32_t subframe_us;           /*!< 子帧周期 */
+	uint32_t estimate_us;           /*!< 按传输层估算的整屏刷新耗时 */
+	uint32_t flushes;               /*!< 已完成的整屏刷新次数 */
+	uint32_t flush_rate;            /*!< 启动以来平均每秒整屏刷新次数 */
+	uint32_t missed;                /*!< 刷新超时累计错过的子帧数 */
+	uint32_t flush_us_last;         /*!< 上一次整屏刷新耗时 */
+	uint32_t flush_us_max;
+} SSD1306_GrayStats_t;
+
+
+esp_err_t SSD1306_GrayStart(uint8_t cycle_hz);
+void SSD1306_GrayStop(void);
+void SSD1306_GrayClear(void);
+void SSD1306_GrayDrawPixel(int16_t x, int16_t y, uint8_t level);
+void SSD1306_GrayFillRectangle(int16_t x, int16_t y, uint16_t w, uint16_t h, uint8_t level);
+void SSD1306_GrayCopyMono(void);
+void SSD1306_GrayGetStats(SSD1306_GrayStats_t *stats);
+
+#endif
@@ -0,0 +1,104 @@
+/*
+* @file         ssd1306_pixel.h
+* @brief        OLED显存不检查边界的内联像素/span操作
+* @details      按颜色用宏展开成Set/Clear/Xor三组函数，调用者必须先完成裁剪，
+*               并用SSD1306_MarkDirty标记修改的区域，否则不会被刷新
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef SSD1306_PIXEL_H
+#define SSD1306_PIXEL_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include "ssd1306.h"
+/*
+===========================
+显存(逻辑画布，每页stride字节，每字节纵向8像素低位在上)
+===========================
+*/
+extern uint8_t g_oled_buffer[];
+extern uint16_t g_oled_stride;
+
+bool SSD1306_ClipRect(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1);
+void SSD1306_MarkDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define SSD1306_PIXEL_PTR(x, y)     (&g_oled_buffer[(x) + ((y) >> 3) * g_oled_stride])
+#define SSD1306_PIXEL_BIT(y)        ((uint8_t)(1 << ((y) & 7)))
+
+//按颜色的字节操作
+#define SSD1306_OP_SET(dst, mask)   ((dst) |= (mask))
+#define SSD1306_OP_CLEAR(dst, mask) ((dst) &= (uint8_t)~(mask))
+#define SSD1306_OP_XOR(dst, mask)   ((dst) ^= (mask))
+
+/*
+ * 生成一组内联函数(坐标为逻辑画布绝对坐标，闭区间，不检查边界):
+ *   SSD1306_<Name>PixelUnchecked(x, y)
+ *   SSD1306_<Name>HSpanUnchecked(x0, x1, y)     x0<=x1
+ *   SSD1306_<Name>RectUnchecked(x0, y0, x1, y1) x0<=x1, y0<=y1，按页掩码整字节写
+ *   SSD1306_<Name>PlaneRectUnchecked(plane, stride, x0, y0, x1, y1)
+ *                                               同上，写到指定的位平面(如灰度的低位平面)
+ */
+#define SSD1306_DEFINE_PIXEL_OPS(Name, OP)                                              \
+static inline void SSD1306_##Name##PixelUnchecked(int16_t x, int16_t y)                 \
+{                                                                                       \
+    OP(*SSD1306_PIXEL_PTR(x, y), SSD1306_PIXEL_BIT(y));                                 \
+}                                                                                       \
+static inline void SSD1306_##Name##HSpanUnchecked(int16_t x0, int16_t x1, int16_t y)    \
+{                                                                                       \
+    uint8_t *p = SSD1306_PIXEL_PTR(x0, y);                                              \
+    uint8_t *end = p + (x1 - x0) + 1;                                                   \
+    uint8_t mask = SSD1306_PIXEL_BIT(y);                                                \
+    while (p < end)                                                                     \
+    {                                                                                   \
+        OP(*p, mask);                                                                   \
+        p ++;                                                                           \
+    }                                                                                   \
+}                                                                                       \
+static inline void SSD1306_##Name##PlaneRectUnchecked(uint8_t *plane, uint16_t stride,  \
+                                                      int16_t x0, int16_t y0,           \
+                                                      int16_t x1, int16_t y1)           \
+{                                                                                       \
+    int16_t page;                                                                       \
+    uint8_t mask;                                                                       \
+    uint8_t *p, *end;                                                                   \
+    for (page = y0 >> 3; page <= (y1 >> 3); page ++)                                    \
+    {                                                                                   \
+        mask = 0xFF;                                                                    \
+        if (page == (y0 >> 3))                                                          \
+        {                                                                               \
+            mask &= 0xFF << (y0 & 7);                                                   \
+        }                                                                               \
+        if (page == (y1 >> 3))                                                          \
+        {                                                                               \
+            mask &= 0xFF >> (7 - (y1 & 7));                                             \
+        }                                                                               \
+        p = &plane[page * stride + x0];                                                 \
+        end = p + (x1 - x0) + 1;                                                        \
+        while (p < end)                                                                 \
+        {                                                                               \
+            OP(*p, mask);                                                               \
+            p ++;                                                                       \
+        }                                                                               \
+    }                                                                                   \
+}                                                                                       \
+static inline void SSD1306_##Name##RectUnchecked(int16_t x0, int16_t y0,                \
+                                                 int16_t x1, int16_t y1)                \
+{                                                                                       \
+    SSD1306_##Name##PlaneRectUnchecked(g_oled_buffer, g_oled_stride, x0, y0, x1, y1);   \
+}
+
+SSD1306_DEFINE_PIXEL_OPS(Set, SSD1306_OP_SET)
+SSD1306_DEFINE_PIXEL_OPS(Clear, SSD1306_OP_CLEAR)
+SSD1306_DEFINE_PIXEL_OPS(Xor, SSD1306_OP_XOR)
+
+#endif
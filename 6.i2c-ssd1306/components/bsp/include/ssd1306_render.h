@@ -0,0 +1,76 @@
+/*
+* @file         ssd1306_render.h
+* @brief        OLED按帧率刷新的渲染调度任务
+* @details      多个任务提交绘图请求，由渲染任务合并后按目标帧率统一刷新到屏幕
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef SSD1306_RENDER_H
+#define SSD1306_RENDER_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include "ssd1306.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define SSD1306_RENDER_QUEUE_LEN        16               //绘图请求队列深度
+#define SSD1306_RENDER_STR_MAX          24               //单个请求字符串最大长度(含'\0')
+#define SSD1306_RENDER_TASK_STACK       (1024*2)         //渲染任务栈大小
+#define SSD1306_RENDER_TASK_PRIO        (configMAX_PRIORITIES-2)
+#define SSD1306_RENDER_DEFAULT_FPS      20               //默认目标帧率
+
+//绘图请求类型
+typedef enum {
+	SSD1306_REQ_CLEAR = 0,          /*!< 清空显存 */
+	SSD1306_REQ_STR,                /*!< 字符串 */
+	SSD1306_REQ_LINE,               /*!< 直线 x0,y0,x1,y1 */
+	SSD1306_REQ_RECT,               /*!< 矩形 x0,y0,w=x1,h=y1 */
+	SSD1306_REQ_FILLED_RECT,        /*!< 实心矩形 x0,y0,w=x1,h=y1 */
+	SSD1306_REQ_CIRCLE,             /*!< 圆 x0,y0,r=x1 */
+	SSD1306_REQ_CUSTOM              /*!< 在渲染任务中执行回调 */
+} SSD1306_ReqType_t;
+
+//绘图请求
+typedef struct {
+	SSD1306_ReqType_t type;
+	SSD1306_COLOR_t color;
+	int16_t x0;
+	int16_t y0;
+	int16_t x1;
+	int16_t y1;
+	FontDef_t *font;
+	char str[SSD1306_RENDER_STR_MAX];
+	void (*draw)(void *arg);        /*!< SSD1306_REQ_CUSTOM回调，只能画显存不能刷新 */
+	void *arg;
+} SSD1306_DrawReq_t;
+
+//每帧耗时统计(单位us)
+typedef struct {
+	uint32_t frames;                /*!< 已刷新帧数 */
+	uint32_t dropped_frames;        /*!< 因渲染/刷新超时错过的帧截止时间 */
+	uint32_t requests;              /*!< 已处理的绘图请求数 */
+	uint32_t coalesced;             /*!< 被合并到同一帧、省掉的刷新次数 */
+	uint32_t render_us_last;        /*!< 上一帧绘图耗时 */
+	uint32_t render_us_max;
+	uint32_t flush_us_last;         /*!< 上一帧刷新耗时 */
+	uint32_t flush_us_max;
+} SSD1306_RenderStats_t;
+
+
+esp_err_t SSD1306_RenderStart(uint8_t fps);
+void SSD1306_RenderSetFps(uint8_t fps);
+esp_err_t SSD1306_RenderSubmit(const SSD1306_DrawReq_t *req, TickType_t wait);
+esp_err_t SSD1306_RenderClear(void);
+esp_err_t SSD1306_RenderStr(int16_t x, int16_t y, const char *str, FontDef_t *Font, SSD1306_COLOR_t color);
+esp_err_t SSD1306_RenderLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR_t c);
+esp_err_t SSD1306_RenderCustom(void (*draw)(void *arg), void *arg);
+void SSD1306_RenderGetStats(SSD1306_RenderStats_t *stats);
+
+#endif
@@ -0,0 +1,91 @@
+/*
+* @file         ssd1306_transport.h
+* @brief        OLED传输层(I2C/SPI)
+* @details      驱动只通过传输层发送命令和显存数据，绘图接口与传输方式无关；
+*               同时给出两种传输方式的字节数/耗时估算，便于按产品选型
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef SSD1306_TRANSPORT_H
+#define SSD1306_TRANSPORT_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include "esp_err.h"
+/*
+===========================
+宏定义
+===========================
+*/
+//SPI(4线，DC脚区分命令/数据)
+#define SSD1306_SPI_HOST                HSPI_HOST
+#define SSD1306_SPI_DMA_CHAN            1
+#define SSD1306_SPI_MOSI_IO             13
+#define SSD1306_SPI_SCLK_IO             14
+#define SSD1306_SPI_CS_IO               15
+#define SSD1306_SPI_DC_IO               27
+#define SSD1306_SPI_RST_IO              26
+#define SSD1306_SPI_CLOCK_HZ            (8*1000*1000)    //SSD1306 SPI最高10MHz
+#define SSD1306_SPI_QUEUE_LEN           18               //一帧最多8页*(窗口命令+数据)+余量
+
+/*
+ * 传输层
+ * write_cmds/write_data可以只排队不等待完成，数据缓冲区在sync返回前必须保持不变；
+ * 后面几个字段只用于耗时估算
+ */
+typedef struct {
+	const char *name;
+	esp_err_t (*init)(void);
+	esp_err_t (*write_cmds)(const uint8_t *cmds, uint16_t len);
+	esp_err_t (*write_data)(const uint8_t *data, uint16_t len);
+	esp_err_t (*sync)(void);            /*!< 等待已排队的传输完成，可为NULL */
+	uint32_t clock_hz;                  /*!< 总线时钟 */
+	uint8_t bits_per_byte;              /*!< 每字节占用的时钟数，I2C含ACK为9 */
+	uint16_t txn_overhead_bits;         /*!< 每次传输额外的时钟数，I2C为起始+地址+控制字节+停止 */
+	uint16_t txn_overhead_us;           /*!< 每次传输的驱动软件开销(估计值) */
+} SSD1306_Transport_t;
+
+extern SSD1306_Transport_t SSD1306_TransportI2C;       //clock_hz在init中按自动调速结果更新
+extern const SSD1306_Transport_t SSD1306_TransportSPI;
+
+/**
+ * 估算一次传输的耗时，只做整数运算，不依赖硬件，可在PC上编译使用
+ * @param[in]   t       传输层
+ * @param[in]   bytes   负载字节数
+ * @param[in]   txns    传输次数
+ * @retval      估算耗时(us)
+ */
+static inline uint32_t SSD1306_TransportCostUs(const SSD1306_Transport_t *t, uint32_t bytes, uint32_t txns)
+{
+	uint64_t bits = (uint64_t)bytes * t->bits_per_byte + (uint64_t)txns * t->txn_overhead_bits;
+	return (uint32_t)(bits * 1000000ULL / t->clock_hz) + txns * t->txn_overhead_us;
+}
+
+/**
+ * 估算一次刷新的耗时:每个脏页一次6字节窗口命令+一次数据传输
+ * @param[in]   t            传输层
+ * @param[in]   pages        脏页数
+ * @param[in]   data_bytes   显存数据字节数(整屏为1024)
+ * @retval      估算耗时(us)
+ */
+static inline uint32_t SSD1306_FlushCostUs(const SSD1306_Transport_t *t, uint32_t pages, uint32_t data_bytes)
+{
+	return SSD1306_TransportCostUs(t, pages * 6 + data_bytes, pages * 2);
+}
+
+/**
+ * 估算一次整屏刷新(SSD1306_FlushFrame)的耗时:一次6字节窗口命令+一次1024字节数据
+ * @param[in]   t            传输层
+ * @retval      估算耗时(us)
+ */
+static inline uint32_t SSD1306_FrameCostUs(const SSD1306_Transport_t *t)
+{
+	return SSD1306_TransportCostUs(t, 6 + 128 * 8, 2);
+}
+
+#endif
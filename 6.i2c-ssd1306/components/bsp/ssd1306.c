@@ -12,6 +12,8 @@
 =============
 */
 #include "ssd1306.h"
+#include "ssd1306_pixel.h"
+#include "ssd1306_transport.h"
 #include "string.h"
 #include "stdlib.h"
 #include "fonts.h"
@@ -20,12 +22,26 @@
 全局变量定义
 =========================== 
 */
-//OLED缓存128*64bit
-static uint8_t g_oled_buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
+//OLED缓存128*64bit，ssd1306_pixel.h的内联函数直接访问
+uint8_t g_oled_buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
+//显存每页字节数，等于逻辑画布宽度
+uint16_t g_oled_stride = SSD1306_WIDTH;
+//90/270度旋转时转置后的发送缓存
+static uint8_t g_oled_txbuf[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
 //OLED实时信息
 static SSD1306_t oled;
+//传输层，默认I2C
+static const SSD1306_Transport_t *g_transport = &SSD1306_TransportI2C;
 //OLED是否正在显示，1显示，0等待
 static bool is_show_str =0;
+//绘图后是否立即刷新，渲染调度任务运行时关闭
+static bool is_auto_update = 1;
+//每页脏列范围[x0,x1]，x0>x1表示该页未修改
+static uint8_t g_dirty_x0[SSD1306_MAX_PAGES];
+static uint8_t g_dirty_x1[SSD1306_MAX_PAGES];
+//视口栈，[0]为整个逻辑画布，栈顶为当前裁剪区和原点
+static SSD1306_Viewport_t g_viewport[SSD1306_VIEWPORT_DEPTH];
+static uint8_t g_viewport_top = 0;
 
 /* Absolute value */
 #define ABS(x)   ((x) > 0 ? (x) : -(x))
@@ -37,133 +53,120 @@ static bool is_show_str =0;
 */
 
 /** 
- * oled_i2c 初始化
- * @param[in]   无
+ * 向oled写命令
+ * @param[in]   command
  * @retval      
- *              无                              
+ *              - ESP_OK                              
  * @par         修改日志 
  *               Ver0.0.1:
                      Caesar, 2019/10/18, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 通过传输层发送\n 
  */
-static void i2c_init(void)
+static int oled_write_cmd(uint8_t command)
 {
-    //注释参考sht30之i2c教程
-    i2c_config_t conf;
-    conf.mode = I2C_MODE_MASTER;
-    conf.sda_io_num = I2C_OLED_MASTER_SDA_IO;
-    conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.scl_io_num = I2C_OLED_MASTER_SCL_IO;
-    conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.master.clk_speed = 400000;
-    i2c_param_config(I2C_OLED_MASTER_NUM, &conf);
-    i2c_driver_install(I2C_OLED_MASTER_NUM, conf.mode,0, 0, 0);
+    return g_transport->write_cmds(&command, 1);
 }
 
 /** 
- * 向oled写命令
- * @param[in]   command
+ * 标记显存脏区
+ * @param[in]   x      列坐标
+ * @param[in]   page   页号(y/8)
  * @retval      
- *              - ESP_OK                              
+ *              无                              
  * @par         修改日志 
  *               Ver0.0.1:
-                     Caesar, 2019/10/18, 初始化版本\n 
+                     Caesar, 2026/10/19, 初始化版本\n 
  */
-
-static int oled_write_cmd(uint8_t command)
+static inline void oled_mark_dirty(uint16_t x, uint8_t page)
 {
-    //注释参考sht30之i2c教程
-    int ret;
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    ret = i2c_master_start(cmd);
-    ret = i2c_master_write_byte(cmd, OLED_WRITE_ADDR |WRITE_BIT , ACK_CHECK_EN); 
-    ret = i2c_master_write_byte(cmd, WRITE_CMD, ACK_CHECK_EN);
-    ret = i2c_master_write_byte(cmd,command, ACK_CHECK_EN);
-    ret = i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(I2C_OLED_MASTER_NUM, cmd, 100 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
-    if (ret != ESP_OK) 
+    if (x < g_dirty_x0[page])
     {
-        return ret;
+        g_dirty_x0[page] = x;
+    }
+    if (x > g_dirty_x1[page])
+    {
+        g_dirty_x1[page] = x;
     }
-    return ret;
 }
 
 /** 
- * 向oled写数据
- * @param[in]   data
+ * 绘图结束后按需刷新(自动刷新开启且不在画字符串过程中)
+ * @param[in]   无
  * @retval      
- *              - ESP_OK                              
+ *              无                              
  * @par         修改日志 
  *               Ver0.0.1:
-                     Caesar, 2019/10/18, 初始化版本\n  
+                     Caesar, 2026/10/19, 初始化版本\n 
  */
-static int oled_write_data(uint8_t data)
+static void oled_auto_update(void)
 {
-    //注释参考sht30之i2c教程
-    int ret;
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    ret = i2c_master_start(cmd);
-    ret = i2c_master_write_byte(cmd, OLED_WRITE_ADDR | WRITE_BIT, ACK_CHECK_EN);
-    ret = i2c_master_write_byte(cmd, WRITE_DATA, ACK_CHECK_EN);
-    ret = i2c_master_write_byte(cmd, data, ACK_CHECK_EN);
-    ret = i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(I2C_OLED_MASTER_NUM, cmd, 100 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
-    if (ret != ESP_OK) 
+    if(0 == is_show_str && is_auto_update)
     {
-        return ret;
+        SSD1306_UpdateScreen();
     }
-    return ret;
 }
+
 /** 
- * 向oled写长数据
- * @param[in]   data   要写入的数据
- * @param[in]   len     数据长度
+ * 初始化 oled(I2C)
+ * @param[in]   NULL
  * @retval      
- *              - ESP_OK                              
+ *              - ESP_OK
+ *              - 其它  总线初始化或oled无应答
  * @par         修改日志 
  *               Ver0.0.1:
-                     Caesar, 2019/10/18, 初始化版本\n  
+                     Caesar, 2019/10/18, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 返回初始化结果\n 
  */
-static int oled_write_long_data(uint8_t *data,uint16_t len)
+esp_err_t SSD1306_Init(void)
 {
-    //注释参考sht30之i2c教程
-    int ret;
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    ret = i2c_master_start(cmd);
-    ret = i2c_master_write_byte(cmd, OLED_WRITE_ADDR | WRITE_BIT, ACK_CHECK_EN);
-    ret = i2c_master_write_byte(cmd, WRITE_DATA, ACK_CHECK_EN);
-    ret = i2c_master_write(cmd, data, len,ACK_CHECK_EN);
-    ret = i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(I2C_OLED_MASTER_NUM, cmd, 10000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
-    if (ret != ESP_OK) 
-    {
-        return ret;
-    }
-    return ret;    
+    return SSD1306_InitWithTransport(&SSD1306_TransportI2C);
 }
 
 /** 
- * 初始化 oled
- * @param[in]   NULL
+ * 用指定传输层初始化 oled，绘图接口与传输方式无关
+ * 总线初始化失败或第一条命令无应答时不再发送初始化序列
+ * @param[in]   transport   &SSD1306_TransportI2C 或 &SSD1306_TransportSPI
  * @retval      
- *              NULL                            
+ *              - ESP_OK
+ *              - 其它  transport->init或第一条命令的错误
  * @par         修改日志 
  *               Ver0.0.1:
-                     Caesar, 2019/10/18, 初始化版本\n 
+                     Caesar, 2026/10/19, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 返回总线初始化错误\n 
  */
-void SSD1306_Init(void)
+esp_err_t SSD1306_InitWithTransport(const SSD1306_Transport_t *transport)
 {
-    //i2c初始化
-    i2c_init();
+    esp_err_t ret;
+
+    //总线初始化
+    g_transport = transport;
+    ret = g_transport->init();
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE("OLED", "%s init failed: %d", transport->name, ret);
+        return ret;
+    }
+    oled.Width = SSD1306_WIDTH;
+    oled.Height = SSD1306_HEIGHT;
+    oled.Rotation = SSD1306_ROTATION_0;
+    oled.Inverted = 0;
+    g_oled_stride = oled.Width;
+    SSD1306_ResetViewport();
     //oled配置
-    oled_write_cmd(TURN_OFF_CMD);
+    ret = oled_write_cmd(TURN_OFF_CMD);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE("OLED", "no response on %s: %d", transport->name, ret);
+        return ret;
+    }
     oled_write_cmd(0xAE);//关显示
-    oled_write_cmd(0X20);//低列地址
-    oled_write_cmd(0X10);//高列地址
+    oled_write_cmd(0X20);//设置寻址模式
+    oled_write_cmd(0X00);//水平寻址，刷新时用0x21/0x22设置窗口
     oled_write_cmd(0XB0);//
-    oled_write_cmd(0XC8);
+    oled_write_cmd(SET7_SCAN_DIR);//COM扫描方向，旋转时由SSD1306_SetRotation修改
     oled_write_cmd(0X00);
     oled_write_cmd(0X10);
      //设置行显示的开始地址(0-63)  
@@ -173,7 +176,7 @@ void SSD1306_Init(void)
     oled_write_cmd(0X81);
     oled_write_cmd(0XFF);//这个值越大，屏幕越亮(和上条指令一起使用)(0x00-0xff) 
 
-    oled_write_cmd(0XA1);//0xA1: 左右反置，  0xA0: 正常显示（默认0xA0）
+    oled_write_cmd(SET6_SEG_MAPPING);//0xA1: 左右反置，  0xA0: 正常显示（默认0xA0）
    //0xA6: 表示正常显示（在面板上1表示点亮，0表示不亮）  
     //0xA7: 表示逆显示（在面板上0表示点亮，1表示不亮）
     oled_write_cmd(0XA6); 
@@ -204,27 +207,342 @@ void SSD1306_Init(void)
     oled_write_cmd(0XAF);
     //清屏
     SSD1306_Clear();
+    return ESP_OK;
 }
 
 /** 
- * 将显存内容刷新到oled显示区
+ * 8x8位矩阵转置: out[b]的第k位 = in[k]的第b位
+ * @param[in]   in      输入8字节(每字节为一列的8个纵向像素)
+ * @param[out]  out     输出8字节
+ * @retval      
+ *              无                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static void oled_transpose8x8(const uint8_t *in, uint8_t *out)
+{
+    //Hacker's Delight transpose8，按字节逆序装载/存储得到低位在前的转置
+    uint32_t x, y, t;
+    x = ((uint32_t)in[7] << 24) | ((uint32_t)in[6] << 16) | ((uint32_t)in[5] << 8) | in[4];
+    y = ((uint32_t)in[3] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[1] << 8) | in[0];
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    out[7] = x >> 24; out[6] = x >> 16; out[5] = x >> 8; out[4] = x;
+    out[3] = y >> 24; out[2] = y >> 16; out[1] = y >> 8; out[0] = y;
+}
+
+/** 
+ * 90/270度时把逻辑显存的脏块转置到发送缓存，并换算出物理脏区
+ * 逻辑(lx,ly)对应物理(px=ly,py=lx)，左右/上下方向由硬件重映射决定
+ * @param[out]  x0   物理各页脏区起始列
+ * @param[out]  x1   物理各页脏区结束列
+ * @retval      
+ *              无                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static void oled_transpose_dirty(uint8_t *x0, uint8_t *x1)
+{
+    uint8_t lpage, ppage, pcol;
+    for(lpage = 0; lpage < oled.Height / 8; lpage ++)
+    {
+        if(g_dirty_x0[lpage] > g_dirty_x1[lpage])
+        {
+            continue;
+        }
+        //逻辑页lpage的第8*ppage~8*ppage+7列 -> 物理页ppage的第8*lpage~8*lpage+7列
+        pcol = lpage * 8;
+        for(ppage = g_dirty_x0[lpage] / 8; ppage <= g_dirty_x1[lpage] / 8; ppage ++)
+        {
+            oled_transpose8x8(&g_oled_buffer[lpage * oled.Width + ppage * 8],
+                              &g_oled_txbuf[ppage * SSD1306_WIDTH + pcol]);
+            if(pcol < x0[ppage])
+            {
+                x0[ppage] = pcol;
+            }
+            if(pcol + 7 > x1[ppage])
+            {
+                x1[ppage] = pcol + 7;
+            }
+        }
+    }
+}
+
+/** 
+ * 整屏刷新:一次窗口命令+一次1024字节数据传输，不看脏区
+ * 只支持横屏(0/180度)，frame按SSD1306_WIDTH字节一页排列
+ * @param[in]   frame   整屏数据，可以不是g_oled_buffer(如灰度的另一个位平面)
+ * @retval      
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_STATE  竖屏
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+esp_err_t SSD1306_FlushFrame(const uint8_t *frame)
+{
+    static const uint8_t win[6] = {0x21, 0, SSD1306_WIDTH - 1, 0x22, 0, SSD1306_PAGES - 1};
+    esp_err_t ret;
+
+    if (oled.Rotation == SSD1306_ROTATION_90 || oled.Rotation == SSD1306_ROTATION_270)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ret = g_transport->write_cmds(win, sizeof(win));
+    if (ret == ESP_OK)
+    {
+        //水平寻址模式下窗口内列地址到头自动换页，整屏一次发完
+        ret = g_transport->write_data(frame, SSD1306_WIDTH * SSD1306_PAGES);
+    }
+    if (g_transport->sync)
+    {
+        g_transport->sync();
+    }
+    return ret;
+}
+
+/** 
+ * 将显存内容刷新到oled显示区(只发送上次刷新后修改过的列)
  * @param[in]   NULL
  * @retval      
  *              NULL                           
  * @par         修改日志 
  *               Ver0.0.1:
                      Caesar, 2019/10/18, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 横屏整屏都脏时走SSD1306_FlushFrame，2次传输代替16次\n 
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 传输失败时保留脏区，下次刷新重发\n
  */
 void SSD1306_UpdateScreen(void)
 {
-    uint8_t line_index;
-    for(line_index = 0; line_index < 8; line_index ++)
+    uint8_t page;
+    uint8_t win[6];
+    uint8_t x0[SSD1306_PAGES];
+    uint8_t x1[SSD1306_PAGES];
+    uint8_t *src = g_oled_buffer;
+    esp_err_t ret = ESP_OK;
+
+    //清屏/填充后每页都是整行脏，合并成一次整屏传输
+    for (page = 0; page < SSD1306_PAGES; page ++)
+    {
+        if (g_dirty_x0[page] != 0 || g_dirty_x1[page] != SSD1306_WIDTH - 1)
+        {
+            break;
+        }
+    }
+    if (page == SSD1306_PAGES && SSD1306_FlushFrame(g_oled_buffer) == ESP_OK)
+    {
+        memset(g_dirty_x0, SSD1306_WIDTH, sizeof(g_dirty_x0));
+        memset(g_dirty_x1, 0, sizeof(g_dirty_x1));
+        return;
+    }
+
+    if(oled.Rotation == SSD1306_ROTATION_90 || oled.Rotation == SSD1306_ROTATION_270)
+    {
+        memset(x0, SSD1306_WIDTH, sizeof(x0));
+        memset(x1, 0, sizeof(x1));
+        oled_transpose_dirty(x0, x1);
+        src = g_oled_txbuf;
+    }
+    else
+    {
+        memcpy(x0, g_dirty_x0, sizeof(x0));
+        memcpy(x1, g_dirty_x1, sizeof(x1));
+    }
+
+    for(page = 0; page < SSD1306_PAGES; page ++)
+    {
+        //本页未修改，跳过
+        if(x0[page] > x1[page])
+        {
+            continue;
+        }
+        //列地址、页地址窗口，只发送脏列
+        win[0] = 0x21;
+        win[1] = x0[page];
+        win[2] = x1[page];
+        win[3] = 0x22;
+        win[4] = page;
+        win[5] = page;
+        if(g_transport->write_cmds(win, sizeof(win)) != ESP_OK ||
+           g_transport->write_data(&src[SSD1306_WIDTH * page + x0[page]], x1[page] - x0[page] + 1) != ESP_OK)
+        {
+            ret = ESP_FAIL;
+        }
+    }
+    //SPI等排队传输要等发完，之后才能改显存
+    if(g_transport->sync)
+    {
+        g_transport->sync();
+    }
+    //传输失败时保留脏区，下次刷新整段重发
+    if(ret != ESP_OK)
     {
-        oled_write_cmd(0xb0+line_index);
-        oled_write_cmd(0x00);
-        oled_write_cmd(0x10);
-        
-        oled_write_long_data(&g_oled_buffer[SSD1306_WIDTH * line_index],SSD1306_WIDTH);
+        return;
+    }
+    memset(g_dirty_x0, SSD1306_WIDTH, sizeof(g_dirty_x0));
+    memset(g_dirty_x1, 0, sizeof(g_dirty_x1));
+}
+
+/** 
+ * 设置显示方向
+ * 0/180度只切换段重映射(0xA0/0xA1)和COM扫描方向(0xC0/0xC8)，显存内容保留；
+ * 90/270度逻辑画布变为64x128，刷新时按8x8块转置，切换横竖屏会清空显存
+ * @param[in]   rotation   显示方向
+ * @retval      
+ *              NULL                           
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+void SSD1306_SetRotation(SSD1306_ROTATION_t rotation)
+{
+    bool portrait = (rotation == SSD1306_ROTATION_90 || rotation == SSD1306_ROTATION_270);
+    bool was_portrait = (oled.Rotation == SSD1306_ROTATION_90 || oled.Rotation == SSD1306_ROTATION_270);
+
+    switch(rotation)
+    {
+        case SSD1306_ROTATION_180:
+            oled_write_cmd(0xA0);
+            oled_write_cmd(0xC0);
+            break;
+        case SSD1306_ROTATION_90:
+            oled_write_cmd(0xA0);
+            oled_write_cmd(0xC8);
+            break;
+        case SSD1306_ROTATION_270:
+            oled_write_cmd(0xA1);
+            oled_write_cmd(0xC0);
+            break;
+        case SSD1306_ROTATION_0:
+        default:
+            rotation = SSD1306_ROTATION_0;
+            oled_write_cmd(SET6_SEG_MAPPING);
+            oled_write_cmd(SET7_SCAN_DIR);
+            break;
+    }
+    oled.Rotation = rotation;
+    oled.Width = portrait ? SSD1306_HEIGHT : SSD1306_WIDTH;
+    oled.Height = portrait ? SSD1306_WIDTH : SSD1306_HEIGHT;
+    g_oled_stride = oled.Width;
+    SSD1306_ResetViewport();
+
+    if(portrait != was_portrait)
+    {
+        SSD1306_Fill(SSD1306_COLOR_BLACK);
+    }
+    else
+    {
+        //硬件重映射只影响之后写入的数据，整屏重发一次
+        memset(g_dirty_x0, 0, sizeof(g_dirty_x0));
+        memset(g_dirty_x1, oled.Width - 1, sizeof(g_dirty_x1));
+    }
+    oled_auto_update();
+}
+
+/** 
+ * 硬件反色显示(0xA7/0xA6)，不改写显存
+ * @param[in]   invert   1:反色 0:正常
+ * @retval      
+ *              NULL                           
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+void SSD1306_InvertDisplay(bool invert)
+{
+    oled_write_cmd(invert ? 0xA7 : SET8_NORMAL_DIS);
+    oled.Inverted = invert;
+}
+
+/** 
+ * 获取逻辑画布宽度(随旋转变化)
+ * @retval      宽度(像素)
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+uint16_t SSD1306_GetWidth(void)
+{
+    return oled.Width;
+}
+
+/** 
+ * 获取当前使用的传输层，用于估算刷新耗时
+ * @retval      传输层
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+const SSD1306_Transport_t *SSD1306_GetTransport(void)
+{
+    return g_transport;
+}
+
+/** 
+ * 获取逻辑画布高度(随旋转变化)
+ * @retval      高度(像素)
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+uint16_t SSD1306_GetHeight(void)
+{
+    return oled.Height;
+}
+
+/** 
+ * 设置绘图后是否立即刷新
+ * @param[in]   enable  1:每次绘图后刷新 0:由调用者(渲染任务)刷新
+ * @retval      
+ *              NULL                           
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+void SSD1306_SetAutoUpdate(bool enable)
+{
+    is_auto_update = enable;
+}
+
+/** 
+ * 用颜色填充显存，不刷新
+ * @param[in]   color   色值0/1
+ * @retval      
+ *              NULL                           
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+void SSD1306_Fill(SSD1306_COLOR_t color)
+{
+    uint8_t page;
+    uint16_t i;
+    if (color == SSD1306_COLOR_XOR)
+    {
+        for (i = 0; i < sizeof(g_oled_buffer); i ++)
+        {
+            g_oled_buffer[i] ^= 0xff;
+        }
+    }
+    else
+    {
+        memset(g_oled_buffer, (color == SSD1306_COLOR_BLACK) ? 0x00 : 0xff, sizeof(g_oled_buffer));
+    }
+    for(page = 0; page < oled.Height / 8; page ++)
+    {
+        g_dirty_x0[page] = 0;
+        g_dirty_x1[page] = oled.Width - 1;
     }
 }
 
@@ -240,8 +558,8 @@ void SSD1306_UpdateScreen(void)
 void SSD1306_Clear(void)
 {
     //清0缓存
-    memset(g_oled_buffer,SSD1306_COLOR_BLACK,sizeof(g_oled_buffer));
-    SSD1306_UpdateScreen();
+    SSD1306_Fill(SSD1306_COLOR_BLACK);
+    oled_auto_update();
 }
 /** 
  * 填屏
@@ -255,8 +573,8 @@ void SSD1306_Clear(void)
 void SSD1306_All_On(void)
 {
     //置ff缓存
-    memset(g_oled_buffer,0xff,sizeof(g_oled_buffer));
-    SSD1306_UpdateScreen();
+    SSD1306_Fill(SSD1306_COLOR_WHITE);
+    oled_auto_update();
 }
 /** 
  * 移动坐标
@@ -273,33 +591,371 @@ void SSD1306_GotoXY(uint16_t x, uint16_t y)
 	oled.CurrentX = x;
 	oled.CurrentY = y;
 }
+/** 
+ * 重置视口栈为整个逻辑画布
+ * @param[in]   NULL
+ * @retval      
+ *              NULL                            
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+void SSD1306_ResetViewport(void)
+{
+    g_viewport_top = 0;
+    g_viewport[0].x0 = 0;
+    g_viewport[0].y0 = 0;
+    g_viewport[0].x1 = oled.Width - 1;
+    g_viewport[0].y1 = oled.Height - 1;
+    g_viewport[0].ox = 0;
+    g_viewport[0].oy = 0;
+}
+
+/** 
+ * 压入裁剪区，可选择同时把原点移到裁剪区左上角
+ * @param[in]   x       左上角x(当前局部坐标)
+ * @param[in]   y       左上角y(当前局部坐标)
+ * @param[in]   w       宽
+ * @param[in]   h       高
+ * @param[in]   origin  1:原点移到(x,y) 0:原点不变
+ * @retval      
+ *              - ESP_OK
+ *              - ESP_ERR_NO_MEM   栈满
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static esp_err_t oled_push_clip(int16_t x, int16_t y, uint16_t w, uint16_t h, bool origin)
+{
+    SSD1306_Viewport_t *cur = &g_viewport[g_viewport_top];
+    SSD1306_Viewport_t *next;
+    int16_t ax = cur->ox + x;
+    int16_t ay = cur->oy + y;
+
+    if(g_viewport_top + 1 >= SSD1306_VIEWPORT_DEPTH)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    next = &g_viewport[g_viewport_top + 1];
+    //与当前裁剪区求交，可能为空(x0>x1)
+    next->x0 = (ax > cur->x0) ? ax : cur->x0;
+    next->y0 = (ay > cur->y0) ? ay : cur->y0;
+    next->x1 = (ax + (int16_t)w - 1 < cur->x1) ? ax + (int16_t)w - 1 : cur->x1;
+    next->y1 = (ay + (int16_t)h - 1 < cur->y1) ? ay + (int16_t)h - 1 : cur->y1;
+    next->ox = origin ? ax : cur->ox;
+    next->oy = origin ? ay : cur->oy;
+    g_viewport_top ++;
+    return ESP_OK;
+}
+
+/** 
+ * 压入视口:原点移到(x,y)，并裁剪到w*h，之后控件可用局部坐标绘图
+ * @param[in]   x   左上角x(当前局部坐标)
+ * @param[in]   y   左上角y(当前局部坐标)
+ * @param[in]   w   宽
+ * @param[in]   h   高
+ * @retval      
+ *              - ESP_OK
+ *              - ESP_ERR_NO_MEM   栈满
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+esp_err_t SSD1306_PushViewport(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+    return oled_push_clip(x, y, w, h, 1);
+}
+
+/** 
+ * 压入裁剪区，原点不变
+ * @param[in]   x   左上角x(当前局部坐标)
+ * @param[in]   y   左上角y(当前局部坐标)
+ * @param[in]   w   宽
+ * @param[in]   h   高
+ * @retval      
+ *              - ESP_OK
+ *              - ESP_ERR_NO_MEM   栈满
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+esp_err_t SSD1306_PushClip(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+    return oled_push_clip(x, y, w, h, 0);
+}
+
+/** 
+ * 弹出视口/裁剪区
+ * @param[in]   NULL
+ * @retval      
+ *              NULL                            
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+void SSD1306_PopViewport(void)
+{
+    if(g_viewport_top > 0)
+    {
+        g_viewport_top --;
+    }
+}
+
+/** 
+ * 点是否在当前裁剪区内(绝对坐标)
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static inline bool oled_in_clip(int16_t x, int16_t y)
+{
+    SSD1306_Viewport_t *clip = &g_viewport[g_viewport_top];
+    return x >= clip->x0 && x <= clip->x1 && y >= clip->y0 && y <= clip->y1;
+}
+
+/** 
+ * 矩形与当前裁剪区求交(绝对坐标，闭区间)，同时规范化左上/右下
+ * @param[in,out]   x0,y0,x1,y1   矩形
+ * @retval      
+ *              - 1 交集非空
+ *              - 0 完全在裁剪区外
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static bool oled_clip_rect(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1)
+{
+    SSD1306_Viewport_t *clip = &g_viewport[g_viewport_top];
+    int16_t tmp;
+    if (*x1 < *x0)
+    {
+        tmp = *x0; *x0 = *x1; *x1 = tmp;
+    }
+    if (*y1 < *y0)
+    {
+        tmp = *y0; *y0 = *y1; *y1 = tmp;
+    }
+    if (*x0 < clip->x0) *x0 = clip->x0;
+    if (*y0 < clip->y0) *y0 = clip->y0;
+    if (*x1 > clip->x1) *x1 = clip->x1;
+    if (*y1 > clip->y1) *y1 = clip->y1;
+    return (*x0 <= *x1) && (*y0 <= *y1);
+}
+
+/** 
+ * 视口坐标的矩形转换为逻辑画布绝对坐标并与裁剪区求交，给ssd1306_pixel.h的调用者用
+ * @param[in,out]   x0,y0,x1,y1   矩形对角(闭区间)，输入为视口坐标，输出为绝对坐标
+ * @retval      
+ *              - 1 交集非空
+ *              - 0 完全在裁剪区外
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+bool SSD1306_ClipRect(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1)
+{
+    *x0 += g_viewport[g_viewport_top].ox;
+    *x1 += g_viewport[g_viewport_top].ox;
+    *y0 += g_viewport[g_viewport_top].oy;
+    *y1 += g_viewport[g_viewport_top].oy;
+    return oled_clip_rect(x0, y0, x1, y1);
+}
+
+/** 
+ * 标记矩形脏区(绝对坐标，已裁剪)，使用ssd1306_pixel.h直接写显存后须调用
+ * @param[in]   x0,y0,x1,y1   矩形对角(闭区间)
+ * @retval      
+ *              无                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+void SSD1306_MarkDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    uint8_t page;
+    for (page = y0 >> 3; page <= (y1 >> 3); page ++)
+    {
+        oled_mark_dirty(x0, page);
+        oled_mark_dirty(x1, page);
+    }
+}
+
+/** 
+ * 填充矩形(绝对坐标)，裁剪一次后按页掩码整字节写入，横线/竖线也走这里
+ * @param[in]   x0,y0,x1,y1   矩形对角(闭区间)
+ * @param[in]   color   色值0/1
+ * @retval      
+ *              无                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static void oled_fill_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR_t color)
+{
+    if (!oled_clip_rect(&x0, &y0, &x1, &y1))
+    {
+        return;
+    }
+    SSD1306_MarkDirty(x0, y0, x1, y1);
+    if (color == SSD1306_COLOR_WHITE)
+    {
+        SSD1306_SetRectUnchecked(x0, y0, x1, y1);
+    }
+    else if (color == SSD1306_COLOR_XOR)
+    {
+        SSD1306_XorRectUnchecked(x0, y0, x1, y1);
+    }
+    else
+    {
+        SSD1306_ClearRectUnchecked(x0, y0, x1, y1);
+    }
+}
+
+/*
+ * 按颜色展开的画线/画圆光栅化(绝对坐标)，像素写入为ssd1306_pixel.h的内联操作；
+ * inside为1时包围盒整体在裁剪区内，逐点不再检查
+ */
+#define OLED_PLOT(Name, x, y, inside)                                   \
+    do {                                                                \
+        if ((inside) || oled_in_clip((x), (y)))                         \
+        {                                                               \
+            SSD1306_##Name##PixelUnchecked((x), (y));                   \
+        }                                                               \
+    } while (0)
+
+#define OLED_DEFINE_RASTER(Name)                                                    \
+static void oled_line_##Name(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool inside) \
+{                                                                                   \
+	int16_t dx, dy, sx, sy, err, e2;                                                \
+	dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);                                         \
+	dy = (y0 < y1) ? (y1 - y0) : (y0 - y1);                                         \
+	sx = (x0 < x1) ? 1 : -1;                                                        \
+	sy = (y0 < y1) ? 1 : -1;                                                        \
+	err = ((dx > dy) ? dx : -dy) / 2;                                               \
+	while (1) {                                                                     \
+		OLED_PLOT(Name, x0, y0, inside);                                            \
+		if (x0 == x1 && y0 == y1) {                                                 \
+			break;                                                                  \
+		}                                                                           \
+		e2 = err;                                                                   \
+		if (e2 > -dx) {                                                             \
+			err -= dy;                                                              \
+			x0 += sx;                                                               \
+		}                                                                           \
+		if (e2 < dy) {                                                              \
+			err += dx;                                                              \
+			y0 += sy;                                                               \
+		}                                                                           \
+	}                                                                               \
+}                                                                                   \
+static void oled_circle_##Name(int16_t x0, int16_t y0, int16_t r, bool inside)     \
+{                                                                                   \
+	int16_t f = 1 - r;                                                              \
+	int16_t ddF_x = 1;                                                              \
+	int16_t ddF_y = -2 * r;                                                         \
+	int16_t x = 0;                                                                  \
+	int16_t y = r;                                                                  \
+	OLED_PLOT(Name, x0, y0 + r, inside);                                            \
+	OLED_PLOT(Name, x0, y0 - r, inside);                                            \
+	OLED_PLOT(Name, x0 + r, y0, inside);                                            \
+	OLED_PLOT(Name, x0 - r, y0, inside);                                            \
+	while (x < y) {                                                                 \
+		if (f >= 0) {                                                               \
+			y--;                                                                    \
+			ddF_y += 2;                                                             \
+			f += ddF_y;                                                             \
+		}                                                                           \
+		x++;                                                                        \
+		ddF_x += 2;                                                                 \
+		f += ddF_x;                                                                 \
+		OLED_PLOT(Name, x0 + x, y0 + y, inside);                                    \
+		OLED_PLOT(Name, x0 - x, y0 + y, inside);                                    \
+		OLED_PLOT(Name, x0 + x, y0 - y, inside);                                    \
+		OLED_PLOT(Name, x0 - x, y0 - y, inside);                                    \
+		if (x == y) {                                                               \
+			break;  /* 对角线上的点已画过，XOR时不能再翻转一次 */                 \
+		}                                                                           \
+		OLED_PLOT(Name, x0 + y, y0 + x, inside);                                    \
+		OLED_PLOT(Name, x0 - y, y0 + x, inside);                                    \
+		OLED_PLOT(Name, x0 + y, y0 - x, inside);                                    \
+		OLED_PLOT(Name, x0 - y, y0 - x, inside);                                    \
+	}                                                                               \
+}
+
+OLED_DEFINE_RASTER(Set)
+OLED_DEFINE_RASTER(Clear)
+OLED_DEFINE_RASTER(Xor)
+
+/** 
+ * 画线(绝对坐标)，包围盒裁剪一次后按颜色调用展开的光栅化
+ * @param[in]   x0,y0,x1,y1   端点
+ * @param[in]   c   色值0/1
+ * @retval      
+ *              无                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static void oled_draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR_t c)
+{
+	int16_t bx0 = x0, by0 = y0, bx1 = x1, by1 = y1;
+	bool inside;
+
+	/* 横线、竖线按span填充 */
+	if (x0 == x1 || y0 == y1) {
+		oled_fill_rect(x0, y0, x1, y1, c);
+		return;
+	}
+
+	/* 包围盒裁剪:完全在外直接返回 */
+	if (!oled_clip_rect(&bx0, &by0, &bx1, &by1)) {
+		return;
+	}
+	SSD1306_MarkDirty(bx0, by0, bx1, by1);
+	inside = oled_in_clip(x0, y0) && oled_in_clip(x1, y1);
+
+	if (c == SSD1306_COLOR_WHITE) {
+		oled_line_Set(x0, y0, x1, y1, inside);
+	} else if (c == SSD1306_COLOR_XOR) {
+		oled_line_Xor(x0, y0, x1, y1, inside);
+	} else {
+		oled_line_Clear(x0, y0, x1, y1, inside);
+	}
+}
+
 /** 
  * 向显存写入
- * @param[in]   x   坐标
- * @param[in]   y   坐标
+ * @param[in]   x   坐标(当前视口局部坐标)
+ * @param[in]   y   坐标(当前视口局部坐标)
  * @param[in]   color   色值0/1
  * @retval      
  *              - ESP_OK                              
  * @par         修改日志 
  *               Ver0.0.1:
                      Caesar, 2019/10/18, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 按视口原点偏移并裁剪\n 
  */
 void SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color) 
 {
-	if (
-		x >= SSD1306_WIDTH ||
-		y >= SSD1306_HEIGHT
-	) 
+	int16_t ax = (int16_t)x + g_viewport[g_viewport_top].ox;
+	int16_t ay = (int16_t)y + g_viewport[g_viewport_top].oy;
+	if (!oled_in_clip(ax, ay)) 
     {
 		return;
 	}
+	oled_mark_dirty(ax, ay >> 3);
 	if (color == SSD1306_COLOR_WHITE) 
 	{
-		g_oled_buffer[x + (y / 8) * SSD1306_WIDTH] |= 1 << (y % 8);
+		SSD1306_SetPixelUnchecked(ax, ay);
+	} 
+	else if (color == SSD1306_COLOR_XOR) 
+	{
+		SSD1306_XorPixelUnchecked(ax, ay);
 	} 
     else
     {
-		g_oled_buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
+		SSD1306_ClearPixelUnchecked(ax, ay);
 	}
 }
 /** 
@@ -314,39 +970,59 @@ void SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color)
  * @par         修改日志 
  *               Ver0.0.1:
                      XinC_Guo, 2018/07/18, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 字符框裁剪一次后逐点不再检查\n 
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 越过右/下边缘的字符由裁剪区截断，起点在画布外才返回0\n 
  */
 char SSD1306_DrawChar(uint16_t x,uint16_t y,char ch, FontDef_t* Font, SSD1306_COLOR_t color) 
 {
-	uint32_t i, b, j;
-	if ( SSD1306_WIDTH <= (oled.CurrentX + Font->FontWidth) || SSD1306_HEIGHT <= (oled.CurrentY + Font->FontHeight) ) 
-    {
-		return 0;
-	}
+	int16_t i, j, ax, ay, x0, y0, x1, y1;
+	uint32_t b;
 	if(0 == is_show_str)
     {
         SSD1306_GotoXY(x,y);
     }
-
-	for (i = 0; i < Font->FontHeight; i++) 
+	ax = (int16_t)oled.CurrentX + g_viewport[g_viewport_top].ox;
+	ay = (int16_t)oled.CurrentY + g_viewport[g_viewport_top].oy;
+	if (ax >= oled.Width || ay >= oled.Height) 
     {
-		b = Font->data[(ch - 32) * Font->FontHeight + i];
-		for (j = 0; j < Font->FontWidth; j++)
-        {
-			if ((b << j) & 0x8000) 
-            {
-				SSD1306_DrawPixel(oled.CurrentX + j, (oled.CurrentY + i), (SSD1306_COLOR_t) color);
-			} 
-            else 
-            {
-				SSD1306_DrawPixel(oled.CurrentX + j, (oled.CurrentY + i), (SSD1306_COLOR_t)!color);
+		return 0;
+	}
+
+	x0 = ax;
+	y0 = ay;
+	x1 = ax + Font->FontWidth - 1;
+	y1 = ay + Font->FontHeight - 1;
+	if (oled_clip_rect(&x0, &y0, &x1, &y1))
+	{
+		SSD1306_MarkDirty(x0, y0, x1, y1);
+		for (i = y0 - ay; i <= y1 - ay; i++) 
+	    {
+			b = Font->data[(ch - 32) * Font->FontHeight + i];
+			for (j = x0 - ax; j <= x1 - ax; j++)
+	        {
+				//前景/背景按颜色二选一，不再逐点判断颜色；XOR只翻转前景，背景透明
+				if (color == SSD1306_COLOR_XOR) 
+	            {
+					if ((b << j) & 0x8000) 
+		            {
+						SSD1306_XorPixelUnchecked(ax + j, ay + i);
+					}
+				} 
+				else if ((((b << j) & 0x8000) != 0) == (color == SSD1306_COLOR_WHITE)) 
+	            {
+					SSD1306_SetPixelUnchecked(ax + j, ay + i);
+				} 
+	            else 
+	            {
+					SSD1306_ClearPixelUnchecked(ax + j, ay + i);
+				}
 			}
 		}
 	}
 	oled.CurrentX += Font->FontWidth;
-	if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+	oled_auto_update();
 	return ch;
 }
 /** 
@@ -376,184 +1052,142 @@ char SSD1306_DrawStr(uint16_t x,uint16_t y, char* str, FontDef_t* Font, SSD1306_
 		str++;
 	}
     is_show_str=0;
-    SSD1306_UpdateScreen();
+    oled_auto_update();
 	return *str;
 }
 
 void SSD1306_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, SSD1306_COLOR_t c) {
-	int16_t dx, dy, sx, sy, err, e2, i, tmp; 
-	
-	/* Check for overflow */
-	if (x0 >= SSD1306_WIDTH) {
-		x0 = SSD1306_WIDTH - 1;
-	}
-	if (x1 >= SSD1306_WIDTH) {
-		x1 = SSD1306_WIDTH - 1;
-	}
-	if (y0 >= SSD1306_HEIGHT) {
-		y0 = SSD1306_HEIGHT - 1;
-	}
-	if (y1 >= SSD1306_HEIGHT) {
-		y1 = SSD1306_HEIGHT - 1;
-	}
-	
-	dx = (x0 < x1) ? (x1 - x0) : (x0 - x1); 
-	dy = (y0 < y1) ? (y1 - y0) : (y0 - y1); 
-	sx = (x0 < x1) ? 1 : -1; 
-	sy = (y0 < y1) ? 1 : -1; 
-	err = ((dx > dy) ? dx : -dy) / 2; 
-
-	if (dx == 0) {
-		if (y1 < y0) {
-			tmp = y1;
-			y1 = y0;
-			y0 = tmp;
-		}
-		
-		if (x1 < x0) {
-			tmp = x1;
-			x1 = x0;
-			x0 = tmp;
-		}
-		
-		/* Vertical line */
-		for (i = y0; i <= y1; i++) {
-			SSD1306_DrawPixel(x0, i, c);
-		}
-		
-		/* Return from function */
-		return;
-	}
-	
-	if (dy == 0) {
-		if (y1 < y0) {
-			tmp = y1;
-			y1 = y0;
-			y0 = tmp;
-		}
-		
-		if (x1 < x0) {
-			tmp = x1;
-			x1 = x0;
-			x0 = tmp;
-		}
-		
-		/* Horizontal line */
-		for (i = x0; i <= x1; i++) {
-			SSD1306_DrawPixel(i, y0, c);
-		}
-		
-		/* Return from function */
-		return;
-	}
-	
-	while (1) {
-		SSD1306_DrawPixel(x0, y0, c); 
-		if (x0 == x1 && y0 == y1) {
-			break;
-		}
-		e2 = err; 
-		if (e2 > -dx) {
-			err -= dy;
-			x0 += sx;
-		} 
-		if (e2 < dy) {
-			err += dx;
-			y0 += sy;
-		} 
-	}
-    if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+	int16_t ox = g_viewport[g_viewport_top].ox;
+	int16_t oy = g_viewport[g_viewport_top].oy;
+
+	/* 端点不再钳位到屏幕边缘(会改变斜率)，超出部分由裁剪区丢弃 */
+	oled_draw_line((int16_t)x0 + ox, (int16_t)y0 + oy, (int16_t)x1 + ox, (int16_t)y1 + oy, c);
+    oled_auto_update();
 }
 
 void SSD1306_DrawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1306_COLOR_t c) {
-	/* Check input parameters */
-	if (
-		x >= SSD1306_WIDTH ||
-		y >= SSD1306_HEIGHT
-	) {
-		/* Return error */
-		return;
-	}
-	
-	/* Check width and height */
-	if ((x + w) >= SSD1306_WIDTH) {
-		w = SSD1306_WIDTH - x;
+	int16_t ax = (int16_t)x + g_viewport[g_viewport_top].ox;
+	int16_t ay = (int16_t)y + g_viewport[g_viewport_top].oy;
+
+	/* 4条边各自按span裁剪，超出部分不画，不再压缩宽高；角点只画一次(XOR) */
+	oled_fill_rect(ax, ay, ax + w, ay, c);                     /* Top line */
+	if (h > 0) {
+		oled_fill_rect(ax, ay + h, ax + w, ay + h, c);         /* Bottom line */
 	}
-	if ((y + h) >= SSD1306_HEIGHT) {
-		h = SSD1306_HEIGHT - y;
+	if (h > 1) {
+		oled_fill_rect(ax, ay + 1, ax, ay + h - 1, c);         /* Left line */
+		if (w > 0) {
+			oled_fill_rect(ax + w, ay + 1, ax + w, ay + h - 1, c); /* Right line */
+		}
 	}
-	
-	/* Draw 4 lines */
-	SSD1306_DrawLine(x, y, x + w, y, c);         /* Top line */
-	SSD1306_DrawLine(x, y + h, x + w, y + h, c); /* Bottom line */
-	SSD1306_DrawLine(x, y, x, y + h, c);         /* Left line */
-	SSD1306_DrawLine(x + w, y, x + w, y + h, c); /* Right line */
 
-    if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+    oled_auto_update();
 }
 
 void SSD1306_DrawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1306_COLOR_t c) {
-	uint8_t i;
-	
-	/* Check input parameters */
-	if (
-		x >= SSD1306_WIDTH ||
-		y >= SSD1306_HEIGHT
-	) {
-		/* Return error */
-		return;
-	}
-	
-	/* Check width and height */
-	if ((x + w) >= SSD1306_WIDTH) {
-		w = SSD1306_WIDTH - x;
-	}
-	if ((y + h) >= SSD1306_HEIGHT) {
-		h = SSD1306_HEIGHT - y;
-	}
-	
-	/* Draw lines */
-	for (i = 0; i <= h; i++) {
-		/* Draw lines */
-		SSD1306_DrawLine(x, y + i, x + w, y + i, c);
-	}
+	int16_t ax = (int16_t)x + g_viewport[g_viewport_top].ox;
+	int16_t ay = (int16_t)y + g_viewport[g_viewport_top].oy;
 
-    if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+	oled_fill_rect(ax, ay, ax + w, ay + h, c);
+
+    oled_auto_update();
 }
 
 void SSD1306_DrawTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_COLOR_t color) {
+	int16_t ox = g_viewport[g_viewport_top].ox;
+	int16_t oy = g_viewport[g_viewport_top].oy;
+
 	/* Draw lines */
-	SSD1306_DrawLine(x1, y1, x2, y2, color);
-	SSD1306_DrawLine(x2, y2, x3, y3, color);
-	SSD1306_DrawLine(x3, y3, x1, y1, color);
+	oled_draw_line((int16_t)x1 + ox, (int16_t)y1 + oy, (int16_t)x2 + ox, (int16_t)y2 + oy, color);
+	oled_draw_line((int16_t)x2 + ox, (int16_t)y2 + oy, (int16_t)x3 + ox, (int16_t)y3 + oy, color);
+	oled_draw_line((int16_t)x3 + ox, (int16_t)y3 + oy, (int16_t)x1 + ox, (int16_t)y1 + oy, color);
+	if (color == SSD1306_COLOR_XOR) {
+		/* 每个顶点被两条边各翻转一次，再翻一次 */
+		SSD1306_DrawPixel(x1, y1, color);
+		SSD1306_DrawPixel(x2, y2, color);
+		SSD1306_DrawPixel(x3, y3, color);
+	}
 
-    if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+    oled_auto_update();
 }
 
 
+/** 
+ * 扫描线填充三角形(绝对坐标)，每行一个span且只画一次，供XOR使用
+ * @param[in]   x0,y0,x1,y1,x2,y2   顶点
+ * @param[in]   c   色值
+ * @retval      
+ *              无                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static void oled_fill_triangle_rows(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                    int16_t x2, int16_t y2, SSD1306_COLOR_t c)
+{
+	int16_t a, b, y, last, tmp;
+	int32_t sa, sb;
+
+	/* 按y排序: y0 <= y1 <= y2 */
+	if (y0 > y1) { tmp = y0; y0 = y1; y1 = tmp; tmp = x0; x0 = x1; x1 = tmp; }
+	if (y1 > y2) { tmp = y1; y1 = y2; y2 = tmp; tmp = x1; x1 = x2; x2 = tmp; }
+	if (y0 > y1) { tmp = y0; y0 = y1; y1 = tmp; tmp = x0; x0 = x1; x1 = tmp; }
+
+	if (y0 == y2) {
+		a = b = x0;
+		if (x1 < a) a = x1; else if (x1 > b) b = x1;
+		if (x2 < a) a = x2; else if (x2 > b) b = x2;
+		oled_fill_rect(a, y0, b, y0, c);
+		return;
+	}
+
+	/* 上半部分(含y1行，除非下半部分是平底) */
+	last = (y1 == y2) ? y1 : y1 - 1;
+	sa = 0;
+	sb = 0;
+	for (y = y0; y <= last; y++) {
+		a = x0 + sa / (y1 - y0);
+		b = x0 + sb / (y2 - y0);
+		sa += x1 - x0;
+		sb += x2 - x0;
+		oled_fill_rect(a, y, b, y, c);
+	}
+
+	/* 下半部分 */
+	sa = (int32_t)(x2 - x1) * (y - y1);
+	sb = (int32_t)(x2 - x0) * (y - y0);
+	for (; y <= y2; y++) {
+		a = x1 + sa / (y2 - y1);
+		b = x0 + sb / (y2 - y0);
+		sa += x2 - x1;
+		sb += x2 - x0;
+		oled_fill_rect(a, y, b, y, c);
+	}
+}
+
 void SSD1306_DrawFilledTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_COLOR_t color) {
 	int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
 	yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
 	curpixel = 0;
+	int16_t ox = g_viewport[g_viewport_top].ox;
+	int16_t oy = g_viewport[g_viewport_top].oy;
+	int16_t ax1 = (int16_t)x1 + ox, ay1 = (int16_t)y1 + oy;
+	int16_t ax2 = (int16_t)x2 + ox, ay2 = (int16_t)y2 + oy;
+	int16_t ax3 = (int16_t)x3 + ox, ay3 = (int16_t)y3 + oy;
+
+	/* 下面的扇形画法大量重叠，XOR时改用扫描线 */
+	if (color == SSD1306_COLOR_XOR) {
+		oled_fill_triangle_rows(ax1, ay1, ax2, ay2, ax3, ay3, color);
+		oled_auto_update();
+		return;
+	}
 	
-	deltax = ABS(x2 - x1);
-	deltay = ABS(y2 - y1);
-	x = x1;
-	y = y1;
+	deltax = ABS(ax2 - ax1);
+	deltay = ABS(ay2 - ay1);
+	x = ax1;
+	y = ay1;
 
-	if (x2 >= x1) {
+	if (ax2 >= ax1) {
 		xinc1 = 1;
 		xinc2 = 1;
 	} else {
@@ -561,7 +1195,7 @@ void SSD1306_DrawFilledTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t
 		xinc2 = -1;
 	}
 
-	if (y2 >= y1) {
+	if (ay2 >= ay1) {
 		yinc1 = 1;
 		yinc2 = 1;
 	} else {
@@ -586,7 +1220,7 @@ void SSD1306_DrawFilledTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t
 	}
 
 	for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-		SSD1306_DrawLine(x, y, x3, y3, color);
+		oled_draw_line(x, y, ax3, ay3, color);
 
 		num += numadd;
 		if (num >= den) {
@@ -598,49 +1232,33 @@ void SSD1306_DrawFilledTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t
 		y += yinc2;
 	}
 
-    if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+    oled_auto_update();
 }
 
 void SSD1306_DrawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t c) {
-	int16_t f = 1 - r;
-	int16_t ddF_x = 1;
-	int16_t ddF_y = -2 * r;
-	int16_t x = 0;
-	int16_t y = r;
-
-    SSD1306_DrawPixel(x0, y0 + r, c);
-    SSD1306_DrawPixel(x0, y0 - r, c);
-    SSD1306_DrawPixel(x0 + r, y0, c);
-    SSD1306_DrawPixel(x0 - r, y0, c);
+	int16_t bx0, by0, bx1, by1;
+	bool inside;
 
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+	x0 += g_viewport[g_viewport_top].ox;
+	y0 += g_viewport[g_viewport_top].oy;
 
-        SSD1306_DrawPixel(x0 + x, y0 + y, c);
-        SSD1306_DrawPixel(x0 - x, y0 + y, c);
-        SSD1306_DrawPixel(x0 + x, y0 - y, c);
-        SSD1306_DrawPixel(x0 - x, y0 - y, c);
+	/* 包围盒裁剪一次:完全在外返回，完全在内逐点不再检查 */
+	bx0 = x0 - r; by0 = y0 - r; bx1 = x0 + r; by1 = y0 + r;
+	if (!oled_clip_rect(&bx0, &by0, &bx1, &by1)) {
+		return;
+	}
+	SSD1306_MarkDirty(bx0, by0, bx1, by1);
+	inside = (bx0 == x0 - r) && (by0 == y0 - r) && (bx1 == x0 + r) && (by1 == y0 + r);
 
-        SSD1306_DrawPixel(x0 + y, y0 + x, c);
-        SSD1306_DrawPixel(x0 - y, y0 + x, c);
-        SSD1306_DrawPixel(x0 + y, y0 - x, c);
-        SSD1306_DrawPixel(x0 - y, y0 - x, c);
-    }
+	if (c == SSD1306_COLOR_WHITE) {
+		oled_circle_Set(x0, y0, r, inside);
+	} else if (c == SSD1306_COLOR_XOR) {
+		oled_circle_Xor(x0, y0, r, inside);
+	} else {
+		oled_circle_Clear(x0, y0, r, inside);
+	}
 
-    if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+    oled_auto_update();
 }
 
 void SSD1306_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t c) {
@@ -649,12 +1267,14 @@ void SSD1306_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t
 	int16_t ddF_y = -2 * r;
 	int16_t x = 0;
 	int16_t y = r;
+	int16_t px = x;
+	int16_t py = y;
 
-    SSD1306_DrawPixel(x0, y0 + r, c);
-    SSD1306_DrawPixel(x0, y0 - r, c);
-    SSD1306_DrawPixel(x0 + r, y0, c);
-    SSD1306_DrawPixel(x0 - r, y0, c);
-    SSD1306_DrawLine(x0 - r, y0, x0 + r, y0, c);
+	x0 += g_viewport[g_viewport_top].ox;
+	y0 += g_viewport[g_viewport_top].oy;
+
+	/* 每列一个竖直span且只画一次(XOR不会相互抵消)，由oled_fill_rect裁剪 */
+    oled_fill_rect(x0, y0 - r, x0, y0 + r, c);
 
     while (x < y) {
         if (f >= 0) {
@@ -666,16 +1286,18 @@ void SSD1306_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t
         ddF_x += 2;
         f += ddF_x;
 
-        SSD1306_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, c);
-        SSD1306_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, c);
-
-        SSD1306_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, c);
-        SSD1306_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, c);
+        if (x <= y) {
+            oled_fill_rect(x0 + x, y0 - y, x0 + x, y0 + y, c);
+            oled_fill_rect(x0 - x, y0 - y, x0 - x, y0 + y, c);
+        }
+        if (y != py) {
+            oled_fill_rect(x0 + py, y0 - px, x0 + py, y0 + px, c);
+            oled_fill_rect(x0 - py, y0 - px, x0 - py, y0 + px, c);
+            py = y;
+        }
+        px = x;
     }
 
-    if(0 == is_show_str)
-    {
-       SSD1306_UpdateScreen(); 
-    }
+    oled_auto_update();
 }
 
@@ -0,0 +1,374 @@
+/*
+* @file         ssd1306_gray.c
+* @brief        OLED时间抖动4级灰度
+* @details      esp_timer按子帧周期唤醒刷新任务，任务只在要显示的位平面变化时
+*               用SSD1306_FlushFrame整屏刷新(2次传输)，高位平面的第2个子帧不用重发；
+*               普通单色绘图只写高位平面，即灰度2，需要全亮时调用SSD1306_GrayCopyMono
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "ssd1306_gray.h"
+#include "ssd1306_pixel.h"
+#include "ssd1306_transport.h"
+#include "string.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define GRAY_PLANE_SIZE     (SSD1306_WIDTH * SSD1306_PAGES)
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+//低位平面，高位平面就是g_oled_buffer
+static uint8_t g_gray_lsb[GRAY_PLANE_SIZE];
+static TaskHandle_t g_gray_task_handle = NULL;
+static esp_timer_handle_t g_gray_timer = NULL;
+//刷新任务持有，停止时等待正在进行的刷新结束
+static SemaphoreHandle_t g_gray_lock = NULL;
+static volatile bool g_gray_running = 0;
+static SSD1306_GrayStats_t g_gray_stats;
+static int64_t g_gray_start_us;
+static portMUX_TYPE g_gray_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 子帧定时器回调(esp_timer任务中执行)，唤醒刷新任务
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void gray_timer_cb(void *arg)
+{
+    (void)arg;
+    xTaskNotifyGive(g_gray_task_handle);
+}
+
+/**
+ * 灰度绘图与刷新任务互斥，保证一次刷新看到的两个位平面是一致的
+ * 第一次启动灰度模式前还没有锁，也没有刷新任务，直接返回
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void gray_begin_draw(void)
+{
+    if (g_gray_lock != NULL)
+    {
+        xSemaphoreTake(g_gray_lock, portMAX_DELAY);
+    }
+}
+
+/**
+ * 结束灰度绘图，释放gray_begin_draw取得的锁
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void gray_end_draw(void)
+{
+    if (g_gray_lock != NULL)
+    {
+        xSemaphoreGive(g_gray_lock);
+    }
+}
+
+/**
+ * 刷新任务:按子帧序号决定显示哪个位平面，平面不变就不发送
+ * 子帧0、1显示高位平面，子帧2显示低位平面；刷新超时错过的子帧直接跳过，保持相位与时间对齐
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void gray_task(void *arg)
+{
+    uint32_t ticks;
+    uint8_t phase = 0;
+    const uint8_t *shown = NULL;
+    const uint8_t *want;
+    int64_t t0;
+    uint32_t us;
+
+    (void)arg;
+    while (1)
+    {
+        ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!g_gray_running)
+        {
+            shown = NULL;
+            continue;
+        }
+        phase = (phase + ticks) % SSD1306_GRAY_SUBFRAMES;
+        want = (phase == SSD1306_GRAY_SUBFRAMES - 1) ? g_gray_lsb : g_oled_buffer;
+        if (want == shown)
+        {
+            continue;
+        }
+
+        xSemaphoreTake(g_gray_lock, portMAX_DELAY);
+        t0 = esp_timer_get_time();
+        SSD1306_FlushFrame(want);
+        us = (uint32_t)(esp_timer_get_time() - t0);
+        xSemaphoreGive(g_gray_lock);
+        shown = want;
+
+        portENTER_CRITICAL(&g_gray_stats_mux);
+        g_gray_stats.flushes ++;
+        g_gray_stats.missed += ticks - 1;
+        g_gray_stats.flush_us_last = us;
+        if (us > g_gray_stats.flush_us_max)
+        {
+            g_gray_stats.flush_us_max = us;
+        }
+        portEXIT_CRITICAL(&g_gray_stats_mux);
+    }
+}
+
+/**
+ * 启动灰度模式，之后绘图函数不再自动刷新，不能与渲染任务同时使用
+ * 按当前传输层估算整屏刷新耗时，超过子帧周期时拒绝启动
+ * (400kHz I2C整屏约23ms，只能做到约14Hz灰度周期，会明显闪烁，建议使用SPI)
+ * @param[in]   cycle_hz   灰度周期频率，0使用默认值
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_STATE  竖屏(0/180度才支持整屏刷新)
+ *              - ESP_ERR_NOT_SUPPORTED  传输层太慢，达不到要求的频率
+ *              - ESP_ERR_NO_MEM
+ *              - 其它  esp_timer创建错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 创建失败时释放已创建的定时器和互斥量\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 定时器启动失败时恢复自动刷新并清除运行标志\n
+ */
+esp_err_t SSD1306_GrayStart(uint8_t cycle_hz)
+{
+    esp_timer_create_args_t args;
+    uint32_t period_us;
+    uint32_t estimate_us;
+    esp_err_t ret;
+
+    if (cycle_hz == 0)
+    {
+        cycle_hz = SSD1306_GRAY_DEFAULT_HZ;
+    }
+    if (SSD1306_GetWidth() != SSD1306_WIDTH)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    period_us = 1000000 / ((uint32_t)cycle_hz * SSD1306_GRAY_SUBFRAMES);
+    estimate_us = SSD1306_FrameCostUs(SSD1306_GetTransport());
+    if (estimate_us >= period_us)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    if (g_gray_task_handle == NULL)
+    {
+        g_gray_lock = xSemaphoreCreateMutex();
+        if (g_gray_lock == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        memset(&args, 0, sizeof(args));
+        args.callback = gray_timer_cb;
+        args.name = "oled_gray";
+        ret = esp_timer_create(&args, &g_gray_timer);
+        if (ret != ESP_OK)
+        {
+            vSemaphoreDelete(g_gray_lock);
+            g_gray_lock = NULL;
+            g_gray_timer = NULL;
+            return ret;
+        }
+        if (xTaskCreate(gray_task, "oled_gray_task", SSD1306_GRAY_TASK_STACK, NULL,
+                        SSD1306_GRAY_TASK_PRIO, &g_gray_task_handle) != pdPASS)
+        {
+            //释放已创建的部分，下次调用重新创建
+            esp_timer_delete(g_gray_timer);
+            g_gray_timer = NULL;
+            vSemaphoreDelete(g_gray_lock);
+            g_gray_lock = NULL;
+            g_gray_task_handle = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    else
+    {
+        SSD1306_GrayStop();
+    }
+
+    memset(&g_gray_stats, 0, sizeof(g_gray_stats));
+    g_gray_stats.cycle_hz = cycle_hz;
+    g_gray_stats.subframe_us = period_us;
+    g_gray_stats.estimate_us = estimate_us;
+    g_gray_start_us = esp_timer_get_time();
+
+    SSD1306_SetAutoUpdate(0);
+    g_gray_running = 1;
+    ret = esp_timer_start_periodic(g_gray_timer, period_us);
+    if (ret != ESP_OK)
+    {
+        g_gray_running = 0;
+        SSD1306_SetAutoUpdate(1);
+    }
+    return ret;
+}
+
+/**
+ * 停止灰度模式，等待正在进行的刷新结束后按单色(高位平面)刷新一次
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SSD1306_GrayStop(void)
+{
+    if (!g_gray_running)
+    {
+        return;
+    }
+    esp_timer_stop(g_gray_timer);
+    g_gray_running = 0;
+    xSemaphoreTake(g_gray_lock, portMAX_DELAY);
+    xSemaphoreGive(g_gray_lock);
+
+    SSD1306_MarkDirty(0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1);
+    SSD1306_UpdateScreen();
+    SSD1306_SetAutoUpdate(1);
+}
+
+/**
+ * 清空两个位平面
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 与刷新任务互斥\n
+ */
+void SSD1306_GrayClear(void)
+{
+    gray_begin_draw();
+    SSD1306_Fill(SSD1306_COLOR_BLACK);
+    memset(g_gray_lsb, 0, sizeof(g_gray_lsb));
+    gray_end_draw();
+}
+
+/**
+ * 按灰度填充矩形，坐标按当前视口偏移并裁剪
+ * @param[in]   x,y     左上角
+ * @param[in]   w,h     宽高(与SSD1306_DrawFilledRectangle相同，右下角为x+w,y+h)
+ * @param[in]   level   灰度0~3
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 改用ssd1306_pixel.h的位平面矩形操作\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 与刷新任务互斥\n
+ */
+void SSD1306_GrayFillRectangle(int16_t x, int16_t y, uint16_t w, uint16_t h, uint8_t level)
+{
+    int16_t x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+
+    if (!SSD1306_ClipRect(&x0, &y0, &x1, &y1))
+    {
+        return;
+    }
+    //灰度只在横屏下使用，两个位平面的每页都是SSD1306_WIDTH字节
+    gray_begin_draw();
+    if (level & 0x02)
+    {
+        SSD1306_SetPlaneRectUnchecked(g_oled_buffer, SSD1306_WIDTH, x0, y0, x1, y1);
+    }
+    else
+    {
+        SSD1306_ClearPlaneRectUnchecked(g_oled_buffer, SSD1306_WIDTH, x0, y0, x1, y1);
+    }
+    if (level & 0x01)
+    {
+        SSD1306_SetPlaneRectUnchecked(g_gray_lsb, SSD1306_WIDTH, x0, y0, x1, y1);
+    }
+    else
+    {
+        SSD1306_ClearPlaneRectUnchecked(g_gray_lsb, SSD1306_WIDTH, x0, y0, x1, y1);
+    }
+    gray_end_draw();
+}
+
+/**
+ * 按灰度画点，坐标按当前视口偏移并裁剪
+ * @param[in]   x,y     坐标
+ * @param[in]   level   灰度0~3
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SSD1306_GrayDrawPixel(int16_t x, int16_t y, uint8_t level)
+{
+    SSD1306_GrayFillRectangle(x, y, 0, 0, level);
+}
+
+/**
+ * 把单色绘图结果(高位平面)拷到低位平面，使单色点亮的像素为灰度3、其余为0
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 与刷新任务互斥\n
+ */
+void SSD1306_GrayCopyMono(void)
+{
+    gray_begin_draw();
+    memcpy(g_gray_lsb, g_oled_buffer, sizeof(g_gray_lsb));
+    gray_end_draw();
+}
+
+/**
+ * 读取灰度刷新统计
+ * @param[out]  stats   统计结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SSD1306_GrayGetStats(SSD1306_GrayStats_t *stats)
+{
+    int64_t elapsed = esp_timer_get_time() - g_gray_start_us;
+
+    portENTER_CRITICAL(&g_gray_stats_mux);
+    *stats = g_gray_stats;
+    portEXIT_CRITICAL(&g_gray_stats_mux);
+    if (elapsed > 0)
+    {
+        stats->flush_rate = (uint32_t)((int64_t)stats->flushes * 1000000 / elapsed);
+    }
+}
@@ -0,0 +1,133 @@
+/*
+* @file         ssd1306_i2c.c 
+* @brief        OLED I2C传输层
+* @details      原ssd1306.c中的i2c读写函数，按传输层接口封装；
+*               经i2c_bus总线任务发送，显存数据分块写，块之间可以插入传感器读
+* @author       Caesar, 2019/10/18, 初始化版本\n  
+* @par Copyright (c):  
+*               Caesar,Email:792910363@qq.com
+*/
+/* 
+=============
+头文件包含
+=============
+*/
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+#include "i2c_bus.h"
+
+/*
+===========================
+全局变量定义
+=========================== 
+*/
+static I2CBus_Device_t *g_oled_dev = NULL;
+
+/*
+===========================
+函数定义
+=========================== 
+*/
+
+/** 
+ * 自动调速的探测:连续写几条NOP命令，每个字节都要应答(I2C接口的SSD1306不能读回)
+ * @param[in]   dev   oled器件
+ * @param[in]   arg   无
+ * @retval      
+ *              - ESP_OK                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ */
+static esp_err_t i2c_probe(I2CBus_Device_t *dev, void *arg)
+{
+    static const uint8_t ctrl = WRITE_CMD;
+    static const uint8_t nops[4] = {0xE3, 0xE3, 0xE3, 0xE3};
+    return I2CBus_Write(dev, &ctrl, 1, nops, sizeof(nops), 0);
+}
+
+/** 
+ * oled_i2c 初始化
+ * @param[in]   无
+ * @retval      
+ *              - ESP_OK                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2019/10/18, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 端口由i2c_bus管理，这里只登记器件\n 
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 按探测结果设置oled的i2c时钟\n
+ */
+static esp_err_t i2c_init(void)
+{
+    esp_err_t ret = I2CBus_Init(I2C_OLED_MASTER_NUM, I2C_OLED_MASTER_SDA_IO,
+                                I2C_OLED_MASTER_SCL_IO, I2C_OLED_MASTER_FREQ_HZ);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    //整屏刷新是大块传输，优先级低于传感器
+    g_oled_dev = I2CBus_AddDevice(I2C_OLED_MASTER_NUM, OLED_WRITE_ADDR >> 1, "ssd1306", I2C_BUS_PRIO_LOW);
+    if (g_oled_dev == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    //刷新耗时与时钟成正比，用探测到的最高可靠时钟，耗时估算随之更新
+    if (I2CBus_AutoTune(g_oled_dev, I2C_OLED_MASTER_MAX_FREQ_HZ, i2c_probe, NULL) == 0)
+    {
+        return ESP_FAIL;
+    }
+    SSD1306_TransportI2C.clock_hz = g_oled_dev->clk_hz;
+    return ESP_OK;
+}
+
+/** 
+ * 向oled连续写多条命令(一次i2c传输)
+ * @param[in]   cmds   命令序列
+ * @param[in]   len    命令长度
+ * @retval      
+ *              - ESP_OK                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n 
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 经i2c_bus发送\n
+ */
+static esp_err_t i2c_write_cmds(const uint8_t *cmds, uint16_t len)
+{
+    static const uint8_t ctrl = WRITE_CMD;
+    return I2CBus_Write(g_oled_dev, &ctrl, 1, cmds, len, 0);
+}
+
+/** 
+ * 向oled写长数据
+ * @param[in]   data   要写入的数据
+ * @param[in]   len     数据长度
+ * @retval      
+ *              - ESP_OK                              
+ * @par         修改日志 
+ *               Ver0.0.1:
+                     Caesar, 2019/10/18, 初始化版本\n  
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 经i2c_bus分块发送\n
+ */
+static esp_err_t i2c_write_data(const uint8_t *data, uint16_t len)
+{
+    static const uint8_t ctrl = WRITE_DATA;
+    //水平寻址模式下显存地址跨传输自动递增，可以拆块发送
+    return I2CBus_Write(g_oled_dev, &ctrl, 1, data, len, 1);
+}
+
+//I2C传输层:每次传输阻塞到完成，无需sync
+SSD1306_Transport_t SSD1306_TransportI2C = {
+    .name = "i2c",
+    .init = i2c_init,
+    .write_cmds = i2c_write_cmds,
+    .write_data = i2c_write_data,
+    .sync = NULL,
+    .clock_hz = I2C_OLED_MASTER_FREQ_HZ,
+    .bits_per_byte = 9,
+    .txn_overhead_bits = 20,
+    .txn_overhead_us = 60,
+};
@@ -0,0 +1,345 @@
+/*
+* @file         ssd1306_render.c
+* @brief        OLED按帧率刷新的渲染调度任务
+* @details      生产者任务只投递绘图请求，渲染任务是唯一操作显存和i2c的任务；
+*               同一帧内的请求合并后在帧截止时间统一刷新，避免每次绘图都阻塞刷屏
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "ssd1306_render.h"
+#include "string.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+/*
+===========================
+全局变量定义
+===========================
+*/
+static QueueHandle_t g_render_queue = NULL;
+static TaskHandle_t g_render_task_handle = NULL;
+//帧周期(tick)
+static volatile TickType_t g_frame_ticks;
+static SSD1306_RenderStats_t g_render_stats;
+static portMUX_TYPE g_render_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 帧率转换为帧周期tick数，至少1个tick
+ * @param[in]   fps   目标帧率
+ * @retval
+ *              帧周期tick数
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static TickType_t render_fps_to_ticks(uint8_t fps)
+{
+    TickType_t ticks;
+    if (fps == 0)
+    {
+        fps = SSD1306_RENDER_DEFAULT_FPS;
+    }
+    ticks = (1000 / fps) / portTICK_PERIOD_MS;
+    return (ticks == 0) ? 1 : ticks;
+}
+
+/**
+ * 在渲染任务中执行一条绘图请求(只画显存)
+ * @param[in]   req   绘图请求
+ * @retval
+ *              无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void render_execute(SSD1306_DrawReq_t *req)
+{
+    switch (req->type)
+    {
+        case SSD1306_REQ_CLEAR:
+            SSD1306_Fill(SSD1306_COLOR_BLACK);
+            break;
+        case SSD1306_REQ_STR:
+            SSD1306_DrawStr(req->x0, req->y0, req->str, req->font, req->color);
+            break;
+        case SSD1306_REQ_LINE:
+            SSD1306_DrawLine(req->x0, req->y0, req->x1, req->y1, req->color);
+            break;
+        case SSD1306_REQ_RECT:
+            SSD1306_DrawRectangle(req->x0, req->y0, req->x1, req->y1, req->color);
+            break;
+        case SSD1306_REQ_FILLED_RECT:
+            SSD1306_DrawFilledRectangle(req->x0, req->y0, req->x1, req->y1, req->color);
+            break;
+        case SSD1306_REQ_CIRCLE:
+            SSD1306_DrawCircle(req->x0, req->y0, req->x1, req->color);
+            break;
+        case SSD1306_REQ_CUSTOM:
+            if (req->draw)
+            {
+                req->draw(req->arg);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 渲染任务:收集请求直到帧截止时间，有修改才刷新一次
+ * @param[in]   arg   无
+ * @retval
+ *              无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void render_task(void *arg)
+{
+    SSD1306_DrawReq_t req;
+    TickType_t deadline = xTaskGetTickCount() + g_frame_ticks;
+    TickType_t now;
+    int32_t remain;
+    uint32_t pending = 0;
+    uint32_t render_us = 0;
+    uint32_t missed;
+    int64_t t0;
+
+    while (1)
+    {
+        now = xTaskGetTickCount();
+        remain = (int32_t)(deadline - now);
+        if (remain > 0 && xQueueReceive(g_render_queue, &req, remain) == pdTRUE)
+        {
+            t0 = esp_timer_get_time();
+            render_execute(&req);
+            pending ++;
+            //把已排队的请求一次画完
+            while (xQueueReceive(g_render_queue, &req, 0) == pdTRUE)
+            {
+                render_execute(&req);
+                pending ++;
+            }
+            render_us += (uint32_t)(esp_timer_get_time() - t0);
+            continue;
+        }
+
+        //到达帧截止时间
+        if (pending)
+        {
+            t0 = esp_timer_get_time();
+            SSD1306_UpdateScreen();
+            t0 = esp_timer_get_time() - t0;
+
+            portENTER_CRITICAL(&g_render_stats_mux);
+            g_render_stats.frames ++;
+            g_render_stats.requests += pending;
+            g_render_stats.coalesced += pending - 1;
+            g_render_stats.render_us_last = render_us;
+            if (render_us > g_render_stats.render_us_max)
+            {
+                g_render_stats.render_us_max = render_us;
+            }
+            g_render_stats.flush_us_last = (uint32_t)t0;
+            if ((uint32_t)t0 > g_render_stats.flush_us_max)
+            {
+                g_render_stats.flush_us_max = (uint32_t)t0;
+            }
+            portEXIT_CRITICAL(&g_render_stats_mux);
+            pending = 0;
+            render_us = 0;
+        }
+
+        //下一帧截止时间，已经错过的帧计为丢帧并跳过
+        deadline += g_frame_ticks;
+        now = xTaskGetTickCount();
+        if ((int32_t)(deadline - now) <= 0)
+        {
+            missed = (now - deadline) / g_frame_ticks + 1;
+            deadline += missed * g_frame_ticks;
+            portENTER_CRITICAL(&g_render_stats_mux);
+            g_render_stats.dropped_frames += missed;
+            portEXIT_CRITICAL(&g_render_stats_mux);
+        }
+    }
+}
+
+/**
+ * 启动渲染任务，之后绘图函数不再自动刷新
+ * @param[in]   fps   目标帧率，0使用默认值
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_NO_MEM
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t SSD1306_RenderStart(uint8_t fps)
+{
+    if (g_render_task_handle)
+    {
+        SSD1306_RenderSetFps(fps);
+        return ESP_OK;
+    }
+    g_frame_ticks = render_fps_to_ticks(fps);
+    g_render_queue = xQueueCreate(SSD1306_RENDER_QUEUE_LEN, sizeof(SSD1306_DrawReq_t));
+    if (g_render_queue == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    SSD1306_SetAutoUpdate(0);
+    if (xTaskCreate(render_task, "oled_render_task", SSD1306_RENDER_TASK_STACK, NULL,
+                    SSD1306_RENDER_TASK_PRIO, &g_render_task_handle) != pdPASS)
+    {
+        SSD1306_SetAutoUpdate(1);
+        vQueueDelete(g_render_queue);
+        g_render_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+/**
+ * 修改目标帧率，下一帧生效
+ * @param[in]   fps   目标帧率，0使用默认值
+ * @retval
+ *              无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SSD1306_RenderSetFps(uint8_t fps)
+{
+    g_frame_ticks = render_fps_to_ticks(fps);
+}
+
+/**
+ * 投递绘图请求(可在多个任务中调用)
+ * @param[in]   req    绘图请求，内容会被拷贝
+ * @param[in]   wait   队列满时等待的tick数
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_STATE  渲染任务未启动
+ *              - ESP_ERR_TIMEOUT        队列满
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t SSD1306_RenderSubmit(const SSD1306_DrawReq_t *req, TickType_t wait)
+{
+    if (g_render_queue == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xQueueSend(g_render_queue, req, wait) != pdTRUE)
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+/**
+ * 投递清屏请求
+ * @retval      同SSD1306_RenderSubmit
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t SSD1306_RenderClear(void)
+{
+    SSD1306_DrawReq_t req;
+    memset(&req, 0, sizeof(req));
+    req.type = SSD1306_REQ_CLEAR;
+    return SSD1306_RenderSubmit(&req, portMAX_DELAY);
+}
+
+/**
+ * 投递字符串请求，超过SSD1306_RENDER_STR_MAX-1的部分被截断
+ * @param[in]   x     显示坐标x
+ * @param[in]   y     显示坐标y
+ * @param[in]   str   要显示的字符串
+ * @param[in]   Font  显示的字形
+ * @param[in]   color 颜色  1显示 0不显示
+ * @retval      同SSD1306_RenderSubmit
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t SSD1306_RenderStr(int16_t x, int16_t y, const char *str, FontDef_t *Font, SSD1306_COLOR_t color)
+{
+    SSD1306_DrawReq_t req;
+    memset(&req, 0, sizeof(req));
+    req.type = SSD1306_REQ_STR;
+    req.x0 = x;
+    req.y0 = y;
+    req.font = Font;
+    req.color = color;
+    strncpy(req.str, str, SSD1306_RENDER_STR_MAX - 1);
+    return SSD1306_RenderSubmit(&req, portMAX_DELAY);
+}
+
+/**
+ * 投递直线请求
+ * @retval      同SSD1306_RenderSubmit
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t SSD1306_RenderLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR_t c)
+{
+    SSD1306_DrawReq_t req;
+    memset(&req, 0, sizeof(req));
+    req.type = SSD1306_REQ_LINE;
+    req.x0 = x0;
+    req.y0 = y0;
+    req.x1 = x1;
+    req.y1 = y1;
+    req.color = c;
+    return SSD1306_RenderSubmit(&req, portMAX_DELAY);
+}
+
+/**
+ * 投递自定义绘图回调，回调在渲染任务中执行，arg须在执行前保持有效
+ * @param[in]   draw  绘图回调
+ * @param[in]   arg   回调参数
+ * @retval      同SSD1306_RenderSubmit
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t SSD1306_RenderCustom(void (*draw)(void *arg), void *arg)
+{
+    SSD1306_DrawReq_t req;
+    memset(&req, 0, sizeof(req));
+    req.type = SSD1306_REQ_CUSTOM;
+    req.draw = draw;
+    req.arg = arg;
+    return SSD1306_RenderSubmit(&req, portMAX_DELAY);
+}
+
+/**
+ * 读取每帧耗时统计
+ * @param[out]  stats   统计结果
+ * @retval
+ *              无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SSD1306_RenderGetStats(SSD1306_RenderStats_t *stats)
+{
+    portENTER_CRITICAL(&g_render_stats_mux);
+    *stats = g_render_stats;
+    portEXIT_CRITICAL(&g_render_stats_mux);
+}
@@ -0,0 +1,248 @@
+/*
+* @file         ssd1306_spi.c
+* @brief        OLED SPI传输层(4线SPI + DC脚)
+* @details      命令和显存数据都以DMA传输排队发出，CPU不等待单次传输完成；
+*               SSD1306_UpdateScreen结束时调用sync等待本帧全部发完
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+#include "string.h"
+#include "esp_attr.h"
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define SPI_DC_CMD          0           //DC低电平:命令
+#define SPI_DC_DATA         1           //DC高电平:数据
+#define SPI_CMD_BUF_LEN     8           //每个传输槽缓存的命令字节数
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static spi_device_handle_t g_spi_dev;
+//传输槽，按排队顺序循环使用
+static spi_transaction_t g_spi_trans[SSD1306_SPI_QUEUE_LEN];
+//命令拷贝(调用者的命令通常在栈上)
+static uint8_t g_spi_cmd_buf[SSD1306_SPI_QUEUE_LEN][SPI_CMD_BUF_LEN];
+static uint8_t g_spi_next = 0;
+static uint8_t g_spi_inflight = 0;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 传输开始前按transaction的user字段设置DC脚(中断中调用)
+ * @param[in]   t   当前传输
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void IRAM_ATTR spi_pre_transfer_cb(spi_transaction_t *t)
+{
+    gpio_set_level(SSD1306_SPI_DC_IO, (int)t->user);
+}
+
+/**
+ * 取回最早排队的一个传输
+ * @retval
+ *              - ESP_OK
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t spi_reclaim_one(void)
+{
+    spi_transaction_t *done;
+    esp_err_t ret = spi_device_get_trans_result(g_spi_dev, &done, portMAX_DELAY);
+    if (ret == ESP_OK)
+    {
+        g_spi_inflight --;
+    }
+    return ret;
+}
+
+/**
+ * 排队一次传输，传输槽用完时先取回最早的一个
+ * @param[in]   buf   发送缓冲区(完成前保持有效)
+ * @param[in]   len   字节数
+ * @param[in]   dc    SPI_DC_CMD/SPI_DC_DATA
+ * @param[out]  slot  使用的传输槽序号
+ * @retval
+ *              - ESP_OK
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t spi_queue(const uint8_t *buf, uint16_t len, int dc)
+{
+    spi_transaction_t *t;
+    esp_err_t ret;
+
+    if (g_spi_inflight >= SSD1306_SPI_QUEUE_LEN)
+    {
+        ret = spi_reclaim_one();
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+    }
+    t = &g_spi_trans[g_spi_next];
+    memset(t, 0, sizeof(*t));
+    t->length = len * 8;
+    t->tx_buffer = buf;
+    t->user = (void *)dc;
+    ret = spi_device_queue_trans(g_spi_dev, t, portMAX_DELAY);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    g_spi_next = (g_spi_next + 1) % SSD1306_SPI_QUEUE_LEN;
+    g_spi_inflight ++;
+    return ESP_OK;
+}
+
+/**
+ * 初始化SPI总线、DC/RST脚并复位OLED
+ * @retval
+ *              - ESP_OK
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t spi_init(void)
+{
+    esp_err_t ret;
+    spi_bus_config_t buscfg;
+    spi_device_interface_config_t devcfg;
+
+    gpio_pad_select_gpio(SSD1306_SPI_DC_IO);
+    gpio_set_direction(SSD1306_SPI_DC_IO, GPIO_MODE_OUTPUT);
+    gpio_pad_select_gpio(SSD1306_SPI_RST_IO);
+    gpio_set_direction(SSD1306_SPI_RST_IO, GPIO_MODE_OUTPUT);
+    //硬件复位
+    gpio_set_level(SSD1306_SPI_RST_IO, 0);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    gpio_set_level(SSD1306_SPI_RST_IO, 1);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+
+    memset(&buscfg, 0, sizeof(buscfg));
+    buscfg.mosi_io_num = SSD1306_SPI_MOSI_IO;
+    buscfg.miso_io_num = -1;
+    buscfg.sclk_io_num = SSD1306_SPI_SCLK_IO;
+    buscfg.quadwp_io_num = -1;
+    buscfg.quadhd_io_num = -1;
+    buscfg.max_transfer_sz = SSD1306_WIDTH * SSD1306_PAGES + SPI_CMD_BUF_LEN;
+    ret = spi_bus_initialize(SSD1306_SPI_HOST, &buscfg, SSD1306_SPI_DMA_CHAN);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    memset(&devcfg, 0, sizeof(devcfg));
+    devcfg.clock_speed_hz = SSD1306_SPI_CLOCK_HZ;
+    devcfg.mode = 0;
+    devcfg.spics_io_num = SSD1306_SPI_CS_IO;
+    devcfg.queue_size = SSD1306_SPI_QUEUE_LEN;
+    devcfg.pre_cb = spi_pre_transfer_cb;
+    return spi_bus_add_device(SSD1306_SPI_HOST, &devcfg, &g_spi_dev);
+}
+
+/**
+ * 排队发送命令，命令先拷贝到传输槽自己的缓存
+ * @param[in]   cmds   命令序列
+ * @param[in]   len    命令长度
+ * @retval
+ *              - ESP_OK
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t spi_write_cmds(const uint8_t *cmds, uint16_t len)
+{
+    esp_err_t ret = ESP_OK;
+    uint16_t n;
+    uint8_t *buf;
+
+    while (len > 0 && ret == ESP_OK)
+    {
+        n = (len > SPI_CMD_BUF_LEN) ? SPI_CMD_BUF_LEN : len;
+        //spi_queue可能先取回最早的传输，槽位在它之后才空出来
+        if (g_spi_inflight >= SSD1306_SPI_QUEUE_LEN)
+        {
+            ret = spi_reclaim_one();
+            if (ret != ESP_OK)
+            {
+                break;
+            }
+        }
+        buf = g_spi_cmd_buf[g_spi_next];
+        memcpy(buf, cmds, n);
+        ret = spi_queue(buf, n, SPI_DC_CMD);
+        cmds += n;
+        len -= n;
+    }
+    return ret;
+}
+
+/**
+ * 排队发送显存数据(DMA直接读取data，sync前不能修改)
+ * @param[in]   data   数据
+ * @param[in]   len    数据长度
+ * @retval
+ *              - ESP_OK
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t spi_write_data(const uint8_t *data, uint16_t len)
+{
+    return spi_queue(data, len, SPI_DC_DATA);
+}
+
+/**
+ * 等待所有排队的传输完成
+ * @retval
+ *              - ESP_OK
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t spi_sync(void)
+{
+    esp_err_t ret = ESP_OK;
+    while (g_spi_inflight > 0 && ret == ESP_OK)
+    {
+        ret = spi_reclaim_one();
+    }
+    return ret;
+}
+
+//SPI传输层:DMA排队传输，每次传输的驱动开销按排队后约15us估计
+const SSD1306_Transport_t SSD1306_TransportSPI = {
+    .name = "spi",
+    .init = spi_init,
+    .write_cmds = spi_write_cmds,
+    .write_data = spi_write_data,
+    .sync = spi_sync,
+    .clock_hz = SSD1306_SPI_CLOCK_HZ,
+    .bits_per_byte = 8,
+    .txn_overhead_bits = 0,
+    .txn_overhead_us = 15,
+};
@@ -15,14 +15,30 @@
 #include <freertos/FreeRTOS.h>
 #include "freertos/task.h"
 #include "ssd1306.h"
+#include "ssd1306_render.h"
+#include "i2c_bus.h"
+#include "i2c_trace.h"
+#include "i2c_diag.h"
 #include "fonts.h"
 
+//启动时的总线诊断结果
+static I2CDiag_Result_t g_i2c_diag;
+
 void app_main()
 {
 	char pbuf[20];
 	uint8_t len = 0;
     unsigned int cnt=0;
-    SSD1306_Init();
+    SSD1306_RenderStats_t stats;
+    if (SSD1306_Init() != ESP_OK)
+    {
+        ESP_LOGE("OLED", "oled init failed");
+    }
+    //打印总线上的器件和延迟，便于区分总线变慢和器件失效
+    if (I2CDiag_Scan(I2C_OLED_MASTER_NUM, &g_i2c_diag) == ESP_OK)
+    {
+        I2CDiag_Print(&g_i2c_diag);
+    }
     SSD1306_DrawStr(0,0,  "ESP32 I2C Demo", &Font_7x10, 1);
     SSD1306_DrawStr(0,15, "ssd1306 example", &Font_7x10, 1);
     SSD1306_DrawStr(0,30, "Hello World!", &Font_7x10, 1);
@@ -35,15 +51,26 @@ void app_main()
 	SSD1306_DrawCircle(50,30,20,1);
 	vTaskDelay(10000 / portTICK_PERIOD_MS);
 	SSD1306_Clear();
+	//记录i2c传输，每分钟从串口导出一次，用components/i2c_bus/tools/i2c_trace.py分析
+	I2CTrace_Start();
+	//之后由渲染任务按帧率合并刷新
+	SSD1306_RenderStart(SSD1306_RENDER_DEFAULT_FPS);
     while(1)
     {   
         len = sprintf(pbuf,"%04d",cnt % 10000);
 		pbuf[len] = '\0';
-		SSD1306_DrawStr(20,0,pbuf,&Font_7x10,1);//显示0000-9999(3种字体大小)
-		SSD1306_DrawStr(20,15,pbuf,&Font_11x18,1);
-		SSD1306_DrawStr(20,34,pbuf,&Font_16x26,1);
+		SSD1306_RenderStr(20,0,pbuf,&Font_7x10,1);//显示0000-9999(3种字体大小)
+		SSD1306_RenderStr(20,15,pbuf,&Font_11x18,1);
+		SSD1306_RenderStr(20,34,pbuf,&Font_16x26,1);
 		cnt++;
         vTaskDelay(1000 / portTICK_PERIOD_MS);
-        ESP_LOGI("OLED", "cnt = %d \r\n", cnt);
+        SSD1306_RenderGetStats(&stats);
+        ESP_LOGI("OLED", "cnt = %d frames = %u dropped = %u render = %uus flush = %uus\r\n", cnt,
+                 stats.frames, stats.dropped_frames, stats.render_us_last, stats.flush_us_last);
+        I2CBus_PrintStats(I2C_OLED_MASTER_NUM);
+        if (cnt % 60 == 0)
+        {
+            I2CTrace_Dump();
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+/*
+* @file         oled_fake.c
+* @brief        PC上的SSD1306替身
+* @details      命令按字节流解析(ssd1306.c逐字节发送命令，参数可能分在几次传输里)，
+*               只处理寻址窗口(0x21/0x22)和重映射(0xA0/0xA1、0xC0/0xC8)，其它命令只跳过参数
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <string.h>
+#include "oled_fake.h"
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+int64_t g_oled_fake_us;
+
+//模拟显存和寻址状态
+static uint8_t g_ram[SSD1306_PAGES][SSD1306_WIDTH];
+static uint8_t g_col_start, g_col_end, g_page_start, g_page_end;
+static uint8_t g_col, g_page;
+static bool g_seg_remap, g_com_remap;
+//正在接收参数的命令和已收到的参数
+static uint8_t g_cmd, g_args[2], g_nargs, g_want;
+static OledFake_Stats_t g_stats;
+
+static esp_err_t fake_init(void);
+static esp_err_t fake_write_cmds(const uint8_t *cmds, uint16_t len);
+static esp_err_t fake_write_data(const uint8_t *data, uint16_t len);
+
+//测试程序经SSD1306_InitWithTransport使用的假传输层，时序参数由OledFake_Reset设置
+SSD1306_Transport_t g_oled_fake_transport = {
+    .name = "i2c",
+    .init = fake_init,
+    .write_cmds = fake_write_cmds,
+    .write_data = fake_write_data,
+    .sync = NULL,
+    .clock_hz = 400000,
+    .bits_per_byte = 9,
+    .txn_overhead_bits = 20,
+    .txn_overhead_us = 60,
+};
+//SSD1306_Init默认使用的传输层，回调与上面相同
+SSD1306_Transport_t SSD1306_TransportI2C = {
+    .name = "i2c",
+    .init = fake_init,
+    .write_cmds = fake_write_cmds,
+    .write_data = fake_write_data,
+    .sync = NULL,
+    .clock_hz = 400000,
+    .bits_per_byte = 9,
+    .txn_overhead_bits = 20,
+    .txn_overhead_us = 60,
+};
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+static esp_err_t fake_init(void)
+{
+    return ESP_OK;
+}
+
+//命令的参数个数
+static uint8_t cmd_args(uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case 0x21: case 0x22:
+            return 2;
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void exec_cmd(void)
+{
+    switch (g_cmd)
+    {
+        case 0x21:
+            g_col_start = g_col = g_args[0] & 0x7F;
+            g_col_end = g_args[1] & 0x7F;
+            break;
+        case 0x22:
+            g_page_start = g_page = g_args[0] & 0x07;
+            g_page_end = g_args[1] & 0x07;
+            break;
+        case 0xA0: case 0xA1:
+            g_seg_remap = g_cmd & 1;
+            break;
+        case 0xC0: case 0xC8:
+            g_com_remap = (g_cmd == 0xC8);
+            break;
+        default:
+            break;
+    }
+}
+
+static void account(uint32_t bytes)
+{
+    uint32_t us = SSD1306_TransportCostUs(&g_oled_fake_transport, bytes, 1);
+
+    g_stats.bus_us += us;
+    g_oled_fake_us += us;
+}
+
+static esp_err_t fake_write_cmds(const uint8_t *cmds, uint16_t len)
+{
+    uint16_t i;
+
+    for (i = 0; i < len; i ++)
+    {
+        if (g_want)
+        {
+            g_args[g_nargs ++] = cmds[i];
+            g_want --;
+        }
+        else
+        {
+            g_cmd = cmds[i];
+            g_nargs = 0;
+            g_want = cmd_args(g_cmd);
+        }
+        if (g_want == 0)
+        {
+            exec_cmd();
+        }
+    }
+    g_stats.cmd_txns ++;
+    account(len);
+    return ESP_OK;
+}
+
+//水平寻址:列到窗口末尾回到起始列并换页，页到末尾回到起始页
+static esp_err_t fake_write_data(const uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+
+    for (i = 0; i < len; i ++)
+    {
+        g_ram[g_page][g_col] = data[i];
+        if (g_col == g_col_end)
+        {
+            g_col = g_col_start;
+            g_page = (g_page == g_page_end) ? g_page_start : g_page + 1;
+        }
+        else
+        {
+            g_col = (g_col + 1) & 0x7F;
+        }
+    }
+    g_stats.data_txns ++;
+    g_stats.data_bytes += len;
+    account(len);
+    return ESP_OK;
+}
+
+void OledFake_Reset(const char *name, uint32_t clock_hz, uint8_t bits_per_byte,
+                    uint16_t overhead_bits, uint16_t overhead_us)
+{
+    memset(g_ram, 0, sizeof(g_ram));
+    g_col_start = g_col = 0;
+    g_col_end = SSD1306_WIDTH - 1;
+    g_page_start = g_page = 0;
+    g_page_end = SSD1306_PAGES - 1;
+    g_seg_remap = 1;
+    g_com_remap = 1;
+    g_want = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_oled_fake_transport.name = name;
+    g_oled_fake_transport.clock_hz = clock_hz;
+    g_oled_fake_transport.bits_per_byte = bits_per_byte;
+    g_oled_fake_transport.txn_overhead_bits = overhead_bits;
+    g_oled_fake_transport.txn_overhead_us = overhead_us;
+}
+
+//屏幕坐标(sx,sy)处看到的像素
+bool OledFake_ScreenPixel(uint16_t sx, uint16_t sy)
+{
+    uint16_t col = g_seg_remap ? sx : SSD1306_WIDTH - 1 - sx;
+    uint16_t row = g_com_remap ? sy : SSD1306_HEIGHT - 1 - sy;
+
+    return (g_ram[row >> 3][col] >> (row & 7)) & 1;
+}
+
+void OledFake_GetStats(OledFake_Stats_t *stats, bool reset)
+{
+    *stats = g_stats;
+    if (reset)
+    {
+        memset(&g_stats, 0, sizeof(g_stats));
+    }
+}
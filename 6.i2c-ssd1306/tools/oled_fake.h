@@ -0,0 +1,61 @@
+/*
+* @file         oled_fake.h
+* @brief        PC上的SSD1306替身
+* @details      提供假传输层g_oled_fake_transport(回调同时以SSD1306_TransportI2C的名字供SSD1306_Init使用)，
+*               解析收到的命令，按水平寻址模式把数据写入128x8页的模拟显存，并按段重映射/COM扫描方向
+*               给出屏幕上看到的像素(以0度的0xA1/0xC8为屏幕正方向)；
+*               同时按OledFake_Reset给出的时钟参数累计模拟的总线时间，供各测试程序使用
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef OLED_FAKE_H
+#define OLED_FAKE_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "ssd1306.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+//传输统计
+typedef struct {
+	uint32_t cmd_txns;              /*!< 命令传输次数 */
+	uint32_t data_txns;             /*!< 数据传输次数 */
+	uint32_t data_bytes;            /*!< 数据字节数 */
+	uint64_t bus_us;                /*!< 按传输层时钟参数估算的总线时间 */
+} OledFake_Stats_t;
+
+//传输层时序参数，与ssd1306_i2c.c/ssd1306_spi.c一致，用作OledFake_Reset的参数
+#define OLED_FAKE_I2C(hz)           "i2c", (hz), 9, 20, 60
+#define OLED_FAKE_SPI(hz)           "spi", (hz), 8, 0, 15
+
+//模拟时钟(us)，每次传输前进估算的总线时间
+extern int64_t g_oled_fake_us;
+//时序参数随OledFake_Reset变化的假传输层，需要按传输层估算时间的测试用SSD1306_InitWithTransport选用
+extern SSD1306_Transport_t g_oled_fake_transport;
+
+
+void OledFake_Reset(const char *name, uint32_t clock_hz, uint8_t bits_per_byte,
+                    uint16_t overhead_bits, uint16_t overhead_us);
+bool OledFake_ScreenPixel(uint16_t sx, uint16_t sy);
+void OledFake_GetStats(OledFake_Stats_t *stats, bool reset);
+
+static inline double OledFake_NowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#endif
@@ -0,0 +1,258 @@
+/*
+* @file         ssd1306_draw_bench.c
+* @brief        SSD1306画线/画圆在PC上的校验与性能测试
+* @details      1. 随机线段和圆(部分或全部超出画布、三种颜色、有无视口和裁剪区)，
+*                  与逐点调用SSD1306_DrawPixel的参考实现比较显存
+*               2. 每个像素的耗时，与逐点调用SSD1306_DrawPixel对比
+*               编译: gcc -O2 -I../../tools/host_stub -I../components/bsp/include ssd1306_draw_bench.c oled_fake.c
+*                     ../components/bsp/ssd1306.c -o ssd1306_draw_bench
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "ssd1306_pixel.h"
+#include "oled_fake.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define CHECK_ROUNDS                20000
+#define BENCH_ROUNDS                200000
+#define BUFFER_SIZE                 (SSD1306_WIDTH * SSD1306_PAGES)
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static uint8_t g_background[BUFFER_SIZE];
+static uint8_t g_result[BUFFER_SIZE];
+//参考实现画的点数
+static uint32_t g_plots;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+//参考实现:与ssd1306.c相同的Bresenham，每点经过SSD1306_DrawPixel的裁剪
+static void ref_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, SSD1306_COLOR_t c)
+{
+    int16_t dx = abs(x1 - x0), dy = abs(y1 - y0);
+    int16_t sx = (x0 < x1) ? 1 : -1, sy = (y0 < y1) ? 1 : -1;
+    int16_t err = ((dx > dy) ? dx : -dy) / 2, e2;
+
+    while (1)
+    {
+        SSD1306_DrawPixel(x0, y0, c);
+        g_plots ++;
+        if (x0 == x1 && y0 == y1)
+        {
+            break;
+        }
+        e2 = err;
+        if (e2 > -dx)
+        {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dy)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+//参考实现:中点画圆，对角线上的点只画一次
+static void ref_circle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t c)
+{
+    int16_t f = 1 - r, ddf_x = 1, ddf_y = -2 * r, x = 0, y = r;
+
+    SSD1306_DrawPixel(x0, y0 + r, c);
+    SSD1306_DrawPixel(x0, y0 - r, c);
+    SSD1306_DrawPixel(x0 + r, y0, c);
+    SSD1306_DrawPixel(x0 - r, y0, c);
+    g_plots += 4;
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y --;
+            ddf_y += 2;
+            f += ddf_y;
+        }
+        x ++;
+        ddf_x += 2;
+        f += ddf_x;
+        SSD1306_DrawPixel(x0 + x, y0 + y, c);
+        SSD1306_DrawPixel(x0 - x, y0 + y, c);
+        SSD1306_DrawPixel(x0 + x, y0 - y, c);
+        SSD1306_DrawPixel(x0 - x, y0 - y, c);
+        g_plots += 4;
+        if (x == y)
+        {
+            break;
+        }
+        SSD1306_DrawPixel(x0 + y, y0 + x, c);
+        SSD1306_DrawPixel(x0 - y, y0 + x, c);
+        SSD1306_DrawPixel(x0 + y, y0 - x, c);
+        SSD1306_DrawPixel(x0 - y, y0 - x, c);
+        g_plots += 4;
+    }
+}
+
+static int16_t rnd(int16_t lo, int16_t hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+//随机设置视口/裁剪区，返回压栈次数
+static int push_random_clip(void)
+{
+    switch (rand() % 3)
+    {
+        case 1:
+            SSD1306_PushViewport(rnd(-20, 100), rnd(-20, 50), rnd(1, 100), rnd(1, 60));
+            return 1;
+        case 2:
+            SSD1306_PushClip(rnd(0, 100), rnd(0, 50), rnd(1, 60), rnd(1, 40));
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int check(void)
+{
+    int16_t x0, y0, x1, y1, r;
+    SSD1306_COLOR_t c;
+    bool circle;
+    int i, n, errors = 0, lines = 0, circles = 0;
+
+    for (i = 0; i < CHECK_ROUNDS; i ++)
+    {
+        for (n = 0; n < BUFFER_SIZE; n ++)
+        {
+            g_background[n] = rand();
+        }
+        circle = rand() & 1;
+        c = (SSD1306_COLOR_t)(rand() % 3);
+        x0 = rnd(-40, 170);
+        y0 = rnd(-40, 110);
+        x1 = (rand() % 4) ? rnd(-40, 170) : x0;          //也覆盖横线、竖线
+        y1 = (rand() % 4) ? rnd(-40, 110) : y0;
+        r = rnd(0, 70);
+        n = push_random_clip();
+
+        memcpy(g_oled_buffer, g_background, BUFFER_SIZE);
+        if (circle)
+        {
+            SSD1306_DrawCircle(x0, y0, r, c);
+        }
+        else
+        {
+            SSD1306_DrawLine(x0, y0, x1, y1, c);
+        }
+        memcpy(g_result, g_oled_buffer, BUFFER_SIZE);
+
+        memcpy(g_oled_buffer, g_background, BUFFER_SIZE);
+        if (circle)
+        {
+            ref_circle(x0, y0, r, c);
+        }
+        else
+        {
+            ref_line(x0, y0, x1, y1, c);
+        }
+        if (memcmp(g_result, g_oled_buffer, BUFFER_SIZE))
+        {
+            if (errors < 5)
+            {
+                printf("%s (%d,%d)-(%d,%d) color %d differs from reference\n",
+                       circle ? "circle" : "line", x0, y0, x1, y1, c);
+            }
+            errors ++;
+        }
+        while (n --)
+        {
+            SSD1306_PopViewport();
+        }
+        circle ? circles ++ : lines ++;
+    }
+    printf("%d lines, %d circles, %s\n", lines, circles, errors ? "FAILED" : "ok");
+    return errors;
+}
+
+static void bench(void)
+{
+    double t0, line, line_ref, circle, circle_ref;
+    uint32_t line_px, circle_px;
+    int i;
+
+    g_plots = 0;
+    ref_line(0, 0, 127, 63, SSD1306_COLOR_XOR);
+    line_px = g_plots;
+    g_plots = 0;
+    ref_circle(64, 32, 30, SSD1306_COLOR_XOR);
+    circle_px = g_plots;
+
+    //斜线和r=30的圆，都在画布内
+    t0 = OledFake_NowNs();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        SSD1306_DrawLine(0, i & 63, 127, 63 - (i & 63), SSD1306_COLOR_XOR);
+    }
+    line = (OledFake_NowNs() - t0) / BENCH_ROUNDS / line_px;
+    t0 = OledFake_NowNs();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        ref_line(0, i & 63, 127, 63 - (i & 63), SSD1306_COLOR_XOR);
+    }
+    line_ref = (OledFake_NowNs() - t0) / BENCH_ROUNDS / line_px;
+
+    t0 = OledFake_NowNs();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        SSD1306_DrawCircle(64, 32, 30, SSD1306_COLOR_XOR);
+    }
+    circle = (OledFake_NowNs() - t0) / BENCH_ROUNDS / circle_px;
+    t0 = OledFake_NowNs();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        ref_circle(64, 32, 30, SSD1306_COLOR_XOR);
+    }
+    circle_ref = (OledFake_NowNs() - t0) / BENCH_ROUNDS / circle_px;
+
+    printf("line:   %.2f ns/px, per-pixel DrawPixel %.2f ns/px\n", line, line_ref);
+    printf("circle: %.2f ns/px, per-pixel DrawPixel %.2f ns/px\n", circle, circle_ref);
+}
+
+int main(void)
+{
+    int errors;
+
+    OledFake_Reset(OLED_FAKE_I2C(400000));
+    if (SSD1306_Init() != ESP_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    SSD1306_SetAutoUpdate(0);
+    errors = check();
+    bench();
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,378 @@
+/*
+* @file         ssd1306_gray_bench.c
+* @brief        SSD1306时间抖动灰度在PC上的校验与刷新率测试
+* @details      用替身的FreeRTOS/esp_timer在模拟时间上运行刷新任务:每次等通知就前进到下一个
+*               子帧时刻(刷新超时则按错过的子帧数返回)，传输按传输层时钟参数占用模拟时间
+*               1. 创建定时器/任务失败时返回错误并释放已创建的部分，之后能正常启动；
+*                  启动定时器失败时恢复自动刷新；灰度绘图与刷新任务互斥
+*               2. 随机灰度矩形，连续3个子帧在替身屏幕上点亮的次数等于灰度
+*               3. 不同传输层和灰度频率下能否启动、实际整屏刷新率、错过的子帧数
+*               编译: gcc -O2 -I../../tools/host_stub -I../components/bsp/include ssd1306_gray_bench.c oled_fake.c
+*                     ../components/bsp/ssd1306.c ../components/bsp/ssd1306_gray.c -o ssd1306_gray_bench
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "ssd1306.h"
+#include "ssd1306_gray.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "oled_fake.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define RUN_US                      2000000             //每种配置模拟运行的时间
+#define LEVEL_RECTS                 40
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static TaskFunction_t g_task_fn;
+static jmp_buf g_task_exit;
+static int64_t g_run_end_us;
+//替身定时器:下一个子帧时刻和周期
+static int64_t g_next_fire_us;
+static uint64_t g_period_us;
+//创建失败注入和未释放对象计数
+static bool g_fail_timer, g_fail_task, g_fail_start;
+static int g_live_timers, g_live_mutexes;
+static uint32_t g_mutex_takes;
+//采样:每个子帧开始时记下屏幕，连续3个子帧的点亮次数
+static uint8_t g_on_count[SSD1306_HEIGHT][SSD1306_WIDTH];
+static uint32_t g_samples;
+static bool g_sampling;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    g_live_mutexes ++;
+    return malloc(1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    g_live_mutexes --;
+    free(sem);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout)
+{
+    (void)sem;
+    (void)timeout;
+    g_mutex_takes ++;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle)
+{
+    (void)args;
+    if (g_fail_timer)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    g_live_timers ++;
+    *handle = (esp_timer_handle_t)malloc(1);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    g_live_timers --;
+    free(timer);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    (void)timer;
+    if (g_fail_start)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_period_us = period_us;
+    g_next_fire_us = g_oled_fake_us + period_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    (void)timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return g_oled_fake_us;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle)
+{
+    (void)name;
+    (void)stack;
+    (void)arg;
+    (void)prio;
+    if (g_fail_task)
+    {
+        return 0;
+    }
+    g_task_fn = fn;
+    *handle = (TaskHandle_t)fn;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    (void)ticks;
+}
+
+void xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+}
+
+//刷新任务等子帧:前进到下一个子帧时刻，刷新超时时一次返回错过的子帧数
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t timeout)
+{
+    uint32_t n = 1;
+    uint16_t x, y;
+
+    (void)clear;
+    (void)timeout;
+    if (g_sampling)
+    {
+        for (y = 0; y < SSD1306_HEIGHT; y ++)
+        {
+            for (x = 0; x < SSD1306_WIDTH; x ++)
+            {
+                g_on_count[y][x] += OledFake_ScreenPixel(x, y);
+            }
+        }
+        g_samples ++;
+    }
+    if (g_oled_fake_us < g_next_fire_us)
+    {
+        g_oled_fake_us = g_next_fire_us;
+    }
+    else
+    {
+        n = (uint32_t)((g_oled_fake_us - g_next_fire_us) / g_period_us) + 1;
+    }
+    g_next_fire_us += (int64_t)n * g_period_us;
+    if (g_oled_fake_us >= g_run_end_us)
+    {
+        longjmp(g_task_exit, 1);
+    }
+    return n;
+}
+
+//在模拟时间上运行刷新任务
+static void run_task(int64_t us)
+{
+    g_run_end_us = g_oled_fake_us + us;
+    if (setjmp(g_task_exit) == 0)
+    {
+        g_task_fn(NULL);
+    }
+}
+
+static int check_unwind(void)
+{
+    OledFake_Stats_t fs;
+    uint32_t takes;
+    esp_err_t ret;
+    int errors = 0;
+
+    g_fail_task = 1;
+    ret = SSD1306_GrayStart(0);
+    g_fail_task = 0;
+    if (ret != ESP_ERR_NO_MEM || g_live_timers || g_live_mutexes)
+    {
+        printf("task create failure: ret %d, %d timers, %d mutexes left\n", ret, g_live_timers, g_live_mutexes);
+        errors ++;
+    }
+    g_fail_timer = 1;
+    ret = SSD1306_GrayStart(0);
+    g_fail_timer = 0;
+    if (ret != ESP_ERR_NO_MEM || g_live_timers || g_live_mutexes)
+    {
+        printf("timer create failure: ret %d, %d timers, %d mutexes left\n", ret, g_live_timers, g_live_mutexes);
+        errors ++;
+    }
+    ret = SSD1306_GrayStart(0);
+    if (ret != ESP_OK || g_live_timers != 1 || g_live_mutexes != 1)
+    {
+        printf("start after failures: ret %d, %d timers, %d mutexes\n", ret, g_live_timers, g_live_mutexes);
+        errors ++;
+    }
+    takes = g_mutex_takes;
+    SSD1306_GrayFillRectangle(0, 0, 3, 3, 1);
+    SSD1306_GrayCopyMono();
+    if (g_mutex_takes - takes != 2)
+    {
+        printf("gray drawing took the lock %u times, expected 2\n", g_mutex_takes - takes);
+        errors ++;
+    }
+    SSD1306_GrayStop();
+
+    //定时器启动失败:不进入灰度模式，单色绘图照常自动刷新，GrayStop不再刷新
+    g_fail_start = 1;
+    ret = SSD1306_GrayStart(0);
+    g_fail_start = 0;
+    OledFake_GetStats(&fs, 1);
+    SSD1306_GrayStop();
+    OledFake_GetStats(&fs, 1);
+    if (ret == ESP_OK || fs.data_txns)
+    {
+        printf("timer start failure: ret %d, GrayStop flushed %u times\n", ret, fs.data_txns);
+        errors ++;
+    }
+    SSD1306_DrawLine(0, 0, 3, 0, SSD1306_COLOR_WHITE);
+    OledFake_GetStats(&fs, 1);
+    if (fs.data_txns == 0)
+    {
+        printf("timer start failure: auto update not restored\n");
+        errors ++;
+    }
+    printf("init unwind: %s\n", errors ? "FAILED" : "ok");
+    return errors;
+}
+
+static int check_levels(void)
+{
+    static uint8_t expect[SSD1306_HEIGHT][SSD1306_WIDTH];
+    int16_t x, y, w, h, i, j;
+    uint8_t level;
+    int errors = 0;
+
+    memset(expect, 0, sizeof(expect));
+    SSD1306_GrayClear();
+    for (i = 0; i < LEVEL_RECTS; i ++)
+    {
+        x = rand() % 160 - 16;
+        y = rand() % 90 - 13;
+        w = rand() % 40;
+        h = rand() % 30;
+        level = rand() % SSD1306_GRAY_LEVELS;
+        SSD1306_GrayFillRectangle(x, y, w, h, level);
+        for (j = 0; j <= h * (w + 1) + w; j ++)
+        {
+            int16_t px = x + j % (w + 1), py = y + j / (w + 1);
+            if (px >= 0 && px < SSD1306_WIDTH && py >= 0 && py < SSD1306_HEIGHT)
+            {
+                expect[py][px] = level;
+            }
+        }
+    }
+
+    //跳过第一个子帧(之前显示的内容)，再采样3个子帧
+    if (SSD1306_GrayStart(0) != ESP_OK)
+    {
+        printf("gray start failed\n");
+        return 1;
+    }
+    run_task(g_period_us + 1);
+    memset(g_on_count, 0, sizeof(g_on_count));
+    g_samples = 0;
+    g_sampling = 1;
+    run_task(g_period_us * SSD1306_GRAY_SUBFRAMES);
+    g_sampling = 0;
+    SSD1306_GrayStop();
+
+    for (y = 0; y < SSD1306_HEIGHT; y ++)
+    {
+        for (x = 0; x < SSD1306_WIDTH; x ++)
+        {
+            if (g_on_count[y][x] != expect[y][x])
+            {
+                if (errors < 5)
+                {
+                    printf("pixel (%d,%d) level %u lit in %u of %u subframes\n",
+                           x, y, expect[y][x], g_on_count[y][x], g_samples);
+                }
+                errors ++;
+            }
+        }
+    }
+    printf("levels: %d rects, %u subframes sampled, %s\n", LEVEL_RECTS, g_samples, errors ? "FAILED" : "ok");
+    return errors;
+}
+
+static void bench(const char *name, uint32_t clock_hz, uint8_t bits_per_byte,
+                  uint16_t overhead_bits, uint16_t overhead_us)
+{
+    static const uint8_t rates[] = {30, 60, 90};
+    SSD1306_GrayStats_t stats;
+    esp_err_t ret;
+    uint8_t i;
+
+    OledFake_Reset(name, clock_hz, bits_per_byte, overhead_bits, overhead_us);
+    for (i = 0; i < sizeof(rates); i ++)
+    {
+        ret = SSD1306_GrayStart(rates[i]);
+        if (ret != ESP_OK)
+        {
+            printf("%s %5ukHz %2uHz: estimate %5u us > subframe %5u us, not started\n", name,
+                   clock_hz / 1000, rates[i], SSD1306_FrameCostUs(SSD1306_GetTransport()),
+                   1000000 / (rates[i] * SSD1306_GRAY_SUBFRAMES));
+            continue;
+        }
+        run_task(RUN_US);
+        SSD1306_GrayGetStats(&stats);
+        SSD1306_GrayStop();
+        printf("%s %5ukHz %2uHz: estimate %5u us, subframe %5u us, flush %5u us, "
+               "%3u flushes/s (ideal %3u), missed %u\n", name, clock_hz / 1000, rates[i],
+               stats.estimate_us, stats.subframe_us, stats.flush_us_max, stats.flush_rate,
+               rates[i] * 2, stats.missed);
+    }
+}
+
+int main(void)
+{
+    int errors = 0;
+
+    OledFake_Reset(OLED_FAKE_SPI(8000000));
+    if (SSD1306_InitWithTransport(&g_oled_fake_transport) != ESP_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    errors += check_unwind();
+    errors += check_levels();
+    bench(OLED_FAKE_I2C(400000));
+    bench(OLED_FAKE_I2C(1000000));
+    bench(OLED_FAKE_SPI(8000000));
+    bench(OLED_FAKE_SPI(10000000));
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
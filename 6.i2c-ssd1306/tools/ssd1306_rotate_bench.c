@@ -0,0 +1,214 @@
+/*
+* @file         ssd1306_rotate_bench.c
+* @brief        SSD1306旋转刷新在PC上的校验与性能测试
+* @details      1. 4个方向下随机画点并刷新，检查替身屏幕上每个像素的位置符合顺时针旋转
+*               2. 再翻转几个点做局部刷新，检查转置后的物理脏区和发送字节数
+*               3. 整屏刷新的CPU耗时:0度直接发送、90度8x8块转置、逐位转置的参考实现
+*               编译: gcc -O2 -I../../tools/host_stub -I../components/bsp/include ssd1306_rotate_bench.c oled_fake.c
+*                     ../components/bsp/ssd1306.c -o ssd1306_rotate_bench
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "oled_fake.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define BENCH_FRAMES                20000
+#define RANDOM_PIXELS               1500
+#define PARTIAL_PIXELS              5
+#define BENCH_I2C_HZ                400000
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+//期望的逻辑画布内容，[y][x]
+static uint8_t g_expect[SSD1306_WIDTH][SSD1306_WIDTH];
+//参考转置的输入(90度的逻辑画布)和输出
+static uint8_t g_ref_src[SSD1306_HEIGHT * SSD1306_MAX_PAGES];
+static uint8_t g_ref_txbuf[SSD1306_WIDTH * SSD1306_PAGES];
+static volatile uint8_t g_sink;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+//逻辑坐标在屏幕上的位置(顺时针旋转)
+static void screen_pos(SSD1306_ROTATION_t rot, uint16_t x, uint16_t y, uint16_t *sx, uint16_t *sy)
+{
+    switch (rot)
+    {
+        case SSD1306_ROTATION_90:  *sx = SSD1306_WIDTH - 1 - y; *sy = x; break;
+        case SSD1306_ROTATION_180: *sx = SSD1306_WIDTH - 1 - x; *sy = SSD1306_HEIGHT - 1 - y; break;
+        case SSD1306_ROTATION_270: *sx = y; *sy = SSD1306_HEIGHT - 1 - x; break;
+        default:                   *sx = x; *sy = y; break;
+    }
+}
+
+static int check_screen(SSD1306_ROTATION_t rot, const char *step)
+{
+    uint16_t w = SSD1306_GetWidth(), h = SSD1306_GetHeight();
+    uint16_t x, y, sx, sy;
+    int errors = 0;
+
+    for (y = 0; y < h; y ++)
+    {
+        for (x = 0; x < w; x ++)
+        {
+            screen_pos(rot, x, y, &sx, &sy);
+            if (OledFake_ScreenPixel(sx, sy) != g_expect[y][x])
+            {
+                if (errors < 5)
+                {
+                    printf("rotation %d %s: logical (%u,%u) screen (%u,%u) wrong\n",
+                           rot * 90, step, x, y, sx, sy);
+                }
+                errors ++;
+            }
+        }
+    }
+    return errors;
+}
+
+static int check_rotation(SSD1306_ROTATION_t rot)
+{
+    OledFake_Stats_t stats;
+    uint16_t w, h, x, y;
+    int errors, i;
+
+    SSD1306_SetRotation(rot);
+    w = SSD1306_GetWidth();
+    h = SSD1306_GetHeight();
+    memset(g_expect, 0, sizeof(g_expect));
+    SSD1306_Fill(SSD1306_COLOR_BLACK);
+    for (i = 0; i < RANDOM_PIXELS; i ++)
+    {
+        x = rand() % w;
+        y = rand() % h;
+        SSD1306_DrawPixel(x, y, SSD1306_COLOR_WHITE);
+        g_expect[y][x] = 1;
+    }
+    SSD1306_UpdateScreen();
+    errors = check_screen(rot, "full");
+
+    //局部刷新:只发送翻转过的点所在的列(竖屏为8列的块)
+    OledFake_GetStats(&stats, 1);
+    for (i = 0; i < PARTIAL_PIXELS; i ++)
+    {
+        x = rand() % w;
+        y = rand() % h;
+        g_expect[y][x] ^= 1;
+        SSD1306_DrawPixel(x, y, g_expect[y][x] ? SSD1306_COLOR_WHITE : SSD1306_COLOR_BLACK);
+    }
+    SSD1306_UpdateScreen();
+    errors += check_screen(rot, "partial");
+    OledFake_GetStats(&stats, 1);
+    printf("rotation %3d: %ux%u, partial update of %d pixels sent %u bytes in %u txns, %s\n",
+           rot * 90, w, h, PARTIAL_PIXELS, stats.data_bytes, stats.cmd_txns + stats.data_txns,
+           errors ? "FAILED" : "ok");
+    return errors;
+}
+
+//逐位转置的参考实现:逻辑(lx,ly)->物理(px=ly,py=lx)
+static void ref_transpose(void)
+{
+    uint16_t lx, ly;
+
+    memset(g_ref_txbuf, 0, sizeof(g_ref_txbuf));
+    for (ly = 0; ly < SSD1306_WIDTH; ly ++)
+    {
+        for (lx = 0; lx < SSD1306_HEIGHT; lx ++)
+        {
+            if (g_ref_src[lx + (ly >> 3) * SSD1306_HEIGHT] & (1 << (ly & 7)))
+            {
+                g_ref_txbuf[(lx >> 3) * SSD1306_WIDTH + ly] |= 1 << (lx & 7);
+            }
+        }
+    }
+}
+
+static void bench(void)
+{
+    OledFake_Stats_t stats;
+    double t0, flat, rot, ref;
+    int i;
+
+    //交替填满黑白，每帧整屏都是脏的
+    SSD1306_SetRotation(SSD1306_ROTATION_0);
+    t0 = OledFake_NowNs();
+    for (i = 0; i < BENCH_FRAMES; i ++)
+    {
+        SSD1306_Fill((i & 1) ? SSD1306_COLOR_WHITE : SSD1306_COLOR_BLACK);
+        SSD1306_UpdateScreen();
+    }
+    flat = (OledFake_NowNs() - t0) / BENCH_FRAMES;
+
+    SSD1306_SetRotation(SSD1306_ROTATION_90);
+    OledFake_GetStats(&stats, 1);
+    t0 = OledFake_NowNs();
+    for (i = 0; i < BENCH_FRAMES; i ++)
+    {
+        SSD1306_Fill((i & 1) ? SSD1306_COLOR_WHITE : SSD1306_COLOR_BLACK);
+        SSD1306_UpdateScreen();
+    }
+    rot = (OledFake_NowNs() - t0) / BENCH_FRAMES;
+    OledFake_GetStats(&stats, 1);
+
+    for (i = 0; i < (int)sizeof(g_ref_src); i ++)
+    {
+        g_ref_src[i] = rand();
+    }
+    t0 = OledFake_NowNs();
+    for (i = 0; i < BENCH_FRAMES; i ++)
+    {
+        g_ref_src[i & 0x3FF] ^= 1;
+        ref_transpose();
+        g_sink += g_ref_txbuf[i & 0x3FF];
+    }
+    ref = (OledFake_NowNs() - t0) / BENCH_FRAMES;
+
+    printf("full frame cpu: 0deg %.0f ns, 90deg %.0f ns (transpose %.0f ns), bit-by-bit reference %.0f ns\n",
+           flat, rot, rot - flat, ref);
+    printf("90deg full frame at %ukHz i2c: %u txns, bus %u us per frame\n",
+           BENCH_I2C_HZ / 1000, (stats.cmd_txns + stats.data_txns) / BENCH_FRAMES,
+           (uint32_t)(stats.bus_us / BENCH_FRAMES));
+}
+
+int main(void)
+{
+    int errors = 0;
+
+    OledFake_Reset(OLED_FAKE_I2C(BENCH_I2C_HZ));
+    if (SSD1306_Init() != ESP_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    SSD1306_SetAutoUpdate(0);
+    errors += check_rotation(SSD1306_ROTATION_0);
+    errors += check_rotation(SSD1306_ROTATION_90);
+    errors += check_rotation(SSD1306_ROTATION_180);
+    errors += check_rotation(SSD1306_ROTATION_270);
+    //横竖屏来回切换后仍正确
+    errors += check_rotation(SSD1306_ROTATION_90);
+    errors += check_rotation(SSD1306_ROTATION_0);
+    bench();
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
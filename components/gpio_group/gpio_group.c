@@ -0,0 +1,184 @@
+/*
+* @file         gpio_group.c
+* @brief        GPIO组原子写
+* @details      掩码计算与寄存器写分开:GpioGroup_Define/Compile/BuildTable只做位运算，
+*               可在PC上用tools/gpio_group_check.c校验；GpioGroup_Init额外配置引脚为输出
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "gpio_group.h"
+#include "string.h"
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 定义引脚组并计算各引脚的寄存器位，不操作硬件
+ * 先检查全部引脚再写入，出错时group保持原样
+ * @param[out]  group    引脚组
+ * @param[in]   pins     引脚列表，图样第i位对应pins[i]
+ * @param[in]   count    引脚数，不超过GPIO_GROUP_MAX_PINS
+ * @param[in]   invert   反相掩码，第i位为1时pins[i]低电平有效
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG  引脚数错误、不能输出或重复
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 先检查全部引脚，出错时不修改group\n
+ */
+esp_err_t GpioGroup_Define(GpioGroup_t *group, const gpio_num_t *pins, uint8_t count, uint32_t invert)
+{
+    uint64_t all = 0, bit;
+    uint8_t i;
+
+    if (count == 0 || count > GPIO_GROUP_MAX_PINS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (i = 0; i < count; i ++)
+    {
+        if (!GPIO_IS_VALID_OUTPUT_GPIO(pins[i]))
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        bit = 1ULL << pins[i];
+        if (all & bit)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        all |= bit;
+    }
+
+    memset(group, 0, sizeof(*group));
+    for (i = 0; i < count; i ++)
+    {
+        if (pins[i] < 32)
+        {
+            group->bit_lo[i] = 1UL << pins[i];
+        }
+        else
+        {
+            group->bit_hi[i] = 1UL << (pins[i] - 32);
+        }
+        group->pin[i] = pins[i];
+    }
+    group->all_lo = (uint32_t)all;
+    group->all_hi = (uint32_t)(all >> 32);
+    group->count = count;
+    group->invert = invert & ((1UL << count) - 1);
+    return ESP_OK;
+}
+
+/**
+ * 定义引脚组并把引脚配置为推挽输出
+ * @param[out]  group    引脚组
+ * @param[in]   pins     引脚列表
+ * @param[in]   count    引脚数
+ * @param[in]   invert   反相掩码
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t GpioGroup_Init(GpioGroup_t *group, const gpio_num_t *pins, uint8_t count, uint32_t invert)
+{
+    gpio_config_t cfg;
+    esp_err_t ret;
+
+    ret = GpioGroup_Define(group, pins, count, invert);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    cfg.pin_bit_mask = ((uint64_t)group->all_hi << 32) | group->all_lo;
+    cfg.mode = GPIO_MODE_OUTPUT;
+    cfg.pull_up_en = GPIO_PULLUP_DISABLE;
+    cfg.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    cfg.intr_type = GPIO_INTR_DISABLE;
+    return gpio_config(&cfg);
+}
+
+/**
+ * 计算图样对应的置位/清零掩码，组外引脚不受影响
+ * @param[in]   group     引脚组
+ * @param[in]   pattern   图样，第i位为1表示第i个引脚有效(已考虑反相)
+ * @param[out]  masks     掩码
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void GpioGroup_Compile(const GpioGroup_t *group, uint32_t pattern, GpioGroup_Masks_t *masks)
+{
+    uint32_t level = pattern ^ group->invert;
+    uint8_t i;
+
+    masks->set_lo = 0;
+    masks->set_hi = 0;
+    for (i = 0; i < group->count; i ++)
+    {
+        if (level & (1UL << i))
+        {
+            masks->set_lo |= group->bit_lo[i];
+            masks->set_hi |= group->bit_hi[i];
+        }
+    }
+    masks->clr_lo = group->all_lo & ~masks->set_lo;
+    masks->clr_hi = group->all_hi & ~masks->set_hi;
+}
+
+/**
+ * 预先计算图样0~size-1的掩码表
+ * @param[in]   group   引脚组
+ * @param[out]  table   掩码表
+ * @param[in]   size    表长度，超过2^count时只填前2^count项
+ * @retval      填写的项数
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+uint16_t GpioGroup_BuildTable(const GpioGroup_t *group, GpioGroup_Masks_t *table, uint16_t size)
+{
+    uint32_t patterns = 1UL << group->count;
+    uint16_t i;
+
+    if (size > patterns)
+    {
+        size = patterns;
+    }
+    for (i = 0; i < size; i ++)
+    {
+        GpioGroup_Compile(group, i, &table[i]);
+    }
+    return size;
+}
+
+/**
+ * 输出图样(现算掩码)，频繁切换的图样建议用GpioGroup_BuildTable+GpioGroup_Apply
+ * @param[in]   group     引脚组
+ * @param[in]   pattern   图样
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void GpioGroup_Write(const GpioGroup_t *group, uint32_t pattern)
+{
+    GpioGroup_Masks_t masks;
+
+    GpioGroup_Compile(group, pattern, &masks);
+    GpioGroup_Apply(&masks);
+}
@@ -0,0 +1,88 @@
+/*
+* @file         gpio_group.h
+* @brief        GPIO组原子写
+* @details      把若干输出引脚定义为一组，组内第i位对应第i个引脚；写一个图样时先算好
+*               置位/清零掩码，再一次写W1TS、一次写W1TC寄存器(GPIO32~33再各写一次)，
+*               不经过驱动函数，也不会出现逐个引脚变化的中间状态
+*               常用图样可以用GpioGroup_BuildTable预先算成表，写入时只剩寄存器操作，
+*               适合多灯图样切换和软件模拟时序
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef GPIO_GROUP_H
+#define GPIO_GROUP_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "soc/gpio_struct.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define GPIO_GROUP_MAX_PINS         8                   //每组最多引脚数
+
+//一个图样对应的寄存器掩码(lo为GPIO0~31，hi为GPIO32~39的第0~7位)
+typedef struct {
+	uint32_t set_lo;
+	uint32_t clr_lo;
+	uint32_t set_hi;
+	uint32_t clr_hi;
+} GpioGroup_Masks_t;
+
+//引脚组
+typedef struct {
+	uint8_t count;
+	uint8_t pin[GPIO_GROUP_MAX_PINS];
+	uint32_t invert;                /*!< 按位反相(低电平有效的引脚)，第i位对应第i个引脚 */
+	uint32_t bit_lo[GPIO_GROUP_MAX_PINS];   /*!< 各引脚在lo寄存器中的位，不在则为0 */
+	uint32_t bit_hi[GPIO_GROUP_MAX_PINS];   /*!< 各引脚在hi寄存器中的位，不在则为0 */
+	uint32_t all_lo;                /*!< 组内全部引脚 */
+	uint32_t all_hi;
+} GpioGroup_t;
+
+
+esp_err_t GpioGroup_Define(GpioGroup_t *group, const gpio_num_t *pins, uint8_t count, uint32_t invert);
+esp_err_t GpioGroup_Init(GpioGroup_t *group, const gpio_num_t *pins, uint8_t count, uint32_t invert);
+void GpioGroup_Compile(const GpioGroup_t *group, uint32_t pattern, GpioGroup_Masks_t *masks);
+uint16_t GpioGroup_BuildTable(const GpioGroup_t *group, GpioGroup_Masks_t *table, uint16_t size);
+void GpioGroup_Write(const GpioGroup_t *group, uint32_t pattern);
+
+/**
+ * 按预先算好的掩码输出，只有寄存器写，可在中断中使用
+ * 置位和清零的引脚互不重叠，两次写之间只差一个总线周期
+ * @param[in]   masks   掩码
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static inline __attribute__((always_inline)) void GpioGroup_Apply(const GpioGroup_Masks_t *masks)
+{
+    GPIO.out_w1ts = masks->set_lo;
+    GPIO.out_w1tc = masks->clr_lo;
+    if (masks->set_hi | masks->clr_hi)
+    {
+        GPIO.out1_w1ts.val = masks->set_hi;
+        GPIO.out1_w1tc.val = masks->clr_hi;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
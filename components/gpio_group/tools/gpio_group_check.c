@@ -0,0 +1,145 @@
+/*
+* @file         gpio_group_check.c
+* @brief        gpio_group掩码在PC上的校验
+* @details      用替身寄存器模拟W1TS/W1TC的效果，对每个图样检查:
+*               1. 组内每个引脚的电平符合图样和反相设置
+*               2. 组外引脚不变，置位与清零掩码不重叠且覆盖整组
+*               3. 掩码表与逐个计算的结果一致；非法引脚定义被拒绝，且不修改已有的组
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include gpio_group_check.c ../gpio_group.c -o gpio_group_check
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpio_group.h"
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+gpio_dev_t GPIO;
+static uint64_t g_configured;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    g_configured = cfg->pin_bit_mask;
+    return ESP_OK;
+}
+
+//写一个图样并按W1TS/W1TC的语义更新输出寄存器
+static void apply(const GpioGroup_Masks_t *m)
+{
+    GPIO.out_w1ts = GPIO.out_w1tc = 0;
+    GPIO.out1_w1ts.val = GPIO.out1_w1tc.val = 0;
+    GpioGroup_Apply(m);
+    GPIO.out = (GPIO.out | GPIO.out_w1ts) & ~GPIO.out_w1tc;
+    GPIO.out1.val = (GPIO.out1.val | GPIO.out1_w1ts.val) & ~GPIO.out1_w1tc.val & 0xFF;
+}
+
+static int check_group(const char *name, const gpio_num_t *pins, uint8_t count, uint32_t invert)
+{
+    GpioGroup_t g;
+    GpioGroup_Masks_t m, table[1 << GPIO_GROUP_MAX_PINS];
+    uint32_t p, before_lo, before_hi, level, n;
+    int errors = 0;
+    uint8_t i;
+
+    if (GpioGroup_Init(&g, pins, count, invert) != ESP_OK)
+    {
+        printf("%s: define failed\n", name);
+        return 1;
+    }
+    if (g_configured != (((uint64_t)g.all_hi << 32) | g.all_lo))
+    {
+        printf("%s: gpio_config mask %llx\n", name, (unsigned long long)g_configured);
+        errors ++;
+    }
+    n = GpioGroup_BuildTable(&g, table, sizeof(table) / sizeof(table[0]));
+    if (n != (1UL << count))
+    {
+        printf("%s: table size %u\n", name, n);
+        errors ++;
+    }
+    for (p = 0; p < (1UL << count); p ++)
+    {
+        GpioGroup_Compile(&g, p, &m);
+        if (memcmp(&m, &table[p], sizeof(m)))
+        {
+            printf("%s: table[%u] differs\n", name, p);
+            errors ++;
+        }
+        if ((m.set_lo & m.clr_lo) || (m.set_hi & m.clr_hi) ||
+            (m.set_lo | m.clr_lo) != g.all_lo || (m.set_hi | m.clr_hi) != g.all_hi)
+        {
+            printf("%s: pattern %x masks overlap or miss pins\n", name, p);
+            errors ++;
+        }
+        GPIO.out = (uint32_t)rand() ^ ((uint32_t)rand() << 16);
+        GPIO.out1.val = rand() & 0xFF;
+        before_lo = GPIO.out;
+        before_hi = GPIO.out1.val;
+        apply(&m);
+        if (((GPIO.out ^ before_lo) & ~g.all_lo) || ((GPIO.out1.val ^ before_hi) & ~g.all_hi))
+        {
+            printf("%s: pattern %x touched pins outside the group\n", name, p);
+            errors ++;
+        }
+        for (i = 0; i < count; i ++)
+        {
+            level = (pins[i] < 32) ? (GPIO.out >> pins[i]) & 1 : (GPIO.out1.val >> (pins[i] - 32)) & 1;
+            if (level != (((p ^ invert) >> i) & 1))
+            {
+                printf("%s: pattern %x pin %d level %u\n", name, p, pins[i], level);
+                errors ++;
+            }
+        }
+    }
+    printf("%s: %u patterns, %s\n", name, 1U << count, errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    static const gpio_num_t rgb_user[] = {2, 18, 19, 5};
+    static const gpio_num_t mixed[] = {32, 0, 33, 27, 23, 4, 13, 12};
+    static const gpio_num_t input_only[] = {2, 34};
+    static const gpio_num_t dup[] = {18, 18};
+    static const gpio_num_t missing[] = {20};
+    GpioGroup_t g, saved;
+    int errors = 0;
+
+    errors += check_group("rgb+user", rgb_user, 4, 0x07);
+    errors += check_group("mixed banks", mixed, 8, 0xA5);
+    GpioGroup_Define(&g, rgb_user, 4, 0x07);
+    saved = g;
+    if (GpioGroup_Define(&g, input_only, 2, 0) == ESP_OK ||
+        GpioGroup_Define(&g, dup, 2, 0) == ESP_OK ||
+        GpioGroup_Define(&g, missing, 1, 0) == ESP_OK ||
+        GpioGroup_Define(&g, rgb_user, 0, 0) == ESP_OK ||
+        GpioGroup_Define(&g, mixed, GPIO_GROUP_MAX_PINS + 1, 0) == ESP_OK)
+    {
+        printf("invalid group accepted\n");
+        errors ++;
+    }
+    if (memcmp(&g, &saved, sizeof(g)) != 0)
+    {
+        printf("rejected definition modified the group\n");
+        errors ++;
+    }
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
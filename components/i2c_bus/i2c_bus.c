@@ -0,0 +1,867 @@
+/*
+* @file         i2c_bus.c
+* @brief        I2C总线管理
+* @details      请求放在调用者栈上，队列里只传指针，调用者阻塞到总线任务执行完；
+*               总线任务先取高优先级队列，分块写每发完一块都先处理已排队的高优先级请求；
+*               只有总线任务访问i2c驱动，恢复总线时可以直接卸载/重装驱动
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "i2c_bus.h"
+#include "i2c_trace.h"
+#include "string.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "rom/ets_sys.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_BUS_TAG         "i2c_bus"
+#define ACK_CHECK_EN        0x1                 //主机检查从机的ACK
+#define ACK_VAL             0x0                 //应答
+#define NACK_VAL            0x1                 //不应答
+
+//排队的传输请求
+typedef struct {
+	I2CBus_Device_t *dev;
+	uint8_t prefix[I2C_BUS_PREFIX_MAX];         /*!< 每一块都重发的前缀 */
+	uint8_t prefix_len;
+	const uint8_t *tx;
+	uint16_t tx_len;
+	uint8_t *rx;
+	uint16_t rx_len;
+	bool chunked;
+	int64_t submit_us;
+	esp_err_t ret;
+} i2c_bus_req_t;
+
+//端口
+typedef struct {
+	bool inited;
+	i2c_port_t port;
+	int sda_io;
+	int scl_io;
+	uint32_t clk_hz;                            /*!< 安装驱动时的时钟，也是器件的默认时钟 */
+	uint32_t cur_clk_hz;                        /*!< 控制器当前的时钟 */
+	QueueHandle_t queue[I2C_BUS_PRIO_MAX];
+	SemaphoreHandle_t pending;                  /*!< 计数信号量，每投递一个请求释放一次 */
+	TaskHandle_t task;
+	uint8_t dev_count;
+	I2CBus_Device_t devices[I2C_BUS_MAX_DEVICES];
+} i2c_bus_port_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static i2c_bus_port_t g_i2c_bus[I2C_NUM_MAX];
+static portMUX_TYPE g_i2c_bus_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 切换控制器时钟，各时序参数按i2c_param_config的算法取半周期
+ * 控制器超时按APB周期计，也要随时钟重新设置，否则从高速切回低速后一个SCL周期就会超时
+ * @param[in]   bus      端口
+ * @param[in]   clk_hz   时钟
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 控制器超时随时钟缩放\n
+ */
+static void i2c_bus_set_clock(i2c_bus_port_t *bus, uint32_t clk_hz)
+{
+    int half = I2C_APB_CLK_FREQ / clk_hz / 2;
+    int tout = half * 2 * I2C_BUS_TOUT_PERIODS;
+
+    i2c_set_period(bus->port, half, half);
+    i2c_set_start_timing(bus->port, half, half);
+    i2c_set_stop_timing(bus->port, half, half);
+    i2c_set_data_timing(bus->port, half / 2, half / 2);
+    i2c_set_timeout(bus->port, (tout > I2C_BUS_TOUT_MAX) ? I2C_BUS_TOUT_MAX : tout);
+    bus->cur_clk_hz = clk_hz;
+}
+
+/**
+ * 执行一次i2c传输: [写 前缀+tx] [重复起始 读 rx]，并记入器件统计和跟踪记录
+ * 控制器时钟与器件时钟不同时先切换
+ * @param[in]   dev      器件
+ * @param[in]   prefix   前缀，可为NULL
+ * @param[in]   plen     前缀长度
+ * @param[in]   tx       写数据，可为NULL
+ * @param[in]   tx_len   写长度
+ * @param[out]  rx       读缓冲，可为NULL
+ * @param[in]   rx_len   读长度
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c_master_cmd_begin的错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 写入传输跟踪记录\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 按器件时钟切换控制器时钟\n
+ */
+static esp_err_t i2c_bus_txn(I2CBus_Device_t *dev, const uint8_t *prefix, uint8_t plen,
+                             const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len)
+{
+    i2c_bus_port_t *bus = &g_i2c_bus[dev->port];
+    esp_err_t ret;
+    int64_t t0;
+    uint32_t dt;
+    bool wrote = 0;
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+
+    i2c_master_start(cmd);
+    if (plen || tx_len || !rx_len)
+    {
+        i2c_master_write_byte(cmd, dev->addr << 1 | I2C_MASTER_WRITE, ACK_CHECK_EN);
+        if (plen)
+        {
+            i2c_master_write(cmd, (uint8_t *)prefix, plen, ACK_CHECK_EN);
+        }
+        if (tx_len)
+        {
+            i2c_master_write(cmd, (uint8_t *)tx, tx_len, ACK_CHECK_EN);
+        }
+        wrote = 1;
+    }
+    if (rx_len)
+    {
+        if (wrote)
+        {
+            i2c_master_start(cmd);
+        }
+        i2c_master_write_byte(cmd, dev->addr << 1 | I2C_MASTER_READ, ACK_CHECK_EN);
+        if (rx_len > 1)
+        {
+            i2c_master_read(cmd, rx, rx_len - 1, ACK_VAL);
+        }
+        i2c_master_read_byte(cmd, rx + rx_len - 1, NACK_VAL);
+    }
+    i2c_master_stop(cmd);
+
+    if (dev->clk_hz != bus->cur_clk_hz)
+    {
+        i2c_bus_set_clock(bus, dev->clk_hz);
+    }
+    t0 = esp_timer_get_time();
+    ret = i2c_master_cmd_begin(dev->port, cmd, I2C_BUS_TIMEOUT_MS / portTICK_RATE_MS);
+    dt = (uint32_t)(esp_timer_get_time() - t0);
+    i2c_cmd_link_delete(cmd);
+
+    portENTER_CRITICAL(&g_i2c_bus_mux);
+    dev->stats.transactions ++;
+    dev->stats.bytes += plen + tx_len + rx_len;
+    dev->stats.bus_us += dt;
+    portEXIT_CRITICAL(&g_i2c_bus_mux);
+    I2CTrace_Add(dev->port, dev->addr, t0, dt, plen + tx_len, rx_len, ret);
+    return ret;
+}
+
+/**
+ * 安装i2c驱动(端口参数取自bus)
+ * @param[in]   bus   端口
+ * @retval
+ *              - ESP_OK
+ *              - 其它  i2c驱动安装错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 记录控制器当前时钟\n
+ */
+static esp_err_t i2c_bus_install(i2c_bus_port_t *bus)
+{
+    i2c_config_t conf;
+
+    memset(&conf, 0, sizeof(conf));
+    conf.mode = I2C_MODE_MASTER;
+    conf.sda_io_num = bus->sda_io;
+    conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
+    conf.scl_io_num = bus->scl_io;
+    conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
+    conf.master.clk_speed = bus->clk_hz;
+    i2c_param_config(bus->port, &conf);
+    bus->cur_clk_hz = bus->clk_hz;
+    return i2c_driver_install(bus->port, conf.mode, 0, 0, 0);
+}
+
+/**
+ * 总线是否空闲(SDA、SCL都为高)
+ * @param[in]   bus   端口
+ * @retval      1空闲 0有线被拉低
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static bool i2c_bus_lines_idle(i2c_bus_port_t *bus)
+{
+    return gpio_get_level(bus->sda_io) && gpio_get_level(bus->scl_io);
+}
+
+/**
+ * 恢复总线:卸载驱动(同时复位i2c控制器)，把SCL/SDA切成GPIO开漏，SDA被拉低时
+ * 最多发9个SCL脉冲让从机发完卡住的字节并释放SDA，再发STOP，最后重装驱动
+ * @param[in]   bus   端口
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_STATE  恢复后总线仍不空闲(短路/器件损坏)
+ *              - 其它  i2c驱动安装错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t i2c_bus_recover(i2c_bus_port_t *bus)
+{
+    gpio_config_t io;
+    esp_err_t ret;
+    bool idle;
+    uint8_t i;
+
+    i2c_driver_delete(bus->port);
+    memset(&io, 0, sizeof(io));
+    io.pin_bit_mask = (1ULL << bus->sda_io) | (1ULL << bus->scl_io);
+    io.mode = GPIO_MODE_INPUT_OUTPUT_OD;
+    io.pull_up_en = GPIO_PULLUP_ENABLE;
+    gpio_config(&io);
+    gpio_set_level(bus->sda_io, 1);
+    gpio_set_level(bus->scl_io, 1);
+    ets_delay_us(I2C_BUS_RECOVER_HALF_US);
+
+    for (i = 0; i < 9 && gpio_get_level(bus->sda_io) == 0; i ++)
+    {
+        gpio_set_level(bus->scl_io, 0);
+        ets_delay_us(I2C_BUS_RECOVER_HALF_US);
+        gpio_set_level(bus->scl_io, 1);
+        ets_delay_us(I2C_BUS_RECOVER_HALF_US);
+    }
+    //STOP:SCL为高时SDA由低变高，从机状态机回到空闲
+    gpio_set_level(bus->scl_io, 0);
+    ets_delay_us(I2C_BUS_RECOVER_HALF_US);
+    gpio_set_level(bus->sda_io, 0);
+    ets_delay_us(I2C_BUS_RECOVER_HALF_US);
+    gpio_set_level(bus->scl_io, 1);
+    ets_delay_us(I2C_BUS_RECOVER_HALF_US);
+    gpio_set_level(bus->sda_io, 1);
+    ets_delay_us(I2C_BUS_RECOVER_HALF_US);
+    idle = i2c_bus_lines_idle(bus);
+
+    ret = i2c_bus_install(bus);
+    if (ret == ESP_OK && !idle)
+    {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    ESP_LOGW(I2C_BUS_TAG, "port %d recovered, %u clocks, %s", bus->port, i, idle ? "idle" : "still stuck");
+    return ret;
+}
+
+/**
+ * 执行一次传输，失败时:超时或总线线被拉低则先恢复总线；允许重试时按指数退避重试
+ * 器件本窗口的失败数已用完错误预算时不再重试，避免不在线的器件反复占用总线
+ * @param[in]   bus     端口
+ * @param[in]   dev     器件
+ * @param[in]   req     请求(取前缀、读缓冲)
+ * @param[in]   tx      本次写数据
+ * @param[in]   tx_len  本次写长度
+ * @param[in]   retry   是否允许重试(器件内部地址会随写入前移的分块写不能重试)
+ * @retval
+ *              - ESP_OK
+ *              - 其它  最后一次传输的错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 自动调速期间不重试\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 调速标志改为no_retry，扫描探测也不重试\n
+ */
+static esp_err_t i2c_bus_transfer(i2c_bus_port_t *bus, I2CBus_Device_t *dev, i2c_bus_req_t *req,
+                                  const uint8_t *tx, uint16_t tx_len, bool retry)
+{
+    uint32_t backoff = I2C_BUS_BACKOFF_MS;
+    esp_err_t ret;
+    uint8_t n = 0;
+
+    while (1)
+    {
+        ret = i2c_bus_txn(dev, req->prefix, req->prefix_len, tx, tx_len, req->rx, req->rx_len);
+        if (ret == ESP_OK)
+        {
+            return ret;
+        }
+        //NACK且总线空闲只说明器件没应答；超时或线被拉低说明总线/控制器卡住
+        if (ret != ESP_FAIL || !i2c_bus_lines_idle(bus))
+        {
+            i2c_bus_recover(bus);
+            portENTER_CRITICAL(&g_i2c_bus_mux);
+            dev->stats.recoveries ++;
+            portEXIT_CRITICAL(&g_i2c_bus_mux);
+        }
+        if (!retry || dev->no_retry || n >= I2C_BUS_RETRY_MAX || dev->win_errors >= I2C_BUS_ERR_BUDGET)
+        {
+            return ret;
+        }
+        //esp_timer回调里可能有器件驱动在等本任务完成请求，退避不能靠esp_timer唤醒；
+        //按tick向上取整，至少等一个tick
+        vTaskDelay((backoff + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+        backoff = (backoff * 2 > I2C_BUS_BACKOFF_MAX_MS) ? I2C_BUS_BACKOFF_MAX_MS : backoff * 2;
+        n ++;
+        portENTER_CRITICAL(&g_i2c_bus_mux);
+        dev->stats.retries ++;
+        portEXIT_CRITICAL(&g_i2c_bus_mux);
+    }
+}
+
+static void i2c_bus_execute(i2c_bus_port_t *bus, i2c_bus_req_t *req);
+
+/**
+ * 分块写的间隙:执行所有已排队的高优先级请求
+ * @param[in]   bus   端口
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void i2c_bus_yield(i2c_bus_port_t *bus)
+{
+    i2c_bus_req_t *req;
+    while (xQueueReceive(bus->queue[I2C_BUS_PRIO_HIGH], &req, 0) == pdTRUE)
+    {
+        //与主循环的计数保持一致，取不到时主循环多醒一次也没关系
+        xSemaphoreTake(bus->pending, 0);
+        i2c_bus_execute(bus, req);
+    }
+}
+
+/**
+ * 执行一个请求并唤醒调用者
+ * @param[in]   bus   端口
+ * @param[in]   req   请求
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 失败时恢复总线、退避重试，统计错误率\n
+ */
+static void i2c_bus_execute(i2c_bus_port_t *bus, i2c_bus_req_t *req)
+{
+    I2CBus_Device_t *dev = req->dev;
+    uint32_t wait_us = (uint32_t)(esp_timer_get_time() - req->submit_us);
+    uint16_t off = 0;
+    uint16_t n;
+
+    if (req->chunked && req->tx_len > I2C_BUS_CHUNK_BYTES)
+    {
+        req->ret = ESP_OK;
+        while (off < req->tx_len && req->ret == ESP_OK)
+        {
+            n = req->tx_len - off;
+            if (n > I2C_BUS_CHUNK_BYTES)
+            {
+                n = I2C_BUS_CHUNK_BYTES;
+            }
+            req->ret = i2c_bus_transfer(bus, dev, req, req->tx + off, n, 0);
+            off += n;
+            if (off < req->tx_len)
+            {
+                i2c_bus_yield(bus);
+            }
+        }
+    }
+    else
+    {
+        req->ret = i2c_bus_transfer(bus, dev, req, req->tx, req->tx_len, !req->chunked);
+    }
+
+    portENTER_CRITICAL(&g_i2c_bus_mux);
+    dev->stats.requests ++;
+    dev->win_requests ++;
+    if (req->ret != ESP_OK)
+    {
+        dev->stats.errors ++;
+        dev->win_errors ++;
+    }
+    if (dev->win_requests >= I2C_BUS_ERR_WINDOW)
+    {
+        dev->stats.err_rate_pm = dev->win_errors * 1000 / dev->win_requests;
+        dev->win_requests = 0;
+        dev->win_errors = 0;
+    }
+    dev->stats.wait_us_last = wait_us;
+    if (wait_us > dev->stats.wait_us_max)
+    {
+        dev->stats.wait_us_max = wait_us;
+    }
+    portEXIT_CRITICAL(&g_i2c_bus_mux);
+    xSemaphoreGive(dev->done);
+}
+
+/**
+ * 总线任务:高优先级队列优先
+ * @param[in]   arg   端口
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void i2c_bus_task(void *arg)
+{
+    i2c_bus_port_t *bus = (i2c_bus_port_t *)arg;
+    i2c_bus_req_t *req;
+    uint8_t prio;
+
+    while (1)
+    {
+        xSemaphoreTake(bus->pending, portMAX_DELAY);
+        for (prio = 0; prio < I2C_BUS_PRIO_MAX; prio ++)
+        {
+            if (xQueueReceive(bus->queue[prio], &req, 0) == pdTRUE)
+            {
+                i2c_bus_execute(bus, req);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * 初始化失败时按创建的逆序释放:计数信号量、各优先级队列，最后卸载驱动
+ * @param[in]   bus   端口
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void i2c_bus_unwind(i2c_bus_port_t *bus)
+{
+    uint8_t prio;
+
+    if (bus->pending)
+    {
+        vSemaphoreDelete(bus->pending);
+        bus->pending = NULL;
+    }
+    for (prio = I2C_BUS_PRIO_MAX; prio > 0; prio --)
+    {
+        if (bus->queue[prio - 1])
+        {
+            vQueueDelete(bus->queue[prio - 1]);
+            bus->queue[prio - 1] = NULL;
+        }
+    }
+    i2c_driver_delete(bus->port);
+}
+
+/**
+ * 初始化端口并启动总线任务，已初始化时直接返回(器件默认时钟以第一次初始化为准)
+ * @param[in]   port     I2C_NUM_0/I2C_NUM_1
+ * @param[in]   sda_io   SDA脚
+ * @param[in]   scl_io   SCL脚
+ * @param[in]   clk_hz   总线时钟
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG  端口号超出范围
+ *              - ESP_ERR_NO_MEM
+ *              - 其它  i2c驱动安装错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 记录引脚\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 时钟作为器件的默认时钟\n
+ *               Ver0.0.4:
+                     Caesar, 2026/10/19, 检查端口号，失败时逆序释放已创建的队列并卸载驱动\n
+ */
+esp_err_t I2CBus_Init(i2c_port_t port, int sda_io, int scl_io, uint32_t clk_hz)
+{
+    i2c_bus_port_t *bus;
+    esp_err_t ret;
+    uint8_t prio;
+
+    if (port >= I2C_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bus = &g_i2c_bus[port];
+    if (bus->inited)
+    {
+        return ESP_OK;
+    }
+    bus->port = port;
+    bus->sda_io = sda_io;
+    bus->scl_io = scl_io;
+    bus->clk_hz = clk_hz;
+    ret = i2c_bus_install(bus);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    for (prio = 0; prio < I2C_BUS_PRIO_MAX; prio ++)
+    {
+        bus->queue[prio] = xQueueCreate(I2C_BUS_QUEUE_LEN, sizeof(i2c_bus_req_t *));
+        if (bus->queue[prio] == NULL)
+        {
+            i2c_bus_unwind(bus);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    bus->pending = xSemaphoreCreateCounting(I2C_BUS_QUEUE_LEN * I2C_BUS_PRIO_MAX, 0);
+    if (bus->pending == NULL)
+    {
+        i2c_bus_unwind(bus);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(i2c_bus_task, "i2c_bus_task", I2C_BUS_TASK_STACK, bus,
+                    I2C_BUS_TASK_PRIO, &bus->task) != pdPASS)
+    {
+        bus->task = NULL;
+        i2c_bus_unwind(bus);
+        return ESP_ERR_NO_MEM;
+    }
+    bus->inited = 1;
+    return ESP_OK;
+}
+
+/**
+ * 在端口上登记一个器件
+ * @param[in]   port   端口(须已I2CBus_Init)
+ * @param[in]   addr   7位地址
+ * @param[in]   name   名称，用于统计输出
+ * @param[in]   prio   该器件请求的优先级
+ * @retval
+ *              器件句柄，端口号超出范围/端口未初始化/器件已满/内存不足时为NULL
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 器件时钟默认取端口时钟\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 检查端口号\n
+ */
+I2CBus_Device_t *I2CBus_AddDevice(i2c_port_t port, uint8_t addr, const char *name, I2C_BUS_PRIO_t prio)
+{
+    i2c_bus_port_t *bus;
+    I2CBus_Device_t *dev = NULL;
+    SemaphoreHandle_t lock, done;
+
+    if (port >= I2C_NUM_MAX || !g_i2c_bus[port].inited)
+    {
+        return NULL;
+    }
+    bus = &g_i2c_bus[port];
+    lock = xSemaphoreCreateMutex();
+    done = xSemaphoreCreateBinary();
+    if (lock != NULL && done != NULL)
+    {
+        //表项填好后才计入dev_count，统计/诊断不会看到一半的器件
+        portENTER_CRITICAL(&g_i2c_bus_mux);
+        if (bus->dev_count < I2C_BUS_MAX_DEVICES)
+        {
+            dev = &bus->devices[bus->dev_count];
+            memset(dev, 0, sizeof(*dev));
+            dev->port = port;
+            dev->addr = addr;
+            dev->name = name;
+            dev->prio = prio;
+            dev->clk_hz = bus->clk_hz;
+            dev->lock = lock;
+            dev->done = done;
+            bus->dev_count ++;
+        }
+        portEXIT_CRITICAL(&g_i2c_bus_mux);
+    }
+    if (dev == NULL)
+    {
+        if (lock)
+        {
+            vSemaphoreDelete(lock);
+        }
+        if (done)
+        {
+            vSemaphoreDelete(done);
+        }
+    }
+    return dev;
+}
+
+/**
+ * 把请求交给总线任务并等待完成
+ * @param[in]   req   请求(调用者栈上)
+ * @retval      请求的执行结果
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t i2c_bus_submit(i2c_bus_req_t *req)
+{
+    I2CBus_Device_t *dev = req->dev;
+    i2c_bus_port_t *bus = &g_i2c_bus[dev->port];
+
+    xSemaphoreTake(dev->lock, portMAX_DELAY);
+    req->submit_us = esp_timer_get_time();
+    xQueueSend(bus->queue[dev->prio], &req, portMAX_DELAY);
+    xSemaphoreGive(bus->pending);
+    xSemaphoreTake(dev->done, portMAX_DELAY);
+    xSemaphoreGive(dev->lock);
+    return req->ret;
+}
+
+/**
+ * 写器件: 前缀+数据，chunked时数据按I2C_BUS_CHUNK_BYTES分成多次传输，每次都重发前缀，
+ * 块之间总线可以被高优先级请求插入(要求器件能接受拆开的写，如OLED显存写)；
+ * chunked的请求失败时不重试(器件内部地址可能已前移)，由调用者决定是否整段重发
+ * @param[in]   dev          器件
+ * @param[in]   prefix       前缀(寄存器地址/控制字节)，可为NULL
+ * @param[in]   prefix_len   前缀长度，不超过I2C_BUS_PREFIX_MAX
+ * @param[in]   data         数据
+ * @param[in]   len          数据长度
+ * @param[in]   chunked      是否允许分块
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 说明分块写失败不重试\n
+ */
+esp_err_t I2CBus_Write(I2CBus_Device_t *dev, const uint8_t *prefix, uint8_t prefix_len,
+                       const uint8_t *data, uint16_t len, bool chunked)
+{
+    i2c_bus_req_t req;
+
+    if (dev == NULL || prefix_len > I2C_BUS_PREFIX_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(&req, 0, sizeof(req));
+    req.dev = dev;
+    if (prefix_len)
+    {
+        memcpy(req.prefix, prefix, prefix_len);
+    }
+    req.prefix_len = prefix_len;
+    req.tx = data;
+    req.tx_len = len;
+    req.chunked = chunked;
+    return i2c_bus_submit(&req);
+}
+
+/**
+ * 读器件
+ * @param[in]   dev    器件
+ * @param[out]  data   读缓冲
+ * @param[in]   len    读长度
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t I2CBus_Read(I2CBus_Device_t *dev, uint8_t *data, uint16_t len)
+{
+    return I2CBus_WriteRead(dev, NULL, 0, data, len);
+}
+
+/**
+ * 先写后读(重复起始，中间不释放总线)，如读寄存器
+ * @param[in]   dev      器件
+ * @param[in]   tx       写数据，可为NULL
+ * @param[in]   tx_len   写长度，不超过I2C_BUS_PREFIX_MAX
+ * @param[out]  rx       读缓冲
+ * @param[in]   rx_len   读长度
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ *              - 其它  i2c错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t I2CBus_WriteRead(I2CBus_Device_t *dev, const uint8_t *tx, uint8_t tx_len,
+                           uint8_t *rx, uint16_t rx_len)
+{
+    i2c_bus_req_t req;
+
+    if (dev == NULL || tx_len > I2C_BUS_PREFIX_MAX || rx == NULL || rx_len == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(&req, 0, sizeof(req));
+    req.dev = dev;
+    if (tx_len)
+    {
+        memcpy(req.prefix, tx, tx_len);
+    }
+    req.prefix_len = tx_len;
+    req.rx = rx;
+    req.rx_len = rx_len;
+    return i2c_bus_submit(&req);
+}
+
+/**
+ * 设置器件的传输时钟，下一次传输起生效
+ * @param[in]   dev      器件
+ * @param[in]   clk_hz   时钟
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CBus_SetClock(I2CBus_Device_t *dev, uint32_t clk_hz)
+{
+    portENTER_CRITICAL(&g_i2c_bus_mux);
+    dev->clk_hz = clk_hz;
+    portEXIT_CRITICAL(&g_i2c_bus_mux);
+}
+
+/**
+ * 默认探测:只发地址，检查器件应答
+ * @param[in]   dev   器件
+ * @param[in]   arg   无
+ * @retval      ESP_OK应答 其它无应答
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t i2c_bus_probe_ack(I2CBus_Device_t *dev, void *arg)
+{
+    (void)arg;
+    return I2CBus_Write(dev, NULL, 0, NULL, 0, 0);
+}
+
+/**
+ * 自动调速:从标准模式起逐档升高时钟，每档连续I2C_BUS_TUNE_ROUNDS次探测都成功才算可靠，
+ * 第一次失败即停止，器件使用最高的可靠时钟；调速期间失败不重试，结束后清空错误率窗口
+ * 须在器件开始正常通信前调用
+ * @param[in]   dev      器件
+ * @param[in]   max_hz   器件允许的最高时钟(数据手册)
+ * @param[in]   probe    探测函数，NULL时只检查地址应答
+ * @param[in]   arg      探测函数参数
+ * @retval
+ *              选定的时钟，标准模式也不可靠时为0(器件保持标准模式)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+uint32_t I2CBus_AutoTune(I2CBus_Device_t *dev, uint32_t max_hz, I2CBus_Probe_t probe, void *arg)
+{
+    static const uint32_t clks[] = {I2C_BUS_CLK_STANDARD, I2C_BUS_CLK_FAST, I2C_BUS_CLK_FAST_PLUS};
+    uint32_t best = 0;
+    uint8_t i, n;
+
+    if (probe == NULL)
+    {
+        probe = i2c_bus_probe_ack;
+    }
+    dev->no_retry = 1;
+    for (i = 0; i < sizeof(clks) / sizeof(clks[0]) && clks[i] <= max_hz; i ++)
+    {
+        I2CBus_SetClock(dev, clks[i]);
+        for (n = 0; n < I2C_BUS_TUNE_ROUNDS; n ++)
+        {
+            if (probe(dev, arg) != ESP_OK)
+            {
+                break;
+            }
+        }
+        if (n < I2C_BUS_TUNE_ROUNDS)
+        {
+            break;
+        }
+        best = clks[i];
+    }
+    dev->no_retry = 0;
+    I2CBus_SetClock(dev, best ? best : I2C_BUS_CLK_STANDARD);
+
+    portENTER_CRITICAL(&g_i2c_bus_mux);
+    dev->win_requests = 0;
+    dev->win_errors = 0;
+    portEXIT_CRITICAL(&g_i2c_bus_mux);
+    ESP_LOGI(I2C_BUS_TAG, "%s tuned to %ukHz", dev->name, best / 1000);
+    return best;
+}
+
+/**
+ * 总线当前是否空闲(SDA、SCL都为高)，用于区分总线被拉死和器件不应答
+ * 只是一次采样，总线任务正在传输时也可能读到低电平
+ * @param[in]   port   端口
+ * @retval      1空闲 0有线被拉低或端口未初始化
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool I2CBus_LinesIdle(i2c_port_t port)
+{
+    i2c_bus_port_t *bus = &g_i2c_bus[port];
+    return bus->inited && i2c_bus_lines_idle(bus);
+}
+
+/**
+ * 读取器件统计
+ * @param[in]   dev     器件
+ * @param[out]  stats   统计结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CBus_GetStats(I2CBus_Device_t *dev, I2CBus_Stats_t *stats)
+{
+    portENTER_CRITICAL(&g_i2c_bus_mux);
+    *stats = dev->stats;
+    portEXIT_CRITICAL(&g_i2c_bus_mux);
+}
+
+/**
+ * 打印端口上所有器件的统计
+ * @param[in]   port   端口
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 输出重试、恢复次数和错误率\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 输出器件时钟\n
+ */
+void I2CBus_PrintStats(i2c_port_t port)
+{
+    i2c_bus_port_t *bus = &g_i2c_bus[port];
+    I2CBus_Stats_t stats;
+    uint8_t i;
+
+    for (i = 0; i < bus->dev_count; i ++)
+    {
+        I2CBus_GetStats(&bus->devices[i], &stats);
+        ESP_LOGI(I2C_BUS_TAG, "%-8s 0x%02x %ukHz req:%u txn:%u bytes:%u err:%u(%u.%u%%) retry:%u recover:%u "
+                 "bus:%ums wait:%u/%uus",
+                 bus->devices[i].name, bus->devices[i].addr, bus->devices[i].clk_hz / 1000, stats.requests,
+                 stats.transactions, stats.bytes, stats.errors,
+                 stats.err_rate_pm / 10, stats.err_rate_pm % 10, stats.retries, stats.recoveries,
+                 (uint32_t)(stats.bus_us / 1000), stats.wait_us_last, stats.wait_us_max);
+    }
+}
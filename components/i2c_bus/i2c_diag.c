@@ -0,0 +1,387 @@
+/*
+* @file         i2c_diag.c
+* @brief        I2C总线扫描与延迟诊断
+* @details      探测经i2c_bus总线任务进行(端口由器件驱动初始化，与正常通信按优先级排队)，
+*               每个端口登记一个名为"i2c_diag"的探测器件，逐个改地址做只发地址的写；
+*               无应答地址上测得的"总线时间-理论位时间"最小值作为驱动固有开销，
+*               应答器件超出这部分的时间即估计为时钟拉伸
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "i2c_diag.h"
+#include "string.h"
+#include "stdlib.h"
+#include "stdarg.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_DIAG_PROBE_BITS     11                  //只发地址的写:起始+8位地址+ACK+停止
+
+//已知器件
+typedef struct {
+	uint8_t addr;
+	const char *name;
+} i2c_diag_known_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static const i2c_diag_known_t g_diag_known[] = {
+    {0x23, "BH1750"},                               //ADDR脚接地
+    {0x5C, "BH1750"},                               //ADDR脚接高
+    {0x3C, "SSD1306"},
+    {0x3D, "SSD1306"},
+};
+static I2CBus_Device_t *g_diag_dev[I2C_NUM_MAX];
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 按地址查已知器件名
+ * @param[in]   addr   7位地址
+ * @retval      器件名，未知为NULL
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static const char *diag_known_name(uint8_t addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < sizeof(g_diag_known) / sizeof(g_diag_known[0]); i ++)
+    {
+        if (g_diag_known[i].addr == addr)
+        {
+            return g_diag_known[i].name;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * 探测一个地址:只发地址的写，记录往返延迟和占用总线的时间
+ * @param[in]   dev      探测器件
+ * @param[in]   addr     7位地址
+ * @param[out]  rtt_us   往返延迟
+ * @param[out]  bus_us   占用总线的时间
+ * @retval
+ *              - ESP_OK  有应答
+ *              - ESP_FAIL  无应答
+ *              - 其它  总线错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static esp_err_t diag_probe(I2CBus_Device_t *dev, uint8_t addr, uint32_t *rtt_us, uint32_t *bus_us)
+{
+    I2CBus_Stats_t before, after;
+    esp_err_t ret;
+    int64_t t0;
+
+    //请求是同步的，总线任务只在执行期间读addr
+    dev->addr = addr;
+    I2CBus_GetStats(dev, &before);
+    t0 = esp_timer_get_time();
+    ret = I2CBus_Write(dev, NULL, 0, NULL, 0, 0);
+    *rtt_us = (uint32_t)(esp_timer_get_time() - t0);
+    I2CBus_GetStats(dev, &after);
+    *bus_us = (uint32_t)(after.bus_us - before.bus_us);
+    return ret;
+}
+
+/**
+ * 对一个应答的器件测量延迟分布
+ * @param[in]       dev        探测器件
+ * @param[in]       model_us   理论位时间
+ * @param[in]       overhead   驱动固有开销
+ * @param[in,out]   d          器件结果(addr已填)
+ * @retval          无
+ * @par             修改日志
+ *                   Ver0.0.1:
+                         Caesar, 2026/10/19, 初始化版本\n
+ */
+static void diag_measure(I2CBus_Device_t *dev, uint32_t model_us, uint32_t overhead, I2CDiag_Device_t *d)
+{
+    uint32_t rtt, bus, stretch, limit;
+    uint64_t rtt_sum = 0, bus_sum = 0, stretch_sum = 0;
+    uint16_t ok = 0;
+    uint8_t i, b;
+
+    d->rtt_min_us = UINT32_MAX;
+    for (i = 0; i < I2C_DIAG_ROUNDS; i ++)
+    {
+        if (diag_probe(dev, d->addr, &rtt, &bus) != ESP_OK)
+        {
+            d->errors ++;
+            continue;
+        }
+        ok ++;
+        rtt_sum += rtt;
+        bus_sum += bus;
+        if (rtt < d->rtt_min_us) d->rtt_min_us = rtt;
+        if (rtt > d->rtt_max_us) d->rtt_max_us = rtt;
+        stretch = (bus > model_us + overhead) ? bus - model_us - overhead : 0;
+        stretch_sum += stretch;
+        if (stretch > d->stretch_max_us) d->stretch_max_us = stretch;
+
+        for (b = 0, limit = I2C_DIAG_HIST_MIN_US; b < I2C_DIAG_HIST_BUCKETS - 1 && rtt >= limit; b ++)
+        {
+            limit <<= 1;
+        }
+        d->hist[b] ++;
+    }
+    if (ok == 0)
+    {
+        d->rtt_min_us = 0;
+        return;
+    }
+    d->rtt_avg_us = (uint32_t)(rtt_sum / ok);
+    d->bus_avg_us = (uint32_t)(bus_sum / ok);
+    d->stretch_avg_us = (uint32_t)(stretch_sum / ok);
+}
+
+/**
+ * 扫描一个端口并测量各应答器件的延迟；端口须已由器件驱动初始化(I2CBus_Init)
+ * 扫描期间其它器件照常通信，探测请求按低优先级排队
+ * @param[in]   port     端口
+ * @param[out]  result   扫描结果
+ * @retval
+ *              - ESP_OK  扫描完成(总线超时中止也返回ESP_OK，见result->bus_error)
+ *              - ESP_ERR_INVALID_ARG  端口号无效
+ *              - ESP_ERR_INVALID_STATE  端口未初始化或器件表已满
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 检查端口号\n
+ */
+esp_err_t I2CDiag_Scan(i2c_port_t port, I2CDiag_Result_t *result)
+{
+    I2CBus_Device_t *dev;
+    uint32_t rtt, bus, extra, model_us;
+    uint32_t overhead = UINT32_MAX;
+    I2CDiag_Device_t *d;
+    esp_err_t ret;
+    int64_t t0;
+    uint8_t addr, i;
+
+    if (port >= I2C_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    dev = g_diag_dev[port];
+    if (dev == NULL)
+    {
+        dev = I2CBus_AddDevice(port, 0, "i2c_diag", I2C_BUS_PRIO_LOW);
+        if (dev == NULL)
+        {
+            return ESP_ERR_INVALID_STATE;
+        }
+        //无应答是扫描的常态，不重试也不触发重试退避
+        dev->no_retry = 1;
+        g_diag_dev[port] = dev;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->port = port;
+    result->clk_hz = dev->clk_hz;
+    result->lines_idle = I2CBus_LinesIdle(port);
+    model_us = I2C_DIAG_PROBE_BITS * 1000000 / dev->clk_hz;
+
+    t0 = esp_timer_get_time();
+    for (addr = I2C_DIAG_ADDR_FIRST; addr <= I2C_DIAG_ADDR_LAST; addr ++)
+    {
+        ret = diag_probe(dev, addr, &rtt, &bus);
+        extra = (bus > model_us) ? bus - model_us : 0;
+        if (ret == ESP_OK)
+        {
+            if (result->found < I2C_DIAG_MAX_FOUND)
+            {
+                d = &result->devices[result->found ++];
+                d->addr = addr;
+                d->name = diag_known_name(addr);
+            }
+        }
+        else if (ret == ESP_FAIL)
+        {
+            if (extra < overhead)
+            {
+                overhead = extra;
+            }
+        }
+        else
+        {
+            //超时:总线被拉死且恢复无效，继续扫只会每个地址都等超时
+            result->bus_error = ret;
+            break;
+        }
+    }
+    result->scan_us = (uint32_t)(esp_timer_get_time() - t0);
+    result->overhead_us = (overhead == UINT32_MAX) ? 0 : overhead;
+
+    for (i = 0; i < result->found && result->bus_error == ESP_OK; i ++)
+    {
+        diag_measure(dev, model_us, result->overhead_us, &result->devices[i]);
+    }
+    return ESP_OK;
+}
+
+/**
+ * 向报告追加一段文本，缓冲区满后截断
+ * @param[out]      buf    缓冲区
+ * @param[in]       size   缓冲区长度
+ * @param[in,out]   pos    已写入长度
+ * @param[in]       fmt    格式
+ * @retval          无
+ * @par             修改日志
+ *                   Ver0.0.1:
+                         Caesar, 2026/10/19, 初始化版本\n
+ */
+static void diag_append(char *buf, size_t size, size_t *pos, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    if (*pos + 1 >= size)
+    {
+        return;
+    }
+    va_start(ap, fmt);
+    n = vsnprintf(buf + *pos, size - *pos, fmt, ap);
+    va_end(ap);
+    if (n > 0)
+    {
+        *pos = (*pos + n < size) ? *pos + n : size - 1;
+    }
+}
+
+/**
+ * 把扫描结果格式化为文本
+ * @param[in]   result   扫描结果
+ * @param[out]  buf      缓冲区(建议I2C_DIAG_REPORT_LEN)
+ * @param[in]   size     缓冲区长度
+ * @retval      文本长度(不含结尾0，缓冲区不够时截断)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+int I2CDiag_Format(const I2CDiag_Result_t *result, char *buf, size_t size)
+{
+    const I2CDiag_Device_t *d;
+    size_t pos = 0;
+    uint8_t i, b;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+    buf[0] = '\0';
+    diag_append(buf, size, &pos, "i2c port %d %ukHz lines:%s overhead:%uus scan:%ums found:%u\n",
+                result->port, result->clk_hz / 1000, result->lines_idle ? "idle" : "STUCK",
+                result->overhead_us, result->scan_us / 1000, result->found);
+    if (result->bus_error != ESP_OK)
+    {
+        diag_append(buf, size, &pos, "  bus timeout (0x%x), scan aborted: SDA/SCL held low or controller hung\n",
+                    result->bus_error);
+    }
+    else if (result->found == 0)
+    {
+        diag_append(buf, size, &pos, "  no device answered: check power, wiring and pull-ups\n");
+    }
+    for (i = 0; i < result->found; i ++)
+    {
+        d = &result->devices[i];
+        diag_append(buf, size, &pos, "  0x%02x %-8s rtt:%u/%u/%uus bus:%uus stretch:%u/%uus err:%u\n    hist",
+                    d->addr, d->name ? d->name : "unknown", d->rtt_min_us, d->rtt_avg_us,
+                    d->rtt_max_us, d->bus_avg_us, d->stretch_avg_us, d->stretch_max_us, d->errors);
+        for (b = 0; b < I2C_DIAG_HIST_BUCKETS - 1; b ++)
+        {
+            diag_append(buf, size, &pos, " <%u:%u", I2C_DIAG_HIST_MIN_US << b, d->hist[b]);
+        }
+        diag_append(buf, size, &pos, " >=%u:%u", I2C_DIAG_HIST_MIN_US << (b - 1), d->hist[b]);
+        diag_append(buf, size, &pos, "\n");
+    }
+    return (int)pos;
+}
+
+/**
+ * 在控制台打印扫描结果
+ * @param[in]   result   扫描结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CDiag_Print(const I2CDiag_Result_t *result)
+{
+    char *buf = malloc(I2C_DIAG_REPORT_LEN);
+
+    if (buf == NULL)
+    {
+        return;
+    }
+    I2CDiag_Format(result, buf, I2C_DIAG_REPORT_LEN);
+    printf("%s", buf);
+    free(buf);
+}
+
+/**
+ * 把扫描结果的文本报告用一个UDP包发出(网络须已连接)
+ * @param[in]   result   扫描结果
+ * @param[in]   ip       目标IP(点分十进制)
+ * @param[in]   port     目标端口
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_NO_MEM
+ *              - ESP_FAIL  socket错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t I2CDiag_SendUdp(const I2CDiag_Result_t *result, const char *ip, uint16_t port)
+{
+    struct sockaddr_in to;
+    char *buf;
+    int sock, len;
+    esp_err_t ret = ESP_OK;
+
+    buf = malloc(I2C_DIAG_REPORT_LEN);
+    if (buf == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    len = I2CDiag_Format(result, buf, I2C_DIAG_REPORT_LEN);
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        free(buf);
+        return ESP_FAIL;
+    }
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    to.sin_addr.s_addr = inet_addr(ip);
+    if (sendto(sock, buf, len, 0, (struct sockaddr *)&to, sizeof(to)) < 0)
+    {
+        ret = ESP_FAIL;
+    }
+    close(sock);
+    free(buf);
+    return ret;
+}
@@ -0,0 +1,309 @@
+/*
+* @file         i2c_sched.c
+* @brief        I2C传感器轮询调度
+* @details      每个传感器的一次采样分两个动作:启动转换(释放时刻)和读取(转换完成时刻)；
+*               每轮从已到期的动作中选截止时间最早的执行，没有到期动作时用esp_timer单次定时
+*               唤醒，不按tick休眠，转换时间短于一个tick的传感器也能准时读取
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "i2c_sched.h"
+#include "string.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_SCHED_TAG       "i2c_sched"
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static I2CSched_Sensor_t g_sched_sensors[I2C_SCHED_MAX_SENSORS];
+static uint8_t g_sched_count = 0;
+static TaskHandle_t g_sched_task_handle = NULL;
+static esp_timer_handle_t g_sched_timer = NULL;
+static portMUX_TYPE g_sched_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 唤醒定时器回调
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void sched_timer_cb(void *arg)
+{
+    (void)arg;
+    xTaskNotifyGive(g_sched_task_handle);
+}
+
+/**
+ * 结束一次采样:统计截止时间，计算下一次释放时刻，已错过的整周期跳过
+ * @param[in]   s      传感器
+ * @param[in]   done   读取完成时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void sched_finish(I2CSched_Sensor_t *s, int64_t done)
+{
+    uint32_t skipped = 0;
+
+    s->converting = 0;
+    s->release_us += s->cfg.period_us;
+    if (s->release_us <= done)
+    {
+        skipped = (uint32_t)((done - s->release_us) / s->cfg.period_us) + 1;
+        s->release_us += (int64_t)skipped * s->cfg.period_us;
+    }
+    portENTER_CRITICAL(&g_sched_mux);
+    s->stats.jobs ++;
+    s->stats.skipped += skipped;
+    if (done > s->deadline_us)
+    {
+        s->stats.deadline_misses ++;
+    }
+    portEXIT_CRITICAL(&g_sched_mux);
+}
+
+/**
+ * 执行传感器的下一个动作:空闲时启动转换(连续模式直接读)，转换中时读取
+ * @param[in]   s     传感器
+ * @param[in]   now   当前时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void sched_run(I2CSched_Sensor_t *s, int64_t now)
+{
+    esp_err_t ret;
+    uint32_t late;
+
+    if (!s->converting)
+    {
+        s->deadline_us = s->release_us + s->cfg.period_us;
+        s->ready_us = s->release_us;
+        if (s->cfg.start)
+        {
+            ret = s->cfg.start(s->cfg.ctx);
+            if (ret != ESP_OK)
+            {
+                portENTER_CRITICAL(&g_sched_mux);
+                s->stats.errors ++;
+                portEXIT_CRITICAL(&g_sched_mux);
+                sched_finish(s, esp_timer_get_time());
+                return;
+            }
+            //转换期间不占总线，先去处理别的传感器
+            s->ready_us = esp_timer_get_time() + s->cfg.conv_us;
+            s->converting = 1;
+            return;
+        }
+    }
+
+    late = (uint32_t)(now - s->ready_us);
+    ret = s->cfg.read(s->cfg.ctx);
+    portENTER_CRITICAL(&g_sched_mux);
+    if (ret != ESP_OK)
+    {
+        s->stats.errors ++;
+    }
+    s->stats.late_us_last = late;
+    if (late > s->stats.late_us_max)
+    {
+        s->stats.late_us_max = late;
+    }
+    portEXIT_CRITICAL(&g_sched_mux);
+    sched_finish(s, esp_timer_get_time());
+}
+
+/**
+ * 调度任务:执行到期动作中截止时间最早的一个，都没到期就定时到最近的动作
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void sched_task(void *arg)
+{
+    I2CSched_Sensor_t *s, *best;
+    int64_t now, t, next;
+    uint8_t i, count;
+
+    (void)arg;
+    while (1)
+    {
+        now = esp_timer_get_time();
+        best = NULL;
+        next = INT64_MAX;
+        portENTER_CRITICAL(&g_sched_mux);
+        count = g_sched_count;
+        portEXIT_CRITICAL(&g_sched_mux);
+
+        for (i = 0; i < count; i ++)
+        {
+            s = &g_sched_sensors[i];
+            t = s->converting ? s->ready_us : s->release_us;
+            if (t <= now)
+            {
+                //空闲的传感器还没算本次截止时间，按释放时刻+周期比较
+                if (!s->converting)
+                {
+                    s->deadline_us = s->release_us + s->cfg.period_us;
+                }
+                if (best == NULL || s->deadline_us < best->deadline_us)
+                {
+                    best = s;
+                }
+            }
+            else if (t < next)
+            {
+                next = t;
+            }
+        }
+
+        if (best)
+        {
+            sched_run(best, now);
+            continue;
+        }
+        if (next != INT64_MAX)
+        {
+            esp_timer_stop(g_sched_timer);
+            esp_timer_start_once(g_sched_timer, (uint64_t)(next - now));
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/**
+ * 启动调度任务，传感器可以在启动前后添加
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_NO_MEM
+ *              - 其它  定时器错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t I2CSched_Start(void)
+{
+    esp_timer_create_args_t args;
+    esp_err_t ret;
+
+    if (g_sched_task_handle)
+    {
+        return ESP_OK;
+    }
+    memset(&args, 0, sizeof(args));
+    args.callback = sched_timer_cb;
+    args.name = "i2c_sched";
+    ret = esp_timer_create(&args, &g_sched_timer);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    if (xTaskCreate(sched_task, "i2c_sched_task", I2C_SCHED_TASK_STACK, NULL,
+                    I2C_SCHED_TASK_PRIO, &g_sched_task_handle) != pdPASS)
+    {
+        //删除定时器，失败后可以重新调用
+        esp_timer_delete(g_sched_timer);
+        g_sched_timer = NULL;
+        g_sched_task_handle = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+/**
+ * 添加一个传感器，第一次采样立即释放
+ * @param[in]   config   配置，内容会被拷贝
+ * @retval
+ *              调度表中的传感器，参数错误或表满时为NULL
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+I2CSched_Sensor_t *I2CSched_Add(const I2CSched_Config_t *config)
+{
+    I2CSched_Sensor_t *s = NULL;
+
+    if (config->read == NULL || config->period_us == 0 || config->conv_us >= config->period_us)
+    {
+        return NULL;
+    }
+    portENTER_CRITICAL(&g_sched_mux);
+    if (g_sched_count < I2C_SCHED_MAX_SENSORS)
+    {
+        s = &g_sched_sensors[g_sched_count];
+        memset(s, 0, sizeof(*s));
+        s->cfg = *config;
+        s->release_us = esp_timer_get_time();
+        g_sched_count ++;
+    }
+    portEXIT_CRITICAL(&g_sched_mux);
+
+    if (s && g_sched_task_handle)
+    {
+        xTaskNotifyGive(g_sched_task_handle);
+    }
+    return s;
+}
+
+/**
+ * 读取传感器统计
+ * @param[in]   sensor   传感器
+ * @param[out]  stats    统计结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CSched_GetStats(I2CSched_Sensor_t *sensor, I2CSched_Stats_t *stats)
+{
+    portENTER_CRITICAL(&g_sched_mux);
+    *stats = sensor->stats;
+    portEXIT_CRITICAL(&g_sched_mux);
+}
+
+/**
+ * 打印所有传感器的调度统计
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CSched_PrintStats(void)
+{
+    I2CSched_Stats_t stats;
+    uint8_t i;
+
+    for (i = 0; i < g_sched_count; i ++)
+    {
+        I2CSched_GetStats(&g_sched_sensors[i], &stats);
+        ESP_LOGI(I2C_SCHED_TAG, "%-8s jobs:%u err:%u miss:%u skip:%u late:%u/%uus",
+                 g_sched_sensors[i].cfg.name, stats.jobs, stats.errors,
+                 stats.deadline_misses, stats.skipped, stats.late_us_last, stats.late_us_max);
+    }
+}
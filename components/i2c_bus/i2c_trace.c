@@ -0,0 +1,179 @@
+/*
+* @file         i2c_trace.c
+* @brief        I2C传输跟踪记录
+* @details      写入只在临界区内拷贝16字节，关闭时只多一次判断；两个端口的总线任务可以同时写入。
+*               导出从上次导出的位置继续，只输出新的记录；导出期间照常记录。
+*               导出格式(每行以"#I2CT"开头，便于从日志中筛出):
+*                   #I2CT H <版本> <记录字节数> <记录条数> <上次导出后被覆盖的条数>
+*                   #I2CT D <若干条记录的十六进制>
+*                   #I2CT E <实际导出条数>(导出期间被覆盖的记录跳过，可能少于H行的条数)
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "i2c_trace.h"
+#include <stdio.h>
+#include "string.h"
+#include "freertos/FreeRTOS.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_TRACE_MASK      (I2C_TRACE_LEN - 1)
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static I2CTrace_Record_t g_trace_buf[I2C_TRACE_LEN];
+static uint32_t g_trace_head = 0;                   //写入的记录总数
+static uint32_t g_trace_tail = 0;                   //已导出到的位置(记录序号)
+static volatile bool g_trace_enabled = 0;
+static portMUX_TYPE g_trace_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 开始记录(不清除已有记录)
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CTrace_Start(void)
+{
+    g_trace_enabled = 1;
+}
+
+/**
+ * 停止记录
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CTrace_Stop(void)
+{
+    g_trace_enabled = 0;
+}
+
+/**
+ * 清除所有记录
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 同时清除导出位置\n
+ */
+void I2CTrace_Clear(void)
+{
+    portENTER_CRITICAL(&g_trace_mux);
+    g_trace_head = 0;
+    g_trace_tail = 0;
+    portEXIT_CRITICAL(&g_trace_mux);
+}
+
+/**
+ * 记录一次传输，由总线任务在每次i2c_master_cmd_begin之后调用
+ * @param[in]   port       端口
+ * @param[in]   addr       7位地址
+ * @param[in]   start_us   开始时刻
+ * @param[in]   dur_us     耗时
+ * @param[in]   tx_len     写字节数
+ * @param[in]   rx_len     读字节数
+ * @param[in]   result     结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void I2CTrace_Add(uint8_t port, uint8_t addr, int64_t start_us, uint32_t dur_us,
+                  uint16_t tx_len, uint16_t rx_len, int32_t result)
+{
+    I2CTrace_Record_t *rec;
+
+    if (!g_trace_enabled)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&g_trace_mux);
+    rec = &g_trace_buf[g_trace_head & I2C_TRACE_MASK];
+    rec->start_us = (uint32_t)start_us;
+    rec->dur_us = dur_us;
+    rec->port = port;
+    rec->addr = addr;
+    rec->tx_len = tx_len;
+    rec->rx_len = rx_len;
+    rec->result = (int16_t)result;
+    g_trace_head ++;
+    portEXIT_CRITICAL(&g_trace_mux);
+}
+
+/**
+ * 从控制台串口导出上次导出之后的新记录(从旧到新)，导出期间不暂停记录
+ * 导出开始时确定要导出的范围，之后写入的记录留给下一次导出；
+ * 逐条在临界区内拷贝，拷贝前已被新记录覆盖的跳过，E行给出实际导出的条数
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 记录导出位置，重复导出不再输出旧记录；导出期间照常记录\n
+ */
+void I2CTrace_Dump(void)
+{
+    char line[I2C_TRACE_DUMP_PER_LINE * sizeof(I2CTrace_Record_t) * 2 + 1];
+    I2CTrace_Record_t rec;
+    const uint8_t *p;
+    uint32_t head, tail, count, lost, seq, done = 0;
+    uint16_t pos = 0;
+    uint8_t j;
+    bool valid;
+
+    portENTER_CRITICAL(&g_trace_mux);
+    head = g_trace_head;
+    tail = g_trace_tail;
+    g_trace_tail = head;
+    portEXIT_CRITICAL(&g_trace_mux);
+    count = (head - tail > I2C_TRACE_LEN) ? I2C_TRACE_LEN : head - tail;
+    lost = head - tail - count;
+
+    printf("#I2CT H %d %u %u %u\n", I2C_TRACE_VERSION, (uint32_t)sizeof(I2CTrace_Record_t), count, lost);
+    for (seq = head - count; seq != head; seq ++)
+    {
+        portENTER_CRITICAL(&g_trace_mux);
+        valid = (g_trace_head - seq <= I2C_TRACE_LEN);
+        if (valid)
+        {
+            rec = g_trace_buf[seq & I2C_TRACE_MASK];
+        }
+        portEXIT_CRITICAL(&g_trace_mux);
+        if (valid)
+        {
+            p = (const uint8_t *)&rec;
+            for (j = 0; j < sizeof(rec); j ++)
+            {
+                pos += sprintf(line + pos, "%02x", p[j]);
+            }
+            done ++;
+        }
+        if ((pos > 0) && (done % I2C_TRACE_DUMP_PER_LINE == 0 || seq + 1 == head))
+        {
+            printf("#I2CT D %s\n", line);
+            pos = 0;
+        }
+    }
+    printf("#I2CT E %u\n", done);
+}
@@ -0,0 +1,117 @@
+/*
+* @file         i2c_bus.h
+* @brief        I2C总线管理
+* @details      每个I2C端口由一个总线任务独占，各器件驱动把传输请求按优先级排队交给它执行；
+*               可分块的大数据写(如OLED整屏刷新)在块之间让出总线给高优先级请求，
+*               并按器件统计占用总线的时间；传输失败时检测SDA是否被拉死，发时钟脉冲恢复总线、
+*               重装驱动，按指数退避重试，并按器件统计错误率；
+*               每个器件有自己的时钟(可在启动时自动探测)，总线任务在传输之间按需切换
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "driver/i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_BUS_MAX_DEVICES         8                   //每个端口最多挂的器件数
+#define I2C_BUS_QUEUE_LEN           8                   //每个优先级的请求队列深度
+#define I2C_BUS_PREFIX_MAX          4                   //写请求前缀(寄存器地址/控制字节)最大长度
+#define I2C_BUS_CHUNK_BYTES         128                 //可分块写的块大小，400kHz下约2.9ms
+#define I2C_BUS_TIMEOUT_MS          100                 //单次传输超时
+#define I2C_BUS_TASK_STACK          (1024*2)
+#define I2C_BUS_RETRY_MAX           3                   //失败后最多重试次数(只对不分块的请求)
+#define I2C_BUS_BACKOFF_MS          1                   //第一次重试前的等待，之后每次翻倍(按tick向上取整)
+#define I2C_BUS_BACKOFF_MAX_MS      8                   //重试等待上限
+#define I2C_BUS_TOUT_PERIODS        8                   //控制器超时(SCL周期数)，与i2c_param_config相同
+#define I2C_BUS_TOUT_MAX            0xFFFFF             //控制器超时寄存器上限(APB周期)
+#define I2C_BUS_RECOVER_HALF_US     5                   //恢复总线时SCL半周期(100kHz)
+#define I2C_BUS_ERR_WINDOW          64                  //错误率统计窗口(请求数)
+#define I2C_BUS_ERR_BUDGET          8                   //窗口内失败请求达到此数后不再重试，窗口结束恢复
+#define I2C_BUS_TUNE_ROUNDS         16                  //自动调速时每档时钟须连续探测成功的次数
+
+//自动调速的候选时钟
+#define I2C_BUS_CLK_STANDARD        100000              //标准模式
+#define I2C_BUS_CLK_FAST            400000              //快速模式
+#define I2C_BUS_CLK_FAST_PLUS       1000000             //快速+模式(需要较强的上拉)
+#define I2C_BUS_TASK_PRIO           (configMAX_PRIORITIES-1)
+
+//请求优先级
+typedef enum {
+	I2C_BUS_PRIO_HIGH = 0,          /*!< 延迟敏感的短传输(传感器读) */
+	I2C_BUS_PRIO_LOW,               /*!< 大块传输(显示刷新) */
+	I2C_BUS_PRIO_MAX
+} I2C_BUS_PRIO_t;
+
+//器件统计(单位us)
+typedef struct {
+	uint32_t requests;              /*!< 执行的请求数 */
+	uint32_t transactions;          /*!< 完成的i2c传输次数(分块写每块、每次重试各算一次) */
+	uint32_t bytes;                 /*!< 收发的负载字节数 */
+	uint32_t errors;                /*!< 重试后仍失败的请求数 */
+	uint32_t retries;               /*!< 重试次数 */
+	uint32_t recoveries;            /*!< 本器件出错触发的总线恢复次数 */
+	uint16_t err_rate_pm;           /*!< 上一个统计窗口的请求失败率(千分比) */
+	uint64_t bus_us;                /*!< 累计占用总线时间 */
+	uint32_t wait_us_last;          /*!< 上一个请求的排队等待时间 */
+	uint32_t wait_us_max;
+} I2CBus_Stats_t;
+
+//挂在总线上的器件
+typedef struct {
+	i2c_port_t port;
+	uint8_t addr;                   /*!< 7位地址 */
+	const char *name;
+	I2C_BUS_PRIO_t prio;
+	uint32_t clk_hz;                /*!< 该器件的传输时钟 */
+	bool no_retry;                  /*!< 失败不重试(自动调速、扫描等探测用) */
+	SemaphoreHandle_t lock;         /*!< 同一器件的请求串行 */
+	SemaphoreHandle_t done;         /*!< 总线任务完成请求后释放 */
+	uint16_t win_requests;          /*!< 当前统计窗口的请求数 */
+	uint16_t win_errors;            /*!< 当前统计窗口的失败请求数 */
+	I2CBus_Stats_t stats;
+} I2CBus_Device_t;
+
+//自动调速的探测函数，在当前时钟下做一次有校验的传输(应答或读回)，成功返回ESP_OK
+typedef esp_err_t (*I2CBus_Probe_t)(I2CBus_Device_t *dev, void *arg);
+
+
+esp_err_t I2CBus_Init(i2c_port_t port, int sda_io, int scl_io, uint32_t clk_hz);
+I2CBus_Device_t *I2CBus_AddDevice(i2c_port_t port, uint8_t addr, const char *name, I2C_BUS_PRIO_t prio);
+esp_err_t I2CBus_Write(I2CBus_Device_t *dev, const uint8_t *prefix, uint8_t prefix_len,
+                       const uint8_t *data, uint16_t len, bool chunked);
+esp_err_t I2CBus_Read(I2CBus_Device_t *dev, uint8_t *data, uint16_t len);
+esp_err_t I2CBus_WriteRead(I2CBus_Device_t *dev, const uint8_t *tx, uint8_t tx_len,
+                           uint8_t *rx, uint16_t rx_len);
+void I2CBus_SetClock(I2CBus_Device_t *dev, uint32_t clk_hz);
+uint32_t I2CBus_AutoTune(I2CBus_Device_t *dev, uint32_t max_hz, I2CBus_Probe_t probe, void *arg);
+bool I2CBus_LinesIdle(i2c_port_t port);
+void I2CBus_GetStats(I2CBus_Device_t *dev, I2CBus_Stats_t *stats);
+void I2CBus_PrintStats(i2c_port_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/*
+* @file         i2c_diag.h
+* @brief        I2C总线扫描与延迟诊断
+* @details      在已由器件驱动初始化的端口上扫描全部7位地址，识别已知器件，
+*               对每个应答的器件测量往返延迟分布和时钟拉伸时间；结果可打印到控制台，
+*               也可格式化为文本经UDP发送，用于区分总线变慢和器件/总线失效
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef I2C_DIAG_H
+#define I2C_DIAG_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include "i2c_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_DIAG_ADDR_FIRST         0x08                //扫描范围(0x00~0x07、0x78~0x7F为保留地址)
+#define I2C_DIAG_ADDR_LAST          0x77
+#define I2C_DIAG_MAX_FOUND          16                  //最多记录的应答器件数
+#define I2C_DIAG_ROUNDS             32                  //每个器件测量延迟的次数
+#define I2C_DIAG_HIST_BUCKETS       8                   //往返延迟直方图档数
+#define I2C_DIAG_HIST_MIN_US        64                  //第0档上限，之后每档翻倍，最后一档不封顶
+#define I2C_DIAG_REPORT_LEN         1536                //文本报告缓冲区建议长度
+
+//一个应答的器件
+typedef struct {
+	uint8_t addr;
+	const char *name;               /*!< 已知器件名，未知为NULL */
+	uint16_t errors;                /*!< 测量延迟时失败的次数 */
+	uint32_t rtt_min_us;            /*!< 往返延迟(提交请求到返回，含排队和任务切换) */
+	uint32_t rtt_avg_us;
+	uint32_t rtt_max_us;
+	uint32_t bus_avg_us;            /*!< 占用总线的时间 */
+	uint32_t stretch_avg_us;        /*!< 时钟拉伸估计:总线时间-理论位时间-驱动固有开销 */
+	uint32_t stretch_max_us;
+	uint16_t hist[I2C_DIAG_HIST_BUCKETS];
+} I2CDiag_Device_t;
+
+//一个端口的扫描结果
+typedef struct {
+	i2c_port_t port;
+	uint32_t clk_hz;                /*!< 扫描使用的时钟(端口默认时钟) */
+	bool lines_idle;                /*!< 扫描前总线是否空闲，0说明SDA/SCL被拉死 */
+	esp_err_t bus_error;            /*!< 扫描因总线超时中止时为对应错误，否则ESP_OK */
+	uint32_t overhead_us;           /*!< 驱动固有开销(无应答地址上测得的最小额外时间) */
+	uint32_t scan_us;               /*!< 扫描耗时 */
+	uint8_t found;
+	I2CDiag_Device_t devices[I2C_DIAG_MAX_FOUND];
+} I2CDiag_Result_t;
+
+
+esp_err_t I2CDiag_Scan(i2c_port_t port, I2CDiag_Result_t *result);
+int I2CDiag_Format(const I2CDiag_Result_t *result, char *buf, size_t size);
+void I2CDiag_Print(const I2CDiag_Result_t *result);
+esp_err_t I2CDiag_SendUdp(const I2CDiag_Result_t *result, const char *ip, uint16_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/*
+* @file         i2c_sched.h
+* @brief        I2C传感器轮询调度
+* @details      一个任务按表驱动所有传感器(周期、转换时间、启动/读取回调)，
+*               到期的动作按最早截止时间优先执行；启动转换后不等待，
+*               一个传感器转换期间总线可以给其它传感器读写
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef I2C_SCHED_H
+#define I2C_SCHED_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_SCHED_MAX_SENSORS       8                   //最多调度的传感器数
+#define I2C_SCHED_TASK_STACK        (1024*3)
+#define I2C_SCHED_TASK_PRIO         (configMAX_PRIORITIES-2)
+
+//传感器配置
+typedef struct {
+	const char *name;
+	uint32_t period_us;             /*!< 采样周期，也是每次采样的相对截止时间 */
+	uint32_t conv_us;               /*!< 启动转换到可以读取的时间 */
+	esp_err_t (*start)(void *ctx);  /*!< 启动一次转换，连续模式的传感器为NULL */
+	esp_err_t (*read)(void *ctx);   /*!< 读取结果并交给应用 */
+	void *ctx;
+} I2CSched_Config_t;
+
+//传感器统计
+typedef struct {
+	uint32_t jobs;                  /*!< 完成的采样次数 */
+	uint32_t errors;                /*!< start/read返回错误的次数 */
+	uint32_t deadline_misses;       /*!< 读取完成晚于截止时间的次数 */
+	uint32_t skipped;               /*!< 因超时整周期跳过的采样数 */
+	uint32_t late_us_last;          /*!< 结果可读到开始读取的延迟 */
+	uint32_t late_us_max;
+} I2CSched_Stats_t;
+
+//调度表中的传感器
+typedef struct {
+	I2CSched_Config_t cfg;
+	bool converting;                /*!< 已启动转换，等待读取 */
+	int64_t release_us;             /*!< 本次采样的释放时刻 */
+	int64_t ready_us;               /*!< 结果可读时刻 */
+	int64_t deadline_us;            /*!< 本次采样的截止时刻 */
+	I2CSched_Stats_t stats;
+} I2CSched_Sensor_t;
+
+
+esp_err_t I2CSched_Start(void);
+I2CSched_Sensor_t *I2CSched_Add(const I2CSched_Config_t *config);
+void I2CSched_GetStats(I2CSched_Sensor_t *sensor, I2CSched_Stats_t *stats);
+void I2CSched_PrintStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
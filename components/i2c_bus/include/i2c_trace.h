@@ -0,0 +1,58 @@
+/*
+* @file         i2c_trace.h
+* @brief        I2C传输跟踪记录
+* @details      总线任务每完成一次i2c传输就把端口、地址、字节数、耗时和结果写入二进制环形缓冲区，
+*               满了覆盖最旧的记录；需要时按固定格式从串口(控制台)导出上次导出之后的新记录，
+*               主机端用components/i2c_bus/tools/i2c_trace.py解析
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef I2C_TRACE_H
+#define I2C_TRACE_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_TRACE_LEN               256                 //记录条数，必须是2的幂(每条16字节)
+#define I2C_TRACE_VERSION           1                   //导出格式版本，记录结构变化时加1
+#define I2C_TRACE_DUMP_PER_LINE     4                   //导出时每行的记录数
+
+//一次i2c传输的记录，导出时按小端原样输出
+typedef struct {
+	uint32_t start_us;              /*!< 开始时刻(esp_timer低32位) */
+	uint32_t dur_us;                /*!< i2c_master_cmd_begin耗时 */
+	uint8_t  port;
+	uint8_t  addr;                  /*!< 7位地址 */
+	uint16_t tx_len;                /*!< 写字节数(含前缀，不含地址字节) */
+	uint16_t rx_len;                /*!< 读字节数 */
+	int16_t  result;                /*!< esp_err_t */
+} I2CTrace_Record_t;
+
+
+void I2CTrace_Start(void);
+void I2CTrace_Stop(void);
+void I2CTrace_Clear(void);
+void I2CTrace_Add(uint8_t port, uint8_t addr, int64_t start_us, uint32_t dur_us,
+                  uint16_t tx_len, uint16_t rx_len, int32_t result);
+void I2CTrace_Dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
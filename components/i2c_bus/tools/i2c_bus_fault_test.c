@@ -0,0 +1,308 @@
+/*
+* @file         i2c_bus_fault_test.c
+* @brief        i2c_bus重试/恢复/错误预算在PC上的故障注入测试
+* @details      用i2c_fake替身代替i2c驱动和GPIO，对不同地址的器件注入故障:
+*               1. NACK一次:退避后重试成功，不恢复总线
+*               2. 器件不在线:重试I2C_BUS_RETRY_MAX次，退避按tick取整、逐次翻倍到上限
+*               3. 超时一次:恢复总线(卸载/重装驱动)后重试成功
+*               4. SDA被拉死、几个时钟后释放:恢复时发时钟脉冲和STOP，之后总线空闲
+*               5. SDA一直被拉死:每次失败都恢复，有限时间内返回错误
+*               6. 错误预算:窗口内失败达到预算后不再重试，窗口结束后统计失败率并恢复重试
+*               7. 分块写失败不重试；自动调速期间不重试，选出从机支持的最高时钟
+*               8. 切换时钟时控制器超时(APB周期)跟着缩放
+*               9. 端口号超出范围时初始化/登记器件返回错误；初始化失败时释放队列并卸载驱动
+*               每一步都检查没有无限等待(退避等待esp_timer回调、完成信号量不会被释放等)
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include i2c_bus_fault_test.c i2c_fake.c ../i2c_bus.c
+*                     ../i2c_trace.c -o i2c_bus_fault_test
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <string.h>
+#include "i2c_bus.h"
+#include "i2c_fake.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define PORT                        I2C_NUM_0
+#define TIMEOUT_TICKS               (I2C_BUS_TIMEOUT_MS / portTICK_PERIOD_MS)
+#define CHUNKED_LEN                 (I2C_BUS_CHUNK_BYTES * 3)
+#define TOUT_CYCLES(hz)             (I2C_APB_CLK_FREQ / (hz) * I2C_BUS_TOUT_PERIODS)
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static int g_errors;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("  FAILED: %s\n", what);
+        g_errors ++;
+    }
+}
+
+//每一步结束时:没有无限等待
+static void finish(const char *name, int errors_before)
+{
+    I2CFake_Stats_t fs;
+
+    I2CFake_GetStats(&fs, 0);
+    expect(fs.unbounded_waits == 0, "no unbounded wait");
+    expect(fs.max_timeout_ticks <= TIMEOUT_TICKS, "finite transfer timeout");
+    printf("%-14s %s\n", name, g_errors == errors_before ? "ok" : "FAILED");
+}
+
+static I2CBus_Device_t *add(uint8_t addr, bool present)
+{
+    if (present)
+    {
+        I2CFake_AddSlave(addr, I2C_BUS_CLK_FAST);
+    }
+    return I2CBus_AddDevice(PORT, addr, "dev", I2C_BUS_PRIO_HIGH);
+}
+
+//第n次重试前的退避tick数
+static TickType_t backoff_ticks(uint8_t n)
+{
+    uint32_t ms = I2C_BUS_BACKOFF_MS << n;
+
+    if (ms > I2C_BUS_BACKOFF_MAX_MS)
+    {
+        ms = I2C_BUS_BACKOFF_MAX_MS;
+    }
+    return (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+}
+
+static void test_nack_once(void)
+{
+    int e = g_errors;
+    I2CBus_Device_t *dev = add(0x23, 1);
+    I2CBus_Stats_t st;
+    I2CFake_Stats_t fs;
+    uint8_t buf[2] = {0};
+
+    I2CFake_GetStats(&fs, 1);
+    I2CFake_Fault(0x23, I2C_FAKE_NACK, 1, 0);
+    expect(I2CBus_Read(dev, buf, sizeof(buf)) == ESP_OK, "read succeeds after one NACK");
+    expect(buf[0] == 0x23 && buf[1] == 0x23, "data read back");
+    I2CBus_GetStats(dev, &st);
+    I2CFake_GetStats(&fs, 0);
+    expect(st.transactions == 2 && st.retries == 1 && st.errors == 0, "one retry, no error");
+    expect(st.recoveries == 0 && fs.deletes == 0, "NACK on an idle bus does not recover");
+    expect(fs.delays == 1 && fs.delay_ticks[0] >= 1, "backoff sleeps at least one tick");
+    finish("nack once", e);
+}
+
+static void test_absent(void)
+{
+    int e = g_errors;
+    I2CBus_Device_t *dev = add(0x50, 0);
+    I2CBus_Stats_t st;
+    I2CFake_Stats_t fs;
+    uint8_t buf[2], n;
+
+    I2CFake_GetStats(&fs, 1);
+    expect(I2CBus_Read(dev, buf, sizeof(buf)) == ESP_FAIL, "absent device returns ESP_FAIL");
+    I2CBus_GetStats(dev, &st);
+    I2CFake_GetStats(&fs, 0);
+    expect(st.transactions == 1 + I2C_BUS_RETRY_MAX && st.retries == I2C_BUS_RETRY_MAX, "retries capped");
+    expect(st.errors == 1 && st.recoveries == 0, "one failed request, no recovery");
+    expect(fs.delays == I2C_BUS_RETRY_MAX, "one backoff per retry");
+    for (n = 0; n < I2C_BUS_RETRY_MAX && n < I2C_FAKE_MAX_DELAYS; n ++)
+    {
+        if (fs.delay_ticks[n] != backoff_ticks(n))
+        {
+            printf("  backoff %u: %u ticks, expected %u\n", n, fs.delay_ticks[n], backoff_ticks(n));
+            expect(0, "exponential backoff rounded up to ticks");
+        }
+    }
+    finish("absent", e);
+}
+
+static void test_timeout_once(void)
+{
+    int e = g_errors;
+    I2CBus_Device_t *dev = add(0x24, 1);
+    I2CBus_Stats_t st;
+    I2CFake_Stats_t fs;
+    uint8_t buf[2];
+
+    I2CFake_GetStats(&fs, 1);
+    I2CFake_Fault(0x24, I2C_FAKE_TIMEOUT, 1, 0);
+    expect(I2CBus_Read(dev, buf, sizeof(buf)) == ESP_OK, "read succeeds after one timeout");
+    I2CBus_GetStats(dev, &st);
+    I2CFake_GetStats(&fs, 0);
+    expect(st.recoveries == 1 && st.retries == 1, "timeout recovers the bus once, then retries");
+    expect(fs.deletes == 1 && fs.installs == 1, "driver reinstalled");
+    expect(fs.max_timeout_ticks == TIMEOUT_TICKS, "transfer timeout is I2C_BUS_TIMEOUT_MS");
+    finish("timeout once", e);
+}
+
+static void test_stuck_released(void)
+{
+    int e = g_errors;
+    I2CBus_Device_t *dev = add(0x25, 1);
+    I2CBus_Stats_t st;
+    I2CFake_Stats_t fs;
+    uint8_t buf[2];
+
+    I2CFake_GetStats(&fs, 1);
+    I2CFake_Fault(0x25, I2C_FAKE_STUCK_SDA, 1, 5);
+    expect(I2CBus_Read(dev, buf, sizeof(buf)) == ESP_OK, "read succeeds after SDA is released");
+    I2CBus_GetStats(dev, &st);
+    I2CFake_GetStats(&fs, 0);
+    expect(st.recoveries == 1, "one recovery");
+    expect(fs.scl_pulses >= 5 && fs.scl_pulses <= 10, "recovery clocks SCL until SDA is released");
+    expect(fs.stops == 1, "recovery ends with a STOP");
+    expect(I2CBus_LinesIdle(PORT), "bus idle afterwards");
+    finish("stuck sda", e);
+}
+
+static void test_stuck_forever(void)
+{
+    int e = g_errors;
+    I2CBus_Device_t *dev = add(0x26, 1);
+    I2CBus_Stats_t st;
+    I2CFake_Stats_t fs;
+    uint8_t buf[2];
+    int64_t t0 = g_i2c_fake_us;
+
+    I2CFake_GetStats(&fs, 1);
+    I2CFake_Fault(0x26, I2C_FAKE_STUCK_SDA, 1, 0);
+    expect(I2CBus_Read(dev, buf, sizeof(buf)) == ESP_ERR_TIMEOUT, "stuck bus returns ESP_ERR_TIMEOUT");
+    I2CBus_GetStats(dev, &st);
+    expect(st.recoveries == 1 + I2C_BUS_RETRY_MAX, "every failed attempt recovers");
+    expect(!I2CBus_LinesIdle(PORT), "bus reported stuck");
+    expect(g_i2c_fake_us - t0 < (1 + I2C_BUS_RETRY_MAX) * (TIMEOUT_TICKS + 1) * portTICK_PERIOD_MS * 1000LL,
+           "gives up in bounded time");
+    finish("stuck forever", e);
+
+    //后面的测试需要空闲的总线
+    I2CFake_Reset();
+}
+
+static void test_budget(void)
+{
+    int e = g_errors;
+    I2CBus_Device_t *dev = add(0x51, 0);
+    I2CBus_Stats_t st;
+    uint32_t before, txns;
+    uint8_t buf[2];
+    uint16_t i;
+
+    for (i = 0; i < I2C_BUS_ERR_WINDOW; i ++)
+    {
+        I2CBus_GetStats(dev, &st);
+        before = st.transactions;
+        I2CBus_Read(dev, buf, sizeof(buf));
+        I2CBus_GetStats(dev, &st);
+        txns = st.transactions - before;
+        if (txns != (i < I2C_BUS_ERR_BUDGET ? 1 + I2C_BUS_RETRY_MAX : 1u))
+        {
+            printf("  request %u: %u transactions\n", i, txns);
+            expect(0, "retries stop once the error budget is spent");
+            break;
+        }
+    }
+    I2CBus_GetStats(dev, &st);
+    expect(st.err_rate_pm == 1000, "window error rate 100%");
+    before = st.transactions;
+    I2CBus_Read(dev, buf, sizeof(buf));
+    I2CBus_GetStats(dev, &st);
+    expect(st.transactions - before == 1 + I2C_BUS_RETRY_MAX, "retries resume in the next window");
+    finish("error budget", e);
+}
+
+static void test_chunked_and_tune(void)
+{
+    static uint8_t data[CHUNKED_LEN];
+    int e = g_errors;
+    I2CBus_Device_t *oled, *dev;
+    I2CBus_Stats_t st;
+    uint8_t ctrl = 0x40, buf[2];
+
+    I2CFake_AddSlave(0x3C, I2C_BUS_CLK_FAST);
+    oled = I2CBus_AddDevice(PORT, 0x3C, "oled", I2C_BUS_PRIO_LOW);
+    I2CFake_Fault(0x3C, I2C_FAKE_NACK, 1, 0);
+    expect(I2CBus_Write(oled, &ctrl, 1, data, sizeof(data), 1) == ESP_FAIL, "chunked write reports the NACK");
+    I2CBus_GetStats(oled, &st);
+    expect(st.transactions == 1 && st.retries == 0, "chunked write stops without retrying");
+    expect(I2CBus_Write(oled, &ctrl, 1, data, sizeof(data), 1) == ESP_OK, "chunked write ok");
+    I2CBus_GetStats(oled, &st);
+    expect(st.transactions == 1 + CHUNKED_LEN / I2C_BUS_CHUNK_BYTES, "one transaction per chunk");
+
+    //从机只支持到400kHz:1MHz探测失败不重试，停在400kHz
+    dev = add(0x29, 1);
+    expect(I2CBus_AutoTune(dev, I2C_BUS_CLK_FAST_PLUS, NULL, NULL) == I2C_BUS_CLK_FAST, "tuned to 400kHz");
+    I2CBus_GetStats(dev, &st);
+    expect(st.retries == 0, "no retries while tuning");
+    expect(I2CBus_Read(dev, buf, sizeof(buf)) == ESP_OK && I2CFake_ClockHz() == I2C_BUS_CLK_FAST,
+           "reads run at the tuned clock");
+    expect(I2CFake_TimeoutCycles() == TOUT_CYCLES(I2C_BUS_CLK_FAST), "controller timeout scaled to 400kHz");
+    //另一个器件用默认的100kHz:超时要跟着放大，不能沿用400kHz的
+    expect(I2CBus_Read(oled, buf, sizeof(buf)) == ESP_OK && I2CFake_ClockHz() == I2C_BUS_CLK_STANDARD,
+           "other device back at 100kHz");
+    expect(I2CFake_TimeoutCycles() == TOUT_CYCLES(I2C_BUS_CLK_STANDARD), "controller timeout scaled to 100kHz");
+    finish("chunked/tune", e);
+}
+
+static void test_init(void)
+{
+    I2CFake_Stats_t fs;
+    int e = g_errors;
+
+    I2CFake_Reset();
+    expect(I2CBus_Init(I2C_NUM_MAX, I2C_FAKE_SDA_IO, I2C_FAKE_SCL_IO, I2C_BUS_CLK_STANDARD) == ESP_ERR_INVALID_ARG,
+           "init rejects an out-of-range port");
+    expect(I2CBus_AddDevice(I2C_NUM_MAX, 0x3C, "dev", I2C_BUS_PRIO_HIGH) == NULL,
+           "add device rejects an out-of-range port");
+    I2CFake_FailTaskCreate(1);
+    expect(I2CBus_Init(PORT, I2C_FAKE_SDA_IO, I2C_FAKE_SCL_IO, I2C_BUS_CLK_STANDARD) == ESP_ERR_NO_MEM,
+           "init reports a failed task create");
+    I2CFake_FailTaskCreate(0);
+    I2CFake_GetStats(&fs, 1);
+    expect(fs.installs == 1 && fs.deletes == 1, "failed init deletes the driver");
+    expect(g_i2c_fake_objects == 0, "failed init deletes the queues");
+    expect(I2CBus_AddDevice(PORT, 0x3C, "dev", I2C_BUS_PRIO_HIGH) == NULL, "failed init leaves the port unusable");
+    finish("init", e);
+}
+
+int main(void)
+{
+    test_init();
+    I2CFake_Reset();
+    if (I2CBus_Init(PORT, I2C_FAKE_SDA_IO, I2C_FAKE_SCL_IO, I2C_BUS_CLK_STANDARD) != ESP_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    test_nack_once();
+    test_absent();
+    test_timeout_once();
+    test_stuck_released();
+    test_stuck_forever();
+    test_budget();
+    test_chunked_and_tune();
+    I2CBus_PrintStats(PORT);
+    printf("%s\n", g_errors ? "FAILED" : "ok");
+    return g_errors ? 1 : 0;
+}
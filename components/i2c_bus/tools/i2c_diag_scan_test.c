@@ -0,0 +1,141 @@
+/*
+* @file         i2c_diag_scan_test.c
+* @brief        I2CDiag_Scan在PC上的测试
+* @details      用i2c_fake替身模拟总线(BH1750、SSD1306和一个未知器件):
+*               1. 端口号越界返回ESP_ERR_INVALID_ARG，未初始化的端口返回ESP_ERR_INVALID_STATE
+*               2. 扫描找到全部应答器件并识别已知器件名，无应答的地址不重试，
+*                  每个器件测量I2C_DIAG_ROUNDS次，直方图计数与之相符，文本报告列出器件
+*               3. 再次扫描复用同一个探测器件，不多占器件表
+*               4. 扫描中途SDA被拉死:在该地址中止并报告总线错误，不逐个地址等超时
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include i2c_diag_scan_test.c i2c_fake.c ../i2c_diag.c
+*                     ../i2c_bus.c ../i2c_trace.c -o i2c_diag_scan_test
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <string.h>
+#include "i2c_diag.h"
+#include "i2c_fake.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define PORT                        I2C_NUM_0
+#define UNKNOWN_ADDR                0x48
+#define PROBES                      (I2C_DIAG_ADDR_LAST - I2C_DIAG_ADDR_FIRST + 1)
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static int g_errors;
+static I2CDiag_Result_t g_result;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("  FAILED: %s\n", what);
+        g_errors ++;
+    }
+}
+
+static void test_args(void)
+{
+    int e = g_errors;
+
+    expect(I2CDiag_Scan(I2C_NUM_MAX, &g_result) == ESP_ERR_INVALID_ARG, "port I2C_NUM_MAX rejected");
+    expect(I2CDiag_Scan((i2c_port_t)(I2C_NUM_MAX + 7), &g_result) == ESP_ERR_INVALID_ARG, "large port rejected");
+    expect(I2CDiag_Scan(I2C_NUM_1, &g_result) == ESP_ERR_INVALID_STATE, "uninitialized port rejected");
+    printf("%-10s %s\n", "args", g_errors == e ? "ok" : "FAILED");
+}
+
+static void test_scan(void)
+{
+    static const uint8_t addrs[] = {0x23, 0x3C, UNKNOWN_ADDR};
+    static char report[I2C_DIAG_REPORT_LEN];
+    int e = g_errors;
+    I2CFake_Stats_t fs;
+    const I2CDiag_Device_t *d;
+    uint32_t sum;
+    uint8_t i, b;
+
+    I2CFake_GetStats(&fs, 1);
+    expect(I2CDiag_Scan(PORT, &g_result) == ESP_OK, "scan ok");
+    I2CFake_GetStats(&fs, 0);
+    expect(g_result.lines_idle && g_result.bus_error == ESP_OK, "bus idle, no bus error");
+    expect(g_result.clk_hz == I2C_BUS_CLK_STANDARD, "scan at the port clock");
+    expect(g_result.found == sizeof(addrs), "all responding devices found");
+    for (i = 0; i < g_result.found && i < sizeof(addrs); i ++)
+    {
+        d = &g_result.devices[i];
+        expect(d->addr == addrs[i], "devices listed in address order");
+        expect((d->addr == UNKNOWN_ADDR) == (d->name == NULL), "known devices named");
+        expect(d->errors == 0 && d->rtt_min_us <= d->rtt_avg_us && d->rtt_avg_us <= d->rtt_max_us,
+               "latency measured");
+        for (b = 0, sum = 0; b < I2C_DIAG_HIST_BUCKETS; b ++)
+        {
+            sum += d->hist[b];
+        }
+        expect(sum == I2C_DIAG_ROUNDS, "histogram counts every round");
+    }
+    expect(fs.txns == (uint32_t)(PROBES + g_result.found * I2C_DIAG_ROUNDS), "absent addresses probed once, no retries");
+    expect(fs.delays == 0 && fs.unbounded_waits == 0, "no backoff, no unbounded wait");
+    I2CDiag_Format(&g_result, report, sizeof(report));
+    expect(strstr(report, "BH1750") != NULL && strstr(report, "SSD1306") != NULL, "report names the devices");
+
+    //再扫一次用同一个探测器件
+    expect(I2CDiag_Scan(PORT, &g_result) == ESP_OK && g_result.found == sizeof(addrs), "rescan ok");
+    printf("%-10s %s\n", "scan", g_errors == e ? "ok" : "FAILED");
+    I2CDiag_Print(&g_result);
+}
+
+static void test_stuck(void)
+{
+    int e = g_errors;
+    I2CFake_Stats_t fs;
+
+    I2CFake_GetStats(&fs, 1);
+    I2CFake_Fault(0x3C, I2C_FAKE_STUCK_SDA, I2C_FAKE_FOREVER, 0);
+    expect(I2CDiag_Scan(PORT, &g_result) == ESP_OK, "scan returns ESP_OK with a bus error");
+    I2CFake_GetStats(&fs, 0);
+    expect(g_result.bus_error == ESP_ERR_TIMEOUT, "bus error reported");
+    expect(g_result.found == 1 && g_result.devices[0].addr == 0x23, "devices before the stuck address kept");
+    expect(fs.txns == 0x3C - I2C_DIAG_ADDR_FIRST + 1, "scan stops at the stuck address");
+    expect(fs.unbounded_waits == 0, "no unbounded wait");
+    expect(I2CDiag_Scan(PORT, &g_result) == ESP_OK && !g_result.lines_idle, "next scan reports stuck lines");
+    printf("%-10s %s\n", "stuck", g_errors == e ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    I2CFake_Reset();
+    I2CFake_AddSlave(0x23, I2C_BUS_CLK_FAST);
+    I2CFake_AddSlave(0x3C, I2C_BUS_CLK_FAST);
+    I2CFake_AddSlave(UNKNOWN_ADDR, I2C_BUS_CLK_STANDARD);
+    if (I2CBus_Init(PORT, I2C_FAKE_SDA_IO, I2C_FAKE_SCL_IO, I2C_BUS_CLK_STANDARD) != ESP_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    test_args();
+    test_scan();
+    test_stuck();
+    printf("%s\n", g_errors ? "FAILED" : "ok");
+    return g_errors ? 1 : 0;
+}
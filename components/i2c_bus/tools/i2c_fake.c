@@ -0,0 +1,594 @@
+/*
+* @file         i2c_fake.c
+* @brief        PC上的I2C总线替身
+* @details      单线程运行:调用者在完成信号量上等待时就地运行总线任务，总线任务在
+*               pending上无限等待(队列已取空)时用longjmp退回调用者；
+*               此时完成信号量仍未释放说明调用者会永远等下去，记为一次死锁
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "i2c_fake.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "rom/ets_sys.h"
+#include "esp_timer.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define FAKE_MAX_SLAVES             8
+#define FAKE_MAX_READS              4
+#define FAKE_TICK_US                (portTICK_PERIOD_MS * 1000)
+
+//登记的从机
+typedef struct {
+	uint8_t addr;
+	uint32_t max_hz;                /*!< 超过此时钟时不应答 */
+	I2C_FAKE_FAULT_t fault;
+	uint32_t fault_count;           /*!< 还要注入故障的传输数 */
+	uint8_t release_clocks;         /*!< SDA被拉死后释放需要的SCL脉冲数，0为不释放 */
+} fake_slave_t;
+
+//命令链:只记录地址、字节数和读缓冲
+typedef struct {
+	bool has_addr;
+	uint8_t addr;
+	uint16_t bytes;
+	uint8_t n_reads;
+	uint8_t *rx[FAKE_MAX_READS];
+	size_t rx_len[FAKE_MAX_READS];
+} fake_cmd_t;
+
+typedef struct {
+	int count;
+	int max;
+} fake_sem_t;
+
+typedef struct {
+	uint8_t *buf;
+	UBaseType_t len;
+	UBaseType_t size;
+	UBaseType_t head;
+	UBaseType_t count;
+} fake_queue_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+int64_t g_i2c_fake_us;
+int g_i2c_fake_objects;
+
+static fake_slave_t g_slaves[FAKE_MAX_SLAVES];
+static uint8_t g_slave_count;
+static I2CFake_Stats_t g_stats;
+//控制器和线路状态
+static bool g_installed;
+static bool g_fail_task;
+static uint32_t g_clk_hz;
+static int g_tout;                  //控制器超时(APB周期)
+static uint8_t g_master_sda = 1, g_master_scl = 1;
+static bool g_sda_held;
+static uint8_t g_release_clocks, g_clocks_seen;
+//总线任务
+static TaskFunction_t g_task_fn;
+static void *g_task_arg;
+static bool g_in_task;
+static jmp_buf g_task_idle;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+void I2CFake_Reset(void)
+{
+    memset(g_slaves, 0, sizeof(g_slaves));
+    g_slave_count = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_sda_held = 0;
+}
+
+void I2CFake_AddSlave(uint8_t addr, uint32_t max_hz)
+{
+    fake_slave_t *s = &g_slaves[g_slave_count ++];
+
+    memset(s, 0, sizeof(*s));
+    s->addr = addr;
+    s->max_hz = max_hz;
+}
+
+//接下来count次访问addr的传输注入故障
+void I2CFake_Fault(uint8_t addr, I2C_FAKE_FAULT_t fault, uint32_t count, uint8_t release_clocks)
+{
+    uint8_t i;
+
+    for (i = 0; i < g_slave_count; i ++)
+    {
+        if (g_slaves[i].addr == addr)
+        {
+            g_slaves[i].fault = fault;
+            g_slaves[i].fault_count = count;
+            g_slaves[i].release_clocks = release_clocks;
+        }
+    }
+}
+
+//之后的xTaskCreate都失败，用于检查初始化失败时的释放
+void I2CFake_FailTaskCreate(bool fail)
+{
+    g_fail_task = fail;
+}
+
+uint32_t I2CFake_ClockHz(void)
+{
+    return g_clk_hz;
+}
+
+//控制器超时(APB周期)
+int I2CFake_TimeoutCycles(void)
+{
+    return g_tout;
+}
+
+void I2CFake_GetStats(I2CFake_Stats_t *stats, bool reset)
+{
+    *stats = g_stats;
+    if (reset)
+    {
+        memset(&g_stats, 0, sizeof(g_stats));
+    }
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return g_i2c_fake_us;
+}
+
+void ets_delay_us(uint32_t us)
+{
+    g_i2c_fake_us += us;
+}
+
+/*
+ * GPIO:主机开漏输出，从机拉住时SDA读到低电平
+ */
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    (void)cfg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level)
+{
+    if (gpio == I2C_FAKE_SCL_IO)
+    {
+        if (!g_master_scl && level)
+        {
+            g_stats.scl_pulses ++;
+            if (g_sda_held && g_release_clocks && ++ g_clocks_seen >= g_release_clocks)
+            {
+                g_sda_held = 0;
+            }
+        }
+        g_master_scl = level;
+    }
+    else if (gpio == I2C_FAKE_SDA_IO)
+    {
+        if (!g_master_sda && level && g_master_scl && !g_sda_held)
+        {
+            g_stats.stops ++;
+        }
+        g_master_sda = level;
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio)
+{
+    if (gpio == I2C_FAKE_SDA_IO)
+    {
+        return g_master_sda && !g_sda_held;
+    }
+    return (gpio == I2C_FAKE_SCL_IO) ? g_master_scl : 1;
+}
+
+/*
+ * i2c驱动
+ */
+esp_err_t i2c_param_config(i2c_port_t port, const i2c_config_t *conf)
+{
+    (void)port;
+    g_clk_hz = conf->master.clk_speed;
+    g_tout = I2C_APB_CLK_FREQ / conf->master.clk_speed * 8;
+    return ESP_OK;
+}
+
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode, size_t slv_rx_buf_len,
+                             size_t slv_tx_buf_len, int intr_alloc_flags)
+{
+    (void)port;
+    (void)mode;
+    (void)slv_rx_buf_len;
+    (void)slv_tx_buf_len;
+    (void)intr_alloc_flags;
+    g_stats.installs ++;
+    g_installed = 1;
+    g_master_sda = g_master_scl = 1;
+    return ESP_OK;
+}
+
+esp_err_t i2c_driver_delete(i2c_port_t port)
+{
+    (void)port;
+    g_stats.deletes ++;
+    g_installed = 0;
+    return ESP_OK;
+}
+
+esp_err_t i2c_set_period(i2c_port_t port, int high_period, int low_period)
+{
+    (void)port;
+    g_clk_hz = I2C_APB_CLK_FREQ / (high_period + low_period);
+    return ESP_OK;
+}
+
+esp_err_t i2c_set_start_timing(i2c_port_t port, int setup_time, int hold_time)
+{
+    (void)port;
+    (void)setup_time;
+    (void)hold_time;
+    return ESP_OK;
+}
+
+esp_err_t i2c_set_stop_timing(i2c_port_t port, int setup_time, int hold_time)
+{
+    (void)port;
+    (void)setup_time;
+    (void)hold_time;
+    return ESP_OK;
+}
+
+esp_err_t i2c_set_data_timing(i2c_port_t port, int sample_time, int hold_time)
+{
+    (void)port;
+    (void)sample_time;
+    (void)hold_time;
+    return ESP_OK;
+}
+
+esp_err_t i2c_set_timeout(i2c_port_t port, int timeout)
+{
+    (void)port;
+    g_tout = timeout;
+    return ESP_OK;
+}
+
+i2c_cmd_handle_t i2c_cmd_link_create(void)
+{
+    return calloc(1, sizeof(fake_cmd_t));
+}
+
+void i2c_cmd_link_delete(i2c_cmd_handle_t cmd)
+{
+    free(cmd);
+}
+
+esp_err_t i2c_master_start(i2c_cmd_handle_t cmd)
+{
+    (void)cmd;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_stop(i2c_cmd_handle_t cmd)
+{
+    (void)cmd;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data, bool ack_en)
+{
+    fake_cmd_t *c = cmd;
+
+    (void)ack_en;
+    if (!c->has_addr)
+    {
+        c->has_addr = 1;
+        c->addr = data >> 1;
+    }
+    c->bytes ++;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_write(i2c_cmd_handle_t cmd, uint8_t *data, size_t len, bool ack_en)
+{
+    (void)data;
+    (void)ack_en;
+    ((fake_cmd_t *)cmd)->bytes += len;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_read(i2c_cmd_handle_t cmd, uint8_t *data, size_t len, int ack)
+{
+    fake_cmd_t *c = cmd;
+
+    (void)ack;
+    if (c->n_reads < FAKE_MAX_READS)
+    {
+        c->rx[c->n_reads] = data;
+        c->rx_len[c->n_reads ++] = len;
+    }
+    c->bytes += len;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_read_byte(i2c_cmd_handle_t cmd, uint8_t *data, int ack)
+{
+    return i2c_master_read(cmd, data, 1, ack);
+}
+
+//执行命令链:按时钟占用模拟时间，从机读回的数据固定为自己的地址
+esp_err_t i2c_master_cmd_begin(i2c_port_t port, i2c_cmd_handle_t cmd, TickType_t ticks)
+{
+    fake_cmd_t *c = cmd;
+    fake_slave_t *s = NULL;
+    int64_t timeout_us = (int64_t)ticks * FAKE_TICK_US;
+    uint32_t byte_us = 9 * 1000000 / g_clk_hz;
+    uint8_t i;
+
+    (void)port;
+    g_stats.txns ++;
+    if (ticks > g_stats.max_timeout_ticks)
+    {
+        g_stats.max_timeout_ticks = ticks;
+    }
+    if (!g_installed)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (g_sda_held)
+    {
+        g_i2c_fake_us += timeout_us;
+        return ESP_ERR_TIMEOUT;
+    }
+    for (i = 0; i < g_slave_count; i ++)
+    {
+        if (g_slaves[i].addr == c->addr)
+        {
+            s = &g_slaves[i];
+        }
+    }
+    if (s && s->fault_count)
+    {
+        if (s->fault_count != I2C_FAKE_FOREVER)
+        {
+            s->fault_count --;
+        }
+        switch (s->fault)
+        {
+            case I2C_FAKE_STUCK_SDA:
+                g_sda_held = 1;
+                g_release_clocks = s->release_clocks;
+                g_clocks_seen = 0;
+                g_i2c_fake_us += timeout_us;
+                return ESP_ERR_TIMEOUT;
+            case I2C_FAKE_TIMEOUT:
+                g_i2c_fake_us += timeout_us;
+                return ESP_ERR_TIMEOUT;
+            default:
+                s = NULL;
+                break;
+        }
+    }
+    if (s == NULL || g_clk_hz > s->max_hz)
+    {
+        g_i2c_fake_us += byte_us;
+        return ESP_FAIL;
+    }
+    for (i = 0; i < c->n_reads; i ++)
+    {
+        memset(c->rx[i], s->addr, c->rx_len[i]);
+    }
+    g_i2c_fake_us += (int64_t)c->bytes * byte_us;
+    return ESP_OK;
+}
+
+/*
+ * FreeRTOS:总线任务在调用者的上下文里运行
+ */
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle)
+{
+    (void)name;
+    (void)stack;
+    (void)prio;
+    if (g_fail_task)
+    {
+        return pdFAIL;
+    }
+    g_task_fn = fn;
+    g_task_arg = arg;
+    *handle = (TaskHandle_t)fn;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (g_stats.delays < I2C_FAKE_MAX_DELAYS)
+    {
+        g_stats.delay_ticks[g_stats.delays] = ticks;
+    }
+    g_stats.delays ++;
+    g_i2c_fake_us += (int64_t)ticks * FAKE_TICK_US;
+}
+
+//没有别的任务会发通知，无限等待就是死锁
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t timeout)
+{
+    (void)clear;
+    if (timeout == portMAX_DELAY)
+    {
+        g_stats.unbounded_waits ++;
+    }
+    return 0;
+}
+
+void xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+}
+
+static void run_bus_task(void)
+{
+    if (g_in_task || g_task_fn == NULL)
+    {
+        return;
+    }
+    g_in_task = 1;
+    if (setjmp(g_task_idle) == 0)
+    {
+        g_task_fn(g_task_arg);
+    }
+    g_in_task = 0;
+}
+
+static SemaphoreHandle_t sem_create(int max, int initial)
+{
+    fake_sem_t *s = malloc(sizeof(*s));
+
+    s->max = max;
+    s->count = initial;
+    g_i2c_fake_objects ++;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return sem_create(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return sem_create(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+    return sem_create(max, initial);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    g_i2c_fake_objects --;
+    free(sem);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    fake_sem_t *s = sem;
+
+    if (s->count >= s->max)
+    {
+        return pdFALSE;
+    }
+    s->count ++;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout)
+{
+    fake_sem_t *s = sem;
+
+    if (s->count == 0 && timeout != 0)
+    {
+        if (g_in_task)
+        {
+            //总线任务取空了队列，回到调用者
+            if (timeout == portMAX_DELAY)
+            {
+                longjmp(g_task_idle, 1);
+            }
+            g_i2c_fake_us += (int64_t)timeout * FAKE_TICK_US;
+            return pdFALSE;
+        }
+        run_bus_task();
+        if (s->count == 0 && timeout == portMAX_DELAY)
+        {
+            g_stats.unbounded_waits ++;
+        }
+    }
+    if (s->count == 0)
+    {
+        return pdFALSE;
+    }
+    s->count --;
+    return pdTRUE;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size)
+{
+    fake_queue_t *q = calloc(1, sizeof(*q));
+
+    q->buf = malloc(len * item_size);
+    q->len = len;
+    q->size = item_size;
+    g_i2c_fake_objects ++;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    fake_queue_t *q = queue;
+
+    g_i2c_fake_objects --;
+    free(q->buf);
+    free(q);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t timeout)
+{
+    fake_queue_t *q = queue;
+
+    (void)timeout;
+    if (q->count == q->len)
+    {
+        return pdFALSE;
+    }
+    memcpy(q->buf + ((q->head + q->count) % q->len) * q->size, item, q->size);
+    q->count ++;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t timeout)
+{
+    fake_queue_t *q = queue;
+
+    (void)timeout;
+    if (q->count == 0)
+    {
+        return pdFALSE;
+    }
+    memcpy(item, q->buf + q->head * q->size, q->size);
+    q->head = (q->head + 1) % q->len;
+    q->count --;
+    return pdTRUE;
+}
@@ -0,0 +1,68 @@
+/*
+* @file         i2c_fake.h
+* @brief        PC上的I2C总线替身
+* @details      提供i2c驱动、GPIO、队列/信号量/任务的替身，i2c_bus.c不改动直接链接:
+*               总线任务在调用者等待完成信号量时就地运行，队列取空时退回调用者；
+*               总线上的从机按地址登记，可注入NACK、超时和SDA被从机拉死(恢复时发够
+*               时钟脉冲才释放，或一直不释放)；传输、退避、超时都按模拟时间计时
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef I2C_FAKE_H
+#define I2C_FAKE_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver/i2c.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define I2C_FAKE_SDA_IO             32
+#define I2C_FAKE_SCL_IO             33
+#define I2C_FAKE_FOREVER            0xFFFFFFFFU         //故障一直持续
+#define I2C_FAKE_MAX_DELAYS         16                  //记录的vTaskDelay次数
+
+//注入的故障
+typedef enum {
+	I2C_FAKE_NACK = 0,              /*!< 从机不应答，总线空闲 */
+	I2C_FAKE_TIMEOUT,               /*!< 传输超时(从机拉住SCL)，之后总线空闲 */
+	I2C_FAKE_STUCK_SDA,             /*!< 从机把SDA拉死，传输超时 */
+} I2C_FAKE_FAULT_t;
+
+//替身统计
+typedef struct {
+	uint32_t txns;                  /*!< i2c_master_cmd_begin次数 */
+	uint32_t installs;              /*!< 安装驱动次数 */
+	uint32_t deletes;               /*!< 卸载驱动次数 */
+	uint32_t scl_pulses;            /*!< GPIO方式发出的SCL脉冲数 */
+	uint32_t stops;                 /*!< GPIO方式发出的STOP数 */
+	uint32_t delays;                /*!< 总线任务vTaskDelay次数 */
+	TickType_t delay_ticks[I2C_FAKE_MAX_DELAYS];
+	TickType_t max_timeout_ticks;   /*!< 传给i2c_master_cmd_begin的最大超时 */
+	uint32_t unbounded_waits;       /*!< 无限等待且不会被满足的次数(死锁) */
+} I2CFake_Stats_t;
+
+//模拟时钟(us)
+extern int64_t g_i2c_fake_us;
+//还没有删除的队列和信号量数
+extern int g_i2c_fake_objects;
+
+
+void I2CFake_Reset(void);
+void I2CFake_AddSlave(uint8_t addr, uint32_t max_hz);
+void I2CFake_Fault(uint8_t addr, I2C_FAKE_FAULT_t fault, uint32_t count, uint8_t release_clocks);
+uint32_t I2CFake_ClockHz(void);
+void I2CFake_FailTaskCreate(bool fail);
+int I2CFake_TimeoutCycles(void);
+void I2CFake_GetStats(I2CFake_Stats_t *stats, bool reset);
+
+#endif
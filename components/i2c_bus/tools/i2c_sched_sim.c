@@ -0,0 +1,377 @@
+/*
+* @file         i2c_sched_sim.c
+* @brief        i2c_sched调度器在PC上的模拟
+* @details      用替身的FreeRTOS/esp_timer在模拟时间上运行调度任务:等通知时前进到单次定时器的
+*               到期时刻，start/read回调按模拟的总线时间前进；总线上挂BH1750(单次高分辨率，
+*               180ms转换)和一个模拟的第二个器件(单次低分辨率，24ms转换)，再加一个连续模式的器件
+*               1. 稳定运行:采样次数符合周期，没有截止时间错过和跳过，转换完成前不读取，
+*                  读取延迟不超过一次总线传输，释放时刻不随时间漂移
+*               2. 一个器件转换期间其它器件的传输照常进行(流水线)
+*               3. 第二个器件的一次读取卡住超过一个周期:按整周期跳过，之后回到原来的时间格上
+*               4. start/read返回错误时计数，后续采样照常
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include i2c_sched_sim.c ../i2c_sched.c -o i2c_sched_sim
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "i2c_sched.h"
+#include "esp_timer.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define STEADY_US                   2000000             //稳定运行时间
+#define STALL_US                    70000               //第二个器件一次读取卡住的时间
+#define RECOVER_US                  3000000             //卡住之后继续运行的时间
+#define START_BUS_US                300                 //一次启动转换的总线时间(写1字节)
+#define READ_BUS_US                 600                 //一次读取的总线时间(读2字节)
+#define LATE_BOUND_US               (2 * READ_BUS_US)   //读取延迟上限:最多等一次别的传输
+
+//模拟器件
+typedef struct {
+	const char *name;
+	uint32_t period_us;
+	uint32_t conv_us;
+	bool once;                      /*!< 单次模式，每次采样先启动转换 */
+	uint32_t fail_every;            /*!< 每隔几次start/read返回错误，0为不出错 */
+	uint32_t stall_us;              /*!< 下一次读取额外占用的总线时间 */
+	int64_t first_us;               /*!< 第一次动作的时刻，释放时间格的起点 */
+	int64_t started_us;             /*!< 本次启动转换的时刻 */
+	uint32_t calls;
+	uint32_t reads;
+	uint32_t early_reads;           /*!< 转换完成前读取的次数 */
+	uint32_t drift_us_max;          /*!< 启动时刻偏离释放时间格的最大值 */
+	uint32_t overlapped;            /*!< 其它器件转换期间执行的动作数 */
+	I2CSched_Sensor_t *sensor;
+} sim_dev_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static int64_t g_now_us;
+static int64_t g_timer_at_us = -1;
+static int64_t g_run_end_us;
+static jmp_buf g_task_exit;
+static TaskFunction_t g_task_fn;
+static esp_timer_cb_t g_timer_cb;
+
+static sim_dev_t g_bh1750 = {.name = "bh1750", .period_us = 200000, .conv_us = 180000, .once = 1};
+static sim_dev_t g_second = {.name = "second", .period_us = 50000, .conv_us = 24000, .once = 1};
+static sim_dev_t g_cont = {.name = "cont", .period_us = 100000, .fail_every = 7};
+static sim_dev_t *g_devs[] = {&g_bh1750, &g_second, &g_cont};
+#define DEV_COUNT                   (sizeof(g_devs) / sizeof(g_devs[0]))
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+int64_t esp_timer_get_time(void)
+{
+    return g_now_us;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle)
+{
+    g_timer_cb = args->callback;
+    *handle = (esp_timer_handle_t)malloc(1);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    (void)timer;
+    g_timer_at_us = g_now_us + (int64_t)timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    (void)timer;
+    g_timer_at_us = -1;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    free(timer);
+    return ESP_OK;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle)
+{
+    (void)name;
+    (void)stack;
+    (void)arg;
+    (void)prio;
+    g_task_fn = fn;
+    *handle = (TaskHandle_t)fn;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    (void)ticks;
+}
+
+void xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+}
+
+//调度任务等通知:前进到定时器到期时刻并执行定时器回调，到运行结束时刻就退出任务
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t timeout)
+{
+    (void)clear;
+    (void)timeout;
+    if (g_timer_at_us < 0)
+    {
+        printf("scheduler idle with no timer armed at %lld us\n", (long long)g_now_us);
+        exit(1);
+    }
+    if (g_timer_at_us >= g_run_end_us)
+    {
+        g_now_us = g_run_end_us;
+        longjmp(g_task_exit, 1);
+    }
+    if (g_now_us < g_timer_at_us)
+    {
+        g_now_us = g_timer_at_us;
+    }
+    g_timer_at_us = -1;
+    g_timer_cb(NULL);
+    return 1;
+}
+
+//在模拟时间上运行调度任务，每次从任务入口重新进入，状态都在调度表里
+static void run_task(int64_t us)
+{
+    g_run_end_us = g_now_us + us;
+    if (setjmp(g_task_exit) == 0)
+    {
+        g_task_fn(NULL);
+    }
+}
+
+//一次总线动作:统计是否与其它器件的转换重叠，再占用总线时间
+static void bus_action(sim_dev_t *d, uint32_t bus_us)
+{
+    uint8_t i;
+
+    for (i = 0; i < DEV_COUNT; i ++)
+    {
+        if (g_devs[i] != d && g_devs[i]->sensor && g_devs[i]->sensor->converting)
+        {
+            d->overlapped ++;
+            break;
+        }
+    }
+    g_now_us += bus_us;
+}
+
+static bool inject_fail(sim_dev_t *d)
+{
+    d->calls ++;
+    return d->fail_every && d->calls % d->fail_every == 0;
+}
+
+//记录动作时刻偏离释放时间格的量，第一次动作定下时间格的起点
+static void track_grid(sim_dev_t *d)
+{
+    uint32_t drift;
+
+    if (d->first_us < 0)
+    {
+        d->first_us = g_now_us;
+    }
+    drift = (uint32_t)((g_now_us - d->first_us) % d->period_us);
+    if (drift > d->drift_us_max)
+    {
+        d->drift_us_max = drift;
+    }
+}
+
+static esp_err_t sim_start(void *ctx)
+{
+    sim_dev_t *d = ctx;
+
+    track_grid(d);
+    d->started_us = g_now_us;
+    bus_action(d, START_BUS_US);
+    return inject_fail(d) ? ESP_FAIL : ESP_OK;
+}
+
+static esp_err_t sim_read(void *ctx)
+{
+    sim_dev_t *d = ctx;
+
+    if (!d->once)
+    {
+        track_grid(d);
+    }
+    if (d->once && g_now_us < d->started_us + START_BUS_US + d->conv_us)
+    {
+        d->early_reads ++;
+    }
+    d->reads ++;
+    bus_action(d, READ_BUS_US + d->stall_us);
+    d->stall_us = 0;
+    return inject_fail(d) ? ESP_FAIL : ESP_OK;
+}
+
+static void add_devices(void)
+{
+    I2CSched_Config_t sc;
+    uint8_t i;
+
+    for (i = 0; i < DEV_COUNT; i ++)
+    {
+        memset(&sc, 0, sizeof(sc));
+        sc.name = g_devs[i]->name;
+        sc.period_us = g_devs[i]->period_us;
+        sc.conv_us = g_devs[i]->conv_us;
+        sc.start = g_devs[i]->once ? sim_start : NULL;
+        sc.read = sim_read;
+        sc.ctx = g_devs[i];
+        g_devs[i]->first_us = -1;
+        g_devs[i]->sensor = I2CSched_Add(&sc);
+    }
+}
+
+//检查一段运行的统计增量:stalled为这段里读取卡住的器件，卡住的这段只检查它按整周期跳过
+static int check_phase(const char *phase, const I2CSched_Stats_t *before, int64_t run_us,
+                       const sim_dev_t *stalled)
+{
+    I2CSched_Stats_t now;
+    const sim_dev_t *d;
+    uint32_t jobs, expect, skipped, misses;
+    int errors = 0;
+    uint8_t i;
+
+    for (i = 0; i < DEV_COUNT; i ++)
+    {
+        d = g_devs[i];
+        I2CSched_GetStats(d->sensor, &now);
+        jobs = now.jobs - before[i].jobs;
+        skipped = now.skipped - before[i].skipped;
+        misses = now.deadline_misses - before[i].deadline_misses;
+        expect = (uint32_t)(run_us / d->period_us);
+        printf("%-7s %-7s jobs:%3u (expect ~%3u) err:%2u miss:%u skip:%u late:%4u/%5uus "
+               "drift:%4uus early:%u overlapped:%u\n", phase, d->name, jobs, expect,
+               now.errors - before[i].errors, misses, skipped, now.late_us_last, now.late_us_max,
+               d->drift_us_max, d->early_reads, d->overlapped);
+
+        if (d->early_reads)
+        {
+            printf("  %s read %u times before conversion finished\n", d->name, d->early_reads);
+            errors ++;
+        }
+        if (stalled)
+        {
+            if (d == stalled && skipped == 0)
+            {
+                printf("  %s stalled for %u us but skipped nothing\n", d->name, STALL_US);
+                errors ++;
+            }
+            continue;
+        }
+        if (skipped || misses)
+        {
+            printf("  %s skipped %u periods, missed %u deadlines\n", d->name, skipped, misses);
+            errors ++;
+        }
+        if (jobs + 1 < expect || jobs > expect + 1)
+        {
+            printf("  %s ran %u jobs, expected %u\n", d->name, jobs, expect);
+            errors ++;
+        }
+        if (now.late_us_last > LATE_BOUND_US)
+        {
+            printf("  %s read %u us late\n", d->name, now.late_us_last);
+            errors ++;
+        }
+        if (d->drift_us_max > LATE_BOUND_US + START_BUS_US)
+        {
+            printf("  %s drifted %u us off its release grid\n", d->name, d->drift_us_max);
+            errors ++;
+        }
+    }
+    return errors;
+}
+
+static void snapshot(I2CSched_Stats_t *stats)
+{
+    uint8_t i;
+
+    for (i = 0; i < DEV_COUNT; i ++)
+    {
+        I2CSched_GetStats(g_devs[i]->sensor, &stats[i]);
+    }
+}
+
+int main(void)
+{
+    I2CSched_Stats_t before[DEV_COUNT];
+    int errors = 0;
+    uint8_t i;
+
+    if (I2CSched_Start() != ESP_OK)
+    {
+        printf("start failed\n");
+        return 1;
+    }
+    add_devices();
+
+    snapshot(before);
+    run_task(STEADY_US);
+    errors += check_phase("steady", before, STEADY_US, NULL);
+    if (g_bh1750.overlapped == 0 || g_second.overlapped == 0)
+    {
+        printf("  no transfers overlapped another sensor's conversion\n");
+        errors ++;
+    }
+    if (g_cont.sensor->stats.errors == 0)
+    {
+        printf("  injected read errors were not counted\n");
+        errors ++;
+    }
+
+    //第二个器件的下一次读取卡住，超过一个周期；其它器件这段时间也会被推迟
+    g_second.stall_us = STALL_US;
+    snapshot(before);
+    run_task(STALL_US + g_bh1750.period_us);
+    errors += check_phase("stall", before, STALL_US + g_bh1750.period_us, &g_second);
+
+    //之后回到原来的时间格上，不再跳过和错过
+    for (i = 0; i < DEV_COUNT; i ++)
+    {
+        g_devs[i]->drift_us_max = 0;
+    }
+    snapshot(before);
+    run_task(RECOVER_US);
+    errors += check_phase("recover", before, RECOVER_US, NULL);
+
+    I2CSched_PrintStats();
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
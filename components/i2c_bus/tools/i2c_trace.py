@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+@file         i2c_trace.py
+@brief        解析I2CTrace_Dump导出的I2C传输跟踪记录
+@details      从串口日志中取出所有完整的"#I2CT"导出(每次导出只含上次之后的新记录)，按顺序拼接后输出:
+                1. 每个器件的传输耗时直方图(按2的幂分档)
+                2. 每个端口按时间窗的总线占用率
+              指定--clk时按该时钟重放记录(保持各传输的开始时刻，耗时按位数计算)，
+              对比实测耗时与理论耗时，并给出该时钟下的占用率
+              用法: python3 i2c_trace.py monitor.log [--window-ms 100] [--clk 400000]
+@author       Caesar, 2026/10/19, 初始化版本
+@par Copyright (c):
+              Caesar,Email:792910363@qq.com
+"""
+import argparse
+import struct
+import sys
+
+RECORD_FMT = "<IIBBHHh"          # 与I2CTrace_Record_t一致
+RECORD_SIZE = struct.calcsize(RECORD_FMT)
+TRACE_VERSION = 1
+BAR_WIDTH = 40
+
+
+def load(lines):
+    """返回所有完整导出拼接成的记录列表(start_us已展开为单调时刻)"""
+    records = []
+    block = None
+    for line in lines:
+        pos = line.find("#I2CT ")
+        if pos < 0:
+            continue
+        fields = line[pos:].split()
+        if len(fields) < 3:
+            continue
+        kind = fields[1]
+        if kind == "H":
+            version, size = int(fields[2]), int(fields[3])
+            if version != TRACE_VERSION or size != RECORD_SIZE:
+                sys.exit("unsupported trace version %d / record size %d" % (version, size))
+            block = bytearray()
+        elif kind == "D" and block is not None:
+            block += bytes.fromhex(fields[2])
+        elif kind == "E" and block is not None:
+            if len(block) == int(fields[2]) * RECORD_SIZE:
+                records += [struct.unpack_from(RECORD_FMT, block, off)
+                            for off in range(0, len(block), RECORD_SIZE)]
+            block = None
+    if not records:
+        sys.exit("no complete #I2CT dump found")
+
+    # esp_timer低32位回绕(约71分钟):每个端口单独展开，只有倒退超过半个周期才算回绕，
+    # 不同端口的记录交错、或按完成顺序写入时开始时刻略有倒退，都不是回绕
+    out = []
+    base = {}
+    last = {}
+    for start, dur, port, addr, tx_len, rx_len, result in records:
+        if port in last and last[port] - start > 1 << 31:
+            base[port] += 1 << 32
+        base.setdefault(port, 0)
+        last[port] = start
+        out.append(dict(start=base[port] + start, dur=dur, port=port, addr=addr,
+                        tx=tx_len, rx=rx_len, result=result))
+    return out
+
+
+def model_us(rec, clk):
+    """理论耗时: 每字节9位(含ACK)，起始/重复起始/停止各约1位"""
+    addr_bytes = (1 if rec["tx"] or not rec["rx"] else 0) + (1 if rec["rx"] else 0)
+    bits = 9 * (addr_bytes + rec["tx"] + rec["rx"]) + addr_bytes + 1
+    return bits * 1e6 / clk
+
+
+def bar(value, full):
+    n = int(round(BAR_WIDTH * value / full)) if full else 0
+    return "#" * n
+
+
+def histogram(records):
+    devices = sorted(set((r["port"], r["addr"]) for r in records))
+    for port, addr in devices:
+        recs = [r for r in records if r["port"] == port and r["addr"] == addr]
+        errors = sum(1 for r in recs if r["result"] != 0)
+        durs = sorted(r["dur"] for r in recs)
+        print("port %d addr 0x%02x: %d txn, %d err, p50 %dus, p99 %dus, max %dus"
+              % (port, addr, len(recs), errors, durs[len(durs) // 2],
+                 durs[min(len(durs) - 1, len(durs) * 99 // 100)], durs[-1]))
+        buckets = {}
+        for d in durs:
+            b = max(d, 1).bit_length() - 1
+            buckets[b] = buckets.get(b, 0) + 1
+        top = max(buckets.values())
+        for b in range(min(buckets), max(buckets) + 1):
+            n = buckets.get(b, 0)
+            print("  %7d-%-7dus %6d %s" % (1 << b, (2 << b) - 1, n, bar(n, top)))
+
+
+def timeline(records, window_us, dur_of, title):
+    print(title)
+    for port in sorted(set(r["port"] for r in records)):
+        recs = [r for r in records if r["port"] == port]
+        t0 = min(r["start"] for r in recs)
+        busy = {}
+        for r in recs:
+            # 传输可能跨越窗口边界，按重叠部分分摊
+            s = r["start"] - t0
+            e = s + dur_of(r)
+            while s < e:
+                w = int(s // window_us)
+                seg = min(e, (w + 1) * window_us) - s
+                busy[w] = busy.get(w, 0) + seg
+                s += seg
+        print(" port %d" % port)
+        for w in range(max(busy) + 1):
+            load = min(1.0, busy.get(w, 0) / window_us)
+            print("  %8.1fms %5.1f%% %s" % (w * window_us / 1000.0, load * 100, bar(load, 1.0)))
+
+
+def replay(records, clk):
+    print("replay at %d Hz (measured vs model, mean us)" % clk)
+    for port, addr in sorted(set((r["port"], r["addr"]) for r in records)):
+        recs = [r for r in records if r["port"] == port and r["addr"] == addr]
+        meas = sum(r["dur"] for r in recs) / len(recs)
+        model = sum(model_us(r, clk) for r in recs) / len(recs)
+        print("  port %d addr 0x%02x: %8.1f %8.1f  overhead %+.1f" % (port, addr, meas, model, meas - model))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="I2C trace analyzer")
+    parser.add_argument("log", nargs="?", help="串口日志，缺省读标准输入")
+    parser.add_argument("--window-ms", type=float, default=100.0, help="占用率时间窗")
+    parser.add_argument("--clk", type=int, help="按该总线时钟重放")
+    args = parser.parse_args()
+
+    with (open(args.log, errors="replace") if args.log else sys.stdin) as f:
+        records = load(f)
+    window_us = args.window_ms * 1000
+    histogram(records)
+    timeline(records, window_us, lambda r: r["dur"], "bus utilization (measured)")
+    if args.clk:
+        replay(records, args.clk)
+        timeline(records, window_us, lambda r: model_us(r, args.clk),
+                 "bus utilization (replayed at %d Hz)" % args.clk)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+/*
+* @file         key_gesture.h
+* @brief        多按键手势识别
+* @details      单击、双击、长按、长按连发、长按松开和组合键(几个键在短时间内先后按下)；
+*               每个键只有一个小状态机，转移由一张[状态][输入]表决定，输入为按下/松开/超时；
+*               所有键共用一个调度:KeyGesture_Feed/KeyGesture_Poll返回下一次需要调用Poll的时间，
+*               调用者只需一个定时器(或带超时的队列等待)，没有按键时不需要任何唤醒；
+*               不依赖硬件和系统，时间由调用者传入(ms)，可在PC上注入边沿序列测试(tools/key_gesture_test.c)
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef KEY_GESTURE_H
+#define KEY_GESTURE_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define KEY_GESTURE_MAX_KEYS        8                   //按键数上限
+#define KEY_GESTURE_LONG_MS         600                 //默认长按时间
+#define KEY_GESTURE_DOUBLE_MS       250                 //默认双击间隔(松开到再次按下)
+#define KEY_GESTURE_REPEAT_MS       150                 //默认连发间隔
+#define KEY_GESTURE_CHORD_MS        80                  //默认组合键窗口(第一个键按下起)
+
+//手势
+typedef enum {
+	KEY_GESTURE_CLICK = 0,          /*!< 单击(开启双击时在双击间隔过后才报告) */
+	KEY_GESTURE_DOUBLE_CLICK,
+	KEY_GESTURE_LONG_PRESS,         /*!< 按住达到长按时间 */
+	KEY_GESTURE_REPEAT,             /*!< 长按后每个连发间隔一次，count为第几次 */
+	KEY_GESTURE_LONG_RELEASE,       /*!< 长按后松开 */
+	KEY_GESTURE_CHORD,              /*!< 组合键，keys为参与的键；之后这些键松开前不再报告单键手势 */
+} KEY_GESTURE_t;
+
+//手势事件
+typedef struct {
+	uint32_t keys;                  /*!< 按键掩码，单键手势只有一位 */
+	uint8_t  type;                  /*!< KEY_GESTURE_t */
+	uint8_t  count;                 /*!< 单击1、双击2、连发次数(255封顶) */
+	uint32_t time_ms;               /*!< 手势成立的时刻 */
+} KeyGesture_Event_t;
+
+/**
+ * 手势回调(在调用KeyGesture_Feed/KeyGesture_Poll的上下文中执行)
+ * @param[in]   event   事件
+ * @param[in]   arg     KeyGesture_Init传入的参数
+ */
+typedef void (*KeyGesture_Cb_t)(const KeyGesture_Event_t *event, void *arg);
+
+//时间阈值(ms，不超过65535)
+typedef struct {
+	uint16_t long_ms;               /*!< 0为不识别长按 */
+	uint16_t double_ms;             /*!< 0为不识别双击，松开即报告单击 */
+	uint16_t repeat_ms;             /*!< 0为长按不连发 */
+	uint16_t chord_ms;              /*!< 0为不识别组合键 */
+} KeyGesture_Config_t;
+
+//单键状态(时刻只存低16位，各阈值都小于65536ms)
+typedef struct {
+	uint8_t  state;
+	uint8_t  timer;                 /*!< 正在等的阈值 */
+	uint8_t  count;
+	uint16_t since;                 /*!< 计时起点 */
+} KeyGesture_Key_t;
+
+//识别器，由调用者静态分配
+typedef struct {
+	KeyGesture_Config_t cfg;
+	uint8_t count;
+	KeyGesture_Key_t key[KEY_GESTURE_MAX_KEYS];
+	uint32_t chord_mask;            /*!< 正在形成的组合键 */
+	uint16_t chord_start;
+	KeyGesture_Cb_t cb;
+	void *arg;
+} KeyGesture_t;
+
+
+void KeyGesture_Init(KeyGesture_t *g, uint8_t count, const KeyGesture_Config_t *cfg, KeyGesture_Cb_t cb, void *arg);
+int32_t KeyGesture_Feed(KeyGesture_t *g, uint8_t key, bool pressed, uint32_t now_ms);
+int32_t KeyGesture_Poll(KeyGesture_t *g, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
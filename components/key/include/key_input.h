@@ -0,0 +1,62 @@
+/*
+* @file         key_input.h
+* @brief        中断驱动的按键输入
+* @details      按键引脚的双边沿中断只记下时刻并关闭该引脚中断，由esp_timer延时消抖后读一次电平，
+*               状态有变化才向队列投递按下/松开事件，再重新打开中断；
+*               没有按键动作时不进中断也不轮询，事件延迟约为消抖时间，
+*               事件带第一个边沿的时刻，可用来计算输入延迟或做手势识别
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef KEY_INPUT_H
+#define KEY_INPUT_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define KEY_INPUT_MAX_KEYS          8                   //按键数上限
+#define KEY_INPUT_QUEUE_LEN         16                  //事件队列长度
+#define KEY_INPUT_DEBOUNCE_MS       5                   //默认消抖时间
+
+//事件类型
+typedef enum {
+	KEY_EVENT_PRESS = 0,
+	KEY_EVENT_RELEASE,
+} KEY_EVENT_TYPE_t;
+
+//按键事件
+typedef struct {
+	uint8_t  key;                   /*!< 按键序号(KeyInput_Init中pins的下标) */
+	uint8_t  type;                  /*!< KEY_EVENT_TYPE_t */
+	int64_t  time_us;               /*!< 触发本次变化的第一个边沿的时刻(esp_timer_get_time) */
+} KeyInput_Event_t;
+
+
+esp_err_t KeyInput_Init(const gpio_num_t *pins, uint8_t count, uint32_t active_low, uint16_t debounce_ms);
+bool KeyInput_Read(KeyInput_Event_t *event, TickType_t timeout);
+bool KeyInput_Pressed(uint8_t key);
+uint32_t KeyInput_Dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
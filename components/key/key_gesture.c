@@ -0,0 +1,324 @@
+/*
+* @file         key_gesture.c
+* @brief        多按键手势识别
+* @details      状态转移表每项给出下一状态、要报告的手势和要等的阈值；超时的计时起点取上一个期限
+*               而不是调用时刻，Poll来晚了也不会让连发间隔漂移，过期的超时会在下一次Feed前先补上；
+*               双击阈值为0时立即按超时处理(松开即单击)，长按和连发阈值为0时不计时；
+*               组合键不在表中:按下时若窗口内已有别的键按住(都还没成立任何手势)，这些键一起转入组合态
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "key_gesture.h"
+#include "string.h"
+/*
+===========================
+宏定义
+===========================
+*/
+//单键状态
+#define KEY_ST_IDLE                 0
+#define KEY_ST_DOWN1                1                   //第一次按下
+#define KEY_ST_UP1                  2                   //第一次松开，等第二次按下
+#define KEY_ST_DOWN2                3                   //第二次按下
+#define KEY_ST_LONG                 4                   //长按中
+#define KEY_ST_CHORD                5                   //属于组合键，等松开
+#define KEY_ST_COUNT                6
+
+//输入
+#define KEY_IN_PRESS                0
+#define KEY_IN_RELEASE              1
+#define KEY_IN_TIMEOUT              2
+#define KEY_IN_COUNT                3
+
+//等待的阈值
+#define KEY_T_NONE                  0
+#define KEY_T_LONG                  1
+#define KEY_T_DOUBLE                2
+#define KEY_T_REPEAT                3
+#define KEY_T_KEEP                  0xFF                //输入无效(如重复的按下)，状态和计时都不变
+
+#define KEY_EV_NONE                 0xFF
+
+typedef struct {
+    uint8_t next;
+    uint8_t event;
+    uint8_t timer;
+} key_gesture_trans_t;
+
+#define KEY_KEEP                    { 0, KEY_EV_NONE, KEY_T_KEEP }
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+//状态转移表[状态][输入]
+static const key_gesture_trans_t g_key_gesture_table[KEY_ST_COUNT][KEY_IN_COUNT] = {
+    [KEY_ST_IDLE] = {
+        [KEY_IN_PRESS]   = { KEY_ST_DOWN1, KEY_EV_NONE,                  KEY_T_LONG },
+        [KEY_IN_RELEASE] = KEY_KEEP,
+        [KEY_IN_TIMEOUT] = KEY_KEEP,
+    },
+    [KEY_ST_DOWN1] = {
+        [KEY_IN_PRESS]   = KEY_KEEP,
+        [KEY_IN_RELEASE] = { KEY_ST_UP1,   KEY_EV_NONE,                  KEY_T_DOUBLE },
+        [KEY_IN_TIMEOUT] = { KEY_ST_LONG,  KEY_GESTURE_LONG_PRESS,       KEY_T_REPEAT },
+    },
+    [KEY_ST_UP1] = {
+        [KEY_IN_PRESS]   = { KEY_ST_DOWN2, KEY_EV_NONE,                  KEY_T_LONG },
+        [KEY_IN_RELEASE] = KEY_KEEP,
+        [KEY_IN_TIMEOUT] = { KEY_ST_IDLE,  KEY_GESTURE_CLICK,            KEY_T_NONE },
+    },
+    [KEY_ST_DOWN2] = {
+        [KEY_IN_PRESS]   = KEY_KEEP,
+        [KEY_IN_RELEASE] = { KEY_ST_IDLE,  KEY_GESTURE_DOUBLE_CLICK,     KEY_T_NONE },
+        [KEY_IN_TIMEOUT] = { KEY_ST_LONG,  KEY_GESTURE_LONG_PRESS,       KEY_T_REPEAT },
+    },
+    [KEY_ST_LONG] = {
+        [KEY_IN_PRESS]   = KEY_KEEP,
+        [KEY_IN_RELEASE] = { KEY_ST_IDLE,  KEY_GESTURE_LONG_RELEASE,     KEY_T_NONE },
+        [KEY_IN_TIMEOUT] = { KEY_ST_LONG,  KEY_GESTURE_REPEAT,           KEY_T_REPEAT },
+    },
+    [KEY_ST_CHORD] = {
+        [KEY_IN_PRESS]   = KEY_KEEP,
+        [KEY_IN_RELEASE] = { KEY_ST_IDLE,  KEY_EV_NONE,                  KEY_T_NONE },
+        [KEY_IN_TIMEOUT] = KEY_KEEP,
+    },
+};
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 取阈值
+ * @param[in]   g       识别器
+ * @param[in]   timer   KEY_T_xxx
+ * @retval      阈值ms
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static uint16_t key_gesture_threshold(const KeyGesture_t *g, uint8_t timer)
+{
+    switch (timer)
+    {
+        case KEY_T_LONG:    return g->cfg.long_ms;
+        case KEY_T_DOUBLE:  return g->cfg.double_ms;
+        case KEY_T_REPEAT:  return g->cfg.repeat_ms;
+        default:            return 0;
+    }
+}
+
+/**
+ * 报告手势
+ * @param[in]   g         识别器
+ * @param[in]   keys      按键掩码
+ * @param[in]   type      手势
+ * @param[in]   count     次数
+ * @param[in]   time_ms   成立时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void key_gesture_emit(KeyGesture_t *g, uint32_t keys, uint8_t type, uint8_t count, uint32_t time_ms)
+{
+    KeyGesture_Event_t event;
+
+    if (g->cb == NULL)
+    {
+        return;
+    }
+    event.keys = keys;
+    event.type = type;
+    event.count = count;
+    event.time_ms = time_ms;
+    g->cb(&event, g->arg);
+}
+
+/**
+ * 按转移表处理一个键的一个输入
+ * @param[in]   g        识别器
+ * @param[in]   idx      按键
+ * @param[in]   input    KEY_IN_xxx
+ * @param[in]   now_ms   当前时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void key_gesture_input(KeyGesture_t *g, uint8_t idx, uint8_t input, uint32_t now_ms)
+{
+    KeyGesture_Key_t *k = &g->key[idx];
+    const key_gesture_trans_t *t;
+
+    do
+    {
+        t = &g_key_gesture_table[k->state][input];
+        if (t->timer == KEY_T_KEEP)
+        {
+            return;
+        }
+        //超时从期限算起，按下/松开从当前时刻算起
+        if (input == KEY_IN_TIMEOUT)
+        {
+            k->since += key_gesture_threshold(g, k->timer);
+        }
+        else
+        {
+            k->since = (uint16_t)now_ms;
+        }
+        k->state = t->next;
+        switch (t->event)
+        {
+            case KEY_GESTURE_CLICK:         k->count = 1; break;
+            case KEY_GESTURE_DOUBLE_CLICK:  k->count = 2; break;
+            case KEY_GESTURE_LONG_PRESS:    k->count = 0; break;
+            case KEY_GESTURE_REPEAT:        k->count += (k->count < 255); break;
+            default:                        break;
+        }
+        if (t->event != KEY_EV_NONE)
+        {
+            key_gesture_emit(g, 1UL << idx, t->event, k->count, now_ms - (uint16_t)((uint16_t)now_ms - k->since));
+        }
+        k->timer = t->timer;
+        if (k->timer != KEY_T_NONE && key_gesture_threshold(g, k->timer) == 0)
+        {
+            //双击关闭时立即超时，长按/连发关闭时不计时
+            k->timer = (k->timer == KEY_T_DOUBLE) ? k->timer : KEY_T_NONE;
+        }
+        input = KEY_IN_TIMEOUT;
+    } while (k->timer == KEY_T_DOUBLE && g->cfg.double_ms == 0);
+}
+
+/**
+ * 初始化识别器，所有键从松开状态开始
+ * @param[out]  g       识别器
+ * @param[in]   count   按键数，不超过KEY_GESTURE_MAX_KEYS
+ * @param[in]   cfg     时间阈值，NULL为默认值
+ * @param[in]   cb      手势回调
+ * @param[in]   arg     回调参数
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void KeyGesture_Init(KeyGesture_t *g, uint8_t count, const KeyGesture_Config_t *cfg, KeyGesture_Cb_t cb, void *arg)
+{
+    memset(g, 0, sizeof(*g));
+    g->count = (count > KEY_GESTURE_MAX_KEYS) ? KEY_GESTURE_MAX_KEYS : count;
+    if (cfg)
+    {
+        g->cfg = *cfg;
+    }
+    else
+    {
+        g->cfg.long_ms = KEY_GESTURE_LONG_MS;
+        g->cfg.double_ms = KEY_GESTURE_DOUBLE_MS;
+        g->cfg.repeat_ms = KEY_GESTURE_REPEAT_MS;
+        g->cfg.chord_ms = KEY_GESTURE_CHORD_MS;
+    }
+    g->cb = cb;
+    g->arg = arg;
+}
+
+/**
+ * 处理到期的超时
+ * @param[in]   g        识别器
+ * @param[in]   now_ms   当前时刻，不能比上一次调用早
+ * @retval      距下一个期限的ms，-1为没有在等的期限(下次按键前不需要再调用)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+int32_t KeyGesture_Poll(KeyGesture_t *g, uint32_t now_ms)
+{
+    KeyGesture_Key_t *k;
+    int32_t next = -1;
+    uint16_t elapsed, threshold;
+    uint8_t i;
+
+    for (i = 0; i < g->count; i ++)
+    {
+        k = &g->key[i];
+        while (k->timer != KEY_T_NONE)
+        {
+            elapsed = (uint16_t)now_ms - k->since;
+            threshold = key_gesture_threshold(g, k->timer);
+            if (elapsed < threshold)
+            {
+                if (next < 0 || threshold - elapsed < next)
+                {
+                    next = threshold - elapsed;
+                }
+                break;
+            }
+            key_gesture_input(g, i, KEY_IN_TIMEOUT, now_ms);
+        }
+    }
+    return next;
+}
+
+/**
+ * 输入一个按键变化(消抖后)
+ * @param[in]   g         识别器
+ * @param[in]   key       按键
+ * @param[in]   pressed   是否按下
+ * @param[in]   now_ms    当前时刻，不能比上一次调用早
+ * @retval      距下一个期限的ms，-1为没有在等的期限
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+int32_t KeyGesture_Feed(KeyGesture_t *g, uint8_t key, bool pressed, uint32_t now_ms)
+{
+    uint32_t bit = 1UL << key;
+    uint8_t i;
+
+    if (key >= g->count)
+    {
+        return KeyGesture_Poll(g, now_ms);
+    }
+    //先补上到期的超时，保证手势顺序与时间一致
+    KeyGesture_Poll(g, now_ms);
+
+    if (pressed && g->cfg.chord_ms && g->key[key].state == KEY_ST_IDLE)
+    {
+        //窗口内的其他键都还按着且没有成立手势，组成(或扩大)组合键
+        for (i = 0; i < g->count; i ++)
+        {
+            if ((g->chord_mask & (1UL << i)) &&
+                g->key[i].state != KEY_ST_DOWN1 && g->key[i].state != KEY_ST_CHORD)
+            {
+                break;
+            }
+        }
+        if (g->chord_mask && i == g->count && (uint16_t)((uint16_t)now_ms - g->chord_start) <= g->cfg.chord_ms)
+        {
+            g->chord_mask |= bit;
+            for (i = 0; i < g->count; i ++)
+            {
+                if (g->chord_mask & (1UL << i))
+                {
+                    g->key[i].state = KEY_ST_CHORD;
+                    g->key[i].timer = KEY_T_NONE;
+                }
+            }
+            key_gesture_emit(g, g->chord_mask, KEY_GESTURE_CHORD, 0, now_ms);
+            return KeyGesture_Poll(g, now_ms);
+        }
+        g->chord_mask = bit;
+        g->chord_start = (uint16_t)now_ms;
+    }
+    key_gesture_input(g, key, pressed ? KEY_IN_PRESS : KEY_IN_RELEASE, now_ms);
+    return KeyGesture_Poll(g, now_ms);
+}
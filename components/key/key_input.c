@@ -0,0 +1,223 @@
+/*
+* @file         key_input.c
+* @brief        中断驱动的按键输入
+* @details      每个按键一个单次esp_timer做消抖:边沿中断关闭本引脚中断并启动定时器，
+*               抖动期间的边沿不再进中断；定时器到期先打开中断再读电平，与已报告的状态比较，
+*               这样打开中断后马上出现的边沿也不会漏掉，重复的检查也不会重复报告
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "key_input.h"
+#include "string.h"
+#include "esp_timer.h"
+#include "freertos/queue.h"
+/*
+===========================
+宏定义
+===========================
+*/
+typedef struct {
+    gpio_num_t pin;
+    uint8_t active_low;
+    volatile uint8_t pressed;       //已报告的状态
+    volatile int64_t edge_us;       //本轮消抖的第一个边沿
+    esp_timer_handle_t timer;
+} key_input_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static key_input_t g_keys[KEY_INPUT_MAX_KEYS];
+static uint8_t g_key_count = 0;
+static uint32_t g_key_debounce_us = KEY_INPUT_DEBOUNCE_MS * 1000;
+static QueueHandle_t g_key_queue = NULL;
+static uint32_t g_key_dropped = 0;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 按键边沿中断:记下时刻，关闭本引脚中断，启动消抖定时器
+ * @param[in]   arg   按键
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void key_input_isr(void *arg)
+{
+    key_input_t *k = arg;
+
+    gpio_intr_disable(k->pin);
+    k->edge_us = esp_timer_get_time();
+    esp_timer_start_once(k->timer, g_key_debounce_us);
+}
+
+/**
+ * 消抖定时器到期(esp_timer任务中执行):重新打开中断，电平与已报告的状态不同时投递事件
+ * @param[in]   arg   按键
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void key_input_timer_cb(void *arg)
+{
+    key_input_t *k = arg;
+    KeyInput_Event_t event;
+    uint8_t pressed;
+
+    gpio_intr_enable(k->pin);
+    pressed = gpio_get_level(k->pin) ^ k->active_low;
+    if (pressed == k->pressed)
+    {
+        return;
+    }
+    k->pressed = pressed;
+    event.key = k - g_keys;
+    event.type = pressed ? KEY_EVENT_PRESS : KEY_EVENT_RELEASE;
+    event.time_us = k->edge_us;
+    if (xQueueSend(g_key_queue, &event, 0) != pdTRUE)
+    {
+        g_key_dropped ++;
+    }
+}
+
+/**
+ * 初始化按键:引脚配置为双边沿中断输入(不开内部上下拉，GPIO34~39没有)，安装GPIO中断服务
+ * @param[in]   pins          按键引脚，事件中的key为下标
+ * @param[in]   count         按键数，不超过KEY_INPUT_MAX_KEYS
+ * @param[in]   active_low    第i位为1时第i个按键按下为低电平
+ * @param[in]   debounce_ms   消抖时间，0为KEY_INPUT_DEBOUNCE_MS
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG     参数错误
+ *              - ESP_ERR_INVALID_STATE   已经初始化
+ *              - ESP_ERR_NO_MEM
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t KeyInput_Init(const gpio_num_t *pins, uint8_t count, uint32_t active_low, uint16_t debounce_ms)
+{
+    esp_timer_create_args_t timer_args = {
+        .callback = key_input_timer_cb,
+        .name = "key_input",
+    };
+    gpio_config_t cfg = {
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_ANYEDGE,
+    };
+    esp_err_t ret;
+    uint8_t i;
+
+    if (count == 0 || count > KEY_INPUT_MAX_KEYS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_key_queue)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_key_queue = xQueueCreate(KEY_INPUT_QUEUE_LEN, sizeof(KeyInput_Event_t));
+    if (g_key_queue == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    g_key_debounce_us = (debounce_ms ? debounce_ms : KEY_INPUT_DEBOUNCE_MS) * 1000;
+    memset(g_keys, 0, sizeof(g_keys));
+    cfg.pin_bit_mask = 0;
+    for (i = 0; i < count; i ++)
+    {
+        cfg.pin_bit_mask |= 1ULL << pins[i];
+    }
+    ret = gpio_config(&cfg);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    //中断服务可能已被别的模块安装
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+    {
+        return ret;
+    }
+    for (i = 0; i < count; i ++)
+    {
+        g_keys[i].pin = pins[i];
+        g_keys[i].active_low = (active_low >> i) & 1;
+        g_keys[i].pressed = gpio_get_level(pins[i]) ^ g_keys[i].active_low;
+        timer_args.arg = &g_keys[i];
+        if (esp_timer_create(&timer_args, &g_keys[i].timer) != ESP_OK)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    g_key_count = count;
+    for (i = 0; i < count; i ++)
+    {
+        ret = gpio_isr_handler_add(pins[i], key_input_isr, &g_keys[i]);
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * 读一个按键事件
+ * @param[out]  event     事件
+ * @param[in]   timeout   等待时间，portMAX_DELAY为一直等
+ * @retval      是否读到
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool KeyInput_Read(KeyInput_Event_t *event, TickType_t timeout)
+{
+    if (g_key_queue == NULL)
+    {
+        return 0;
+    }
+    return xQueueReceive(g_key_queue, event, timeout) == pdTRUE;
+}
+
+/**
+ * 按键当前是否按下(消抖后的状态)
+ * @param[in]   key   按键序号
+ * @retval      是否按下
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool KeyInput_Pressed(uint8_t key)
+{
+    return key < g_key_count && g_keys[key].pressed;
+}
+
+/**
+ * 队列满而丢弃的事件数
+ * @param[in]   无
+ * @retval      丢弃数
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+uint32_t KeyInput_Dropped(void)
+{
+    return g_key_dropped;
+}
@@ -0,0 +1,150 @@
+/*
+* @file         key_gesture_test.c
+* @brief        key_gesture在PC上的测试
+* @details      按边沿时间线输入按键变化，按识别器返回的期限调用Poll(可故意晚到)，
+*               把报告的手势与期望比较；每个用例还在16位时刻回绕附近再跑一遍
+*               时间线写法: "时刻+键"为按下、"时刻-键"为松开，如"0+0 100-0"
+*               期望写法: 类型+按键掩码(十六进制)+@时刻，连发再加#次数，如"C1@350 R1#2@900"
+*               类型: C单击 D双击 L长按 R连发 U长按松开 H组合键
+*               编译: gcc -O2 -I../include key_gesture_test.c ../key_gesture.c -o key_gesture_test
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "key_gesture.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+typedef struct {
+	const char *name;
+	const KeyGesture_Config_t *cfg;     /*!< NULL为默认阈值 */
+	uint32_t late_ms;                   /*!< Poll比期限晚到的时间 */
+	const char *edges;
+	const char *expect;
+} test_case_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static const KeyGesture_Config_t g_no_double = { 600, 0, 150, 80 };
+static const KeyGesture_Config_t g_no_long = { 0, 250, 150, 0 };
+static const KeyGesture_Config_t g_no_repeat = { 600, 250, 0, 80 };
+
+static const test_case_t g_cases[] = {
+	{ "click",              NULL, 0,  "0+0 100-0",                      "C1@350" },
+	{ "double click",       NULL, 0,  "0+0 100-0 200+0 300-0",          "D1@300" },
+	{ "two clicks",         NULL, 0,  "0+0 100-0 400+0 450-0",          "C1@350 C1@700" },
+	{ "long + repeat",      NULL, 0,  "0+0 1000-0",                     "L1@600 R1#1@750 R1#2@900 U1@1000" },
+	{ "long, late poll",    NULL, 37, "0+0 1000-0",                     "L1@600 R1#1@750 R1#2@900 U1@1000" },
+	{ "release before poll",NULL, 500,"0+0 700-0",                      "L1@600 U1@700" },
+	{ "tap then hold",      NULL, 0,  "0+0 100-0 200+0 900-0",          "L1@800 U1@900" },
+	{ "chord",              NULL, 0,  "0+0 50+1 300-0 310-1",           "H3@50" },
+	{ "three key chord",    NULL, 0,  "0+0 30+1 60+2 900-2 910-1 920-0","H3@30 H7@60" },
+	{ "chord window missed",NULL, 0,  "0+0 100+1 200-0 220-1",          "C1@450 C2@470" },
+	{ "chord after release",NULL, 0,  "0+0 20-0 40+1 60-1",             "C1@270 C2@310" },
+	{ "chord then click",   NULL, 0,  "0+0 10+1 100-0 100-1 300+0 350-0","H3@10 C1@600" },
+	{ "keys independent",   NULL, 0,  "0+0 100+1 150-1 700-0",          "C2@400 L1@600 U1@700" },
+	{ "no double",          &g_no_double, 0, "0+0 100-0 200+0 300-0",   "C1@100 C1@300" },
+	{ "no long",            &g_no_long, 0, "0+0 2000-0",                "C1@2250" },
+	{ "no repeat",          &g_no_repeat, 0, "0+0 1000-0",              "L1@600 U1@1000" },
+};
+
+static char g_got[512];
+static uint32_t g_base;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+static void record(const KeyGesture_Event_t *event, void *arg)
+{
+    static const char types[] = "CDLRUH";
+    char item[32];
+
+    (void)arg;
+    if (event->type == KEY_GESTURE_REPEAT)
+    {
+        snprintf(item, sizeof(item), "%s%c%x#%u@%u", g_got[0] ? " " : "", types[event->type],
+                 event->keys, event->count, event->time_ms - g_base);
+    }
+    else
+    {
+        snprintf(item, sizeof(item), "%s%c%x@%u", g_got[0] ? " " : "", types[event->type],
+                 event->keys, event->time_ms - g_base);
+    }
+    strncat(g_got, item, sizeof(g_got) - strlen(g_got) - 1);
+}
+
+//按时间线运行一个用例，时刻都加上base
+static int run(const test_case_t *c, uint32_t base)
+{
+    KeyGesture_t g;
+    const char *p = c->edges;
+    char *end;
+    uint32_t t, now = base;
+    int32_t next = -1;
+    unsigned long key;
+    char dir;
+
+    g_got[0] = 0;
+    g_base = base;
+    KeyGesture_Init(&g, 3, c->cfg, record, NULL);
+    while (1)
+    {
+        while (*p == ' ')
+        {
+            p ++;
+        }
+        t = *p ? base + strtoul(p, &end, 10) : UINT32_MAX;
+        //期限先到就先Poll
+        while (next >= 0 && now + next + c->late_ms <= t)
+        {
+            now += next + c->late_ms;
+            next = KeyGesture_Poll(&g, now);
+        }
+        if (*p == 0)
+        {
+            break;
+        }
+        dir = *end;
+        key = strtoul(end + 1, &end, 10);
+        p = end;
+        now = t;
+        next = KeyGesture_Feed(&g, key, dir == '+', now);
+    }
+    if (strcmp(g_got, c->expect))
+    {
+        printf("%s (base %u): expect \"%s\", got \"%s\"\n", c->name, base, c->expect, g_got);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int errors = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i ++)
+    {
+        errors += run(&g_cases[i], 1000);
+        errors += run(&g_cases[i], 65536 - 300);
+    }
+    printf("%u cases, %s\n", (unsigned)(sizeof(g_cases) / sizeof(g_cases[0])), errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+/*
+* @file         led_color.h
+* @brief        RGB灯颜色计算(定点)
+* @details      HSV/HSL转RGB、色温转RGB、色相渐变，全部为整数运算，不依赖硬件；
+*               输出为每通道0~255，可直接作为亮度级查led_lut.h的表或作为led_fade的关键帧
+*               色相用0~LED_COLOR_HUE_MAX-1表示，每个60°扇区256级
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef LED_COLOR_H
+#define LED_COLOR_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_COLOR_HUE_SECTOR        256                 //每个扇区(60°)的色相级数
+#define LED_COLOR_HUE_MAX           (6 * LED_COLOR_HUE_SECTOR)  //一整圈
+#define LED_COLOR_KELVIN_MIN        1000                //色温范围(K)
+#define LED_COLOR_KELVIN_MAX        12000
+
+typedef struct {
+	uint8_t r;
+	uint8_t g;
+	uint8_t b;
+} LedColor_Rgb_t;
+
+//色相渐变状态:色相为Q16定点，扇区内只累加变化的那个通道，跨扇区时才完整计算一次
+typedef struct {
+	uint32_t hue;                   /*!< 当前色相，Q16 */
+	int32_t step;                   /*!< 每帧色相变化，Q16，负数为反向 */
+	uint8_t s;
+	uint8_t v;
+	uint8_t sector;                 /*!< 当前扇区 */
+	uint8_t ramp_ch;                /*!< 扇区内变化的通道(0 R 1 G 2 B) */
+	int32_t ramp;                   /*!< 变化通道的值，Q16 */
+	int32_t ramp_step;              /*!< 变化通道每帧的增量，Q16 */
+	LedColor_Rgb_t rgb;
+} LedColor_Sweep_t;
+
+
+void LedColor_HsvToRgb(uint16_t h, uint8_t s, uint8_t v, LedColor_Rgb_t *rgb);
+void LedColor_HslToRgb(uint16_t h, uint8_t s, uint8_t l, LedColor_Rgb_t *rgb);
+void LedColor_Kelvin(uint16_t kelvin, uint8_t v, LedColor_Rgb_t *rgb);
+uint16_t LedColor_HueRotate(uint16_t h, int32_t delta);
+void LedColor_SweepInit(LedColor_Sweep_t *sweep, uint16_t h, int32_t delta, uint32_t frames, uint8_t s, uint8_t v);
+const LedColor_Rgb_t *LedColor_SweepNext(LedColor_Sweep_t *sweep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+/*
+* @file         led_fade.h
+* @brief        LEDC多通道同步渐变
+* @details      一组通道(如RGB)按关键帧渐变:每帧给出各通道的目标占空比和时长，一次调用同时启动；
+*               各通道的硬件渐变都结束后，由LEDC渐变结束中断直接启动下一帧，帧之间不需要唤醒任务；
+*               设置亮度曲线(led_lut.h)后关键帧的值为亮度级，中断逐级走查找表，每级之间用硬件线性渐变
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef LED_FADE_H
+#define LED_FADE_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/ledc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_FADE_MAX_CH             4                   //每组最多通道数
+#define LED_FADE_MAX_GROUPS         2                   //最多同时运行的组数
+#define LED_FADE_HW_MAX             1023                //硬件渐变的步数/每步周期数/步长上限(10位)
+
+//一个通道一帧的硬件渐变参数，由LedFade_Play计算
+typedef struct {
+	uint16_t step;                  /*!< 步数 */
+	uint16_t cycle;                 /*!< 每步的PWM周期数 */
+	uint16_t scale;                 /*!< 每步占空比变化量 */
+	uint8_t  dir;                   /*!< ledc_duty_direction_t */
+} LedFade_Hw_t;
+
+//关键帧:从上一帧的目标(第一帧从当前占空比)渐变到duty，用时time_ms
+typedef struct {
+	uint32_t duty[LED_FADE_MAX_CH];     /*!< 占空比，设置了亮度曲线时为亮度级 */
+	uint32_t time_ms;
+	uint32_t cycles;                    /*!< 时长(PWM周期数)，由LedFade_Play填写 */
+	LedFade_Hw_t hw[LED_FADE_MAX_CH];   /*!< 由LedFade_Play填写(未设置亮度曲线时使用) */
+} LedFade_Key_t;
+
+//通道组，由调用者静态分配
+typedef struct {
+	ledc_mode_t speed_mode;
+	ledc_timer_t timer;
+	uint8_t count;
+	ledc_channel_t channel[LED_FADE_MAX_CH];
+	LedFade_Key_t *keys;
+	uint16_t key_count;
+	volatile uint16_t key_idx;      /*!< 正在执行的帧 */
+	uint16_t repeat;                /*!< 剩余遍数，0为无限循环 */
+	uint8_t done_mask;              /*!< 本帧已结束的通道 */
+	volatile bool running;
+	uint32_t start_duty[LED_FADE_MAX_CH];   /*!< 第一遍第一帧的起点 */
+	LedFade_Hw_t first_hw[LED_FADE_MAX_CH]; /*!< 第一遍第一帧的参数(循环时第一帧从最后一帧的目标开始) */
+	const uint32_t *lut;            /*!< 亮度曲线(亮度级->占空比)，NULL为线性 */
+	uint16_t lut_levels;
+	uint16_t seg;                   /*!< 亮度曲线模式:本帧已启动的级数 */
+	uint16_t seg_count;             /*!< 亮度曲线模式:本帧的级数 */
+	uint32_t seg_cycles;            /*!< 亮度曲线模式:每级的PWM周期数 */
+	uint16_t seg_rem;               /*!< 亮度曲线模式:前seg_rem级各多1个周期 */
+	uint32_t seg_carry;             /*!< 亮度曲线模式:上一级取整少用的周期，补到下一级 */
+	uint32_t from_level[LED_FADE_MAX_CH];   /*!< 亮度曲线模式:本帧起点 */
+	uint32_t keys_done;             /*!< 执行完的帧数 */
+	uint8_t  launch;                /*!< 在临界区内准备好、待写入驱动的动作 */
+	volatile bool launching;        /*!< 准备好的动作还没写完 */
+	uint32_t launch_duty[LED_FADE_MAX_CH];  /*!< 待写入的起点(渐变)或最终占空比(结束) */
+	LedFade_Hw_t launch_hw[LED_FADE_MAX_CH];/*!< 待写入的渐变参数 */
+	SemaphoreHandle_t done;         /*!< 序列结束时释放 */
+} LedFade_Group_t;
+
+
+esp_err_t LedFade_Init(void);
+esp_err_t LedFade_AddGroup(LedFade_Group_t *group, ledc_mode_t speed_mode, ledc_timer_t timer,
+                           const ledc_channel_t *channel, uint8_t count);
+esp_err_t LedFade_SetCurve(LedFade_Group_t *group, const uint32_t *lut, uint16_t levels);
+esp_err_t LedFade_Play(LedFade_Group_t *group, LedFade_Key_t *keys, uint16_t key_count, uint16_t repeat);
+void LedFade_Stop(LedFade_Group_t *group);
+bool LedFade_Wait(LedFade_Group_t *group, TickType_t timeout);
+void LedFade_Calc(uint32_t from, uint32_t to, uint32_t cycles, LedFade_Hw_t *hw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
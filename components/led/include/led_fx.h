@@ -0,0 +1,98 @@
+/*
+* @file         led_fx.h
+* @brief        LED灯效字节码解释器
+* @details      灯效写成字节码(设置/渐变/等待/循环/随机/同步)，运行时作为数据加载，
+*               所有灯效共用一个esp_timer调度:只在最早的等待到期或有通道渐变时唤醒，
+*               不为每个灯效创建任务；通道输出由调用者提供的回调完成(GPIO或LEDC均可)
+*               字节码示例(红绿蓝流水，永远循环):
+*                   static const uint8_t s_flow[] = {
+*                       LED_FX_LOOP(0),
+*                       LED_FX_SET(0x07, 0), LED_FX_SET(0x01, 255), LED_FX_WAIT(100),
+*                       LED_FX_SET(0x07, 0), LED_FX_SET(0x02, 255), LED_FX_WAIT(100),
+*                       LED_FX_SET(0x07, 0), LED_FX_SET(0x04, 255), LED_FX_WAIT(100),
+*                       LED_FX_LOOP_END(),
+*                   };
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef LED_FX_H
+#define LED_FX_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_FX_MAX_CH               8                   //通道数上限(通道掩码为8位)
+#define LED_FX_MAX_INST             4                   //同时运行的灯效数
+#define LED_FX_CODE_MAX             128                 //单个灯效字节码长度上限
+#define LED_FX_LOOP_DEPTH           4                   //循环嵌套层数
+#define LED_FX_TICK_MS              10                  //渐变刷新周期
+#define LED_FX_MAX_STEPS            64                  //一次调度最多执行的指令数，防止无等待的死循环
+
+//操作码
+#define LED_FX_OP_END               0x00                //结束:                         无操作数
+#define LED_FX_OP_SET               0x01                //设置亮度:                     掩码 亮度
+#define LED_FX_OP_FADE              0x02                //渐变(不阻塞):                 掩码 亮度 时长ms(16位)
+#define LED_FX_OP_WAIT              0x03                //等待:                         时长ms(16位)
+#define LED_FX_OP_LOOP              0x04                //循环开始:                     次数(0为无限)
+#define LED_FX_OP_LOOP_END          0x05                //循环结束:                     无操作数
+#define LED_FX_OP_RAND              0x06                //各通道设为随机亮度:           掩码 下限 上限
+#define LED_FX_OP_WAIT_RAND         0x07                //随机等待:                     下限ms(16位) 上限ms(16位)
+#define LED_FX_OP_SYNC              0x08                //同步点:id相同的parties个灯效都到达后一起继续: id parties
+
+//字节码书写辅助
+#define LED_FX_U16(v)               ((v) & 0xFF), (((v) >> 8) & 0xFF)
+#define LED_FX_END()                LED_FX_OP_END
+#define LED_FX_SET(mask, level)     LED_FX_OP_SET, (mask), (level)
+#define LED_FX_FADE(mask, level, ms)    LED_FX_OP_FADE, (mask), (level), LED_FX_U16(ms)
+#define LED_FX_WAIT(ms)             LED_FX_OP_WAIT, LED_FX_U16(ms)
+#define LED_FX_LOOP(count)          LED_FX_OP_LOOP, (count)
+#define LED_FX_LOOP_END()           LED_FX_OP_LOOP_END
+#define LED_FX_RAND(mask, lo, hi)   LED_FX_OP_RAND, (mask), (lo), (hi)
+#define LED_FX_WAIT_RAND(lo, hi)    LED_FX_OP_WAIT_RAND, LED_FX_U16(lo), LED_FX_U16(hi)
+#define LED_FX_SYNC(id, parties)    LED_FX_OP_SYNC, (id), (parties)
+
+/**
+ * 通道输出回调(在esp_timer任务中调用)
+ * @param[in]   ch      通道
+ * @param[in]   level   亮度0~255
+ * @param[in]   arg     LedFx_Init传入的参数
+ */
+typedef void (*LedFx_Output_t)(uint8_t ch, uint8_t level, void *arg);
+
+/**
+ * 提交回调:一次调度中有通道变化时，在所有输出回调之后调用一次，
+ * 输出回调只记录电平、由这里一次写出，可避免逐通道变化的中间状态
+ * @param[in]   arg     LedFx_Init传入的参数
+ */
+typedef void (*LedFx_Commit_t)(void *arg);
+
+
+esp_err_t LedFx_Init(uint8_t ch_count, LedFx_Output_t output, void *arg);
+void LedFx_SetCommit(LedFx_Commit_t commit);
+esp_err_t LedFx_Verify(const uint8_t *code, uint16_t len);
+esp_err_t LedFx_Start(const uint8_t *code, uint16_t len, uint8_t *id);
+esp_err_t LedFx_Stop(uint8_t id);
+bool LedFx_Running(uint8_t id);
+uint8_t LedFx_GetLevel(uint8_t ch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+/*
+* @file         led_lut.h
+* @brief        编译期生成的亮度查找表
+* @details      线性占空比在人眼看来前段变化太快、后段几乎不变；按伽马或CIE1931明度曲线
+*               把256级亮度映射为占空比，表在编译期按定时器分辨率换算，例如:
+*                   static const uint32_t s_cie[LED_LUT_LEVELS] = LED_LUT_CIE(13);
+*               表数据由tools/led_lut.py生成，"led_lut.py --check"可在PC上校验
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef LED_LUT_H
+#define LED_LUT_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include "led_lut_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_LUT_LEVELS              LED_LUT_TABLE_LEVELS    //亮度级数(0为灭)
+#define LED_LUT_Q                   LED_LUT_TABLE_Q         //表数据定点位数
+
+//Q24表项换算为bits位分辨率的占空比(四舍五入)，常量表达式
+#define LED_LUT_SCALE(v, bits)      ((uint32_t)(((uint64_t)(v) * ((1ULL << (bits)) - 1) +         \
+                                                 (1ULL << (LED_LUT_Q - 1))) >> LED_LUT_Q))
+
+//bits位分辨率的查找表初始化列表，bits为1~20
+#define LED_LUT_GAMMA(bits)         { LED_LUT_GAMMA_Q24(LED_LUT_SCALE, bits) }
+#define LED_LUT_CIE(bits)           { LED_LUT_CIE_Q24(LED_LUT_SCALE, bits) }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/*
+* @file         led_lut_table.h
+* @brief        亮度查找表数据(由tools/led_lut.py生成，不要手工修改)
+* @details      256级，Q24定点，通过led_lut.h中的宏使用
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef LED_LUT_TABLE_H
+#define LED_LUT_TABLE_H
+
+#define LED_LUT_TABLE_LEVELS        256
+#define LED_LUT_TABLE_Q             24
+
+//伽马2.2，X(v, bits)逐项换算
+#define LED_LUT_GAMMA_Q24(X, bits) \
+	X(0, bits), X(85, bits), X(391, bits), X(955, bits), X(1798, bits), X(2938, bits), X(4388, bits), X(6160, bits), \
+	X(8263, bits), X(10707, bits), X(13500, bits), X(16649, bits), X(20162, bits), X(24044, bits), X(28302, bits), X(32941, bits), \
+	X(37966, bits), X(43383, bits), X(49196, bits), X(55410, bits), X(62029, bits), X(69058, bits), X(76500, bits), X(84359, bits), \
+	X(92640, bits), X(101344, bits), X(110477, bits), X(120042, bits), X(130041, bits), X(140478, bits), X(151356, bits), X(162677, bits), \
+	X(174446, bits), X(186665, bits), X(199336, bits), X(212462, bits), X(226046, bits), X(240091, bits), X(254598, bits), X(269571, bits), \
+	X(285012, bits), X(300923, bits), X(317307, bits), X(334166, bits), X(351502, bits), X(369317, bits), X(387613, bits), X(406394, bits), \
+	X(425659, bits), X(445413, bits), X(465656, bits), X(486391, bits), X(507620, bits), X(529345, bits), X(551566, bits), X(574288, bits), \
+	X(597510, bits), X(621235, bits), X(645466, bits), X(670202, bits), X(695447, bits), X(721202, bits), X(747469, bits), X(774249, bits), \
+	X(801544, bits), X(829356, bits), X(857686, bits), X(886535, bits), X(915906, bits), X(945800, bits), X(976219, bits), X(1007163, bits), \
+	X(1038635, bits), X(1070636, bits), X(1103167, bits), X(1136230, bits), X(1169826, bits), X(1203957, bits), X(1238624, bits), X(1273829, bits), \
+	X(1309572, bits), X(1345856, bits), X(1382681, bits), X(1420049, bits), X(1457961, bits), X(1496419, bits), X(1535423, bits), X(1574976, bits), \
+	X(1615078, bits), X(1655730, bits), X(1696934, bits), X(1738692, bits), X(1781003, bits), X(1823870, bits), X(1867294, bits), X(1911276, bits), \
+	X(1955817, bits), X(2000918, bits), X(2046581, bits), X(2092806, bits), X(2139595, bits), X(2186948, bits), X(2234868, bits), X(2283355, bits), \
+	X(2332410, bits), X(2382034, bits), X(2432229, bits), X(2482995, bits), X(2534333, bits), X(2586246, bits), X(2638733, bits), X(2691795, bits), \
+	X(2745435, bits), X(2799652, bits), X(2854448, bits), X(2909824, bits), X(2965781, bits), X(3022320, bits), X(3079441, bits), X(3137147, bits), \
+	X(3195437, bits), X(3254313, bits), X(3313776, bits), X(3373826, bits), X(3434466, bits), X(3495695, bits), X(3557515, bits), X(3619926, bits), \
+	X(3682930, bits), X(3746527, bits), X(3810719, bits), X(3875505, bits), X(3940889, bits), X(4006869, bits), X(4073447, bits), X(4140624, bits), \
+	X(4208401, bits), X(4276778, bits), X(4345758, bits), X(4415339, bits), X(4485524, bits), X(4556313, bits), X(4627707, bits), X(4699707, bits), \
+	X(4772314, bits), X(4845528, bits), X(4919351, bits), X(4993783, bits), X(5068825, bits), X(5144478, bits), X(5220742, bits), X(5297620, bits), \
+	X(5375110, bits), X(5453215, bits), X(5531935, bits), X(5611271, bits), X(5691223, bits), X(5771793, bits), X(5852981, bits), X(5934787, bits), \
+	X(6017214, bits), X(6100261, bits), X(6183930, bits), X(6268220, bits), X(6353133, bits), X(6438670, bits), X(6524831, bits), X(6611618, bits), \
+	X(6699030, bits), X(6787069, bits), X(6875735, bits), X(6965029, bits), X(7054952, bits), X(7145505, bits), X(7236688, bits), X(7328502, bits), \
+	X(7420948, bits), X(7514026, bits), X(7607737, bits), X(7702083, bits), X(7797062, bits), X(7892678, bits), X(7988929, bits), X(8085817, bits), \
+	X(8183342, bits), X(8281506, bits), X(8380308, bits), X(8479750, bits), X(8579832, bits), X(8680555, bits), X(8781919, bits), X(8883925, bits), \
+	X(8986575, bits), X(9089868, bits), X(9193805, bits), X(9298388, bits), X(9403615, bits), X(9509489, bits), X(9616010, bits), X(9723179, bits), \
+	X(9830995, bits), X(9939461, bits), X(10048576, bits), X(10158341, bits), X(10268757, bits), X(10379824, bits), X(10491543, bits), X(10603916, bits), \
+	X(10716941, bits), X(10830620, bits), X(10944954, bits), X(11059943, bits), X(11175588, bits), X(11291890, bits), X(11408848, bits), X(11526464, bits), \
+	X(11644739, bits), X(11763672, bits), X(11883265, bits), X(12003518, bits), X(12124432, bits), X(12246007, bits), X(12368244, bits), X(12491144, bits), \
+	X(12614706, bits), X(12738933, bits), X(12863823, bits), X(12989379, bits), X(13115600, bits), X(13242487, bits), X(13370041, bits), X(13498262, bits), \
+	X(13627151, bits), X(13756708, bits), X(13886934, bits), X(14017830, bits), X(14149396, bits), X(14281633, bits), X(14414541, bits), X(14548120, bits), \
+	X(14682372, bits), X(14817297, bits), X(14952896, bits), X(15089168, bits), X(15226115, bits), X(15363738, bits), X(15502036, bits), X(15641010, bits), \
+	X(15780661, bits), X(15920990, bits), X(16061996, bits), X(16203681, bits), X(16346045, bits), X(16489088, bits), X(16632812, bits), X(16777216, bits)
+
+//CIE1931明度，X(v, bits)逐项换算
+#define LED_LUT_CIE_Q24(X, bits) \
+	X(0, bits), X(7284, bits), X(14567, bits), X(21851, bits), X(29135, bits), X(36418, bits), X(43702, bits), X(50985, bits), \
+	X(58269, bits), X(65553, bits), X(72836, bits), X(80120, bits), X(87404, bits), X(94687, bits), X(101971, bits), X(109254, bits), \
+	X(116538, bits), X(123822, bits), X(131105, bits), X(138389, bits), X(145673, bits), X(153000, bits), X(160548, bits), X(168340, bits), \
+	X(176380, bits), X(184673, bits), X(193221, bits), X(202029, bits), X(211101, bits), X(220441, bits), X(230052, bits), X(239938, bits), \
+	X(250103, bits), X(260552, bits), X(271288, bits), X(282314, bits), X(293636, bits), X(305256, bits), X(317179, bits), X(329408, bits), \
+	X(341948, bits), X(354801, bits), X(367973, bits), X(381467, bits), X(395287, bits), X(409437, bits), X(423921, bits), X(438742, bits), \
+	X(453904, bits), X(469412, bits), X(485269, bits), X(501480, bits), X(518047, bits), X(534976, bits), X(552269, bits), X(569931, bits), \
+	X(587965, bits), X(606376, bits), X(625167, bits), X(644343, bits), X(663907, bits), X(683862, bits), X(704214, bits), X(724966, bits), \
+	X(746121, bits), X(767684, bits), X(789658, bits), X(812048, bits), X(834857, bits), X(858089, bits), X(881748, bits), X(905839, bits), \
+	X(930364, bits), X(955327, bits), X(980734, bits), X(1006586, bits), X(1032890, bits), X(1059647, bits), X(1086863, bits), X(1114540, bits), \
+	X(1142684, bits), X(1171298, bits), X(1200385, bits), X(1229950, bits), X(1259996, bits), X(1290528, bits), X(1321549, bits), X(1353063, bits), \
+	X(1385074, bits), X(1417586, bits), X(1450603, bits), X(1484129, bits), X(1518167, bits), X(1552722, bits), X(1587797, bits), X(1623397, bits), \
+	X(1659525, bits), X(1696184, bits), X(1733380, bits), X(1771116, bits), X(1809395, bits), X(1848222, bits), X(1887600, bits), X(1927534, bits), \
+	X(1968027, bits), X(2009083, bits), X(2050707, bits), X(2092901, bits), X(2135670, bits), X(2179018, bits), X(2222949, bits), X(2267466, bits), \
+	X(2312573, bits), X(2358275, bits), X(2404575, bits), X(2451477, bits), X(2498984, bits), X(2547102, bits), X(2595834, bits), X(2645183, bits), \
+	X(2695154, bits), X(2745750, bits), X(2796975, bits), X(2848834, bits), X(2901329, bits), X(2954466, bits), X(3008247, bits), X(3062677, bits), \
+	X(3117760, bits), X(3173500, bits), X(3229899, bits), X(3286963, bits), X(3344696, bits), X(3403100, bits), X(3462180, bits), X(3521940, bits), \
+	X(3582384, bits), X(3643516, bits), X(3705339, bits), X(3767857, bits), X(3831075, bits), X(3894996, bits), X(3959624, bits), X(4024963, bits), \
+	X(4091017, bits), X(4157790, bits), X(4225285, bits), X(4293507, bits), X(4362459, bits), X(4432146, bits), X(4502570, bits), X(4573737, bits), \
+	X(4645650, bits), X(4718313, bits), X(4791729, bits), X(4865903, bits), X(4940839, bits), X(5016540, bits), X(5093010, bits), X(5170254, bits), \
+	X(5248274, bits), X(5327076, bits), X(5406662, bits), X(5487037, bits), X(5568205, bits), X(5650170, bits), X(5732935, bits), X(5816504, bits), \
+	X(5900881, bits), X(5986071, bits), X(6072076, bits), X(6158901, bits), X(6246551, bits), X(6335027, bits), X(6424336, bits), X(6514479, bits), \
+	X(6605462, bits), X(6697289, bits), X(6789962, bits), X(6883486, bits), X(6977866, bits), X(7073103, bits), X(7169204, bits), X(7266171, bits), \
+	X(7364009, bits), X(7462721, bits), X(7562311, bits), X(7662783, bits), X(7764142, bits), X(7866390, bits), X(7969532, bits), X(8073571, bits), \
+	X(8178512, bits), X(8284359, bits), X(8391115, bits), X(8498784, bits), X(8607370, bits), X(8716877, bits), X(8827310, bits), X(8938670, bits), \
+	X(9050964, bits), X(9164194, bits), X(9278365, bits), X(9393479, bits), X(9509543, bits), X(9626558, bits), X(9744529, bits), X(9863460, bits), \
+	X(9983355, bits), X(10104218, bits), X(10226052, bits), X(10348861, bits), X(10472650, bits), X(10597422, bits), X(10723182, bits), X(10849932, bits), \
+	X(10977677, bits), X(11106421, bits), X(11236167, bits), X(11366921, bits), X(11498684, bits), X(11631462, bits), X(11765258, bits), X(11900077, bits), \
+	X(12035921, bits), X(12172795, bits), X(12310703, bits), X(12449649, bits), X(12589636, bits), X(12730669, bits), X(12872751, bits), X(13015886, bits), \
+	X(13160079, bits), X(13305332, bits), X(13451650, bits), X(13599038, bits), X(13747497, bits), X(13897034, bits), X(14047651, bits), X(14199352, bits), \
+	X(14352141, bits), X(14506023, bits), X(14661000, bits), X(14817078, bits), X(14974259, bits), X(15132548, bits), X(15291949, bits), X(15452465, bits), \
+	X(15614100, bits), X(15776858, bits), X(15940744, bits), X(16105761, bits), X(16271913, bits), X(16439203, bits), X(16607636, bits), X(16777216, bits)
+
+#endif
@@ -0,0 +1,79 @@
+/*
+* @file         led_swpwm.h
+* @brief        定时器中断软件PWM
+* @details      LEDC通道不够用时，用一个硬件定时器给任意输出引脚(如用户灯)做PWM调光:
+*               各通道按占空比排序，一个周期内只在有引脚翻转的时刻进中断，
+*               同一时刻翻转的引脚经GPIO组(gpio_group.h)一次写出，中断开销与翻转点数有关、与通道数无关；
+*               接口对照LEDC:SetDuty/UpdateDuty/GetDuty/SetFadeWithTime/FadeStart，
+*               另提供中断耗时和延迟统计
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef LED_SWPWM_H
+#define LED_SWPWM_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/ledc.h"
+#include "driver/timer.h"
+#include "gpio_group.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_SWPWM_MAX_CH            GPIO_GROUP_MAX_PINS //通道数上限
+#define LED_SWPWM_TIMER_GROUP       TIMER_GROUP_0       //使用的硬件定时器
+#define LED_SWPWM_TIMER_IDX         TIMER_0
+#define LED_SWPWM_TIMER_DIV         2                   //定时器分频，APB 80MHz/2 = 40MHz(25ns)
+#define LED_SWPWM_TICK_HZ           (80000000 / LED_SWPWM_TIMER_DIV)
+#define LED_SWPWM_MIN_GAP_US        4                   //相邻翻转点小于该间隔时在同一次中断中等待，不再进中断
+#define LED_SWPWM_FADE_TICK_MS      10                  //渐变刷新周期
+
+//一个周期的翻转表:第0项在周期开始时写出，第i项在at[i]时写出(at递增)
+typedef struct {
+	uint8_t count;
+	uint32_t at[LED_SWPWM_MAX_CH + 1];              /*!< 相对周期开始的定时器计数 */
+	GpioGroup_Masks_t masks[LED_SWPWM_MAX_CH + 1];
+} LedSwPwm_Sched_t;
+
+//中断统计，周期数为CPU时钟周期，计数为定时器计数(25ns)
+typedef struct {
+	uint32_t isr_count;             /*!< 进中断次数 */
+	uint32_t edge_count;            /*!< 写出的翻转点数 */
+	uint32_t spin_count;            /*!< 间隔太近、在同一次中断中等到的翻转点数 */
+	uint32_t miss_count;            /*!< 中断来晚、已经错过的翻转点数 */
+	uint32_t cycles_max;            /*!< 单次中断最大耗时 */
+	uint64_t cycles_sum;            /*!< 中断总耗时，除以isr_count为平均耗时 */
+	uint32_t late_max;              /*!< 进中断相对闹钟的最大延迟 */
+} LedSwPwm_Stats_t;
+
+
+esp_err_t LedSwPwm_Init(const gpio_num_t *pins, uint8_t count, uint32_t invert, uint32_t freq_hz, uint8_t duty_bits);
+esp_err_t LedSwPwm_SetDuty(uint8_t ch, uint32_t duty);
+esp_err_t LedSwPwm_UpdateDuty(uint8_t ch);
+uint32_t LedSwPwm_GetDuty(uint8_t ch);
+esp_err_t LedSwPwm_SetFadeWithTime(uint8_t ch, uint32_t target_duty, int max_fade_time_ms);
+esp_err_t LedSwPwm_FadeStart(uint8_t ch, ledc_fade_mode_t fade_mode);
+void LedSwPwm_GetStats(LedSwPwm_Stats_t *stats);
+void LedSwPwm_ResetStats(void);
+void LedSwPwm_Build(const GpioGroup_t *group, const uint32_t *duty, uint8_t duty_bits, uint32_t period,
+                    LedSwPwm_Sched_t *sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
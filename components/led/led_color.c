@@ -0,0 +1,250 @@
+/*
+* @file         led_color.c
+* @brief        RGB灯颜色计算(定点)
+* @details      HSV转RGB:每个扇区内一个通道为v，一个为p=v*(255-s)/255，另一个在两者之间线性变化，
+*               只需两次乘法和移位(除以255用移位实现，0~65025范围内与四舍五入结果一致)；色温查表后线性插值
+*               不依赖ESP-IDF，可在PC上编译(见tools/led_color_bench.c)
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "led_color.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_COLOR_KELVIN_STEP       500                 //色温表间隔(K)
+#define LED_COLOR_HUE_Q16_MAX       ((int32_t)LED_COLOR_HUE_MAX << 16)
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+//黑体色温对应的RGB(1000K~12000K，间隔500K，按Tanner Helland的拟合公式计算)
+static const LedColor_Rgb_t g_kelvin_table[] = {
+    {255,  68,   0}, {255, 108,   0}, {255, 137,  14}, {255, 159,  70}, {255, 177, 110}, {255, 193, 141},
+    {255, 206, 166}, {255, 218, 187}, {255, 228, 206}, {255, 237, 222}, {255, 246, 237}, {255, 254, 250},
+    {243, 242, 255}, {230, 235, 255}, {221, 230, 255}, {215, 226, 255}, {210, 223, 255}, {205, 220, 255},
+    {202, 218, 255}, {199, 216, 255}, {196, 214, 255}, {193, 213, 255}, {191, 211, 255},
+};
+
+//各扇区内线性变化的通道(0 R 1 G 2 B)，偶数扇区上升、奇数扇区下降
+static const uint8_t g_ramp_ch[6] = {1, 0, 2, 1, 0, 2};
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * x/255，x为0~65025
+ * @param[in]   x   被除数
+ * @retval      商(四舍五入)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static inline uint8_t led_color_div255(uint32_t x)
+{
+    x += 128;
+    return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+/**
+ * HSV转RGB
+ * @param[in]   h     色相，0~LED_COLOR_HUE_MAX-1，超出部分取模
+ * @param[in]   s     饱和度0~255
+ * @param[in]   v     亮度0~255
+ * @param[out]  rgb   结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedColor_HsvToRgb(uint16_t h, uint8_t s, uint8_t v, LedColor_Rgb_t *rgb)
+{
+    uint8_t sector, f, p, ramp;
+
+    if (h >= LED_COLOR_HUE_MAX)
+    {
+        h %= LED_COLOR_HUE_MAX;
+    }
+    sector = h / LED_COLOR_HUE_SECTOR;
+    f = h % LED_COLOR_HUE_SECTOR;
+    p = led_color_div255((uint32_t)v * (255 - s));
+    ramp = p + (((uint32_t)(v - p) * ((sector & 1) ? LED_COLOR_HUE_SECTOR - f : f) + 128) >> 8);
+
+    switch (sector)
+    {
+    case 0:  rgb->r = v;    rgb->g = ramp; rgb->b = p;    break;
+    case 1:  rgb->r = ramp; rgb->g = v;    rgb->b = p;    break;
+    case 2:  rgb->r = p;    rgb->g = v;    rgb->b = ramp; break;
+    case 3:  rgb->r = p;    rgb->g = ramp; rgb->b = v;    break;
+    case 4:  rgb->r = ramp; rgb->g = p;    rgb->b = v;    break;
+    default: rgb->r = v;    rgb->g = p;    rgb->b = ramp; break;
+    }
+}
+
+/**
+ * HSL转RGB:先换算为HSV
+ * @param[in]   h     色相，0~LED_COLOR_HUE_MAX-1
+ * @param[in]   s     饱和度0~255
+ * @param[in]   l     明度0~255(128为纯色)
+ * @param[out]  rgb   结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedColor_HslToRgb(uint16_t h, uint8_t s, uint8_t l, LedColor_Rgb_t *rgb)
+{
+    uint32_t v, sv;
+
+    v = l + led_color_div255((uint32_t)s * (l < 128 ? l : 255 - l));
+    sv = v ? 2 * (v - l) * 255 / v : 0;
+    LedColor_HsvToRgb(h, sv > 255 ? 255 : sv, v, rgb);
+}
+
+/**
+ * 色温转RGB
+ * @param[in]   kelvin   色温(K)，超出LED_COLOR_KELVIN_MIN~MAX时取边界
+ * @param[in]   v        亮度0~255
+ * @param[out]  rgb      结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedColor_Kelvin(uint16_t kelvin, uint8_t v, LedColor_Rgb_t *rgb)
+{
+    const LedColor_Rgb_t *a, *b;
+    uint32_t idx, frac;
+
+    if (kelvin < LED_COLOR_KELVIN_MIN)
+    {
+        kelvin = LED_COLOR_KELVIN_MIN;
+    }
+    if (kelvin > LED_COLOR_KELVIN_MAX)
+    {
+        kelvin = LED_COLOR_KELVIN_MAX;
+    }
+    idx = (kelvin - LED_COLOR_KELVIN_MIN) / LED_COLOR_KELVIN_STEP;
+    frac = (kelvin - LED_COLOR_KELVIN_MIN) % LED_COLOR_KELVIN_STEP * 256 / LED_COLOR_KELVIN_STEP;
+    a = &g_kelvin_table[idx];
+    b = (kelvin < LED_COLOR_KELVIN_MAX) ? a + 1 : a;
+
+    rgb->r = led_color_div255(v * ((a->r * (256 - frac) + b->r * frac) >> 8));
+    rgb->g = led_color_div255(v * ((a->g * (256 - frac) + b->g * frac) >> 8));
+    rgb->b = led_color_div255(v * ((a->b * (256 - frac) + b->b * frac) >> 8));
+}
+
+/**
+ * 色相旋转
+ * @param[in]   h       色相
+ * @param[in]   delta   旋转量，可为负
+ * @retval      旋转后的色相，0~LED_COLOR_HUE_MAX-1
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+uint16_t LedColor_HueRotate(uint16_t h, int32_t delta)
+{
+    int32_t r = ((int32_t)h + delta) % LED_COLOR_HUE_MAX;
+
+    return (uint16_t)(r < 0 ? r + LED_COLOR_HUE_MAX : r);
+}
+
+/**
+ * 按当前色相完整计算一次颜色，并准备扇区内的增量
+ * @param[in]   sw   渐变状态
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_color_sweep_sector(LedColor_Sweep_t *sw)
+{
+    uint8_t p = led_color_div255((uint32_t)sw->v * (255 - sw->s));
+    uint8_t *ch = (uint8_t *)&sw->rgb;
+
+    LedColor_HsvToRgb(sw->hue >> 16, sw->s, sw->v, &sw->rgb);
+    sw->sector = (sw->hue >> 16) / LED_COLOR_HUE_SECTOR;
+    sw->ramp_ch = g_ramp_ch[sw->sector];
+    sw->ramp = (int32_t)ch[sw->ramp_ch] << 16;
+    sw->ramp_step = (int32_t)((int64_t)(sw->v - p) * sw->step / LED_COLOR_HUE_SECTOR);
+    if (sw->sector & 1)
+    {
+        sw->ramp_step = -sw->ramp_step;
+    }
+}
+
+/**
+ * 初始化色相渐变:frames帧内色相从h变化delta(可超过一圈，可为负)，s、v不变
+ * @param[out]  sweep    渐变状态
+ * @param[in]   h        起始色相
+ * @param[in]   delta    色相变化总量
+ * @param[in]   frames   帧数
+ * @param[in]   s        饱和度
+ * @param[in]   v        亮度
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedColor_SweepInit(LedColor_Sweep_t *sweep, uint16_t h, int32_t delta, uint32_t frames, uint8_t s, uint8_t v)
+{
+    int64_t step = ((int64_t)delta << 16) / (frames ? frames : 1);
+
+    //每帧不超过一圈
+    if (step >= LED_COLOR_HUE_Q16_MAX || step <= -LED_COLOR_HUE_Q16_MAX)
+    {
+        step %= LED_COLOR_HUE_Q16_MAX;
+    }
+    sweep->hue = (uint32_t)(h % LED_COLOR_HUE_MAX) << 16;
+    sweep->step = (int32_t)step;
+    sweep->s = s;
+    sweep->v = v;
+    led_color_sweep_sector(sweep);
+}
+
+/**
+ * 前进一帧，扇区内只做一次累加
+ * @param[in]   sweep   渐变状态
+ * @retval      本帧颜色(指向sweep内部)
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+const LedColor_Rgb_t *LedColor_SweepNext(LedColor_Sweep_t *sweep)
+{
+    int32_t hue = (int32_t)sweep->hue + sweep->step;
+    int32_t val;
+
+    if (hue < 0)
+    {
+        hue += LED_COLOR_HUE_Q16_MAX;
+    }
+    else if (hue >= LED_COLOR_HUE_Q16_MAX)
+    {
+        hue -= LED_COLOR_HUE_Q16_MAX;
+    }
+    sweep->hue = hue;
+
+    if ((hue >> 16) / LED_COLOR_HUE_SECTOR != sweep->sector)
+    {
+        led_color_sweep_sector(sweep);
+        return &sweep->rgb;
+    }
+    sweep->ramp += sweep->ramp_step;
+    val = (sweep->ramp + 0x8000) >> 16;
+    ((uint8_t *)&sweep->rgb)[sweep->ramp_ch] = (val < 0) ? 0 : (val > 255 ? 255 : val);
+    return &sweep->rgb;
+}
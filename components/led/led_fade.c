@@ -0,0 +1,657 @@
+/*
+* @file         led_fade.c
+* @brief        LEDC多通道同步渐变
+* @details      使用LEDC硬件渐变(每cycle个PWM周期占空比变化scale，共step步)，参数在LedFade_Play中
+*               预先算好，中断里只写寄存器；每帧从上一帧的精确目标值开始，舍入误差不会累积，
+*               各通道都结束才进入下一帧，通道之间不会漂移
+*               亮度曲线模式下一帧拆成逐级的线性段，每段参数在中断里用O(1)整数运算得出
+*               下一段的参数在临界区内算好，ledc驱动函数(自带锁)在临界区外调用
+*               本模块自己注册LEDC中断，不能与ledc_fade_func_install同时使用
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "led_fade.h"
+#include "string.h"
+#include "soc/ledc_struct.h"
+#include "soc/ledc_reg.h"
+/*
+===========================
+宏定义
+===========================
+*/
+//通道渐变结束中断在中断寄存器中的位
+#define LED_FADE_INT_BIT(mode, ch)  (1UL << (((mode) == LEDC_HIGH_SPEED_MODE ?                  \
+                                             LEDC_DUTY_CHNG_END_HSCH0_INT_ENA_S :             \
+                                             LEDC_DUTY_CHNG_END_LSCH0_INT_ENA_S) + (ch)))
+//准备好的动作
+#define LED_FADE_LAUNCH_FADE        1                   //启动一帧(一级)渐变
+#define LED_FADE_LAUNCH_HOLD        2                   //序列结束，定在最终占空比
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static LedFade_Group_t *g_fade_groups[LED_FADE_MAX_GROUPS];
+static uint8_t g_fade_group_count = 0;
+static uint32_t g_fade_int_mask = 0;                //已登记通道的渐变结束中断位
+static ledc_isr_handle_t g_fade_isr = NULL;
+static portMUX_TYPE g_fade_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 计算一段硬件渐变的参数:在满足10位上限的步数中，综合总周期数偏差、终点偏差(不越过目标)
+ * 和每步跳变的大小选一组；三者都按相对值比较，跳变项使渐变尽量细
+ * 纯整数运算，不依赖硬件，可在PC上编译验证
+ * @param[in]   from     起点占空比
+ * @param[in]   to       目标占空比
+ * @param[in]   cycles   期望时长(PWM周期数)
+ * @param[out]  hw       渐变参数
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedFade_Calc(uint32_t from, uint32_t to, uint32_t cycles, LedFade_Hw_t *hw)
+{
+    uint32_t delta = (to > from) ? to - from : from - to;
+    uint32_t n, lo, hi, cyc, sc, terr, verr;
+    uint64_t cost, best = UINT64_MAX;
+
+    hw->dir = (to >= from) ? LEDC_DUTY_DIR_INCREASE : LEDC_DUTY_DIR_DECREASE;
+    if (cycles == 0)
+    {
+        cycles = 1;
+    }
+    if (cycles > LED_FADE_HW_MAX * LED_FADE_HW_MAX)
+    {
+        cycles = LED_FADE_HW_MAX * LED_FADE_HW_MAX;
+    }
+
+    //步数范围:每步周期数和步长都不超过10位，有变化时步长至少为1
+    lo = (cycles + LED_FADE_HW_MAX - 1) / LED_FADE_HW_MAX;
+    if ((delta + LED_FADE_HW_MAX - 1) / LED_FADE_HW_MAX > lo)
+    {
+        lo = (delta + LED_FADE_HW_MAX - 1) / LED_FADE_HW_MAX;
+    }
+    hi = (cycles < LED_FADE_HW_MAX) ? cycles : LED_FADE_HW_MAX;
+    if (delta && delta < hi)
+    {
+        hi = delta;
+    }
+    if (lo > hi)
+    {
+        //时间太短走不完:每个周期都走最大步长，终点由下一帧起点补齐
+        hw->step = hi;
+        hw->cycle = 1;
+        hw->scale = (delta / hi > LED_FADE_HW_MAX) ? LED_FADE_HW_MAX : delta / hi;
+        return;
+    }
+
+    for (n = lo; n <= hi; n ++)
+    {
+        cyc = (cycles + n / 2) / n;
+        if (cyc == 0 || cyc > LED_FADE_HW_MAX)
+        {
+            continue;
+        }
+        sc = delta / n;
+        terr = (n * cyc > cycles) ? n * cyc - cycles : cycles - n * cyc;
+        verr = delta - n * sc;
+        cost = (uint64_t)terr * (delta ? delta : 1) + (uint64_t)(verr + sc) * cycles;
+        if (cost < best)
+        {
+            best = cost;
+            hw->step = n;
+            hw->cycle = cyc;
+            hw->scale = sc;
+            if (cost == 0)
+            {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * 准备一帧(在临界区内调用):记下各通道的起点和渐变参数，由led_fade_launch写入驱动
+ * @param[in]   g      通道组
+ * @param[in]   from   各通道起点
+ * @param[in]   hw     各通道渐变参数
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 只准备参数，驱动调用移到临界区外\n
+ */
+static void led_fade_apply(LedFade_Group_t *g, const uint32_t *from, const LedFade_Hw_t *hw)
+{
+    memcpy(g->launch_duty, from, g->count * sizeof(from[0]));
+    memcpy(g->launch_hw, hw, g->count * sizeof(hw[0]));
+    g->done_mask = 0;
+    g->launch = LED_FADE_LAUNCH_FADE;
+    g->launching = 1;
+}
+
+/**
+ * 写入准备好的动作(在临界区外调用):渐变时先给所有通道写好参数，再依次启动，
+ * 启动间隔只有几次寄存器写；结束时各通道定在最终占空比
+ * @param[in]   g   通道组
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fade_launch(LedFade_Group_t *g)
+{
+    uint8_t i;
+
+    for (i = 0; i < g->count; i ++)
+    {
+        if (g->launch == LED_FADE_LAUNCH_FADE)
+        {
+            ledc_set_fade(g->speed_mode, g->channel[i], g->launch_duty[i], g->launch_hw[i].dir,
+                          g->launch_hw[i].step, g->launch_hw[i].cycle, g->launch_hw[i].scale);
+        }
+        else
+        {
+            ledc_set_duty(g->speed_mode, g->channel[i], g->launch_duty[i]);
+        }
+    }
+    for (i = 0; i < g->count; i ++)
+    {
+        ledc_update_duty(g->speed_mode, g->channel[i]);
+    }
+    g->launching = 0;
+}
+
+/**
+ * 亮度曲线模式下一级的渐变参数:步数取变化量、周期数和10位上限中最小的，
+ * 不做搜索，供中断使用；终点误差由下一级的起点补齐
+ * @param[in]   from     起点占空比
+ * @param[in]   to       目标占空比
+ * @param[in]   cycles   时长(PWM周期数)
+ * @param[out]  hw       渐变参数
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fade_seg_hw(uint32_t from, uint32_t to, uint32_t cycles, LedFade_Hw_t *hw)
+{
+    uint32_t delta = (to > from) ? to - from : from - to;
+    uint32_t n;
+
+    hw->dir = (to >= from) ? LEDC_DUTY_DIR_INCREASE : LEDC_DUTY_DIR_DECREASE;
+    if (cycles == 0)
+    {
+        cycles = 1;
+    }
+    if (delta == 0)
+    {
+        n = (cycles + LED_FADE_HW_MAX - 1) / LED_FADE_HW_MAX;
+    }
+    else
+    {
+        n = (delta < cycles) ? delta : cycles;
+    }
+    if (n > LED_FADE_HW_MAX)
+    {
+        n = LED_FADE_HW_MAX;
+    }
+    hw->step = n;
+    hw->cycle = (cycles / n > LED_FADE_HW_MAX) ? LED_FADE_HW_MAX : cycles / n;
+    hw->scale = (delta / n > LED_FADE_HW_MAX) ? LED_FADE_HW_MAX : delta / n;
+}
+
+/**
+ * 亮度曲线模式:启动本帧的下一级，各通道按各自的级差等比例前进
+ * @param[in]   g   通道组
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fade_segment(LedFade_Group_t *g)
+{
+    const LedFade_Key_t *key = &g->keys[g->key_idx];
+    uint32_t from[LED_FADE_MAX_CH];
+    LedFade_Hw_t hw[LED_FADE_MAX_CH];
+    uint32_t cycles = g->seg_cycles + (g->seg < g->seg_rem ? 1 : 0) + g->seg_carry;
+    uint32_t used = 0;
+    int32_t span, l0, l1;
+    uint8_t i;
+
+    g->seg ++;
+    for (i = 0; i < g->count; i ++)
+    {
+        span = (int32_t)key->duty[i] - (int32_t)g->from_level[i];
+        l0 = (int32_t)g->from_level[i] + span * (g->seg - 1) / g->seg_count;
+        l1 = (int32_t)g->from_level[i] + span * g->seg / g->seg_count;
+        from[i] = g->lut[l0];
+        led_fade_seg_hw(from[i], g->lut[l1], cycles, &hw[i]);
+        if ((uint32_t)hw[i].step * hw[i].cycle > used)
+        {
+            used = (uint32_t)hw[i].step * hw[i].cycle;
+        }
+    }
+    //本级按最慢的通道结束
+    g->seg_carry = (cycles > used) ? cycles - used : 0;
+    led_fade_apply(g, from, hw);
+}
+
+/**
+ * 启动一帧，亮度曲线模式下启动其第一级
+ * @param[in]   g      通道组
+ * @param[in]   from   各通道起点(亮度曲线模式下为亮度级)
+ * @param[in]   hw     各通道渐变参数(仅线性模式使用)
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fade_start_key(LedFade_Group_t *g, const uint32_t *from, const LedFade_Hw_t *hw)
+{
+    const LedFade_Key_t *key = &g->keys[g->key_idx];
+    uint32_t span, segs = 1;
+    uint8_t i;
+
+    if (g->lut == NULL)
+    {
+        led_fade_apply(g, from, hw);
+        return;
+    }
+    for (i = 0; i < g->count; i ++)
+    {
+        g->from_level[i] = from[i];
+        span = (key->duty[i] > from[i]) ? key->duty[i] - from[i] : from[i] - key->duty[i];
+        if (span > segs)
+        {
+            segs = span;
+        }
+    }
+    g->seg = 0;
+    g->seg_carry = 0;
+    g->seg_count = segs;
+    g->seg_cycles = key->cycles / segs;
+    g->seg_rem = key->cycles % segs;
+    led_fade_segment(g);
+}
+
+/**
+ * 一帧结束后启动下一帧
+ * @param[in]   g   通道组
+ * @retval      1已启动下一帧 0序列结束
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 亮度曲线模式下从第一级开始\n
+ */
+static bool led_fade_next(LedFade_Group_t *g)
+{
+    uint16_t idx = g->key_idx + 1;
+
+    if (idx >= g->key_count)
+    {
+        if (g->repeat && -- g->repeat == 0)
+        {
+            return 0;
+        }
+        idx = 0;
+    }
+    g->key_idx = idx;
+    led_fade_start_key(g, g->keys[idx ? idx - 1 : g->key_count - 1].duty, g->keys[idx].hw);
+    return 1;
+}
+
+/**
+ * LEDC中断:记录各组结束的通道，组内全部结束时准备下一帧，序列结束时准备最终占空比；
+ * 退出临界区后再写入驱动，序列结束的组随后通知等待的任务
+ * 只清除已登记通道的中断位，LEDC的其它中断留给别的处理函数
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 亮度曲线模式下逐级启动\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 只清除本模块的中断位；驱动调用移到临界区外\n
+ */
+static void led_fade_isr(void *arg)
+{
+    uint32_t st = LEDC.int_st.val & g_fade_int_mask;
+    BaseType_t woken = pdFALSE;
+    LedFade_Group_t *g;
+    uint8_t gi, i, launch = 0, finish = 0;
+
+    (void)arg;
+    LEDC.int_clr.val = st;
+    portENTER_CRITICAL_ISR(&g_fade_mux);
+    for (gi = 0; gi < g_fade_group_count; gi ++)
+    {
+        g = g_fade_groups[gi];
+        if (!g->running)
+        {
+            continue;
+        }
+        for (i = 0; i < g->count; i ++)
+        {
+            if (st & LED_FADE_INT_BIT(g->speed_mode, g->channel[i]))
+            {
+                g->done_mask |= 1 << i;
+            }
+        }
+        if (g->done_mask != (1 << g->count) - 1)
+        {
+            continue;
+        }
+        launch |= 1 << gi;
+        if (g->lut && g->seg < g->seg_count)
+        {
+            led_fade_segment(g);
+            continue;
+        }
+        g->keys_done ++;
+        if (led_fade_next(g))
+        {
+            continue;
+        }
+        //序列结束，占空比定在最后一帧的目标
+        for (i = 0; i < g->count; i ++)
+        {
+            g->launch_duty[i] = g->lut ? g->lut[g->keys[g->key_count - 1].duty[i]] :
+                                         g->keys[g->key_count - 1].duty[i];
+        }
+        g->launch = LED_FADE_LAUNCH_HOLD;
+        g->launching = 1;
+        g->running = 0;
+        finish |= 1 << gi;
+    }
+    portEXIT_CRITICAL_ISR(&g_fade_mux);
+
+    for (gi = 0; launch; gi ++, launch >>= 1)
+    {
+        if (launch & 1)
+        {
+            g = g_fade_groups[gi];
+            led_fade_launch(g);
+            if (finish & (1 << gi))
+            {
+                xSemaphoreGiveFromISR(g->done, &woken);
+            }
+        }
+    }
+    if (woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/**
+ * 注册LEDC中断(代替ledc_fade_func_install)，重复调用直接返回
+ * @retval
+ *              - ESP_OK
+ *              - 其它  中断分配错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedFade_Init(void)
+{
+    if (g_fade_isr)
+    {
+        return ESP_OK;
+    }
+    return ledc_isr_register(led_fade_isr, NULL, 0, &g_fade_isr);
+}
+
+/**
+ * 登记一组通道，通道须已用ledc_channel_config配置且属于同一定时器
+ * @param[out]  group        通道组
+ * @param[in]   speed_mode   速度模式
+ * @param[in]   timer        定时器
+ * @param[in]   channel      通道列表
+ * @param[in]   count        通道数，不超过LED_FADE_MAX_CH
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ *              - ESP_ERR_NO_MEM  组已满
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 记录本组通道的中断位\n
+ */
+esp_err_t LedFade_AddGroup(LedFade_Group_t *group, ledc_mode_t speed_mode, ledc_timer_t timer,
+                           const ledc_channel_t *channel, uint8_t count)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t i;
+
+    if (count == 0 || count > LED_FADE_MAX_CH)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(group, 0, sizeof(*group));
+    group->speed_mode = speed_mode;
+    group->timer = timer;
+    group->count = count;
+    memcpy(group->channel, channel, count * sizeof(channel[0]));
+    group->done = xSemaphoreCreateBinary();
+    if (group->done == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&g_fade_mux);
+    if (g_fade_group_count < LED_FADE_MAX_GROUPS)
+    {
+        g_fade_groups[g_fade_group_count ++] = group;
+        for (i = 0; i < count; i ++)
+        {
+            g_fade_int_mask |= LED_FADE_INT_BIT(speed_mode, channel[i]);
+        }
+    }
+    else
+    {
+        ret = ESP_ERR_NO_MEM;
+    }
+    portEXIT_CRITICAL(&g_fade_mux);
+    return ret;
+}
+
+/**
+ * 占空比对应的亮度级:查找表中不超过duty的最大一级(表单调不减)
+ * @param[in]   lut      查找表
+ * @param[in]   levels   级数
+ * @param[in]   duty     占空比
+ * @retval      亮度级
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static uint32_t led_fade_level(const uint32_t *lut, uint16_t levels, uint32_t duty)
+{
+    uint32_t lo = 0, hi = levels - 1, mid;
+
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1) / 2;
+        if (lut[mid] <= duty)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+/**
+ * 设置亮度曲线，之后关键帧的值为亮度级(0~levels-1)，正在播放的序列被停止
+ * @param[in]   group    通道组
+ * @param[in]   lut      亮度级->占空比查找表(如LED_LUT_CIE生成的表)，NULL恢复线性
+ * @param[in]   levels   级数
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedFade_SetCurve(LedFade_Group_t *group, const uint32_t *lut, uint16_t levels)
+{
+    if (lut && levels < 2)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    LedFade_Stop(group);
+    group->lut = lut;
+    group->lut_levels = lut ? levels : 0;
+    return ESP_OK;
+}
+
+/**
+ * 播放关键帧序列，正在播放的序列被打断；关键帧数组在播放期间必须保持有效
+ * @param[in]   group       通道组
+ * @param[in]   keys        关键帧(cycles、hw字段在这里计算填写)
+ * @param[in]   key_count   帧数
+ * @param[in]   repeat      播放遍数，0为无限循环
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 支持亮度曲线，关键帧为亮度级\n
+ *               Ver0.0.3:
+                     Caesar, 2026/10/19, 第一帧在临界区外写入驱动\n
+ */
+esp_err_t LedFade_Play(LedFade_Group_t *group, LedFade_Key_t *keys, uint16_t key_count, uint16_t repeat)
+{
+    uint32_t freq, cycles;
+    uint16_t k;
+    uint8_t i;
+
+    if (keys == NULL || key_count == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (k = 0; group->lut && k < key_count; k ++)
+    {
+        for (i = 0; i < group->count; i ++)
+        {
+            if (keys[k].duty[i] >= group->lut_levels)
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+    }
+    LedFade_Stop(group);
+
+    freq = ledc_get_freq(group->speed_mode, group->timer);
+    for (i = 0; i < group->count; i ++)
+    {
+        group->start_duty[i] = ledc_get_duty(group->speed_mode, group->channel[i]);
+        if (group->lut)
+        {
+            group->start_duty[i] = led_fade_level(group->lut, group->lut_levels, group->start_duty[i]);
+        }
+    }
+    for (k = 0; k < key_count; k ++)
+    {
+        cycles = (uint32_t)((uint64_t)freq * keys[k].time_ms / 1000);
+        keys[k].cycles = cycles;
+        //亮度曲线模式的参数在中断里逐级计算
+        for (i = 0; i < group->count && group->lut == NULL; i ++)
+        {
+            LedFade_Calc(k ? keys[k - 1].duty[i] : keys[key_count - 1].duty[i], keys[k].duty[i],
+                         cycles, &keys[k].hw[i]);
+            if (k == 0)
+            {
+                LedFade_Calc(group->start_duty[i], keys[0].duty[i], cycles, &group->first_hw[i]);
+            }
+        }
+    }
+    xSemaphoreTake(group->done, 0);
+
+    portENTER_CRITICAL(&g_fade_mux);
+    group->keys = keys;
+    group->key_count = key_count;
+    group->key_idx = 0;
+    group->repeat = repeat;
+    for (i = 0; i < group->count; i ++)
+    {
+        LEDC.int_ena.val |= LED_FADE_INT_BIT(group->speed_mode, group->channel[i]);
+    }
+    group->running = 1;
+    led_fade_start_key(group, group->start_duty, group->first_hw);
+    portEXIT_CRITICAL(&g_fade_mux);
+    led_fade_launch(group);
+    return ESP_OK;
+}
+
+/**
+ * 停止播放，各通道停在当前占空比
+ * 中断可能正在另一个核上写入本组准备好的动作，等它写完再定住占空比
+ * @param[in]   group   通道组
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 驱动调用移到临界区外\n
+ */
+void LedFade_Stop(LedFade_Group_t *group)
+{
+    bool running;
+    uint8_t i;
+
+    portENTER_CRITICAL(&g_fade_mux);
+    running = group->running;
+    group->running = 0;
+    for (i = 0; running && i < group->count; i ++)
+    {
+        LEDC.int_ena.val &= ~LED_FADE_INT_BIT(group->speed_mode, group->channel[i]);
+    }
+    portEXIT_CRITICAL(&g_fade_mux);
+    while (group->launching)
+    {
+    }
+    for (i = 0; running && i < group->count; i ++)
+    {
+        ledc_set_duty(group->speed_mode, group->channel[i], ledc_get_duty(group->speed_mode, group->channel[i]));
+        ledc_update_duty(group->speed_mode, group->channel[i]);
+    }
+}
+
+/**
+ * 等待有限遍数的序列播放完
+ * @param[in]   group     通道组
+ * @param[in]   timeout   超时(tick)
+ * @retval      1播放完 0超时
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool LedFade_Wait(LedFade_Group_t *group, TickType_t timeout)
+{
+    return xSemaphoreTake(group->done, timeout) == pdTRUE;
+}
@@ -0,0 +1,690 @@
+/*
+* @file         led_fx.c
+* @brief        LED灯效字节码解释器
+* @details      调度定时器为单次触发，每次回调:刷新到期的渐变，执行所有到期的灯效直到其再次等待，
+*               然后按最早的等待到期时刻(有渐变时取下一个刷新时刻)重新定时；没有灯效时不唤醒
+*               等待按计划时刻累加，回调延迟不会累积成节拍漂移
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "led_fx.h"
+#include "string.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_FX_ST_FREE              0                   //空闲
+#define LED_FX_ST_RUN               1                   //运行，wake_us到期后继续执行
+#define LED_FX_ST_SYNC              2                   //在同步点等待
+
+//通道
+typedef struct {
+	int32_t level;                              /*!< 当前亮度，Q16 */
+	int32_t step;                               /*!< 渐变每次刷新的增量，Q16 */
+	uint16_t remain;                            /*!< 渐变剩余刷新次数，0为不在渐变 */
+	uint8_t target;
+	uint8_t out;                                /*!< 已输出的亮度 */
+} led_fx_ch_t;
+
+//循环
+typedef struct {
+	uint16_t pc;                                /*!< 循环体第一条指令 */
+	uint8_t count;                              /*!< 0为无限 */
+	uint8_t remain;
+} led_fx_loop_t;
+
+//运行中的灯效
+typedef struct {
+	uint8_t state;
+	uint8_t code[LED_FX_CODE_MAX];
+	uint16_t len;
+	uint16_t pc;
+	int64_t wake_us;
+	uint8_t sync_id;
+	uint8_t sync_parties;
+	uint8_t sp;
+	led_fx_loop_t loop[LED_FX_LOOP_DEPTH];
+} led_fx_inst_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static led_fx_ch_t g_fx_ch[LED_FX_MAX_CH];
+static led_fx_inst_t g_fx_inst[LED_FX_MAX_INST];
+static uint8_t g_fx_ch_count = 0;
+static LedFx_Output_t g_fx_output = NULL;
+static LedFx_Commit_t g_fx_commit = NULL;
+static bool g_fx_dirty = 0;                     //有通道输出变化，待提交
+static void *g_fx_output_arg = NULL;
+static esp_timer_handle_t g_fx_timer = NULL;
+static SemaphoreHandle_t g_fx_lock = NULL;
+static int64_t g_fx_fade_us = 0;                //下一次渐变刷新时刻
+static uint32_t g_fx_rand = 1;
+static bool g_fx_released = 0;                  //本次回调中有同步点放行
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 伪随机数(xorshift32)
+ * @retval      随机数
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static uint32_t led_fx_rand(void)
+{
+    g_fx_rand ^= g_fx_rand << 13;
+    g_fx_rand ^= g_fx_rand >> 17;
+    g_fx_rand ^= g_fx_rand << 5;
+    return g_fx_rand;
+}
+
+/**
+ * lo~hi之间的随机数
+ * @param[in]   lo   下限
+ * @param[in]   hi   上限
+ * @retval      随机数
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static uint32_t led_fx_rand_range(uint32_t lo, uint32_t hi)
+{
+    return lo + led_fx_rand() % (hi - lo + 1);
+}
+
+/**
+ * 输出通道亮度，只在变化时调用回调
+ * @param[in]   ch   通道
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 记录待提交\n
+ */
+static void led_fx_output(uint8_t ch)
+{
+    uint8_t level = (uint8_t)((g_fx_ch[ch].level + 0x8000) >> 16);
+
+    if (level != g_fx_ch[ch].out)
+    {
+        g_fx_ch[ch].out = level;
+        g_fx_output(ch, level, g_fx_output_arg);
+        g_fx_dirty = 1;
+    }
+}
+
+/**
+ * 设置通道亮度，取消正在进行的渐变
+ * @param[in]   ch      通道
+ * @param[in]   level   亮度
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fx_set(uint8_t ch, uint8_t level)
+{
+    g_fx_ch[ch].remain = 0;
+    g_fx_ch[ch].level = (int32_t)level << 16;
+    led_fx_output(ch);
+}
+
+/**
+ * 开始通道渐变
+ * @param[in]   ch      通道
+ * @param[in]   level   目标亮度
+ * @param[in]   ms      时长
+ * @param[in]   now     当前时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fx_fade(uint8_t ch, uint8_t level, uint16_t ms, int64_t now)
+{
+    uint16_t n = ms / LED_FX_TICK_MS;
+    uint8_t i;
+
+    if (n == 0)
+    {
+        led_fx_set(ch, level);
+        return;
+    }
+    //没有通道在渐变时从现在开始刷新
+    for (i = 0; i < g_fx_ch_count && g_fx_ch[i].remain == 0; i ++);
+    if (i == g_fx_ch_count)
+    {
+        g_fx_fade_us = now + LED_FX_TICK_MS * 1000;
+    }
+    g_fx_ch[ch].target = level;
+    g_fx_ch[ch].step = (((int32_t)level << 16) - g_fx_ch[ch].level) / n;
+    g_fx_ch[ch].remain = n;
+}
+
+/**
+ * 渐变刷新一次
+ * @retval      1还有通道在渐变 0都已结束
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static bool led_fx_fade_tick(void)
+{
+    bool fading = 0;
+    uint8_t ch;
+
+    for (ch = 0; ch < g_fx_ch_count; ch ++)
+    {
+        if (g_fx_ch[ch].remain == 0)
+        {
+            continue;
+        }
+        if (-- g_fx_ch[ch].remain == 0)
+        {
+            g_fx_ch[ch].level = (int32_t)g_fx_ch[ch].target << 16;
+        }
+        else
+        {
+            g_fx_ch[ch].level += g_fx_ch[ch].step;
+            fading = 1;
+        }
+        led_fx_output(ch);
+    }
+    return fading;
+}
+
+/**
+ * 检查同步点，id相同的等待者达到人数时全部放行
+ * @param[in]   id        同步点
+ * @param[in]   parties   人数
+ * @param[in]   now       当前时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fx_sync(uint8_t id, uint8_t parties, int64_t now)
+{
+    uint8_t i, n = 0;
+
+    for (i = 0; i < LED_FX_MAX_INST; i ++)
+    {
+        if (g_fx_inst[i].state == LED_FX_ST_SYNC && g_fx_inst[i].sync_id == id)
+        {
+            n ++;
+        }
+    }
+    if (n < parties)
+    {
+        return;
+    }
+    for (i = 0; i < LED_FX_MAX_INST; i ++)
+    {
+        if (g_fx_inst[i].state == LED_FX_ST_SYNC && g_fx_inst[i].sync_id == id)
+        {
+            g_fx_inst[i].state = LED_FX_ST_RUN;
+            g_fx_inst[i].wake_us = now;
+        }
+    }
+    g_fx_released = 1;
+}
+
+/**
+ * 执行灯效直到等待、同步或结束(字节码已校验过)
+ * @param[in]   fx    灯效
+ * @param[in]   now   当前时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fx_exec(led_fx_inst_t *fx, int64_t now)
+{
+    const uint8_t *c;
+    led_fx_loop_t *lp;
+    uint16_t steps;
+    uint8_t ch;
+
+    for (steps = 0; steps < LED_FX_MAX_STEPS; steps ++)
+    {
+        if (fx->pc >= fx->len)
+        {
+            fx->state = LED_FX_ST_FREE;
+            return;
+        }
+        c = &fx->code[fx->pc];
+        switch (c[0])
+        {
+        case LED_FX_OP_SET:
+            for (ch = 0; ch < g_fx_ch_count; ch ++)
+            {
+                if (c[1] & (1 << ch))
+                {
+                    led_fx_set(ch, c[2]);
+                }
+            }
+            fx->pc += 3;
+            break;
+        case LED_FX_OP_FADE:
+            for (ch = 0; ch < g_fx_ch_count; ch ++)
+            {
+                if (c[1] & (1 << ch))
+                {
+                    led_fx_fade(ch, c[2], c[3] | (c[4] << 8), now);
+                }
+            }
+            fx->pc += 5;
+            break;
+        case LED_FX_OP_WAIT:
+            fx->pc += 3;
+            if ((c[1] | c[2]) == 0)
+            {
+                //等待0:让出到下一个刷新周期
+                fx->wake_us = now + LED_FX_TICK_MS * 1000;
+                return;
+            }
+            fx->wake_us += (c[1] | (c[2] << 8)) * 1000LL;
+            return;
+        case LED_FX_OP_LOOP:
+            lp = &fx->loop[fx->sp ++];
+            lp->pc = fx->pc + 2;
+            lp->count = c[1];
+            lp->remain = c[1];
+            fx->pc += 2;
+            break;
+        case LED_FX_OP_LOOP_END:
+            lp = &fx->loop[fx->sp - 1];
+            if (lp->count == 0 || -- lp->remain > 0)
+            {
+                fx->pc = lp->pc;
+            }
+            else
+            {
+                fx->sp --;
+                fx->pc += 1;
+            }
+            break;
+        case LED_FX_OP_RAND:
+            for (ch = 0; ch < g_fx_ch_count; ch ++)
+            {
+                if (c[1] & (1 << ch))
+                {
+                    led_fx_set(ch, led_fx_rand_range(c[2], c[3]));
+                }
+            }
+            fx->pc += 4;
+            break;
+        case LED_FX_OP_WAIT_RAND:
+            fx->pc += 5;
+            fx->wake_us += led_fx_rand_range(c[1] | (c[2] << 8), c[3] | (c[4] << 8)) * 1000LL;
+            return;
+        case LED_FX_OP_SYNC:
+            fx->pc += 3;
+            fx->state = LED_FX_ST_SYNC;
+            fx->sync_id = c[1];
+            fx->sync_parties = c[2];
+            led_fx_sync(c[1], c[2], now);
+            if (fx->state == LED_FX_ST_SYNC)
+            {
+                return;
+            }
+            break;
+        default:
+            fx->state = LED_FX_ST_FREE;
+            return;
+        }
+    }
+    //一直没有等待:让出到下一个刷新周期
+    fx->wake_us = now + LED_FX_TICK_MS * 1000;
+}
+
+/**
+ * 按最早的唤醒时刻重新定时
+ * @param[in]   now   当前时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_fx_arm(int64_t now)
+{
+    int64_t next = INT64_MAX;
+    uint8_t i;
+
+    for (i = 0; i < g_fx_ch_count; i ++)
+    {
+        if (g_fx_ch[i].remain)
+        {
+            next = g_fx_fade_us;
+            break;
+        }
+    }
+    for (i = 0; i < LED_FX_MAX_INST; i ++)
+    {
+        if (g_fx_inst[i].state == LED_FX_ST_RUN && g_fx_inst[i].wake_us < next)
+        {
+            next = g_fx_inst[i].wake_us;
+        }
+    }
+    esp_timer_stop(g_fx_timer);
+    if (next != INT64_MAX)
+    {
+        esp_timer_start_once(g_fx_timer, (next > now) ? next - now : 1);
+    }
+}
+
+/**
+ * 调度定时器回调(esp_timer任务中执行)
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 通道变化后调用提交回调\n
+ */
+static void led_fx_timer_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+    uint8_t i;
+
+    (void)arg;
+    xSemaphoreTake(g_fx_lock, portMAX_DELAY);
+    if (now >= g_fx_fade_us && led_fx_fade_tick())
+    {
+        g_fx_fade_us += LED_FX_TICK_MS * 1000;
+        if (g_fx_fade_us <= now)
+        {
+            g_fx_fade_us = now + LED_FX_TICK_MS * 1000;
+        }
+    }
+    //同步点放行的灯效在同一次回调中继续执行
+    do
+    {
+        g_fx_released = 0;
+        for (i = 0; i < LED_FX_MAX_INST; i ++)
+        {
+            if (g_fx_inst[i].state == LED_FX_ST_RUN && g_fx_inst[i].wake_us <= now)
+            {
+                led_fx_exec(&g_fx_inst[i], now);
+            }
+        }
+    } while (g_fx_released);
+    if (g_fx_dirty && g_fx_commit)
+    {
+        g_fx_commit(g_fx_output_arg);
+    }
+    g_fx_dirty = 0;
+    led_fx_arm(now);
+    xSemaphoreGive(g_fx_lock);
+}
+
+/**
+ * 初始化，所有通道输出0
+ * @param[in]   ch_count   通道数，不超过LED_FX_MAX_CH
+ * @param[in]   output     通道输出回调
+ * @param[in]   arg        回调参数
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ *              - ESP_ERR_INVALID_STATE  已初始化
+ *              - ESP_ERR_NO_MEM
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedFx_Init(uint8_t ch_count, LedFx_Output_t output, void *arg)
+{
+    esp_timer_create_args_t timer_args = {
+        .callback = led_fx_timer_cb,
+        .arg = NULL,
+        .name = "led_fx",
+    };
+    uint8_t ch;
+
+    if (ch_count == 0 || ch_count > LED_FX_MAX_CH || output == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_fx_lock)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_fx_lock = xSemaphoreCreateMutex();
+    if (g_fx_lock == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (esp_timer_create(&timer_args, &g_fx_timer) != ESP_OK)
+    {
+        vSemaphoreDelete(g_fx_lock);
+        g_fx_lock = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    g_fx_rand = esp_random() | 1;
+    g_fx_ch_count = ch_count;
+    g_fx_output = output;
+    g_fx_output_arg = arg;
+    memset(g_fx_ch, 0, sizeof(g_fx_ch));
+    memset(g_fx_inst, 0, sizeof(g_fx_inst));
+    for (ch = 0; ch < ch_count; ch ++)
+    {
+        output(ch, 0, arg);
+    }
+    return ESP_OK;
+}
+
+/**
+ * 设置提交回调，NULL为不使用
+ * @param[in]   commit   提交回调
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedFx_SetCommit(LedFx_Commit_t commit)
+{
+    g_fx_commit = commit;
+}
+
+/**
+ * 校验字节码:操作数完整、通道在范围内、循环配对且不超过嵌套层数
+ * @param[in]   code   字节码
+ * @param[in]   len    长度
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_SIZE  超长或操作数不完整
+ *              - ESP_ERR_INVALID_ARG   非法指令或操作数
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedFx_Verify(const uint8_t *code, uint16_t len)
+{
+    static const uint8_t op_len[] = {1, 3, 5, 3, 2, 1, 4, 5, 3};
+    uint8_t mask = (uint8_t)((1 << g_fx_ch_count) - 1);
+    uint16_t pc = 0;
+    uint8_t depth = 0;
+    const uint8_t *c;
+
+    if (code == NULL || len == 0 || len > LED_FX_CODE_MAX)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    while (pc < len)
+    {
+        c = &code[pc];
+        if (c[0] >= sizeof(op_len))
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (pc + op_len[c[0]] > len)
+        {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        switch (c[0])
+        {
+        case LED_FX_OP_SET:
+        case LED_FX_OP_FADE:
+            if (c[1] & ~mask)
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            break;
+        case LED_FX_OP_RAND:
+            if ((c[1] & ~mask) || c[2] > c[3])
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            break;
+        case LED_FX_OP_WAIT_RAND:
+            if ((c[1] | (c[2] << 8)) > (c[3] | (c[4] << 8)))
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            break;
+        case LED_FX_OP_LOOP:
+            if (++ depth > LED_FX_LOOP_DEPTH)
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            break;
+        case LED_FX_OP_LOOP_END:
+            if (depth -- == 0)
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            break;
+        case LED_FX_OP_SYNC:
+            if (c[2] == 0 || c[2] > LED_FX_MAX_INST)
+            {
+                return ESP_ERR_INVALID_ARG;
+            }
+            break;
+        default:
+            break;
+        }
+        pc += op_len[c[0]];
+    }
+    return depth ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+
+/**
+ * 加载并启动灯效，字节码被复制，调用后即可释放
+ * @param[in]   code   字节码
+ * @param[in]   len    长度
+ * @param[out]  id     灯效编号，可为NULL
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_STATE  未初始化
+ *              - ESP_ERR_NO_MEM         没有空闲位置
+ *              - 其它                   字节码校验错误，见LedFx_Verify
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedFx_Start(const uint8_t *code, uint16_t len, uint8_t *id)
+{
+    esp_err_t ret;
+    int64_t now;
+    uint8_t i;
+
+    if (g_fx_lock == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ret = LedFx_Verify(code, len);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    xSemaphoreTake(g_fx_lock, portMAX_DELAY);
+    for (i = 0; i < LED_FX_MAX_INST && g_fx_inst[i].state != LED_FX_ST_FREE; i ++);
+    if (i == LED_FX_MAX_INST)
+    {
+        xSemaphoreGive(g_fx_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    now = esp_timer_get_time();
+    memcpy(g_fx_inst[i].code, code, len);
+    g_fx_inst[i].len = len;
+    g_fx_inst[i].pc = 0;
+    g_fx_inst[i].sp = 0;
+    g_fx_inst[i].wake_us = now;
+    g_fx_inst[i].state = LED_FX_ST_RUN;
+    led_fx_arm(now);
+    xSemaphoreGive(g_fx_lock);
+    if (id)
+    {
+        *id = i;
+    }
+    return ESP_OK;
+}
+
+/**
+ * 停止灯效，通道保持当前亮度
+ * @param[in]   id   灯效编号
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedFx_Stop(uint8_t id)
+{
+    if (id >= LED_FX_MAX_INST || g_fx_lock == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(g_fx_lock, portMAX_DELAY);
+    g_fx_inst[id].state = LED_FX_ST_FREE;
+    xSemaphoreGive(g_fx_lock);
+    return ESP_OK;
+}
+
+/**
+ * 灯效是否还在运行
+ * @param[in]   id   灯效编号
+ * @retval      1运行中 0已结束
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool LedFx_Running(uint8_t id)
+{
+    return id < LED_FX_MAX_INST && g_fx_inst[id].state != LED_FX_ST_FREE;
+}
+
+/**
+ * 通道当前输出的亮度
+ * @param[in]   ch   通道
+ * @retval      亮度0~255
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+uint8_t LedFx_GetLevel(uint8_t ch)
+{
+    return ch < LED_FX_MAX_CH ? g_fx_ch[ch].out : 0;
+}
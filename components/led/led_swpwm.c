@@ -0,0 +1,662 @@
+/*
+* @file         led_swpwm.c
+* @brief        定时器中断软件PWM
+* @details      定时器计数一直向上走，闹钟设为下一个翻转点的绝对计数:周期开始时点亮占空比非0的通道，
+*               之后按占空比从小到大依次熄灭，同一时刻的通道合并为一个翻转点；
+*               翻转表(LedSwPwm_Build)在任务中排序算好，两份交替使用，中断只在周期开始时换表，
+*               不会出现半个周期用旧表、半个周期用新表；
+*               渐变由esp_timer每LED_SWPWM_FADE_TICK_MS计算一次占空比并重建翻转表
+*               中断注册为ESP_INTR_FLAG_IRAM，闪存操作期间也能继续输出
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "led_swpwm.h"
+#include "string.h"
+#include "esp_attr.h"
+#include "esp_intr_alloc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "soc/timer_group_struct.h"
+#include "xtensa/hal.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define LED_SWPWM_TIMG              (LED_SWPWM_TIMER_GROUP == TIMER_GROUP_0 ? &TIMERG0 : &TIMERG1)
+#define LED_SWPWM_MIN_GAP           (LED_SWPWM_MIN_GAP_US * (LED_SWPWM_TICK_HZ / 1000000))
+
+//通道渐变状态
+#define LED_SWPWM_FADE_IDLE         0
+#define LED_SWPWM_FADE_SET          1                   //已SetFadeWithTime，等待FadeStart
+#define LED_SWPWM_FADE_RUN          2
+
+typedef struct {
+    uint32_t duty;                  //当前输出的占空比
+    uint32_t staged;                //SetDuty设置，UpdateDuty后生效
+    uint32_t fade_from;
+    uint32_t fade_to;
+    uint32_t fade_us;
+    int64_t fade_start;
+    uint8_t fade_state;
+    SemaphoreHandle_t done;         //渐变结束时释放
+} led_swpwm_ch_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static GpioGroup_t g_swpwm_group;
+static led_swpwm_ch_t g_swpwm_ch[LED_SWPWM_MAX_CH];
+static uint8_t g_swpwm_bits = 0;
+static uint32_t g_swpwm_period = 0;             //一个PWM周期的定时器计数
+static SemaphoreHandle_t g_swpwm_lock = NULL;   //保护通道状态和翻转表的重建
+static esp_timer_handle_t g_swpwm_fade_timer = NULL;
+static timer_isr_handle_t g_swpwm_isr = NULL;
+static bool g_swpwm_fade_running = 0;
+static portMUX_TYPE g_swpwm_mux = portMUX_INITIALIZER_UNLOCKED;
+//以下由中断使用，任务只在g_swpwm_mux保护下修改
+static LedSwPwm_Sched_t g_swpwm_sched[2];
+static LedSwPwm_Sched_t * volatile g_swpwm_active = NULL;
+static LedSwPwm_Sched_t * volatile g_swpwm_pending = NULL;
+static uint8_t g_swpwm_slot = 0;                //下一个要写出的翻转点
+static uint64_t g_swpwm_base = 0;               //当前周期开始的计数
+static uint64_t g_swpwm_alarm = 0;
+static LedSwPwm_Stats_t g_swpwm_stats;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 按占空比生成一个周期的翻转表，纯整数运算，不操作硬件，可在PC上编译验证
+ * 占空比为0的通道整周期熄灭，不小于2^duty_bits的整周期点亮，都不产生翻转点
+ * @param[in]   group       引脚组，第i个引脚对应duty[i]
+ * @param[in]   duty        各通道占空比
+ * @param[in]   duty_bits   占空比位数
+ * @param[in]   period      一个周期的定时器计数
+ * @param[out]  sched       翻转表
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedSwPwm_Build(const GpioGroup_t *group, const uint32_t *duty, uint8_t duty_bits, uint32_t period,
+                    LedSwPwm_Sched_t *sched)
+{
+    uint32_t edge[LED_SWPWM_MAX_CH];
+    uint8_t order[LED_SWPWM_MAX_CH];
+    uint32_t pattern = 0;
+    uint8_t i, j, n = 0, ch;
+
+    //各通道熄灭的时刻，按时刻插入排序(通道数很少)
+    for (i = 0; i < group->count; i ++)
+    {
+        edge[i] = (uint32_t)(((uint64_t)duty[i] * period) >> duty_bits);
+        if (edge[i] == 0)
+        {
+            continue;
+        }
+        pattern |= 1UL << i;
+        if (edge[i] >= period)
+        {
+            continue;
+        }
+        for (j = n; j > 0 && edge[order[j - 1]] > edge[i]; j --)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+        n ++;
+    }
+
+    sched->at[0] = 0;
+    GpioGroup_Compile(group, pattern, &sched->masks[0]);
+    sched->count = 1;
+    for (i = 0; i < n; i ++)
+    {
+        ch = order[i];
+        pattern &= ~(1UL << ch);
+        //与上一个翻转点同时刻的通道合并，一次写出
+        if (sched->count == 1 || sched->at[sched->count - 1] != edge[ch])
+        {
+            sched->at[sched->count] = edge[ch];
+            sched->count ++;
+        }
+        GpioGroup_Compile(group, pattern, &sched->masks[sched->count - 1]);
+    }
+}
+
+/**
+ * 读定时器当前计数
+ * @param[in]   无
+ * @retval      计数
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static inline uint64_t IRAM_ATTR led_swpwm_now(void)
+{
+    timg_dev_t *hw = LED_SWPWM_TIMG;
+
+    hw->hw_timer[LED_SWPWM_TIMER_IDX].update = 1;
+    return ((uint64_t)hw->hw_timer[LED_SWPWM_TIMER_IDX].cnt_high << 32) | hw->hw_timer[LED_SWPWM_TIMER_IDX].cnt_low;
+}
+
+/**
+ * 定时器中断:写出到期的翻转点，间隔小于LED_SWPWM_MIN_GAP的后续翻转点在本次中断中等到再写，
+ * 然后把闹钟设到下一个翻转点；周期开始时换上新的翻转表
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void IRAM_ATTR led_swpwm_isr(void *arg)
+{
+    uint32_t start = xthal_get_ccount();
+    timg_dev_t *hw = LED_SWPWM_TIMG;
+    const LedSwPwm_Sched_t *s;
+    uint64_t now, at;
+    uint32_t cycles;
+
+    (void)arg;
+    hw->int_clr_timers.val = 1UL << LED_SWPWM_TIMER_IDX;
+    portENTER_CRITICAL_ISR(&g_swpwm_mux);
+    now = led_swpwm_now();
+    if (now > g_swpwm_alarm && now - g_swpwm_alarm > g_swpwm_stats.late_max)
+    {
+        g_swpwm_stats.late_max = now - g_swpwm_alarm;
+    }
+    while (1)
+    {
+        if (g_swpwm_slot == 0 && g_swpwm_pending)
+        {
+            g_swpwm_active = g_swpwm_pending;
+            g_swpwm_pending = NULL;
+        }
+        s = g_swpwm_active;
+        GpioGroup_Apply(&s->masks[g_swpwm_slot]);
+        g_swpwm_stats.edge_count ++;
+        g_swpwm_slot ++;
+        if (g_swpwm_slot >= s->count)
+        {
+            g_swpwm_slot = 0;
+            g_swpwm_base += g_swpwm_period;
+            at = g_swpwm_base;
+        }
+        else
+        {
+            at = g_swpwm_base + s->at[g_swpwm_slot];
+        }
+        now = led_swpwm_now();
+        if (at > now + LED_SWPWM_MIN_GAP)
+        {
+            break;
+        }
+        if (now > at)
+        {
+            g_swpwm_stats.miss_count ++;
+            //晚了一个周期以上(如被更高优先级中断长时间占用)，放弃追赶，从下一个周期重新开始
+            if (now - at >= g_swpwm_period)
+            {
+                g_swpwm_slot = 0;
+                g_swpwm_base = now + LED_SWPWM_MIN_GAP;
+                at = g_swpwm_base;
+                break;
+            }
+        }
+        else
+        {
+            g_swpwm_stats.spin_count ++;
+            while (now < at)
+            {
+                now = led_swpwm_now();
+            }
+        }
+    }
+    g_swpwm_alarm = at;
+    hw->hw_timer[LED_SWPWM_TIMER_IDX].alarm_high = (uint32_t)(at >> 32);
+    hw->hw_timer[LED_SWPWM_TIMER_IDX].alarm_low = (uint32_t)at;
+    hw->hw_timer[LED_SWPWM_TIMER_IDX].config.alarm_en = 1;
+
+    cycles = xthal_get_ccount() - start;
+    g_swpwm_stats.isr_count ++;
+    g_swpwm_stats.cycles_sum += cycles;
+    if (cycles > g_swpwm_stats.cycles_max)
+    {
+        g_swpwm_stats.cycles_max = cycles;
+    }
+    portEXIT_CRITICAL_ISR(&g_swpwm_mux);
+}
+
+/**
+ * 按各通道当前占空比重建翻转表，交给中断在下一个周期开始时换上(调用者持有g_swpwm_lock)
+ * 中断正在用的表不动；上一张新表还没被换上时直接覆盖它
+ * @param[in]   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_swpwm_publish(void)
+{
+    uint32_t duty[LED_SWPWM_MAX_CH];
+    LedSwPwm_Sched_t *s;
+    uint8_t i;
+
+    for (i = 0; i < g_swpwm_group.count; i ++)
+    {
+        duty[i] = g_swpwm_ch[i].duty;
+    }
+    portENTER_CRITICAL(&g_swpwm_mux);
+    s = g_swpwm_pending;
+    if (s == NULL)
+    {
+        s = (g_swpwm_active == &g_swpwm_sched[0]) ? &g_swpwm_sched[1] : &g_swpwm_sched[0];
+    }
+    g_swpwm_pending = NULL;
+    portEXIT_CRITICAL(&g_swpwm_mux);
+
+    LedSwPwm_Build(&g_swpwm_group, duty, g_swpwm_bits, g_swpwm_period, s);
+
+    portENTER_CRITICAL(&g_swpwm_mux);
+    g_swpwm_pending = s;
+    portEXIT_CRITICAL(&g_swpwm_mux);
+}
+
+/**
+ * 渐变刷新(esp_timer任务中执行):按已用时间线性插值各通道占空比，到时的通道释放信号量；
+ * 没有通道在渐变时停止定时器
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_swpwm_fade_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+    led_swpwm_ch_t *c;
+    uint64_t elapsed;
+    bool running = 0;
+    uint8_t i;
+
+    (void)arg;
+    xSemaphoreTake(g_swpwm_lock, portMAX_DELAY);
+    for (i = 0; i < g_swpwm_group.count; i ++)
+    {
+        c = &g_swpwm_ch[i];
+        if (c->fade_state != LED_SWPWM_FADE_RUN)
+        {
+            continue;
+        }
+        elapsed = now - c->fade_start;
+        if (elapsed >= c->fade_us)
+        {
+            c->duty = c->fade_to;
+            c->fade_state = LED_SWPWM_FADE_IDLE;
+            xSemaphoreGive(c->done);
+            continue;
+        }
+        if (c->fade_to >= c->fade_from)
+        {
+            c->duty = c->fade_from + (uint32_t)((uint64_t)(c->fade_to - c->fade_from) * elapsed / c->fade_us);
+        }
+        else
+        {
+            c->duty = c->fade_from - (uint32_t)((uint64_t)(c->fade_from - c->fade_to) * elapsed / c->fade_us);
+        }
+        running = 1;
+    }
+    led_swpwm_publish();
+    if (!running)
+    {
+        esp_timer_stop(g_swpwm_fade_timer);
+        g_swpwm_fade_running = 0;
+    }
+    xSemaphoreGive(g_swpwm_lock);
+}
+
+/**
+ * 初始化失败时按创建的逆序释放:中断、渐变刷新定时器、各通道信号量、互斥锁，最后把引脚恢复为禁用
+ * @param[in]   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void led_swpwm_unwind(void)
+{
+    gpio_config_t cfg = {
+        .pin_bit_mask = ((uint64_t)g_swpwm_group.all_hi << 32) | g_swpwm_group.all_lo,
+        .mode = GPIO_MODE_DISABLE,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    uint8_t i;
+
+    if (g_swpwm_isr)
+    {
+        timer_disable_intr(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX);
+        esp_intr_free(g_swpwm_isr);
+        g_swpwm_isr = NULL;
+    }
+    if (g_swpwm_fade_timer)
+    {
+        esp_timer_delete(g_swpwm_fade_timer);
+        g_swpwm_fade_timer = NULL;
+    }
+    for (i = LED_SWPWM_MAX_CH; i > 0; i --)
+    {
+        if (g_swpwm_ch[i - 1].done)
+        {
+            vSemaphoreDelete(g_swpwm_ch[i - 1].done);
+            g_swpwm_ch[i - 1].done = NULL;
+        }
+    }
+    if (g_swpwm_lock)
+    {
+        vSemaphoreDelete(g_swpwm_lock);
+        g_swpwm_lock = NULL;
+    }
+    gpio_config(&cfg);
+    memset(&g_swpwm_group, 0, sizeof(g_swpwm_group));
+}
+
+/**
+ * 初始化软件PWM:配置引脚组和硬件定时器，所有通道从占空比0开始
+ * 定时器计数为25ns，占空比的分辨率不会高于一个计数(周期计数小于2^duty_bits时相邻占空比可能相同)
+ * @param[in]   pins        引脚列表，通道i对应pins[i]
+ * @param[in]   count       通道数，不超过LED_SWPWM_MAX_CH
+ * @param[in]   invert      反相掩码，第i位为1时通道i低电平点亮
+ * @param[in]   freq_hz     PWM频率
+ * @param[in]   duty_bits   占空比位数(同ledc_timer_config的duty_resolution)，1~16
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG     参数错误
+ *              - ESP_ERR_INVALID_STATE   已经初始化
+ *              - ESP_ERR_NO_MEM
+ *              - 其它  中断分配或定时器启动错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 失败时逆序释放已创建的资源\n
+ */
+esp_err_t LedSwPwm_Init(const gpio_num_t *pins, uint8_t count, uint32_t invert, uint32_t freq_hz, uint8_t duty_bits)
+{
+    esp_timer_create_args_t timer_args = {
+        .callback = led_swpwm_fade_cb,
+        .arg = NULL,
+        .name = "led_swpwm",
+    };
+    timer_config_t config = {
+        .alarm_en = TIMER_ALARM_EN,
+        .counter_en = TIMER_PAUSE,
+        .intr_type = TIMER_INTR_LEVEL,
+        .counter_dir = TIMER_COUNT_UP,
+        .auto_reload = TIMER_AUTORELOAD_DIS,
+        .divider = LED_SWPWM_TIMER_DIV,
+    };
+    esp_err_t ret;
+    uint8_t i;
+
+    //一个周期至少要容纳两个翻转点的最小间隔
+    if (freq_hz == 0 || freq_hz > LED_SWPWM_TICK_HZ / (4 * LED_SWPWM_MIN_GAP) || duty_bits == 0 || duty_bits > 16)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_swpwm_lock)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ret = GpioGroup_Init(&g_swpwm_group, pins, count, invert);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    memset(g_swpwm_ch, 0, sizeof(g_swpwm_ch));
+    g_swpwm_lock = xSemaphoreCreateMutex();
+    if (g_swpwm_lock == NULL)
+    {
+        led_swpwm_unwind();
+        return ESP_ERR_NO_MEM;
+    }
+    for (i = 0; i < count; i ++)
+    {
+        g_swpwm_ch[i].done = xSemaphoreCreateBinary();
+        if (g_swpwm_ch[i].done == NULL)
+        {
+            led_swpwm_unwind();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (esp_timer_create(&timer_args, &g_swpwm_fade_timer) != ESP_OK)
+    {
+        g_swpwm_fade_timer = NULL;
+        led_swpwm_unwind();
+        return ESP_ERR_NO_MEM;
+    }
+    g_swpwm_bits = duty_bits;
+    g_swpwm_period = LED_SWPWM_TICK_HZ / freq_hz;
+    memset(&g_swpwm_stats, 0, sizeof(g_swpwm_stats));
+
+    //先输出全灭，第一个周期从一个周期后开始
+    LedSwPwm_Build(&g_swpwm_group, (const uint32_t[LED_SWPWM_MAX_CH]){ 0 }, duty_bits, g_swpwm_period,
+                   &g_swpwm_sched[0]);
+    GpioGroup_Apply(&g_swpwm_sched[0].masks[0]);
+    g_swpwm_active = &g_swpwm_sched[0];
+    g_swpwm_pending = NULL;
+    g_swpwm_slot = 0;
+    g_swpwm_base = g_swpwm_period;
+    g_swpwm_alarm = g_swpwm_base;
+
+    timer_init(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX, &config);
+    timer_set_counter_value(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX, 0);
+    timer_set_alarm_value(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX, g_swpwm_alarm);
+    timer_enable_intr(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX);
+    ret = timer_isr_register(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX, led_swpwm_isr, NULL,
+                             ESP_INTR_FLAG_IRAM, &g_swpwm_isr);
+    if (ret != ESP_OK)
+    {
+        g_swpwm_isr = NULL;
+        timer_disable_intr(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX);
+        led_swpwm_unwind();
+        return ret;
+    }
+    ret = timer_start(LED_SWPWM_TIMER_GROUP, LED_SWPWM_TIMER_IDX);
+    if (ret != ESP_OK)
+    {
+        led_swpwm_unwind();
+    }
+    return ret;
+}
+
+/**
+ * 设置占空比，LedSwPwm_UpdateDuty后生效(同ledc_set_duty)
+ * @param[in]   ch     通道
+ * @param[in]   duty   占空比，2^duty_bits为常亮
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedSwPwm_SetDuty(uint8_t ch, uint32_t duty)
+{
+    if (g_swpwm_lock == NULL || ch >= g_swpwm_group.count || duty > (1UL << g_swpwm_bits))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(g_swpwm_lock, portMAX_DELAY);
+    g_swpwm_ch[ch].staged = duty;
+    xSemaphoreGive(g_swpwm_lock);
+    return ESP_OK;
+}
+
+/**
+ * 使LedSwPwm_SetDuty设置的占空比生效，从下一个PWM周期开始输出(同ledc_update_duty)
+ * 通道正在渐变时停止渐变
+ * @param[in]   ch   通道
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedSwPwm_UpdateDuty(uint8_t ch)
+{
+    led_swpwm_ch_t *c = &g_swpwm_ch[ch];
+
+    if (g_swpwm_lock == NULL || ch >= g_swpwm_group.count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(g_swpwm_lock, portMAX_DELAY);
+    if (c->fade_state == LED_SWPWM_FADE_RUN)
+    {
+        xSemaphoreGive(c->done);
+    }
+    c->fade_state = LED_SWPWM_FADE_IDLE;
+    c->duty = c->staged;
+    led_swpwm_publish();
+    xSemaphoreGive(g_swpwm_lock);
+    return ESP_OK;
+}
+
+/**
+ * 读当前输出的占空比(渐变中为当前值，同ledc_get_duty)
+ * @param[in]   ch   通道
+ * @retval      占空比，通道错误时为0
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+uint32_t LedSwPwm_GetDuty(uint8_t ch)
+{
+    if (ch >= g_swpwm_group.count)
+    {
+        return 0;
+    }
+    return g_swpwm_ch[ch].duty;
+}
+
+/**
+ * 设置渐变:从当前占空比线性变到target_duty，LedSwPwm_FadeStart后开始(同ledc_set_fade_with_time)
+ * @param[in]   ch                  通道
+ * @param[in]   target_duty         目标占空比
+ * @param[in]   max_fade_time_ms    渐变时长
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedSwPwm_SetFadeWithTime(uint8_t ch, uint32_t target_duty, int max_fade_time_ms)
+{
+    led_swpwm_ch_t *c = &g_swpwm_ch[ch];
+
+    if (g_swpwm_lock == NULL || ch >= g_swpwm_group.count || target_duty > (1UL << g_swpwm_bits) ||
+        max_fade_time_ms < 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(g_swpwm_lock, portMAX_DELAY);
+    if (c->fade_state == LED_SWPWM_FADE_RUN)
+    {
+        xSemaphoreGive(c->done);
+    }
+    c->fade_to = target_duty;
+    c->fade_us = (uint32_t)max_fade_time_ms * 1000;
+    c->fade_state = LED_SWPWM_FADE_SET;
+    xSemaphoreGive(g_swpwm_lock);
+    return ESP_OK;
+}
+
+/**
+ * 开始LedSwPwm_SetFadeWithTime设置的渐变(同ledc_fade_start)
+ * @param[in]   ch          通道
+ * @param[in]   fade_mode   LEDC_FADE_WAIT_DONE时等渐变结束再返回
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ *              - ESP_ERR_INVALID_STATE   没有设置渐变
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t LedSwPwm_FadeStart(uint8_t ch, ledc_fade_mode_t fade_mode)
+{
+    led_swpwm_ch_t *c = &g_swpwm_ch[ch];
+
+    if (g_swpwm_lock == NULL || ch >= g_swpwm_group.count)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(g_swpwm_lock, portMAX_DELAY);
+    if (c->fade_state != LED_SWPWM_FADE_SET)
+    {
+        xSemaphoreGive(g_swpwm_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(c->done, 0);
+    c->fade_from = c->duty;
+    c->fade_start = esp_timer_get_time();
+    c->fade_state = LED_SWPWM_FADE_RUN;
+    if (!g_swpwm_fade_running)
+    {
+        esp_timer_start_periodic(g_swpwm_fade_timer, LED_SWPWM_FADE_TICK_MS * 1000);
+        g_swpwm_fade_running = 1;
+    }
+    xSemaphoreGive(g_swpwm_lock);
+    if (fade_mode == LEDC_FADE_WAIT_DONE)
+    {
+        xSemaphoreTake(c->done, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+/**
+ * 读中断统计
+ * @param[out]  stats   统计
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedSwPwm_GetStats(LedSwPwm_Stats_t *stats)
+{
+    portENTER_CRITICAL(&g_swpwm_mux);
+    *stats = g_swpwm_stats;
+    portEXIT_CRITICAL(&g_swpwm_mux);
+}
+
+/**
+ * 清零中断统计
+ * @param[in]   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void LedSwPwm_ResetStats(void)
+{
+    portENTER_CRITICAL(&g_swpwm_mux);
+    memset(&g_swpwm_stats, 0, sizeof(g_swpwm_stats));
+    portEXIT_CRITICAL(&g_swpwm_mux);
+}
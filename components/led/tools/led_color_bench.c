@@ -0,0 +1,193 @@
+/*
+* @file         led_color_bench.c
+* @brief        led_color在PC上的校验与性能测试
+* @details      1. HSV/HSL转RGB与浮点参考实现比较，给出最大误差
+*               2. 色相渐变的增量结果与逐帧完整计算比较
+*               3. 各函数每次调用的耗时，与浮点实现对比
+*               编译: gcc -O2 -I../include led_color_bench.c ../led_color.c -lm -o led_color_bench
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "led_color.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define BENCH_ROUNDS                20000000
+#define SWEEP_FRAMES                3000
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static volatile uint32_t g_sink;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//浮点参考实现，色相单位与LedColor一致
+static void ref_hsv(double h, double s, double v, double *rgb)
+{
+    double hh = fmod(h, LED_COLOR_HUE_MAX) / LED_COLOR_HUE_SECTOR;
+    double c = v * s, x = c * (1 - fabs(fmod(hh, 2) - 1)), m = v - c;
+    int sector = (int)hh;
+    double r[6] = {c, x, 0, 0, x, c}, g[6] = {x, c, c, x, 0, 0}, b[6] = {0, 0, x, c, c, x};
+
+    rgb[0] = (r[sector] + m) * 255;
+    rgb[1] = (g[sector] + m) * 255;
+    rgb[2] = (b[sector] + m) * 255;
+}
+
+static double max_err(const LedColor_Rgb_t *c, const double *ref)
+{
+    double e, m = 0;
+
+    e = fabs(c->r - ref[0]); m = e > m ? e : m;
+    e = fabs(c->g - ref[1]); m = e > m ? e : m;
+    e = fabs(c->b - ref[2]); m = e > m ? e : m;
+    return m;
+}
+
+static int check_accuracy(void)
+{
+    LedColor_Rgb_t c;
+    double ref[3], e, worst = 0, worst_hsl = 0, l, sl, v;
+    int h, s, x;
+
+    for (h = 0; h < LED_COLOR_HUE_MAX; h += 3)
+    {
+        for (s = 0; s < 256; s += 5)
+        {
+            for (x = 0; x < 256; x += 5)
+            {
+                LedColor_HsvToRgb(h, s, x, &c);
+                ref_hsv(h, s / 255.0, x / 255.0, ref);
+                e = max_err(&c, ref);
+                worst = e > worst ? e : worst;
+
+                //HSL参考:先换算为HSV
+                l = x / 255.0;
+                sl = s / 255.0;
+                v = l + sl * (l < 0.5 ? l : 1 - l);
+                LedColor_HslToRgb(h, s, x, &c);
+                ref_hsv(h, v > 0 ? 2 * (1 - l / v) : 0, v, ref);
+                e = max_err(&c, ref);
+                worst_hsl = e > worst_hsl ? e : worst_hsl;
+            }
+        }
+    }
+    printf("HSV max error %.2f LSB, HSL max error %.2f LSB\n", worst, worst_hsl);
+    return worst <= 1.5 && worst_hsl <= 2.5;
+}
+
+static int check_sweep(void)
+{
+    LedColor_Sweep_t sw;
+    LedColor_Rgb_t c;
+    const LedColor_Rgb_t *p;
+    int64_t hue;
+    uint32_t f;
+    int e, worst = 0, dir;
+
+    for (dir = -1; dir <= 1; dir += 2)
+    {
+        LedColor_SweepInit(&sw, 100, dir * 2 * LED_COLOR_HUE_MAX, SWEEP_FRAMES, 230, 200);
+        hue = 100LL << 16;
+        for (f = 0; f < SWEEP_FRAMES; f ++)
+        {
+            p = LedColor_SweepNext(&sw);
+            hue += sw.step;
+            hue = ((hue % ((int64_t)LED_COLOR_HUE_MAX << 16)) + ((int64_t)LED_COLOR_HUE_MAX << 16)) %
+                  ((int64_t)LED_COLOR_HUE_MAX << 16);
+            LedColor_HsvToRgb(hue >> 16, 230, 200, &c);
+            e = abs(p->r - c.r); worst = e > worst ? e : worst;
+            e = abs(p->g - c.g); worst = e > worst ? e : worst;
+            e = abs(p->b - c.b); worst = e > worst ? e : worst;
+        }
+    }
+    printf("sweep vs per-frame kernel: max diff %d LSB\n", worst);
+    return worst <= 1;
+}
+
+static void bench(void)
+{
+    LedColor_Sweep_t sw;
+    LedColor_Rgb_t c;
+    double ref[3], t;
+    uint32_t i;
+
+    t = now_ns();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        LedColor_HsvToRgb(i % LED_COLOR_HUE_MAX, 240, i & 0xFF, &c);
+        g_sink += c.r + c.g + c.b;
+    }
+    printf("LedColor_HsvToRgb   %6.2f ns\n", (now_ns() - t) / BENCH_ROUNDS);
+
+    t = now_ns();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        LedColor_HslToRgb(i % LED_COLOR_HUE_MAX, 240, i & 0xFF, &c);
+        g_sink += c.r + c.g + c.b;
+    }
+    printf("LedColor_HslToRgb   %6.2f ns\n", (now_ns() - t) / BENCH_ROUNDS);
+
+    t = now_ns();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        LedColor_Kelvin(LED_COLOR_KELVIN_MIN + i % (LED_COLOR_KELVIN_MAX - LED_COLOR_KELVIN_MIN), 255, &c);
+        g_sink += c.r + c.g + c.b;
+    }
+    printf("LedColor_Kelvin     %6.2f ns\n", (now_ns() - t) / BENCH_ROUNDS);
+
+    LedColor_SweepInit(&sw, 0, LED_COLOR_HUE_MAX, 1000, 240, 255);
+    t = now_ns();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        const LedColor_Rgb_t *p = LedColor_SweepNext(&sw);
+        g_sink += p->r + p->g + p->b;
+    }
+    printf("LedColor_SweepNext  %6.2f ns\n", (now_ns() - t) / BENCH_ROUNDS);
+
+    t = now_ns();
+    for (i = 0; i < BENCH_ROUNDS; i ++)
+    {
+        ref_hsv(i % LED_COLOR_HUE_MAX, 240 / 255.0, (i & 0xFF) / 255.0, ref);
+        g_sink += (uint32_t)(ref[0] + ref[1] + ref[2]);
+    }
+    printf("float hsv reference %6.2f ns\n", (now_ns() - t) / BENCH_ROUNDS);
+}
+
+int main(void)
+{
+    int ok = 1;
+
+    ok &= check_accuracy();
+    ok &= check_sweep();
+    bench();
+    printf("%s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
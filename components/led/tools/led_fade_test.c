@@ -0,0 +1,400 @@
+/*
+* @file         led_fade_test.c
+* @brief        led_fade在PC上的测试
+* @details      用一个LEDC硬件模型(按PWM周期计时，渐变结束时置中断位并调用注册的中断)运行关键帧序列:
+*               1. 写入的步数/每步周期数/步长都在10位以内，渐变不会越过0或满量程
+*               2. 亮度曲线模式:每帧拆成逐级的线性段，各段步数和周期数的拆分使整帧时长
+*                  与关键帧时长相符(取整少用的周期补到下一段)；保持亮度不变的长帧按10位上限拆步；
+*                  每段的终点不越过下一段的起点，段间的跳变小于一步
+*               3. 过短的帧(级数多于周期数)每级至少一个周期，不会卡住
+*               4. 线性模式:帧时长与关键帧相符，各通道同一时刻进入下一帧
+*               5. 序列结束时占空比正好是最后一帧的目标，并释放完成信号量
+*               6. 中断只清除本模块通道的中断位，同时挂起的其它LEDC中断不受影响
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include led_fade_test.c ../led_fade.c -o led_fade_test
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "led_fade.h"
+#include "led_lut.h"
+#include "soc/ledc_struct.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define PWM_FREQ                    5000
+#define DUTY_MAX                    8191                //13位
+#define CH_COUNT                    3
+#define MAX_EVENTS                  100000              //模拟的中断次数上限
+#define TIME_TOL_PM                 10                  //线性模式帧时长允许的偏差(千分比)
+#define SEG_TOL_CYCLES              4                   //亮度曲线模式帧时长允许的偏差(周期)，只有最后一段的取整补不回来
+#define OTHER_INT_BIT               (1UL << 0)          //定时器0溢出中断，不属于led_fade
+
+//一个通道的硬件状态
+typedef struct {
+	uint32_t duty;                  /*!< 当前(渐变结束时)的占空比 */
+	bool fading;
+	int64_t end_cycle;              /*!< 渐变结束的时刻(PWM周期) */
+	bool has_fade;                  /*!< 有待生效的渐变参数 */
+	bool has_duty;                  /*!< 有待生效的固定占空比 */
+	uint32_t next_duty;
+	LedFade_Hw_t next;
+	LedFade_Hw_t cur;
+	uint32_t fades;                 /*!< 启动的渐变段数 */
+	uint32_t jump_max;              /*!< 段间跳变的最大值 */
+	uint32_t jump_over;             /*!< 段间跳变不小于上一段步数的次数 */
+	uint32_t overshoot;             /*!< 上一段终点越过下一段起点的次数 */
+} hw_ch_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+volatile ledc_dev_t LEDC;
+
+static hw_ch_t g_hw[LEDC_CHANNEL_MAX];
+static int64_t g_cycle;
+static void (*g_isr)(void *);
+static int g_given;
+static uint32_t g_limit_errors;
+static uint32_t g_other_cleared;                    //其它中断位被清除的次数
+static const uint32_t g_cie[LED_LUT_LEVELS] = LED_LUT_CIE(13);
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/*
+ * LEDC和FreeRTOS替身
+ */
+esp_err_t ledc_set_fade(ledc_mode_t mode, ledc_channel_t ch, uint32_t duty, ledc_duty_direction_t dir,
+                        uint32_t step_num, uint32_t duty_cycle_num, uint32_t duty_scale)
+{
+    hw_ch_t *h = &g_hw[ch];
+    uint64_t travel = (uint64_t)step_num * duty_scale;
+
+    (void)mode;
+    if (step_num == 0 || step_num > LED_FADE_HW_MAX || duty_cycle_num == 0 || duty_cycle_num > LED_FADE_HW_MAX ||
+        duty_scale > LED_FADE_HW_MAX ||
+        (dir == LEDC_DUTY_DIR_INCREASE ? duty + travel > DUTY_MAX : travel > duty))
+    {
+        g_limit_errors ++;
+    }
+    h->next_duty = duty;
+    h->next.step = step_num;
+    h->next.cycle = duty_cycle_num;
+    h->next.scale = duty_scale;
+    h->next.dir = dir;
+    h->has_fade = 1;
+    h->has_duty = 0;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t ch, uint32_t duty)
+{
+    (void)mode;
+    g_hw[ch].next_duty = duty;
+    g_hw[ch].has_duty = 1;
+    g_hw[ch].has_fade = 0;
+    return ESP_OK;
+}
+
+//生效:固定占空比立即生效；渐变从给定起点开始，记录与上一段终点的跳变
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t ch)
+{
+    hw_ch_t *h = &g_hw[ch];
+    uint32_t jump;
+    bool up;
+
+    (void)mode;
+    if (h->has_duty)
+    {
+        h->duty = h->next_duty;
+        h->fading = 0;
+    }
+    else if (h->has_fade)
+    {
+        if (h->fades)
+        {
+            jump = (h->next_duty > h->duty) ? h->next_duty - h->duty : h->duty - h->next_duty;
+            if (jump > h->jump_max)
+            {
+                h->jump_max = jump;
+            }
+            if (jump && jump >= h->cur.step)
+            {
+                h->jump_over ++;
+            }
+            up = (h->cur.dir == LEDC_DUTY_DIR_INCREASE);
+            if (up ? h->duty > h->next_duty : h->duty < h->next_duty)
+            {
+                h->overshoot ++;
+            }
+        }
+        h->cur = h->next;
+        h->duty = h->next_duty;
+        h->fading = 1;
+        h->end_cycle = g_cycle + (int64_t)h->cur.step * h->cur.cycle;
+        h->fades ++;
+    }
+    h->has_duty = h->has_fade = 0;
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t mode, ledc_channel_t ch)
+{
+    (void)mode;
+    return g_hw[ch].duty;
+}
+
+uint32_t ledc_get_freq(ledc_mode_t mode, ledc_timer_t timer)
+{
+    (void)mode;
+    (void)timer;
+    return PWM_FREQ;
+}
+
+esp_err_t ledc_isr_register(void (*fn)(void *), void *arg, int intr_alloc_flags, ledc_isr_handle_t *handle)
+{
+    (void)arg;
+    (void)intr_alloc_flags;
+    g_isr = fn;
+    *handle = (ledc_isr_handle_t)fn;
+    return ESP_OK;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return (SemaphoreHandle_t)&g_given;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout)
+{
+    (void)sem;
+    (void)timeout;
+    if (g_given)
+    {
+        g_given = 0;
+        return pdTRUE;
+    }
+    return pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken)
+{
+    (void)sem;
+    g_given = 1;
+    *woken = pdTRUE;
+    return pdTRUE;
+}
+
+/*
+ * 模拟
+ */
+static void reset_hw(const uint32_t *duty)
+{
+    uint8_t i;
+
+    memset(g_hw, 0, sizeof(g_hw));
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        g_hw[i].duty = duty[i];
+    }
+    g_cycle = 0;
+    g_given = 0;
+    g_limit_errors = 0;
+    g_other_cleared = 0;
+}
+
+//运行到序列结束，记录每帧结束的时刻；返回帧数
+static uint16_t run(LedFade_Group_t *g, int64_t *key_end, uint16_t max_keys)
+{
+    int64_t next;
+    uint32_t st, done = g->keys_done;
+    uint16_t n = 0;
+    uint32_t events = 0;
+    uint8_t i;
+
+    while (g->running && events ++ < MAX_EVENTS)
+    {
+        next = INT64_MAX;
+        for (i = 0; i < CH_COUNT; i ++)
+        {
+            if (g_hw[i].fading && g_hw[i].end_cycle < next)
+            {
+                next = g_hw[i].end_cycle;
+            }
+        }
+        if (next == INT64_MAX)
+        {
+            printf("  group running but no channel fading\n");
+            return n;
+        }
+        g_cycle = next;
+        st = 0;
+        for (i = 0; i < CH_COUNT; i ++)
+        {
+            if (g_hw[i].fading && g_hw[i].end_cycle == next)
+            {
+                g_hw[i].fading = 0;
+                if (g_hw[i].cur.dir == LEDC_DUTY_DIR_INCREASE)
+                {
+                    g_hw[i].duty += (uint32_t)g_hw[i].cur.step * g_hw[i].cur.scale;
+                }
+                else
+                {
+                    g_hw[i].duty -= (uint32_t)g_hw[i].cur.step * g_hw[i].cur.scale;
+                }
+                st |= 1UL << (8 + i);
+            }
+        }
+        LEDC.int_st.val = st | OTHER_INT_BIT;
+        LEDC.int_clr.val = 0;
+        g_isr(NULL);
+        g_other_cleared += (LEDC.int_clr.val & OTHER_INT_BIT) ? 1 : 0;
+        if (g->keys_done != done)
+        {
+            done = g->keys_done;
+            if (n < max_keys)
+            {
+                key_end[n ++] = g_cycle;
+            }
+        }
+    }
+    return n;
+}
+
+//检查一次播放:帧时长(每级至少一个周期)、硬件限制、段间跳变、终点和完成信号量
+static int check(const char *name, LedFade_Group_t *g, const LedFade_Key_t *keys, uint16_t key_count,
+                 uint16_t passes)
+{
+    int64_t key_end[32], start = 0, actual, expect;
+    uint16_t n, k, total = key_count * passes;
+    uint32_t final, span, prev[CH_COUNT];
+    int errors = 0;
+    uint8_t i;
+
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        prev[i] = g->start_duty[i];
+    }
+    n = run(g, key_end, sizeof(key_end) / sizeof(key_end[0]));
+    if (n != total)
+    {
+        printf("  %s: %u of %u keys finished\n", name, n, total);
+        errors ++;
+    }
+    for (k = 0; k < n; k ++)
+    {
+        const LedFade_Key_t *key = &keys[k % key_count];
+
+        actual = key_end[k] - start;
+        expect = key->cycles;
+        //亮度曲线模式下每级至少占一个周期
+        for (i = 0, span = 0; g->lut && i < CH_COUNT; i ++)
+        {
+            span = (key->duty[i] > prev[i] + span) ? key->duty[i] - prev[i] :
+                   (prev[i] > key->duty[i] + span) ? prev[i] - key->duty[i] : span;
+        }
+        if (span > expect)
+        {
+            expect = span;
+        }
+        if (g->lut ? llabs(actual - expect) > SEG_TOL_CYCLES :
+                     llabs(actual - expect) * 1000 > expect * TIME_TOL_PM)
+        {
+            printf("  %s: key %u took %lld cycles, expected %lld\n", name, k, (long long)actual, (long long)expect);
+            errors ++;
+        }
+        start = key_end[k];
+        for (i = 0; i < CH_COUNT; i ++)
+        {
+            prev[i] = key->duty[i];
+        }
+    }
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        final = g->lut ? g->lut[keys[key_count - 1].duty[i]] : keys[key_count - 1].duty[i];
+        if (g_hw[i].duty != final)
+        {
+            printf("  %s: ch%u ends at %u, expected %u\n", name, i, g_hw[i].duty, final);
+            errors ++;
+        }
+        if (g_hw[i].overshoot || g_hw[i].jump_over)
+        {
+            printf("  %s: ch%u overshot %u segments, %u jumps not below one step (max %u)\n", name, i,
+                   g_hw[i].overshoot, g_hw[i].jump_over, g_hw[i].jump_max);
+            errors ++;
+        }
+    }
+    if (g_limit_errors)
+    {
+        printf("  %s: %u fades outside the 10-bit limits or the duty range\n", name, g_limit_errors);
+        errors ++;
+    }
+    if (g_other_cleared)
+    {
+        printf("  %s: other LEDC interrupts cleared %u times\n", name, g_other_cleared);
+        errors ++;
+    }
+    if (!LedFade_Wait(g, 0))
+    {
+        printf("  %s: done semaphore not given\n", name);
+        errors ++;
+    }
+    printf("%-10s %u keys, %u segments, %lld cycles, max jump %u: %s\n", name, n, g_hw[0].fades,
+           (long long)g_cycle, g_hw[0].jump_max, errors ? "FAILED" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    static const ledc_channel_t ch[CH_COUNT] = {LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2};
+    static const uint32_t off[CH_COUNT] = {0, 0, 0};
+    static const uint32_t mid[CH_COUNT] = {DUTY_MAX / 2, 100, DUTY_MAX};
+    //亮度级:低亮度区(每级占空比差小于每级周期数，靠补周期保证时长)、渐亮、保持(长帧，级差为0)、
+    //不同通道级差不同、过短的帧
+    static LedFade_Key_t cie_keys[] = {
+        {.duty = {40, 30, 20}, .time_ms = 1000},
+        {.duty = {255, 128, 10}, .time_ms = 1000},
+        {.duty = {255, 128, 10}, .time_ms = 2000},
+        {.duty = {0, 200, 255}, .time_ms = 700},
+        {.duty = {255, 0, 0}, .time_ms = 20},
+    };
+    static LedFade_Key_t lin_keys[] = {
+        {.duty = {DUTY_MAX, 4000, 0}, .time_ms = 1000},
+        {.duty = {0, 4000, 1}, .time_ms = 333},
+        {.duty = {123, 8000, DUTY_MAX}, .time_ms = 3000},
+    };
+    LedFade_Group_t group;
+    int errors = 0;
+
+    LedFade_Init();
+    LedFade_AddGroup(&group, LEDC_HIGH_SPEED_MODE, LEDC_TIMER_0, ch, CH_COUNT);
+
+    reset_hw(off);
+    LedFade_SetCurve(&group, g_cie, LED_LUT_LEVELS);
+    LedFade_Play(&group, cie_keys, sizeof(cie_keys) / sizeof(cie_keys[0]), 2);
+    errors += check("cie", &group, cie_keys, sizeof(cie_keys) / sizeof(cie_keys[0]), 2);
+
+    reset_hw(mid);
+    LedFade_SetCurve(&group, NULL, 0);
+    LedFade_Play(&group, lin_keys, sizeof(lin_keys) / sizeof(lin_keys[0]), 2);
+    errors += check("linear", &group, lin_keys, sizeof(lin_keys) / sizeof(lin_keys[0]), 2);
+
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,424 @@
+/*
+* @file         led_fx_test.c
+* @brief        led_fx字节码解释器在PC上的测试
+* @details      用替身的esp_timer在模拟时间上运行调度(每次回调随机推迟0~LATE_MAX_US，模拟esp_timer任务的延迟):
+*               1. 校验:操作数不完整、非法指令/通道/范围、循环不配对或嵌套过深、同步人数非法都被拒绝
+*               2. 流水灯:无限循环，每步按计划时刻前进，回调延迟不累积成漂移，任一时刻只有一个通道亮
+*               3. 渐变:每个刷新周期最多输出一次，单调变化，按时到达目标
+*               4. 循环:计数循环和嵌套循环的执行次数正确
+*               5. 同步点:先到的灯效等待，人数到齐后在同一次回调中一起继续
+*               6. 随机亮度和随机等待都在给定范围内
+*               7. 没有等待的死循环每次回调只执行有限条指令，不影响其它灯效的节拍
+*               8. 提交回调在一次回调的所有输出之后调用一次；没有灯效和渐变时定时器不再唤醒
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include led_fx_test.c ../led_fx.c -o led_fx_test
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "led_fx.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "freertos/semphr.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define CH_COUNT                    7
+#define LATE_MAX_US                 3000                //回调延迟上限
+#define MAX_EVENTS                  20000               //记录的输出次数
+#define FLOW_STEP_MS                100
+#define FADE_MS                     1000
+
+//一次输出
+typedef struct {
+	int64_t us;
+	uint8_t ch;
+	uint8_t level;
+	uint32_t cb;                    /*!< 第几次定时器回调 */
+} out_event_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static int64_t g_now;
+static int64_t g_due = -1;
+static esp_timer_cb_t g_cb;
+static uint32_t g_callbacks;
+static uint32_t g_commits;
+static uint32_t g_commit_late;                      //提交后同一次回调里又有输出的次数
+static uint32_t g_commit_cb = UINT32_MAX;
+static uint32_t g_seed = 7;
+static out_event_t g_events[MAX_EVENTS];
+static uint32_t g_event_count;
+static int g_errors;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/*
+ * 替身
+ */
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle)
+{
+    g_cb = args->callback;
+    *handle = (esp_timer_handle_t)&g_due;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    (void)timer;
+    g_due = g_now + (int64_t)timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    (void)timer;
+    g_due = -1;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return g_now;
+}
+
+uint32_t esp_random(void)
+{
+    return 0x2545F491;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return (SemaphoreHandle_t)&g_due;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout)
+{
+    (void)sem;
+    (void)timeout;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    (void)sem;
+}
+
+static void output(uint8_t ch, uint8_t level, void *arg)
+{
+    (void)arg;
+    if (g_commit_cb == g_callbacks)
+    {
+        g_commit_late ++;
+    }
+    if (g_event_count < MAX_EVENTS)
+    {
+        g_events[g_event_count].us = g_now;
+        g_events[g_event_count].ch = ch;
+        g_events[g_event_count].level = level;
+        g_events[g_event_count].cb = g_callbacks;
+        g_event_count ++;
+    }
+}
+
+static void commit(void *arg)
+{
+    (void)arg;
+    if (g_commit_cb == g_callbacks)
+    {
+        g_commit_late ++;
+    }
+    g_commit_cb = g_callbacks;
+    g_commits ++;
+}
+
+/*
+ * 模拟
+ */
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("  FAILED: %s\n", what);
+        g_errors ++;
+    }
+}
+
+static uint32_t sim_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return g_seed >> 8;
+}
+
+//运行到end_us，每次回调随机推迟
+static void run_until(int64_t end_us)
+{
+    while (g_due >= 0 && g_due <= end_us)
+    {
+        g_now = g_due + sim_rand() % (LATE_MAX_US + 1);
+        g_due = -1;
+        g_callbacks ++;
+        g_cb(NULL);
+    }
+    if (g_now < end_us)
+    {
+        g_now = end_us;
+    }
+}
+
+static void clear_events(void)
+{
+    g_event_count = 0;
+}
+
+static uint8_t start(const uint8_t *code, uint16_t len)
+{
+    uint8_t id = 0xFF;
+
+    expect(LedFx_Start(code, len, &id) == ESP_OK, "effect starts");
+    return id;
+}
+
+static void test_verify(void)
+{
+    static const uint8_t ok_code[] = {LED_FX_LOOP(2), LED_FX_RAND(0x03, 10, 20), LED_FX_WAIT_RAND(5, 9),
+                                      LED_FX_LOOP_END(), LED_FX_SYNC(3, 2), LED_FX_END()};
+    static const uint8_t truncated[] = {LED_FX_OP_FADE, 0x01, 10, 0};
+    static const uint8_t bad_op[] = {0x09};
+    static const uint8_t bad_mask[] = {LED_FX_SET(1 << CH_COUNT, 1)};
+    static const uint8_t bad_rand[] = {LED_FX_RAND(0x01, 20, 10)};
+    static const uint8_t bad_wait[] = {LED_FX_WAIT_RAND(300, 200)};
+    static const uint8_t open_loop[] = {LED_FX_LOOP(2), LED_FX_WAIT(10)};
+    static const uint8_t stray_end[] = {LED_FX_WAIT(10), LED_FX_LOOP_END()};
+    static const uint8_t deep[] = {LED_FX_LOOP(1), LED_FX_LOOP(1), LED_FX_LOOP(1), LED_FX_LOOP(1), LED_FX_LOOP(1),
+                                   LED_FX_LOOP_END(), LED_FX_LOOP_END(), LED_FX_LOOP_END(), LED_FX_LOOP_END(),
+                                   LED_FX_LOOP_END()};
+    static const uint8_t sync0[] = {LED_FX_SYNC(1, 0)};
+    static const uint8_t sync_many[] = {LED_FX_SYNC(1, LED_FX_MAX_INST + 1)};
+    static uint8_t too_long[LED_FX_CODE_MAX + 1];
+    int e = g_errors;
+
+    expect(LedFx_Verify(ok_code, sizeof(ok_code)) == ESP_OK, "valid code accepted");
+    expect(LedFx_Verify(truncated, sizeof(truncated)) == ESP_ERR_INVALID_SIZE, "truncated operand");
+    expect(LedFx_Verify(too_long, sizeof(too_long)) == ESP_ERR_INVALID_SIZE, "code too long");
+    expect(LedFx_Verify(bad_op, sizeof(bad_op)) == ESP_ERR_INVALID_ARG, "unknown opcode");
+    expect(LedFx_Verify(bad_mask, sizeof(bad_mask)) == ESP_ERR_INVALID_ARG, "channel out of range");
+    expect(LedFx_Verify(bad_rand, sizeof(bad_rand)) == ESP_ERR_INVALID_ARG, "rand range");
+    expect(LedFx_Verify(bad_wait, sizeof(bad_wait)) == ESP_ERR_INVALID_ARG, "wait range");
+    expect(LedFx_Verify(open_loop, sizeof(open_loop)) == ESP_ERR_INVALID_ARG, "unclosed loop");
+    expect(LedFx_Verify(stray_end, sizeof(stray_end)) == ESP_ERR_INVALID_ARG, "loop end without loop");
+    expect(LedFx_Verify(deep, sizeof(deep)) == ESP_ERR_INVALID_ARG, "loop nesting limit");
+    expect(LedFx_Verify(sync0, sizeof(sync0)) == ESP_ERR_INVALID_ARG, "sync with no parties");
+    expect(LedFx_Verify(sync_many, sizeof(sync_many)) == ESP_ERR_INVALID_ARG, "sync parties limit");
+    printf("%-10s %s\n", "verify", g_errors == e ? "ok" : "FAILED");
+}
+
+//流水灯+渐变+无等待的死循环同时运行
+static void test_flow_fade(void)
+{
+    static const uint8_t flow[] = {
+        LED_FX_LOOP(0),
+        LED_FX_SET(0x07, 0), LED_FX_SET(0x01, 255), LED_FX_WAIT(FLOW_STEP_MS),
+        LED_FX_SET(0x07, 0), LED_FX_SET(0x02, 255), LED_FX_WAIT(FLOW_STEP_MS),
+        LED_FX_SET(0x07, 0), LED_FX_SET(0x04, 255), LED_FX_WAIT(FLOW_STEP_MS),
+        LED_FX_LOOP_END(),
+    };
+    static const uint8_t fade[] = {LED_FX_FADE(0x08, 255, FADE_MS), LED_FX_WAIT(FADE_MS + 500),
+                                   LED_FX_FADE(0x08, 0, FADE_MS), LED_FX_WAIT(FADE_MS), LED_FX_END()};
+    static const uint8_t spin[] = {LED_FX_LOOP(0), LED_FX_SET(0x10, 1), LED_FX_LOOP_END()};
+    int e = g_errors;
+    int64_t t0, on_us, late, late_max = 0, fade_end = -1;
+    uint8_t id_flow, id_fade, id_spin, lit, level[CH_COUNT] = {0}, last3 = 0;
+    uint32_t i, k = 0, fade_outs = 0, per_cb = 0, last_cb = UINT32_MAX;
+    bool monotone = 1, falling = 0;
+
+    clear_events();
+    t0 = g_now;
+    id_flow = start(flow, sizeof(flow));
+    id_fade = start(fade, sizeof(fade));
+    id_spin = start(spin, sizeof(spin));
+    run_until(t0 + 10 * 1000000LL);
+
+    for (i = 0; i < g_event_count; i ++)
+    {
+        const out_event_t *ev = &g_events[i];
+
+        level[ev->ch] = ev->level;
+        if (ev->ch < 3 && ev->level == 255)
+        {
+            //第k步应在t0+k*100ms点亮，延迟只来自本次回调
+            on_us = t0 + (int64_t)k * FLOW_STEP_MS * 1000;
+            late = ev->us - on_us;
+            if (ev->ch != k % 3 || late < 0)
+            {
+                printf("  flow step %u: ch%u at %lld us\n", k, ev->ch, (long long)(ev->us - t0));
+                g_errors ++;
+            }
+            if (late > late_max)
+            {
+                late_max = late;
+            }
+            k ++;
+            lit = (level[0] != 0) + (level[1] != 0) + (level[2] != 0);
+            expect(lit == 1, "one flow channel lit");
+        }
+        if (ev->ch == 3)
+        {
+            fade_outs ++;
+            per_cb = (ev->cb == last_cb) ? per_cb + 1 : 1;
+            last_cb = ev->cb;
+            expect(per_cb == 1, "one fade output per refresh");
+            if (ev->level < last3 && !falling)
+            {
+                falling = 1;
+                expect(last3 == 255, "fade reaches its target before falling");
+            }
+            if (falling ? ev->level > last3 : ev->level < last3)
+            {
+                monotone = 0;
+            }
+            if (ev->level == 255 && fade_end < 0)
+            {
+                fade_end = ev->us - t0;
+            }
+            last3 = ev->level;
+        }
+    }
+    expect(k >= 10000 / FLOW_STEP_MS - 1, "flow kept its pace");
+    expect(late_max <= LATE_MAX_US, "flow steps do not drift");
+    expect(monotone && level[3] == 0, "fade monotone and back to 0");
+    expect(fade_end >= FADE_MS * 1000LL && fade_end <= FADE_MS * 1000LL + LED_FX_TICK_MS * 1000 + LATE_MAX_US,
+           "fade reaches 255 on time");
+    expect(fade_outs <= 2 * FADE_MS / LED_FX_TICK_MS, "fade refreshes at most once per tick");
+    expect(!LedFx_Running(id_fade) && LedFx_Running(id_flow) && LedFx_Running(id_spin), "finite effect ended");
+    expect(g_commit_late == 0, "commit after all outputs of a callback");
+    expect(g_commits <= g_callbacks, "at most one commit per callback");
+    printf("%-10s %u steps, flow late max %lldus, fade at 255 after %lldms: %s\n", "flow/fade", k,
+           (long long)late_max, (long long)(fade_end / 1000), g_errors == e ? "ok" : "FAILED");
+
+    LedFx_Stop(id_flow);
+    LedFx_Stop(id_spin);
+    run_until(g_now + 100000);
+}
+
+static void test_loops_rand(void)
+{
+    static const uint8_t nested[] = {
+        LED_FX_LOOP(2), LED_FX_LOOP(3),
+        LED_FX_SET(0x01, 255), LED_FX_WAIT(20), LED_FX_SET(0x01, 0), LED_FX_WAIT(20),
+        LED_FX_LOOP_END(), LED_FX_WAIT(50), LED_FX_LOOP_END(),
+    };
+    static const uint8_t rnd[] = {LED_FX_LOOP(50), LED_FX_RAND(0x06, 40, 60), LED_FX_WAIT_RAND(10, 30),
+                                  LED_FX_LOOP_END()};
+    int e = g_errors;
+    uint32_t i, pulses = 0, rand_outs = 0, waits = 0;
+    int64_t prev = -1, gap, t0 = g_now;
+    bool in_range = 1, wait_ok = 1;
+
+    clear_events();
+    start(nested, sizeof(nested));
+    start(rnd, sizeof(rnd));
+    run_until(t0 + 3 * 1000000LL);
+    for (i = 0; i < g_event_count; i ++)
+    {
+        const out_event_t *ev = &g_events[i];
+
+        if (ev->ch == 0 && ev->level == 255)
+        {
+            pulses ++;
+        }
+        if (ev->ch == 1)
+        {
+            rand_outs ++;
+            in_range &= (ev->level >= 40 && ev->level <= 60);
+            //相邻两次RAND之间的等待(时刻按计划累加，误差只来自回调延迟)
+            if (prev >= 0)
+            {
+                gap = ev->us - prev;
+                waits ++;
+                wait_ok &= (gap >= 10000 - LATE_MAX_US && gap <= 30000 + LATE_MAX_US);
+            }
+            prev = ev->us;
+        }
+    }
+    expect(pulses == 6, "nested 2x3 loop pulses six times");
+    expect(rand_outs > 0 && in_range, "random levels in range");
+    expect(waits > 0 && wait_ok, "random waits in range");
+    expect(g_due < 0, "timer idle once all effects end");
+    printf("%-10s %u pulses, %u random levels: %s\n", "loops", pulses, rand_outs, g_errors == e ? "ok" : "FAILED");
+}
+
+static void test_sync(void)
+{
+    static const uint8_t a[] = {LED_FX_WAIT(120), LED_FX_SYNC(5, 3), LED_FX_SET(0x10, 200)};
+    static const uint8_t b[] = {LED_FX_WAIT(370), LED_FX_SYNC(5, 3), LED_FX_SET(0x20, 200)};
+    static const uint8_t c[] = {LED_FX_WAIT(250), LED_FX_SYNC(5, 3), LED_FX_SET(0x40, 200)};
+    static const uint8_t other[] = {LED_FX_SYNC(6, 2), LED_FX_SET(0x01, 9)};
+    int e = g_errors;
+    int64_t at[3] = {-1, -1, -1}, t0 = g_now;
+    uint32_t cb[3] = {0}, i;
+    uint8_t id_other;
+
+    clear_events();
+    start(a, sizeof(a));
+    start(b, sizeof(b));
+    start(c, sizeof(c));
+    id_other = start(other, sizeof(other));
+    expect(LedFx_Start(a, sizeof(a), NULL) == ESP_ERR_NO_MEM, "no free slot");
+    run_until(t0 + 1000000);
+    for (i = 0; i < g_event_count; i ++)
+    {
+        if (g_events[i].ch >= 4)
+        {
+            at[g_events[i].ch - 4] = g_events[i].us - t0;
+            cb[g_events[i].ch - 4] = g_events[i].cb;
+        }
+    }
+    expect(at[0] >= 370000 && at[0] <= 370000 + LATE_MAX_US, "released when the last party arrives");
+    expect(cb[0] == cb[1] && cb[1] == cb[2], "all parties continue in the same callback");
+    expect(LedFx_Running(id_other) && LedFx_GetLevel(0) != 9, "a different sync point still waits");
+    LedFx_Stop(id_other);
+    run_until(g_now + 100000);
+    expect(g_due < 0, "timer idle");
+    printf("%-10s released at %lldms: %s\n", "sync", (long long)(at[0] / 1000), g_errors == e ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    if (LedFx_Init(CH_COUNT, output, NULL) != ESP_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    LedFx_SetCommit(commit);
+    test_verify();
+    test_flow_fade();
+    test_loops_rand();
+    test_sync();
+    printf("%u callbacks, %u commits\n", g_callbacks, g_commits);
+    printf("%s\n", g_errors ? "FAILED" : "ok");
+    return g_errors ? 1 : 0;
+}
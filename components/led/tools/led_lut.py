@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+@file         led_lut.py
+@brief        生成/校验亮度查找表头文件led_lut_table.h
+@details      表以Q24定点(1<<24为满量程)保存256级的伽马和CIE1931明度曲线，
+              固件用LED_LUT_SCALE在编译期换算到任意占空比分辨率，运行时不需要浮点
+              用法: python3 led_lut.py                生成头文件
+                    python3 led_lut.py --check        校验头文件与生成结果一致，
+                                                      并按固件的整数换算检查1~20位分辨率
+                    python3 led_lut.py --bits 13      打印13位分辨率下的两张表
+@author       Caesar, 2026/10/19, 初始化版本
+@par Copyright (c):
+              Caesar,Email:792910363@qq.com
+"""
+import argparse
+import os
+import sys
+
+LEVELS = 256                    # 写入LED_LUT_TABLE_LEVELS
+Q = 24                          # 写入LED_LUT_TABLE_Q
+GAMMA = 2.2                     # LED_LUT_GAMMA_Q24表的指数，写在该表的注释里
+PER_LINE = 8
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include", "led_lut_table.h")
+
+
+def gamma(x):
+    return x ** GAMMA
+
+
+def cie(x):
+    """CIE1931:明度L*(0~100)均匀变化时对应的相对亮度Y"""
+    lum = x * 100.0
+    if lum <= 8.0:
+        return lum / 903.3
+    return ((lum + 16.0) / 116.0) ** 3
+
+
+CURVES = (("GAMMA", "伽马%.1f" % GAMMA, gamma), ("CIE", "CIE1931明度", cie))
+
+
+def table(func):
+    return [int(round(func(i / (LEVELS - 1)) * (1 << Q))) for i in range(LEVELS)]
+
+
+def scale(v, bits):
+    """与LED_LUT_SCALE相同的整数换算"""
+    return (v * ((1 << bits) - 1) + (1 << (Q - 1))) >> Q
+
+
+def render():
+    out = []
+    out.append("/*")
+    out.append("* @file         led_lut_table.h")
+    out.append("* @brief        亮度查找表数据(由tools/led_lut.py生成，不要手工修改)")
+    out.append("* @details      %d级，Q%d定点，通过led_lut.h中的宏使用" % (LEVELS, Q))
+    out.append("* @author       Caesar, 2026/10/19, 初始化版本\\n")
+    out.append("* @par Copyright (c):")
+    out.append("*               Caesar,Email:792910363@qq.com")
+    out.append("*/")
+    out.append("#ifndef LED_LUT_TABLE_H")
+    out.append("#define LED_LUT_TABLE_H")
+    out.append("")
+    out.append("#define LED_LUT_TABLE_LEVELS        %d" % LEVELS)
+    out.append("#define LED_LUT_TABLE_Q             %d" % Q)
+    for name, desc, func in CURVES:
+        values = table(func)
+        out.append("")
+        out.append("//%s，X(v, bits)逐项换算" % desc)
+        out.append("#define LED_LUT_%s_Q%d(X, bits) \\" % (name, Q))
+        for i in range(0, LEVELS, PER_LINE):
+            items = ", ".join("X(%d, bits)" % v for v in values[i:i + PER_LINE])
+            tail = "," if i + PER_LINE < LEVELS else ""
+            cont = " \\" if i + PER_LINE < LEVELS else ""
+            out.append("\t%s%s%s" % (items, tail, cont))
+    out.append("")
+    out.append("#endif")
+    return "\r\n".join(out) + "\r\n"
+
+
+def check():
+    ok = True
+    with open(HEADER, "rb") as f:
+        if f.read().decode("utf-8") != render():
+            print("led_lut_table.h is out of date, run led_lut.py")
+            ok = False
+    for name, _, func in CURVES:
+        values = table(func)
+        if values[0] != 0 or values[-1] != 1 << Q:
+            print("%s: end points %d %d" % (name, values[0], values[-1]))
+            ok = False
+        for bits in range(1, 21):
+            top = (1 << bits) - 1
+            duty = [scale(v, bits) for v in values]
+            worst = max(abs(d - func(i / (LEVELS - 1)) * top) for i, d in enumerate(duty))
+            if worst > 0.5 + top / float(1 << Q) or duty[-1] != top or duty[0] != 0:
+                print("%s %d bit: max error %.3f LSB" % (name, bits, worst))
+                ok = False
+            if any(b < a for a, b in zip(duty, duty[1:])):
+                print("%s %d bit: not monotonic" % (name, bits))
+                ok = False
+    print("ok" if ok else "FAILED")
+    return ok
+
+
+def dump(bits):
+    for name, desc, func in CURVES:
+        duty = [scale(v, bits) for v in table(func)]
+        zero = sum(1 for d in duty if d == 0) - 1
+        print("%s (%d bit, %d levels stuck at 0):" % (name, bits, zero))
+        for i in range(0, LEVELS, 16):
+            print("  %3d: %s" % (i, " ".join("%6d" % d for d in duty[i:i + 16])))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="generate / verify LED brightness LUTs")
+    parser.add_argument("--check", action="store_true", help="verify header and integer scaling")
+    parser.add_argument("--bits", type=int, help="print the tables for this duty resolution")
+    args = parser.parse_args()
+    if args.check:
+        sys.exit(0 if check() else 1)
+    if args.bits:
+        dump(args.bits)
+        return
+    with open(HEADER, "wb") as f:
+        f.write(render().encode("utf-8"))
+    print("wrote %s" % os.path.normpath(HEADER))
+
+
+if __name__ == "__main__":
+    main()
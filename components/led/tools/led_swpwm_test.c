@@ -0,0 +1,731 @@
+/*
+* @file         led_swpwm_test.c
+* @brief        定时器中断软件PWM在PC上的测试
+* @details      用替身的定时器组寄存器运行中断:每次读计数模拟的计数都前进READ_COST，进中断随机推迟0~LATE_MAX，
+*               GPIO的W1TS/W1TC写入在下一次读计数时生效并按通道记录电平变化:
+*               1. 参数:未初始化、频率/位数越界、重复初始化、通道和占空比越界、没有设置就开始渐变都被拒绝；
+*                  定时器启动失败时释放中断、刷新定时器、信号量和互斥锁，引脚恢复为禁用，之后可以重新初始化
+*               2. 翻转表:随机的引脚组和占空比下，翻转点递增且在周期内，每个通道在熄灭点前后的电平正确
+*               3. 波形:每个周期的点亮时长与占空比相差不超过中断延迟，0和满占空比没有翻转，
+*                  同一时刻熄灭的通道合并为一个翻转点，相隔不到LED_SWPWM_MIN_GAP的翻转点在同一次中断中等到
+*               4. 换表:在周期中的随机时刻更新全部通道，之后的每个周期都完整地使用新表，不出现新旧混合的周期
+*               5. 错过:中断晚了一个周期以上时放弃追赶，计入miss_count，最多拉长一个脉冲、不补出截短的脉冲，
+*                  之后的周期恢复正确的占空比
+*               6. 渐变:占空比单调变化，到时到达目标并释放信号量，渐变结束后刷新定时器停止
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include -I../../gpio_group/include led_swpwm_test.c ../led_swpwm.c
+*                     ../../gpio_group/gpio_group.c -o led_swpwm_test
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "led_swpwm.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "esp_intr_alloc.h"
+#include "soc/timer_group_struct.h"
+#include "xtensa/hal.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define CH_COUNT                    4
+#define INVERT                      0x2                 //通道1低电平点亮
+#define FREQ_HZ                     1000
+#define BITS                        10
+#define FULL                        (1UL << BITS)
+#define PERIOD                      (LED_SWPWM_TICK_HZ / FREQ_HZ)
+#define TICKS_PER_US                (LED_SWPWM_TICK_HZ / 1000000)
+#define MIN_GAP                     (LED_SWPWM_MIN_GAP_US * TICKS_PER_US)
+#define HW                          (g_timg.hw_timer[LED_SWPWM_TIMER_IDX])
+#define READ_COST                   2                   //读一次计数(一次寄存器访问)的耗时
+#define LATE_MAX                    40                  //进中断延迟上限(1us)
+#define TOL                         (LATE_MAX + 8 * READ_COST)
+#define MAX_EDGES                   4096
+#define MAX_CYCLES                  1024
+
+//一次电平变化
+typedef struct {
+	uint64_t at;
+	uint8_t level;
+} edge_t;
+
+//一个周期:点亮时刻和点亮时长
+typedef struct {
+	uint64_t rise;
+	uint32_t on;
+} cycle_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+gpio_dev_t GPIO;
+static const gpio_num_t g_pins[CH_COUNT] = {2, 18, 33, 5};
+static timg_dev_t g_timg;
+static uint64_t g_cnt;                              //模拟的定时器计数
+static bool g_started;
+static void (*g_isr)(void *);
+static esp_timer_cb_t g_fade_cb;
+static int64_t g_fade_next = -1;                    //刷新定时器下一次到期(us)，-1为停止
+static uint32_t g_fade_period;
+static uint8_t g_mutex;
+static uint8_t g_sem[CH_COUNT];                     //各通道的done信号量
+static uint8_t g_sem_count;
+static int g_objects;                               //还没释放的信号量、刷新定时器和中断
+static bool g_fail_start;                           //timer_start返回错误
+static uint64_t g_disabled_pins;                    //最近一次被配置为禁用的引脚
+static uint32_t g_late_once;                        //下一次中断额外推迟
+static uint8_t g_level[CH_COUNT];
+static edge_t g_edges[CH_COUNT][MAX_EDGES];
+static uint32_t g_edge_count[CH_COUNT];
+static cycle_t g_cycles[CH_COUNT][MAX_CYCLES];
+static uint32_t g_seed = 7;
+static int g_errors;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("  FAILED: %s\n", what);
+        g_errors ++;
+    }
+}
+
+static uint32_t sim_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return g_seed >> 8;
+}
+
+/*
+ * 让上一次GPIO写入生效，记录各通道(去掉反相后)的电平变化
+ */
+static void gpio_flush(void)
+{
+    uint32_t lo = (GPIO.out | GPIO.out_w1ts) & ~GPIO.out_w1tc;
+    uint32_t hi = (GPIO.out1.val | GPIO.out1_w1ts.val) & ~GPIO.out1_w1tc.val & 0xFF;
+    uint8_t i, level;
+
+    GPIO.out = lo;
+    GPIO.out1.val = hi;
+    GPIO.out_w1ts = GPIO.out_w1tc = 0;
+    GPIO.out1_w1ts.val = GPIO.out1_w1tc.val = 0;
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        level = ((g_pins[i] < 32) ? (lo >> g_pins[i]) : (hi >> (g_pins[i] - 32))) & 1;
+        level ^= (INVERT >> i) & 1;
+        if (level != g_level[i])
+        {
+            g_level[i] = level;
+            if (g_edge_count[i] < MAX_EDGES)
+            {
+                g_edges[i][g_edge_count[i]].at = g_cnt;
+                g_edges[i][g_edge_count[i]].level = level;
+                g_edge_count[i] ++;
+            }
+        }
+    }
+}
+
+/*
+ * 替身
+ */
+timg_dev_t *LedFake_Timg(int group)
+{
+    (void)group;
+    gpio_flush();
+    HW.cnt_low = (uint32_t)g_cnt;
+    HW.cnt_high = (uint32_t)(g_cnt >> 32);
+    g_cnt += READ_COST;
+    return &g_timg;
+}
+
+unsigned xthal_get_ccount(void)
+{
+    return (unsigned)(g_cnt * 6);
+}
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    if (cfg->mode == GPIO_MODE_DISABLE)
+    {
+        g_disabled_pins = cfg->pin_bit_mask;
+    }
+    return ESP_OK;
+}
+
+esp_err_t timer_init(timer_group_t group, timer_idx_t idx, const timer_config_t *config)
+{
+    (void)group;
+    g_timg.hw_timer[idx].config.alarm_en = config->alarm_en;
+    return ESP_OK;
+}
+
+esp_err_t timer_set_counter_value(timer_group_t group, timer_idx_t idx, uint64_t value)
+{
+    (void)group;
+    (void)idx;
+    g_cnt = value;
+    return ESP_OK;
+}
+
+esp_err_t timer_set_alarm_value(timer_group_t group, timer_idx_t idx, uint64_t value)
+{
+    (void)group;
+    g_timg.hw_timer[idx].alarm_low = (uint32_t)value;
+    g_timg.hw_timer[idx].alarm_high = (uint32_t)(value >> 32);
+    return ESP_OK;
+}
+
+esp_err_t timer_enable_intr(timer_group_t group, timer_idx_t idx)
+{
+    (void)group;
+    (void)idx;
+    return ESP_OK;
+}
+
+esp_err_t timer_disable_intr(timer_group_t group, timer_idx_t idx)
+{
+    (void)group;
+    (void)idx;
+    return ESP_OK;
+}
+
+esp_err_t timer_isr_register(timer_group_t group, timer_idx_t idx, void (*fn)(void *), void *arg,
+                             int intr_alloc_flags, timer_isr_handle_t *handle)
+{
+    (void)group;
+    (void)idx;
+    (void)arg;
+    expect(intr_alloc_flags & ESP_INTR_FLAG_IRAM, "isr registered in IRAM");
+    g_isr = fn;
+    if (handle)
+    {
+        *handle = (timer_isr_handle_t)&g_isr;
+    }
+    g_objects ++;
+    return ESP_OK;
+}
+
+esp_err_t esp_intr_free(intr_handle_t handle)
+{
+    (void)handle;
+    g_isr = NULL;
+    g_objects --;
+    return ESP_OK;
+}
+
+esp_err_t timer_start(timer_group_t group, timer_idx_t idx)
+{
+    (void)group;
+    (void)idx;
+    if (g_fail_start)
+    {
+        return ESP_FAIL;
+    }
+    g_started = 1;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle)
+{
+    g_fade_cb = args->callback;
+    *handle = (esp_timer_handle_t)&g_fade_next;
+    g_objects ++;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    (void)timer;
+    g_fade_cb = NULL;
+    g_objects --;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    (void)timer;
+    g_fade_period = (uint32_t)period_us;
+    g_fade_next = esp_timer_get_time() + (int64_t)period_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    (void)timer;
+    g_fade_next = -1;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)(g_cnt / TICKS_PER_US);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    g_objects ++;
+    return &g_mutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    if (g_sem_count >= CH_COUNT)
+    {
+        return NULL;
+    }
+    g_objects ++;
+    return &g_sem[g_sem_count ++];
+}
+
+//按创建的逆序删除时，信号量槽位正好依次退回
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    if (sem != &g_mutex)
+    {
+        expect(sem == &g_sem[g_sem_count - 1], "semaphores deleted in reverse order");
+        g_sem_count --;
+    }
+    g_objects --;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout)
+{
+    uint8_t *count = sem;
+
+    if (sem == &g_mutex)
+    {
+        return pdTRUE;
+    }
+    expect(timeout == 0 || *count, "no blocking take on an empty semaphore");
+    if (*count == 0)
+    {
+        return pdFALSE;
+    }
+    *count = 0;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    *(uint8_t *)sem = 1;
+    return pdTRUE;
+}
+
+/*
+ * 运行到计数end:按闹钟(加随机延迟)进中断，按到期时刻执行渐变刷新
+ */
+static void run_until(uint64_t end)
+{
+    uint64_t alarm, fade_at;
+
+    while (g_started)
+    {
+        alarm = HW.config.alarm_en ? ((uint64_t)HW.alarm_high << 32 | HW.alarm_low) : UINT64_MAX;
+        fade_at = (g_fade_next >= 0) ? (uint64_t)g_fade_next * TICKS_PER_US : UINT64_MAX;
+        if (alarm <= fade_at && alarm <= end)
+        {
+            alarm += g_late_once ? g_late_once : sim_rand() % (LATE_MAX + 1);
+            g_late_once = 0;
+            if (g_cnt < alarm)
+            {
+                g_cnt = alarm;
+            }
+            HW.config.alarm_en = 0;
+            g_isr(NULL);
+        }
+        else if (fade_at < alarm && fade_at <= end)
+        {
+            if (g_cnt < fade_at)
+            {
+                g_cnt = fade_at;
+            }
+            g_fade_next += g_fade_period;
+            g_fade_cb(NULL);
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (g_cnt < end)
+    {
+        g_cnt = end;
+    }
+}
+
+static void clear_edges(void)
+{
+    memset(g_edge_count, 0, sizeof(g_edge_count));
+}
+
+/*
+ * 把通道ch在[from, to)内的电平变化配成周期(点亮到熄灭)，返回周期数
+ */
+static uint32_t get_cycles(uint8_t ch, uint64_t from, uint64_t to)
+{
+    uint32_t i, n = 0;
+
+    for (i = 0; i + 1 < g_edge_count[ch] && n < MAX_CYCLES; i ++)
+    {
+        if (g_edges[ch][i].at < from || g_edges[ch][i].at >= to || g_edges[ch][i].level != 1)
+        {
+            continue;
+        }
+        expect(g_edges[ch][i + 1].level == 0, "edges alternate");
+        g_cycles[ch][n].rise = g_edges[ch][i].at;
+        g_cycles[ch][n].on = (uint32_t)(g_edges[ch][i + 1].at - g_edges[ch][i].at);
+        n ++;
+    }
+    return n;
+}
+
+static uint32_t edges_in(uint8_t ch, uint64_t from, uint64_t to)
+{
+    uint32_t i, n = 0;
+
+    for (i = 0; i < g_edge_count[ch]; i ++)
+    {
+        n += (g_edges[ch][i].at >= from && g_edges[ch][i].at < to);
+    }
+    return n;
+}
+
+static bool near(uint32_t on, uint32_t duty)
+{
+    uint32_t want = (uint32_t)(((uint64_t)duty * PERIOD) >> BITS);
+
+    return on + TOL >= want && on <= want + TOL;
+}
+
+/*
+ * 检查[from, to)内的输出与占空比一致
+ */
+static void check_wave(const uint32_t *duty, uint64_t from, uint64_t to)
+{
+    uint32_t n, k, periods = (uint32_t)((to - from) / PERIOD);
+    uint8_t i;
+
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        if (duty[i] == 0 || duty[i] >= FULL)
+        {
+            expect(edges_in(i, from, to) == 0 && g_level[i] == (duty[i] != 0), "full and zero duty never toggle");
+            continue;
+        }
+        n = get_cycles(i, from, to);
+        expect(n + 1 >= periods && n <= periods + 1, "one pulse per period");
+        for (k = 0; k < n; k ++)
+        {
+            expect(near(g_cycles[i][k].on, duty[i]), "pulse width matches duty");
+        }
+    }
+}
+
+static void set_all(const uint32_t *duty)
+{
+    uint8_t i;
+
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        expect(LedSwPwm_SetDuty(i, duty[i]) == ESP_OK, "set duty");
+    }
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        expect(LedSwPwm_UpdateDuty(i) == ESP_OK, "update duty");
+    }
+}
+
+static void test_args(void)
+{
+    int e = g_errors;
+
+    expect(LedSwPwm_SetDuty(0, 1) == ESP_ERR_INVALID_ARG, "set duty before init");
+    expect(LedSwPwm_Init(g_pins, CH_COUNT, INVERT, 0, BITS) == ESP_ERR_INVALID_ARG, "zero frequency");
+    expect(LedSwPwm_Init(g_pins, CH_COUNT, INVERT, LED_SWPWM_TICK_HZ / (4 * MIN_GAP) + 1, BITS) ==
+           ESP_ERR_INVALID_ARG, "frequency too high for the edge gap");
+    expect(LedSwPwm_Init(g_pins, CH_COUNT, INVERT, FREQ_HZ, 17) == ESP_ERR_INVALID_ARG, "too many duty bits");
+    g_fail_start = 1;
+    expect(LedSwPwm_Init(g_pins, CH_COUNT, INVERT, FREQ_HZ, BITS) == ESP_FAIL, "timer start failure reported");
+    g_fail_start = 0;
+    expect(g_objects == 0 && g_isr == NULL && g_fade_cb == NULL, "failed init releases everything");
+    expect(g_disabled_pins == ((1ULL << 2) | (1ULL << 18) | (1ULL << 33) | (1ULL << 5)),
+           "failed init disables the pins");
+    expect(LedSwPwm_SetDuty(0, 1) == ESP_ERR_INVALID_ARG, "set duty after failed init");
+    expect(LedSwPwm_Init(g_pins, CH_COUNT, INVERT, FREQ_HZ, BITS) == ESP_OK, "init");
+    expect(LedSwPwm_Init(g_pins, CH_COUNT, INVERT, FREQ_HZ, BITS) == ESP_ERR_INVALID_STATE, "init twice");
+    expect(LedSwPwm_SetDuty(CH_COUNT, 1) == ESP_ERR_INVALID_ARG, "channel out of range");
+    expect(LedSwPwm_SetDuty(0, FULL + 1) == ESP_ERR_INVALID_ARG, "duty out of range");
+    expect(LedSwPwm_SetFadeWithTime(0, FULL + 1, 10) == ESP_ERR_INVALID_ARG, "fade target out of range");
+    expect(LedSwPwm_FadeStart(0, LEDC_FADE_NO_WAIT) == ESP_ERR_INVALID_STATE, "fade start without fade set");
+    printf("%-10s %s\n", "args", g_errors == e ? "ok" : "FAILED");
+}
+
+static void test_build(void)
+{
+    static const gpio_num_t pins[GPIO_GROUP_MAX_PINS] = {2, 18, 19, 5, 4, 32, 33, 13};
+    uint32_t duty[GPIO_GROUP_MAX_PINS], edge, t, ts[3], bit, set, clr, it, invert;
+    int e = g_errors;
+    GpioGroup_t g;
+    LedSwPwm_Sched_t s;
+    uint8_t n, bits, i, k, q, level;
+
+    for (it = 0; it < 20000 && g_errors - e < 10; it ++)
+    {
+        n = 1 + sim_rand() % GPIO_GROUP_MAX_PINS;
+        bits = 1 + sim_rand() % 16;
+        invert = sim_rand() & 0xFF;
+        GpioGroup_Define(&g, pins, n, invert);
+        for (i = 0; i < n; i ++)
+        {
+            switch (sim_rand() % 4)
+            {
+            case 0:
+                duty[i] = 0;
+                break;
+            case 1:
+                duty[i] = 1UL << bits;
+                break;
+            case 2:
+                duty[i] = duty[sim_rand() % (i + 1)];
+                break;
+            default:
+                duty[i] = sim_rand() % ((1UL << bits) + 1);
+                break;
+            }
+        }
+        LedSwPwm_Build(&g, duty, bits, PERIOD, &s);
+        expect(s.count >= 1 && s.count <= n + 1 && s.at[0] == 0, "table size");
+        for (k = 1; k < s.count; k ++)
+        {
+            expect(s.at[k] > s.at[k - 1] && s.at[k] < PERIOD, "edges increase within the period");
+        }
+        for (i = 0; i < n; i ++)
+        {
+            edge = (uint32_t)(((uint64_t)duty[i] * PERIOD) >> bits);
+            ts[0] = 0;
+            ts[1] = edge ? edge - 1 : 0;
+            ts[2] = (edge < PERIOD) ? edge : PERIOD - 1;
+            for (q = 0; q < 3; q ++)
+            {
+                t = ts[q];
+                for (k = 0; k + 1 < s.count && s.at[k + 1] <= t; k ++)
+                {
+                }
+                bit = (pins[i] < 32) ? 1UL << pins[i] : 1UL << (pins[i] - 32);
+                set = (pins[i] < 32) ? s.masks[k].set_lo : s.masks[k].set_hi;
+                clr = (pins[i] < 32) ? s.masks[k].clr_lo : s.masks[k].clr_hi;
+                expect(((set ^ clr) & bit) != 0, "every pin driven");
+                level = ((set & bit) != 0) ^ ((invert >> i) & 1);
+                expect(level == (t < edge), "level at the edge");
+            }
+        }
+    }
+    printf("%-10s %s\n", "build", g_errors == e ? "ok" : "FAILED");
+}
+
+static void test_wave(void)
+{
+    //通道2与通道0同时熄灭(合并)，通道3离周期开始不到最小间隔(在中断中等到)
+    static const uint32_t duty[CH_COUNT] = {300, FULL, 300, 1};
+    static const uint32_t duty2[CH_COUNT] = {0, 700, 1023, FULL / 2};
+    int e = g_errors;
+    LedSwPwm_Stats_t st;
+    uint64_t t0;
+
+    set_all(duty);
+    run_until(g_cnt + 3 * PERIOD);
+    LedSwPwm_ResetStats();
+    clear_edges();
+    t0 = g_cnt;
+    run_until(t0 + 200 * PERIOD);
+    check_wave(duty, t0, g_cnt);
+    LedSwPwm_GetStats(&st);
+    //进中断晚于第二个翻转点时也计入miss_count，一样在同一次中断中写出
+    expect(st.spin_count > 0 && st.spin_count + st.miss_count >= 199, "close edge handled in the same isr");
+    expect(st.isr_count <= 200 * 2 + 2, "one interrupt for merged edges");
+    expect(st.late_max <= LATE_MAX + READ_COST, "isr latency recorded");
+
+    set_all(duty2);
+    run_until(g_cnt + 2 * PERIOD);
+    clear_edges();
+    t0 = g_cnt;
+    run_until(t0 + 200 * PERIOD);
+    check_wave(duty2, t0, g_cnt);
+    printf("%-10s %s\n", "wave", g_errors == e ? "ok" : "FAILED");
+}
+
+static void test_swap(void)
+{
+    static const uint32_t tables[2][CH_COUNT] = {{100, 200, 300, 400}, {900, 700, 50, 600}};
+    uint64_t swap_at[64];
+    uint32_t n[CH_COUNT], k, j, cur;
+    int e = g_errors;
+    uint8_t i, which[2];
+
+    set_all(tables[0]);
+    run_until(g_cnt + 2 * PERIOD);
+    clear_edges();
+    for (j = 0; j < 64; j ++)
+    {
+        run_until(g_cnt + PERIOD / 4 + sim_rand() % (2 * PERIOD));
+        swap_at[j] = g_cnt;
+        set_all(tables[(j + 1) & 1]);
+    }
+    run_until(g_cnt + 3 * PERIOD);
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        n[i] = get_cycles(i, 0, UINT64_MAX);
+        expect(n[i] == n[0], "same number of periods on every channel");
+    }
+    for (k = 0, cur = 0, j = 0; k < n[0]; k ++)
+    {
+        //每个周期所有通道同时点亮，时长都来自同一张表
+        while (j < 64 && swap_at[j] < g_cycles[0][k].rise)
+        {
+            cur = (j + 1) & 1;
+            j ++;
+        }
+        which[0] = which[1] = 0;
+        for (i = 0; i < CH_COUNT; i ++)
+        {
+            expect(g_cycles[i][k].rise == g_cycles[0][k].rise, "channels rise together");
+            which[0] += near(g_cycles[i][k].on, tables[0][i]);
+            which[1] += near(g_cycles[i][k].on, tables[1][i]);
+        }
+        expect(which[cur] == CH_COUNT, "whole period from the table published before it");
+    }
+    printf("%-10s %s\n", "swap", g_errors == e ? "ok" : "FAILED");
+}
+
+static void test_miss(void)
+{
+    static const uint32_t duty[CH_COUNT] = {100, 512, 0, 800};
+    static const uint32_t late[] = {PERIOD + PERIOD / 3, 5 * PERIOD + PERIOD / 2};
+    uint32_t n, k, want, shorter, longer;
+    int e = g_errors;
+    LedSwPwm_Stats_t st;
+    uint64_t t0;
+    uint8_t i, j;
+
+    set_all(duty);
+    for (j = 0; j < sizeof(late) / sizeof(late[0]); j ++)
+    {
+        run_until(g_cnt + 2 * PERIOD);
+        LedSwPwm_ResetStats();
+        clear_edges();
+        g_late_once = late[j];
+        run_until(g_cnt + 10 * PERIOD);
+        LedSwPwm_GetStats(&st);
+        expect(st.miss_count >= 1 && st.late_max >= late[j], "late isr counted");
+        //从下一个周期重新开始:只允许一个被拉长的脉冲，不能补出一串被截短的脉冲
+        for (i = 0; i < CH_COUNT; i ++)
+        {
+            if (duty[i] == 0)
+            {
+                continue;
+            }
+            want = (uint32_t)(((uint64_t)duty[i] * PERIOD) >> BITS);
+            n = get_cycles(i, 0, UINT64_MAX);
+            for (k = 0, shorter = 0, longer = 0; k < n; k ++)
+            {
+                shorter += (g_cycles[i][k].on + TOL < want);
+                longer += (g_cycles[i][k].on > want + TOL);
+            }
+            expect(shorter == 0 && longer <= 1, "no catch-up burst after a miss");
+        }
+        clear_edges();
+        t0 = g_cnt;
+        run_until(t0 + 50 * PERIOD);
+        check_wave(duty, t0, g_cnt);
+    }
+    printf("%-10s %s\n", "miss", g_errors == e ? "ok" : "FAILED");
+}
+
+static void test_fade(void)
+{
+    static const uint32_t duty[CH_COUNT] = {100, 512, 0, 800};
+    uint32_t prev, d, final[CH_COUNT];
+    int e = g_errors;
+    uint64_t t0;
+    uint8_t i;
+
+    set_all(duty);
+    run_until(g_cnt + 2 * PERIOD);
+    g_sem[0] = 0;
+    //只设置不生效的占空比不影响渐变的起点
+    expect(LedSwPwm_SetDuty(0, 900) == ESP_OK, "staged duty");
+    expect(LedSwPwm_SetFadeWithTime(0, 1000, 200) == ESP_OK, "fade set");
+    expect(LedSwPwm_FadeStart(0, LEDC_FADE_NO_WAIT) == ESP_OK, "fade start");
+    expect(g_fade_next >= 0, "refresh timer started");
+    t0 = g_cnt;
+    for (prev = LedSwPwm_GetDuty(0); g_cnt < t0 + 260000ULL * TICKS_PER_US; prev = d)
+    {
+        run_until(g_cnt + 5000 * TICKS_PER_US);
+        d = LedSwPwm_GetDuty(0);
+        expect(d >= prev, "fade monotonic");
+        expect(g_cnt >= t0 + 20000 * TICKS_PER_US || d < 300, "fade starts from the output duty");
+        if (g_cnt < t0 + 190000ULL * TICKS_PER_US)
+        {
+            expect(d < 1000 && g_sem[0] == 0, "fade still running");
+        }
+    }
+    expect(LedSwPwm_GetDuty(0) == 1000 && g_sem[0] == 1, "fade reached target and gave done");
+    expect(g_fade_next < 0, "refresh timer stopped");
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        final[i] = LedSwPwm_GetDuty(i);
+        expect(i == 0 || final[i] == duty[i], "other channels unchanged");
+    }
+    clear_edges();
+    t0 = g_cnt;
+    run_until(t0 + 20 * PERIOD);
+    check_wave(final, t0, g_cnt);
+
+    //渐变中更新占空比:停止渐变并释放信号量
+    g_sem[0] = 0;
+    expect(LedSwPwm_SetFadeWithTime(0, 0, 100) == ESP_OK && LedSwPwm_FadeStart(0, LEDC_FADE_NO_WAIT) == ESP_OK,
+           "second fade");
+    run_until(g_cnt + 30000 * TICKS_PER_US);
+    expect(LedSwPwm_SetDuty(0, 500) == ESP_OK && LedSwPwm_UpdateDuty(0) == ESP_OK, "update during fade");
+    expect(g_sem[0] == 1 && LedSwPwm_GetDuty(0) == 500, "update stops the fade");
+    run_until(g_cnt + 100000 * TICKS_PER_US);
+    expect(LedSwPwm_GetDuty(0) == 500 && g_fade_next < 0, "stopped fade stays stopped");
+    printf("%-10s %s\n", "fade", g_errors == e ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < CH_COUNT; i ++)
+    {
+        g_level[i] = (INVERT >> i) & 1;
+    }
+    test_args();
+    test_build();
+    test_wave();
+    test_swap();
+    test_miss();
+    test_fade();
+    printf("%s\n", g_errors ? "FAILED" : "ok");
+    return g_errors ? 1 : 0;
+}
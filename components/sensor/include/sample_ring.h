@@ -0,0 +1,107 @@
+/*
+* @file         sample_ring.h
+* @brief        传感器样本环形缓冲区
+* @details      单生产者/多消费者，无锁:生产者(采样回调)写入从不等待，消费者各自持有读位置，
+*               被覆盖时跳到最旧的有效样本并计数；每写入一个样本以O(1)更新
+*               全程min/max/均值/方差，以及1s、1min、1h三级分桶统计；
+*               写入只做整数累加，均值和方差在读取统计时才计算
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define SAMPLE_RING_LEN             64                  //样本槽数，必须是2的幂
+#define SAMPLE_RING_HIST_LEN        60                  //每级保留的已完成分桶数
+#define SAMPLE_RING_READ_RETRY      4                   //统计读取与写入冲突时的重试次数
+
+//分桶级别
+typedef enum {
+	SAMPLE_RING_LEVEL_1S = 0,
+	SAMPLE_RING_LEVEL_1MIN,
+	SAMPLE_RING_LEVEL_1H,
+	SAMPLE_RING_LEVELS
+} SAMPLE_RING_LEVEL_t;
+
+//一个样本
+typedef struct {
+	uint32_t seq;                   /*!< 写入序号，从0开始连续 */
+	int64_t  time_us;
+	int32_t  value;
+} SensorSample_t;
+
+//统计结果
+typedef struct {
+	int64_t  start_us;              /*!< 第一个样本的时刻(分桶为桶的起始时刻) */
+	uint32_t count;
+	int32_t  min;
+	int32_t  max;
+	float    mean;
+	float    var;                   /*!< 样本方差，count<2时为0 */
+} SampleStats_t;
+
+//累加器(全部是整数，写入时不做浮点运算，累加结果精确；
+//平方和相对桶内第一个样本累计，大偏置小波动时读取计算方差不会抵消掉有效位，
+//每项不超过2^64，低64位溢出时进位到sq_hi)
+typedef struct {
+	int64_t  start_us;
+	uint32_t count;
+	int32_t  min;
+	int32_t  max;
+	int32_t  shift;                 /*!< 第一个样本 */
+	int64_t  sum;                   /*!< 样本和 */
+	uint64_t sq_lo;                 /*!< (样本-shift)的平方和，低64位 */
+	uint32_t sq_hi;                 /*!< 平方和的进位 */
+} SampleRing_Acc_t;
+
+//环形缓冲区，由调用者静态分配
+typedef struct {
+	SensorSample_t slots[SAMPLE_RING_LEN];
+	volatile uint32_t stamp[SAMPLE_RING_LEN];           /*!< 槽内样本序号+1，0表示正在写 */
+	volatile uint32_t head;                             /*!< 已写入的样本总数 */
+	volatile uint32_t stats_seq;                        /*!< 统计的版本号，奇数表示正在更新 */
+	SampleRing_Acc_t total;
+	SampleRing_Acc_t cur[SAMPLE_RING_LEVELS];
+	SampleStats_t hist[SAMPLE_RING_LEVELS][SAMPLE_RING_HIST_LEN];
+	uint8_t hist_next[SAMPLE_RING_LEVELS];
+	uint8_t hist_count[SAMPLE_RING_LEVELS];
+} SampleRing_t;
+
+//消费者读位置
+typedef struct {
+	uint32_t next;                  /*!< 下一个要读的样本序号 */
+	uint32_t lost;                  /*!< 读得太慢被覆盖的样本数 */
+} SampleRing_Reader_t;
+
+
+void SampleRing_Init(SampleRing_t *ring);
+void SampleRing_Push(SampleRing_t *ring, int64_t time_us, int32_t value);
+void SampleRing_ReaderInit(SampleRing_t *ring, SampleRing_Reader_t *reader, bool from_oldest);
+bool SampleRing_Read(SampleRing_t *ring, SampleRing_Reader_t *reader, SensorSample_t *out);
+bool SampleRing_GetTotal(SampleRing_t *ring, SampleStats_t *stats);
+bool SampleRing_GetCurrent(SampleRing_t *ring, SAMPLE_RING_LEVEL_t level, SampleStats_t *stats);
+bool SampleRing_GetBucket(SampleRing_t *ring, SAMPLE_RING_LEVEL_t level, uint8_t age, SampleStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,116 @@
+/*
+* @file         sensor_pipe.h
+* @brief        传感器数据定点处理流水线
+* @details      原始值依次经过若干级处理(校准、EMA、中值、卡尔曼)，最后做迟滞阈值和
+*               变化检测，只有越过阈值或变化超过设定值时才回调通知消费者；全部为整数运算
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef SENSOR_PIPE_H
+#define SENSOR_PIPE_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define SENSOR_PIPE_MAX_STAGES      4                   //每条流水线最多的处理级数
+#define SENSOR_MEDIAN_MAX           7                   //中值滤波最大窗口
+#define SENSOR_Q16(x)               ((int32_t)((x) * 65536.0 + 0.5))   //常数转Q16，只用于编译期常量
+
+//处理级类型
+typedef enum {
+	SENSOR_STAGE_CALIB = 0,         /*!< y = x*gain + offset */
+	SENSOR_STAGE_EMA,               /*!< 指数滑动平均，系数1/2^shift */
+	SENSOR_STAGE_MEDIAN,            /*!< 滑动中值，去尖峰 */
+	SENSOR_STAGE_KALMAN,            /*!< 一维随机游走模型卡尔曼 */
+} SENSOR_STAGE_t;
+
+//事件标志
+#define SENSOR_EVENT_CHANGE         0x01                //与上次通知的值相差超过change_delta
+#define SENSOR_EVENT_RISE           0x02                //升到高阈值以上
+#define SENSOR_EVENT_FALL           0x04                //降到低阈值以下
+
+//事件
+typedef struct {
+	uint8_t flags;                  /*!< SENSOR_EVENT_xxx的组合 */
+	bool above;                     /*!< 当前是否处于高状态(迟滞) */
+	int32_t value;                  /*!< 处理后的值 */
+	int64_t time_us;
+} SensorEvent_t;
+
+//处理级
+typedef struct {
+	SENSOR_STAGE_t type;
+	union {
+		struct {
+			int32_t gain_q16;       /*!< 增益，Q16 */
+			int32_t offset;
+		} calib;
+		struct {
+			uint8_t shift;
+			bool primed;
+			int64_t acc_q8;         /*!< 累加值，Q8保留小数 */
+		} ema;
+		struct {
+			uint8_t len;
+			uint8_t pos;
+			uint8_t count;
+			int32_t buf[SENSOR_MEDIAN_MAX];
+		} median;
+		struct {
+			int64_t q;              /*!< 过程噪声方差(值的平方) */
+			int64_t r;              /*!< 测量噪声方差 */
+			int64_t p;              /*!< 估计误差方差 */
+			int32_t x;              /*!< 估计值 */
+			bool primed;
+		} kalman;
+	};
+} SensorStage_t;
+
+//事件回调，在调用SensorPipe_Process的任务中执行
+typedef void (*SensorPipe_Callback_t)(const SensorEvent_t *event, void *arg);
+
+//流水线
+typedef struct {
+	SensorStage_t stages[SENSOR_PIPE_MAX_STAGES];
+	uint8_t count;
+	int32_t thr_low;                /*!< 迟滞低阈值 */
+	int32_t thr_high;               /*!< 迟滞高阈值，thr_high<=thr_low时不做阈值检测 */
+	bool above;
+	int32_t change_delta;           /*!< 变化检测门限，0时不做变化检测 */
+	int32_t last_reported;
+	bool reported;
+	SensorPipe_Callback_t callback;
+	void *arg;
+} SensorPipe_t;
+
+
+void SensorPipe_Init(SensorPipe_t *pipe);
+bool SensorPipe_AddCalib(SensorPipe_t *pipe, int32_t gain_q16, int32_t offset);
+bool SensorPipe_AddEma(SensorPipe_t *pipe, uint8_t shift);
+bool SensorPipe_AddMedian(SensorPipe_t *pipe, uint8_t len);
+bool SensorPipe_AddKalman(SensorPipe_t *pipe, int64_t q, int64_t r);
+void SensorPipe_SetHysteresis(SensorPipe_t *pipe, int32_t low, int32_t high);
+void SensorPipe_SetChangeDelta(SensorPipe_t *pipe, int32_t delta);
+void SensorPipe_SetCallback(SensorPipe_t *pipe, SensorPipe_Callback_t callback, void *arg);
+int32_t SensorPipe_Process(SensorPipe_t *pipe, int64_t time_us, int32_t raw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,390 @@
+/*
+* @file         sample_ring.c
+* @brief        传感器样本环形缓冲区
+* @details      样本槽和统计都用序号校验代替锁:生产者先作废、再写数据、最后写序号，
+*               消费者拷贝前后各读一次序号，不一致说明读的过程中被覆盖，丢弃重读；
+*               只允许一个生产者，消费者之间互不影响
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "sample_ring.h"
+#include "string.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define SAMPLE_RING_MASK        (SAMPLE_RING_LEN - 1)
+//内存屏障:双核下保证数据和序号的写入/读取顺序
+#define SAMPLE_RING_BARRIER()   __sync_synchronize()
+
+//各级分桶长度(us)
+static const int64_t g_bucket_us[SAMPLE_RING_LEVELS] = {
+    1000000LL,
+    60 * 1000000LL,
+    3600 * 1000000LL,
+};
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 累加器清零并从start_us开始
+ * @param[out]  acc        累加器
+ * @param[in]   start_us   起始时刻
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void acc_reset(SampleRing_Acc_t *acc, int64_t start_us)
+{
+    memset(acc, 0, sizeof(*acc));
+    acc->start_us = start_us;
+}
+
+/**
+ * 累加一个样本，只做整数运算
+ * @param[in,out]   acc     累加器
+ * @param[in]       value   样本值
+ * @retval          无
+ * @par             修改日志
+ *                   Ver0.0.1:
+                         Caesar, 2026/10/19, 初始化版本\n
+ *                   Ver0.0.2:
+                         Caesar, 2026/10/19, 均值和m2改用双精度\n
+ *                   Ver0.0.3:
+                         Caesar, 2026/10/19, 改为整数累加和与平方和，方差在读取时计算\n
+ */
+static void acc_add(SampleRing_Acc_t *acc, int32_t value)
+{
+    int64_t delta;
+    uint64_t sq;
+
+    if (acc->count == 0)
+    {
+        acc->min = value;
+        acc->max = value;
+        acc->shift = value;
+    }
+    else
+    {
+        if (value < acc->min) acc->min = value;
+        if (value > acc->max) acc->max = value;
+    }
+    acc->count ++;
+    acc->sum += value;
+    //|delta|<2^32，平方用无符号数不会溢出
+    delta = (int64_t)value - acc->shift;
+    sq = (uint64_t)(delta < 0 ? -delta : delta);
+    sq *= sq;
+    acc->sq_lo += sq;
+    if (acc->sq_lo < sq)
+    {
+        acc->sq_hi ++;
+    }
+}
+
+/**
+ * 累加器转换为统计结果，由读者调用(分桶完成时由生产者调用一次)
+ * 方差 = (Σd² - (Σd)²/n) / (n-1)，d为样本减第一个样本
+ * @param[in]   acc     累加器
+ * @param[out]  stats   统计结果
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 由整数和与平方和计算均值和方差\n
+ */
+static void acc_to_stats(const SampleRing_Acc_t *acc, SampleStats_t *stats)
+{
+    double s1, s2, var;
+
+    stats->start_us = acc->start_us;
+    stats->count = acc->count;
+    stats->min = acc->min;
+    stats->max = acc->max;
+    stats->mean = acc->count ? (float)((double)acc->sum / acc->count) : 0.0f;
+    stats->var = 0.0f;
+    if (acc->count > 1)
+    {
+        s1 = (double)(acc->sum - (int64_t)acc->count * acc->shift);
+        s2 = (double)acc->sq_hi * 18446744073709551616.0 + (double)acc->sq_lo;
+        var = (s2 - s1 * s1 / acc->count) / (acc->count - 1);
+        stats->var = (var > 0) ? (float)var : 0.0f;
+    }
+}
+
+/**
+ * 初始化环形缓冲区(生产者和消费者开始使用之前调用)
+ * @param[out]  ring   缓冲区
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SampleRing_Init(SampleRing_t *ring)
+{
+    memset(ring, 0, sizeof(*ring));
+}
+
+/**
+ * 写入一个样本并更新统计，只能由一个任务调用，不阻塞
+ * 跨过分桶边界时把当前桶存入历史，新桶从对齐的边界开始，中间没有样本的桶不记录
+ * @param[in]   ring      缓冲区
+ * @param[in]   time_us   采样时刻
+ * @param[in]   value     样本值
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SampleRing_Push(SampleRing_t *ring, int64_t time_us, int32_t value)
+{
+    uint32_t seq = ring->head;
+    uint32_t idx = seq & SAMPLE_RING_MASK;
+    SampleRing_Acc_t *acc;
+    uint8_t level;
+
+    //样本槽:先作废，再写数据，最后写序号
+    ring->stamp[idx] = 0;
+    SAMPLE_RING_BARRIER();
+    ring->slots[idx].seq = seq;
+    ring->slots[idx].time_us = time_us;
+    ring->slots[idx].value = value;
+    SAMPLE_RING_BARRIER();
+    ring->stamp[idx] = seq + 1;
+    SAMPLE_RING_BARRIER();
+    ring->head = seq + 1;
+
+    //统计:版本号为奇数期间读者重试
+    ring->stats_seq ++;
+    SAMPLE_RING_BARRIER();
+    if (ring->total.count == 0)
+    {
+        ring->total.start_us = time_us;
+    }
+    acc_add(&ring->total, value);
+    for (level = 0; level < SAMPLE_RING_LEVELS; level ++)
+    {
+        acc = &ring->cur[level];
+        if (acc->count && time_us - acc->start_us >= g_bucket_us[level])
+        {
+            acc_to_stats(acc, &ring->hist[level][ring->hist_next[level]]);
+            ring->hist_next[level] = (ring->hist_next[level] + 1) % SAMPLE_RING_HIST_LEN;
+            if (ring->hist_count[level] < SAMPLE_RING_HIST_LEN)
+            {
+                ring->hist_count[level] ++;
+            }
+            acc->count = 0;
+        }
+        if (acc->count == 0)
+        {
+            acc_reset(acc, time_us - time_us % g_bucket_us[level]);
+        }
+        acc_add(acc, value);
+    }
+    SAMPLE_RING_BARRIER();
+    ring->stats_seq ++;
+}
+
+/**
+ * 初始化消费者读位置
+ * @param[in]   ring          缓冲区
+ * @param[out]  reader        读位置
+ * @param[in]   from_oldest   1:从缓冲区中最旧的样本开始 0:只读之后写入的样本
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SampleRing_ReaderInit(SampleRing_t *ring, SampleRing_Reader_t *reader, bool from_oldest)
+{
+    uint32_t head = ring->head;
+
+    reader->lost = 0;
+    reader->next = head;
+    if (from_oldest)
+    {
+        reader->next = (head > SAMPLE_RING_LEN) ? head - SAMPLE_RING_LEN : 0;
+    }
+}
+
+/**
+ * 读取下一个样本，不阻塞；读得太慢被覆盖时跳到最旧的有效样本并累计lost
+ * @param[in]       ring     缓冲区
+ * @param[in,out]   reader   读位置
+ * @param[out]      out      样本
+ * @retval
+ *                  - 1 读到样本
+ *                  - 0 没有新样本
+ * @par             修改日志
+ *                   Ver0.0.1:
+                         Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SampleRing_Read(SampleRing_t *ring, SampleRing_Reader_t *reader, SensorSample_t *out)
+{
+    uint32_t head, idx, stamp;
+
+    while (1)
+    {
+        head = ring->head;
+        SAMPLE_RING_BARRIER();
+        if (reader->next == head)
+        {
+            return 0;
+        }
+        if (head - reader->next > SAMPLE_RING_LEN)
+        {
+            reader->lost += head - reader->next - SAMPLE_RING_LEN;
+            reader->next = head - SAMPLE_RING_LEN;
+        }
+        idx = reader->next & SAMPLE_RING_MASK;
+        stamp = ring->stamp[idx];
+        SAMPLE_RING_BARRIER();
+        *out = ring->slots[idx];
+        SAMPLE_RING_BARRIER();
+        if (stamp == reader->next + 1 && ring->stamp[idx] == stamp)
+        {
+            reader->next ++;
+            return 1;
+        }
+        //拷贝期间被生产者覆盖，重新按head定位
+        reader->lost ++;
+        reader->next ++;
+    }
+}
+
+/**
+ * 按版本号读取一段统计，与写入冲突时重试
+ * @param[in]   ring   缓冲区
+ * @param[in]   src    统计所在位置
+ * @param[out]  dst    拷贝目标
+ * @param[in]   size   字节数
+ * @retval
+ *              - 1 成功
+ *              - 0 重试SAMPLE_RING_READ_RETRY次仍冲突
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static bool ring_read_stats(SampleRing_t *ring, const void *src, void *dst, uint32_t size)
+{
+    uint32_t v1;
+    uint8_t i;
+
+    for (i = 0; i < SAMPLE_RING_READ_RETRY; i ++)
+    {
+        v1 = ring->stats_seq;
+        SAMPLE_RING_BARRIER();
+        if (v1 & 1)
+        {
+            continue;
+        }
+        memcpy(dst, src, size);
+        SAMPLE_RING_BARRIER();
+        if (ring->stats_seq == v1)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * 读取全程统计
+ * @param[in]   ring    缓冲区
+ * @param[out]  stats   统计结果
+ * @retval
+ *              - 1 成功
+ *              - 0 与写入冲突，稍后再读
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SampleRing_GetTotal(SampleRing_t *ring, SampleStats_t *stats)
+{
+    SampleRing_Acc_t acc;
+
+    if (!ring_read_stats(ring, &ring->total, &acc, sizeof(acc)))
+    {
+        return 0;
+    }
+    acc_to_stats(&acc, stats);
+    return 1;
+}
+
+/**
+ * 读取某一级正在累计(未完成)的分桶
+ * @param[in]   ring    缓冲区
+ * @param[in]   level   分桶级别
+ * @param[out]  stats   统计结果
+ * @retval
+ *              - 1 成功
+ *              - 0 与写入冲突，稍后再读
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SampleRing_GetCurrent(SampleRing_t *ring, SAMPLE_RING_LEVEL_t level, SampleStats_t *stats)
+{
+    SampleRing_Acc_t acc;
+
+    if (!ring_read_stats(ring, &ring->cur[level], &acc, sizeof(acc)))
+    {
+        return 0;
+    }
+    acc_to_stats(&acc, stats);
+    return 1;
+}
+
+/**
+ * 读取某一级已完成的分桶
+ * @param[in]   ring    缓冲区
+ * @param[in]   level   分桶级别
+ * @param[in]   age     0为最近完成的一个，依次往前
+ * @param[out]  stats   统计结果
+ * @retval
+ *              - 1 成功
+ *              - 0 没有这么多历史，或与写入冲突
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SampleRing_GetBucket(SampleRing_t *ring, SAMPLE_RING_LEVEL_t level, uint8_t age, SampleStats_t *stats)
+{
+    uint32_t v1;
+    uint8_t i, idx;
+
+    for (i = 0; i < SAMPLE_RING_READ_RETRY; i ++)
+    {
+        v1 = ring->stats_seq;
+        SAMPLE_RING_BARRIER();
+        if (v1 & 1)
+        {
+            continue;
+        }
+        if (age >= ring->hist_count[level])
+        {
+            return 0;
+        }
+        idx = (ring->hist_next[level] + SAMPLE_RING_HIST_LEN - 1 - age) % SAMPLE_RING_HIST_LEN;
+        *stats = ring->hist[level][idx];
+        SAMPLE_RING_BARRIER();
+        if (ring->stats_seq == v1)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
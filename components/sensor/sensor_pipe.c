@@ -0,0 +1,373 @@
+/*
+* @file         sensor_pipe.c
+* @brief        传感器数据定点处理流水线
+* @details      增益用Q16，EMA累加值用Q8，卡尔曼增益用Q16、方差用int64，
+*               不使用浮点，与其它任务争用FPU时也不会增加开销
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "sensor_pipe.h"
+#include "string.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define KALMAN_P_MAX        (1LL << 46)         //限制p，保证(p<<16)不溢出
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 初始化流水线(无处理级、不做阈值和变化检测)
+ * @param[out]  pipe   流水线
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SensorPipe_Init(SensorPipe_t *pipe)
+{
+    memset(pipe, 0, sizeof(*pipe));
+}
+
+/**
+ * 追加一个处理级
+ * @param[in]   pipe   流水线
+ * @param[in]   type   类型
+ * @retval
+ *              新处理级，已满时为NULL
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static SensorStage_t *pipe_add(SensorPipe_t *pipe, SENSOR_STAGE_t type)
+{
+    SensorStage_t *st;
+
+    if (pipe->count >= SENSOR_PIPE_MAX_STAGES)
+    {
+        return NULL;
+    }
+    st = &pipe->stages[pipe->count ++];
+    memset(st, 0, sizeof(*st));
+    st->type = type;
+    return st;
+}
+
+/**
+ * 追加校准级 y = x*gain + offset
+ * @param[in]   pipe       流水线
+ * @param[in]   gain_q16   增益(Q16，1.0为65536，可用SENSOR_Q16)
+ * @param[in]   offset     偏移
+ * @retval      1成功 0处理级已满
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SensorPipe_AddCalib(SensorPipe_t *pipe, int32_t gain_q16, int32_t offset)
+{
+    SensorStage_t *st = pipe_add(pipe, SENSOR_STAGE_CALIB);
+    if (st == NULL)
+    {
+        return 0;
+    }
+    st->calib.gain_q16 = gain_q16;
+    st->calib.offset = offset;
+    return 1;
+}
+
+/**
+ * 追加EMA级，系数1/2^shift(shift=3约等于8个样本的时间常数)
+ * @param[in]   pipe    流水线
+ * @param[in]   shift   1~15
+ * @retval      1成功 0处理级已满或参数错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SensorPipe_AddEma(SensorPipe_t *pipe, uint8_t shift)
+{
+    SensorStage_t *st;
+
+    if (shift == 0 || shift > 15)
+    {
+        return 0;
+    }
+    st = pipe_add(pipe, SENSOR_STAGE_EMA);
+    if (st == NULL)
+    {
+        return 0;
+    }
+    st->ema.shift = shift;
+    return 1;
+}
+
+/**
+ * 追加滑动中值级
+ * @param[in]   pipe   流水线
+ * @param[in]   len    窗口长度，奇数，3~SENSOR_MEDIAN_MAX
+ * @retval      1成功 0处理级已满或参数错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SensorPipe_AddMedian(SensorPipe_t *pipe, uint8_t len)
+{
+    SensorStage_t *st;
+
+    if (len < 3 || len > SENSOR_MEDIAN_MAX || (len & 1) == 0)
+    {
+        return 0;
+    }
+    st = pipe_add(pipe, SENSOR_STAGE_MEDIAN);
+    if (st == NULL)
+    {
+        return 0;
+    }
+    st->median.len = len;
+    return 1;
+}
+
+/**
+ * 追加一维卡尔曼级(状态为随机游走)
+ * @param[in]   pipe   流水线
+ * @param[in]   q      过程噪声方差，越大跟踪越快
+ * @param[in]   r      测量噪声方差，越大越平滑
+ * @retval      1成功 0处理级已满或参数错误
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool SensorPipe_AddKalman(SensorPipe_t *pipe, int64_t q, int64_t r)
+{
+    SensorStage_t *st;
+
+    if (q < 0 || r <= 0)
+    {
+        return 0;
+    }
+    st = pipe_add(pipe, SENSOR_STAGE_KALMAN);
+    if (st == NULL)
+    {
+        return 0;
+    }
+    st->kalman.q = q;
+    st->kalman.r = r;
+    return 1;
+}
+
+/**
+ * 设置迟滞阈值:升到high以上产生RISE，之后降到low以下才产生FALL
+ * @param[in]   pipe   流水线
+ * @param[in]   low    低阈值
+ * @param[in]   high   高阈值，不大于low时关闭阈值检测
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SensorPipe_SetHysteresis(SensorPipe_t *pipe, int32_t low, int32_t high)
+{
+    pipe->thr_low = low;
+    pipe->thr_high = high;
+    pipe->above = 0;
+}
+
+/**
+ * 设置变化检测门限:与上次通知的值相差达到delta时产生CHANGE
+ * @param[in]   pipe    流水线
+ * @param[in]   delta   门限，0关闭
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SensorPipe_SetChangeDelta(SensorPipe_t *pipe, int32_t delta)
+{
+    pipe->change_delta = delta;
+    pipe->reported = 0;
+}
+
+/**
+ * 设置事件回调
+ * @param[in]   pipe       流水线
+ * @param[in]   callback   回调，可为NULL
+ * @param[in]   arg        回调参数
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void SensorPipe_SetCallback(SensorPipe_t *pipe, SensorPipe_Callback_t callback, void *arg)
+{
+    pipe->callback = callback;
+    pipe->arg = arg;
+}
+
+/**
+ * 滑动中值:新值写入环形窗口，对窗口做插入排序取中间值(窗口很小)
+ * @param[in,out]   st   中值级
+ * @param[in]       x    输入
+ * @retval          输出
+ * @par             修改日志
+ *                   Ver0.0.1:
+                         Caesar, 2026/10/19, 初始化版本\n
+ */
+static int32_t stage_median(SensorStage_t *st, int32_t x)
+{
+    int32_t sorted[SENSOR_MEDIAN_MAX];
+    int32_t v;
+    uint8_t i, j;
+
+    st->median.buf[st->median.pos] = x;
+    st->median.pos = (st->median.pos + 1) % st->median.len;
+    if (st->median.count < st->median.len)
+    {
+        st->median.count ++;
+    }
+    for (i = 0; i < st->median.count; i ++)
+    {
+        v = st->median.buf[i];
+        for (j = i; j > 0 && sorted[j - 1] > v; j --)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = v;
+    }
+    return sorted[st->median.count / 2];
+}
+
+/**
+ * 卡尔曼:预测p+=q，增益k=p/(p+r)(Q16)，x+=k*(z-x)，p*=(1-k)
+ * @param[in,out]   st   卡尔曼级
+ * @param[in]       z    测量值
+ * @retval          估计值
+ * @par             修改日志
+ *                   Ver0.0.1:
+                         Caesar, 2026/10/19, 初始化版本\n
+ */
+static int32_t stage_kalman(SensorStage_t *st, int32_t z)
+{
+    int64_t k_q16;
+
+    if (!st->kalman.primed)
+    {
+        st->kalman.x = z;
+        st->kalman.p = st->kalman.r;
+        st->kalman.primed = 1;
+        return z;
+    }
+    st->kalman.p += st->kalman.q;
+    if (st->kalman.p > KALMAN_P_MAX)
+    {
+        st->kalman.p = KALMAN_P_MAX;
+    }
+    k_q16 = (st->kalman.p << 16) / (st->kalman.p + st->kalman.r);
+    st->kalman.x += (int32_t)((k_q16 * ((int64_t)z - st->kalman.x)) >> 16);
+    st->kalman.p = ((65536 - k_q16) * st->kalman.p) >> 16;
+    return st->kalman.x;
+}
+
+/**
+ * 执行一个处理级
+ * @param[in,out]   st   处理级
+ * @param[in]       x    输入
+ * @retval          输出
+ * @par             修改日志
+ *                   Ver0.0.1:
+                         Caesar, 2026/10/19, 初始化版本\n
+ */
+static int32_t stage_run(SensorStage_t *st, int32_t x)
+{
+    switch (st->type)
+    {
+        case SENSOR_STAGE_CALIB:
+            return (int32_t)(((int64_t)x * st->calib.gain_q16) >> 16) + st->calib.offset;
+        case SENSOR_STAGE_EMA:
+            if (!st->ema.primed)
+            {
+                st->ema.acc_q8 = (int64_t)x << 8;
+                st->ema.primed = 1;
+            }
+            else
+            {
+                st->ema.acc_q8 += (((int64_t)x << 8) - st->ema.acc_q8) >> st->ema.shift;
+            }
+            return (int32_t)((st->ema.acc_q8 + 128) >> 8);
+        case SENSOR_STAGE_MEDIAN:
+            return stage_median(st, x);
+        case SENSOR_STAGE_KALMAN:
+            return stage_kalman(st, x);
+        default:
+            return x;
+    }
+}
+
+/**
+ * 处理一个原始值:依次经过各处理级，再做迟滞和变化检测，有事件时回调
+ * @param[in]   pipe      流水线
+ * @param[in]   time_us   采样时刻
+ * @param[in]   raw       原始值
+ * @retval      处理后的值
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+int32_t SensorPipe_Process(SensorPipe_t *pipe, int64_t time_us, int32_t raw)
+{
+    SensorEvent_t ev;
+    int32_t v = raw;
+    int32_t diff;
+    uint8_t i;
+
+    for (i = 0; i < pipe->count; i ++)
+    {
+        v = stage_run(&pipe->stages[i], v);
+    }
+
+    ev.flags = 0;
+    if (pipe->thr_high > pipe->thr_low)
+    {
+        if (!pipe->above && v >= pipe->thr_high)
+        {
+            pipe->above = 1;
+            ev.flags |= SENSOR_EVENT_RISE;
+        }
+        else if (pipe->above && v <= pipe->thr_low)
+        {
+            pipe->above = 0;
+            ev.flags |= SENSOR_EVENT_FALL;
+        }
+    }
+    if (pipe->change_delta > 0)
+    {
+        diff = v - pipe->last_reported;
+        if (!pipe->reported || diff >= pipe->change_delta || diff <= -pipe->change_delta)
+        {
+            ev.flags |= SENSOR_EVENT_CHANGE;
+        }
+    }
+    if (ev.flags)
+    {
+        pipe->last_reported = v;
+        pipe->reported = 1;
+        if (pipe->callback)
+        {
+            ev.above = pipe->above;
+            ev.value = v;
+            ev.time_us = time_us;
+            pipe->callback(&ev, pipe->arg);
+        }
+    }
+    return v;
+}
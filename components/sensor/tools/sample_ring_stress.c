@@ -0,0 +1,313 @@
+/*
+* @file         sample_ring_stress.c
+* @brief        sample_ring在PC上的并发压力测试
+* @details      一个生产者线程全速写入(值和时刻都由序号决定)，同时:
+*               1. 顺序读者:读到的样本完整且序号递增，读到的+丢失的正好等于写入的
+*               2. 慢读者:每读一个样本忙等一会儿，被覆盖时跳过并计入丢失，账目同样要对上
+*               3. 尾部读者:每次从最旧的样本开始只读一个，正是生产者下一个要覆盖的槽，
+*                  走读取期间被覆盖(序号校验不一致)的路径，读到的样本不能是半新半旧的
+*               4. 统计读者:反复读全程和1s分桶的统计，每次读到的都必须是某一时刻的完整快照
+*               另外单线程校验1h分桶(5Hz约1.8万个样本、大偏置小波动)的方差精度，
+*               以及样本在int32两端来回跳变(平方和超过64位)时的均值和方差
+*               编译: gcc -O2 -pthread -I../include sample_ring_stress.c ../sample_ring.c -lm -o sample_ring_stress
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+#include "sample_ring.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define STRESS_SAMPLES              10000000            //压力测试写入的样本数
+#define SAMPLE_US                   1000                //样本间隔，1s分桶1000个样本
+#define SLOW_SPIN                   2000                //慢读者每个样本后的忙等次数
+#define PRECISION_SAMPLES           18000               //1h分桶在5Hz下的样本数
+#define PRECISION_OFFSET            50000000            //5万lx(单位0.001lx)
+#define PRECISION_SPREAD            2000                //波动范围±2lx
+#define PRECISION_MAX_ERR           1e-6                //方差允许的相对误差(单精度m2约为7e-5)
+
+//读者线程的结果
+typedef struct {
+	const char *name;
+	uint64_t got;                   /*!< 读到的样本数 */
+	uint64_t bad;                   /*!< 内容与序号不符或序号不递增的样本数 */
+	uint64_t lost;                  /*!< 丢失的样本数 */
+	uint64_t expect;                /*!< 应当读到+丢失的样本数 */
+	uint64_t snapshots;             /*!< 统计读者:成功读到的快照数 */
+	uint64_t busy;                  /*!< 统计读者:与写入冲突放弃的次数 */
+} reader_result_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static SampleRing_t g_ring;
+static volatile int g_done;
+static volatile uint32_t g_spin_sink;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+//样本内容与序号是否一致
+static bool sample_ok(const SensorSample_t *s)
+{
+    return s->value == (int32_t)s->seq && s->time_us == (int64_t)s->seq * SAMPLE_US;
+}
+
+static void *producer(void *arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for (i = 0; i < STRESS_SAMPLES; i ++)
+    {
+        SampleRing_Push(&g_ring, (int64_t)i * SAMPLE_US, (int32_t)i);
+    }
+    g_done = 1;
+    return NULL;
+}
+
+//顺序读者和慢读者:读到生产者结束且读空为止
+static void *seq_reader(void *arg)
+{
+    reader_result_t *r = arg;
+    SampleRing_Reader_t reader;
+    SensorSample_t s;
+    uint32_t start, spin;
+    int64_t last = -1;
+    int done;
+    bool slow = (strcmp(r->name, "slow") == 0);
+
+    SampleRing_ReaderInit(&g_ring, &reader, 1);
+    start = reader.next;
+    do
+    {
+        done = g_done;
+        while (SampleRing_Read(&g_ring, &reader, &s))
+        {
+            if (!sample_ok(&s) || (int64_t)s.seq <= last)
+            {
+                r->bad ++;
+            }
+            last = s.seq;
+            r->got ++;
+            for (spin = 0; slow && spin < SLOW_SPIN; spin ++)
+            {
+                g_spin_sink ++;
+            }
+        }
+    } while (!done);
+    r->lost = reader.lost;
+    r->expect = STRESS_SAMPLES - start;
+    return NULL;
+}
+
+//尾部读者:每次从最旧的样本开始只读一个
+static void *tail_reader(void *arg)
+{
+    reader_result_t *r = arg;
+    SampleRing_Reader_t reader;
+    SensorSample_t s;
+
+    while (!g_done)
+    {
+        SampleRing_ReaderInit(&g_ring, &reader, 1);
+        if (SampleRing_Read(&g_ring, &reader, &s))
+        {
+            r->bad += !sample_ok(&s);
+            r->got ++;
+        }
+        r->lost += reader.lost;
+    }
+    return NULL;
+}
+
+//统计读者:值等于序号，count个连续样本的min/max/均值由第一个样本唯一确定
+static bool stats_ok(const SampleStats_t *st, uint32_t first)
+{
+    double mean = first + (st->count - 1) / 2.0;
+
+    if (st->count == 0)
+    {
+        return 1;
+    }
+    return st->min == (int32_t)first && st->max == (int32_t)(first + st->count - 1) &&
+           fabs(st->mean - mean) <= mean * 1e-6 + 0.5;
+}
+
+static void *stats_reader(void *arg)
+{
+    reader_result_t *r = arg;
+    SampleStats_t st;
+
+    while (!g_done)
+    {
+        if (SampleRing_GetTotal(&g_ring, &st))
+        {
+            r->bad += !stats_ok(&st, 0);
+            r->snapshots ++;
+        }
+        else
+        {
+            r->busy ++;
+        }
+        if (SampleRing_GetCurrent(&g_ring, SAMPLE_RING_LEVEL_1S, &st))
+        {
+            r->bad += !stats_ok(&st, (uint32_t)(st.start_us / SAMPLE_US)) || st.count > 1000000 / SAMPLE_US;
+            r->snapshots ++;
+        }
+        else
+        {
+            r->busy ++;
+        }
+    }
+    return NULL;
+}
+
+static int stress(void)
+{
+    reader_result_t results[] = {
+        {.name = "seq"}, {.name = "slow"}, {.name = "tail"}, {.name = "stats"},
+    };
+    void *(*fn[])(void *) = {seq_reader, seq_reader, tail_reader, stats_reader};
+    pthread_t threads[4], prod;
+    reader_result_t *r;
+    int errors = 0, i;
+
+    SampleRing_Init(&g_ring);
+    g_done = 0;
+    for (i = 0; i < 4; i ++)
+    {
+        pthread_create(&threads[i], NULL, fn[i], &results[i]);
+    }
+    pthread_create(&prod, NULL, producer, NULL);
+    pthread_join(prod, NULL);
+    for (i = 0; i < 4; i ++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < 4; i ++)
+    {
+        r = &results[i];
+        if (fn[i] == seq_reader)
+        {
+            printf("%-5s reader: got %llu, lost %llu, got+lost %llu of %llu, bad %llu\n", r->name,
+                   (unsigned long long)r->got, (unsigned long long)r->lost,
+                   (unsigned long long)(r->got + r->lost), (unsigned long long)r->expect,
+                   (unsigned long long)r->bad);
+            if (r->got + r->lost != r->expect)
+            {
+                printf("  %s reader: lost-sample accounting is off\n", r->name);
+                errors ++;
+            }
+        }
+        else if (fn[i] == tail_reader)
+        {
+            printf("tail  reader: %llu reads, %llu overwritten before or during the read, bad %llu\n",
+                   (unsigned long long)r->got, (unsigned long long)r->lost, (unsigned long long)r->bad);
+            if (r->lost == 0)
+            {
+                printf("  note: overwrite-while-reading path was not hit (single core?)\n");
+            }
+        }
+        else
+        {
+            printf("stats reader: %llu snapshots, %llu busy, bad %llu\n",
+                   (unsigned long long)r->snapshots, (unsigned long long)r->busy, (unsigned long long)r->bad);
+        }
+        if (r->bad)
+        {
+            printf("  %s reader saw %llu torn or out-of-order results\n", r->name, (unsigned long long)r->bad);
+            errors ++;
+        }
+    }
+    if (results[1].lost == 0)
+    {
+        printf("  slow reader never fell behind, overwrite path not covered\n");
+        errors ++;
+    }
+    return errors;
+}
+
+//1h分桶的方差精度:与双精度两遍算法的结果比较
+static int precision(void)
+{
+    static int32_t values[PRECISION_SAMPLES];
+    SampleStats_t st;
+    double mean = 0, var = 0, err;
+    uint32_t seed = 1, i;
+
+    SampleRing_Init(&g_ring);
+    for (i = 0; i < PRECISION_SAMPLES; i ++)
+    {
+        seed = seed * 1103515245 + 12345;
+        values[i] = PRECISION_OFFSET + (int32_t)((seed >> 8) % (2 * PRECISION_SPREAD + 1)) - PRECISION_SPREAD;
+        SampleRing_Push(&g_ring, (int64_t)i * 200000, values[i]);
+        mean += values[i];
+    }
+    mean /= PRECISION_SAMPLES;
+    for (i = 0; i < PRECISION_SAMPLES; i ++)
+    {
+        var += (values[i] - mean) * (values[i] - mean);
+    }
+    var /= PRECISION_SAMPLES - 1;
+
+    SampleRing_GetCurrent(&g_ring, SAMPLE_RING_LEVEL_1H, &st);
+    err = fabs(st.var - var) / var;
+    printf("1h bucket: %u samples around %d, var %.1f (two-pass %.1f), relative error %.2e, %s\n",
+           st.count, PRECISION_OFFSET, st.var, var, err, err <= PRECISION_MAX_ERR ? "ok" : "FAILED");
+    return (st.count != PRECISION_SAMPLES || err > PRECISION_MAX_ERR) ? 1 : 0;
+}
+
+//样本在INT32_MIN/INT32_MAX之间交替:平方和每两项就超过2^64，检查进位
+static int extremes(void)
+{
+    SampleStats_t st;
+    double mean, var, err;
+    uint32_t i;
+
+    SampleRing_Init(&g_ring);
+    for (i = 0; i < PRECISION_SAMPLES; i ++)
+    {
+        SampleRing_Push(&g_ring, (int64_t)i * 200000, (i & 1) ? INT32_MAX : INT32_MIN);
+    }
+    //一半INT32_MIN一半INT32_MAX:均值-0.5，每个样本偏离均值2^31-0.5
+    mean = -0.5;
+    var = (2147483648.0 - 0.5) * (2147483648.0 - 0.5) * PRECISION_SAMPLES / (PRECISION_SAMPLES - 1);
+    SampleRing_GetCurrent(&g_ring, SAMPLE_RING_LEVEL_1H, &st);
+    err = fabs(st.var - var) / var;
+    printf("extremes: mean %.1f, var %.4e (expected %.4e), relative error %.2e, %s\n",
+           st.mean, st.var, var, err, (fabs(st.mean - mean) < 1 && err <= PRECISION_MAX_ERR) ? "ok" : "FAILED");
+    return (st.min != INT32_MIN || st.max != INT32_MAX || fabs(st.mean - mean) >= 1 ||
+            err > PRECISION_MAX_ERR) ? 1 : 0;
+}
+
+int main(void)
+{
+    int errors = 0;
+
+    errors += stress();
+    errors += precision();
+    errors += extremes();
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
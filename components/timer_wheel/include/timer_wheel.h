@@ -0,0 +1,101 @@
+/*
+* @file         timer_wheel.h
+* @brief        分层时间轮应用定时器
+* @details      大量单次/周期应用定时器共用一个esp_timer:定时器挂在4级、每级64槽的时间轮上，
+*               启动/停止都是O(1)，只在最近的到期或需要下放的槽到来时唤醒一次，空闲时不唤醒；
+*               回调在esp_timer任务中执行，必须不阻塞(不能vTaskDelay、不能等信号量)，
+*               需要"先做A、过一会做B"的逻辑写成在回调中启动下一个定时器(链式定时器)；
+*               每个定时器记录到期延迟和周期抖动，全局记录唤醒延迟和最长回调耗时，用来发现阻塞的回调
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define TIMER_WHEEL_TICK_US         1000                //时间轮刻度，到期时刻向上取整到刻度
+#define TIMER_WHEEL_LEVELS          4                   //级数
+#define TIMER_WHEEL_SLOT_BITS       6                   //每级64槽，4级共覆盖2^24个刻度(约4.6小时)
+#define TIMER_WHEEL_SLOTS           (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOW_CB_US      1000                //回调超过该时间计为慢回调
+
+typedef struct TimerWheel_Timer TimerWheel_Timer_t;
+
+//双向循环链表节点，每个槽一个表头
+typedef struct TimerWheel_Node {
+	struct TimerWheel_Node *next;
+	struct TimerWheel_Node *prev;
+} TimerWheel_Node_t;
+
+/**
+ * 定时器回调(esp_timer任务中执行，不能阻塞)
+ * @param[in]   timer   到期的定时器，回调中可以重新启动或停止它
+ * @param[in]   arg     TimerWheel_Setup传入的参数
+ */
+typedef void (*TimerWheel_Cb_t)(TimerWheel_Timer_t *timer, void *arg);
+
+//单个定时器的统计(us)
+typedef struct {
+	uint32_t runs;                  /*!< 回调次数 */
+	uint32_t skipped;               /*!< 周期定时器因来晚而跳过的周期数 */
+	uint32_t late_max;              /*!< 回调相对到期时刻的最大延迟 */
+	uint64_t late_sum;              /*!< 延迟总和，除以runs为平均延迟 */
+	uint32_t jitter_max;            /*!< 周期定时器相邻两次回调间隔与周期之差的最大绝对值 */
+} TimerWheel_TimerStats_t;
+
+//全局统计(us)
+typedef struct {
+	uint32_t wakes;                 /*!< 唤醒次数 */
+	uint32_t wake_late_max;         /*!< esp_timer唤醒相对预定时刻的最大延迟(反映esp_timer任务是否被其他回调占住) */
+	uint32_t cb_max;                /*!< 单个回调最长耗时 */
+	uint32_t slow_cbs;              /*!< 超过TIMER_WHEEL_SLOW_CB_US的回调次数 */
+	uint32_t cascades;              /*!< 从高级下放到低级的定时器数 */
+} TimerWheel_Stats_t;
+
+//定时器，由调用者静态分配，TimerWheel_Setup后使用，内部字段不要直接修改
+struct TimerWheel_Timer {
+	TimerWheel_Node_t node;         /*!< 必须是第一个成员 */
+	uint32_t expires;               /*!< 到期刻度 */
+	uint8_t level;                  /*!< 所在的级和槽 */
+	uint8_t slot;
+	bool active;
+	int64_t due_us;                 /*!< 到期时刻(已取整到刻度) */
+	uint32_t period_us;             /*!< 0为单次 */
+	int64_t last_us;                /*!< 上一次回调的时刻 */
+	TimerWheel_Cb_t cb;
+	void *arg;
+	TimerWheel_TimerStats_t stats;
+};
+
+
+esp_err_t TimerWheel_Init(void);
+void TimerWheel_Setup(TimerWheel_Timer_t *timer, TimerWheel_Cb_t cb, void *arg);
+esp_err_t TimerWheel_Start(TimerWheel_Timer_t *timer, uint32_t delay_ms, uint32_t period_ms);
+void TimerWheel_Stop(TimerWheel_Timer_t *timer);
+bool TimerWheel_Active(const TimerWheel_Timer_t *timer);
+void TimerWheel_GetTimerStats(TimerWheel_Timer_t *timer, TimerWheel_TimerStats_t *stats, bool reset);
+void TimerWheel_GetStats(TimerWheel_Stats_t *stats, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,613 @@
+/*
+* @file         timer_wheel.c
+* @brief        分层时间轮应用定时器
+* @details      第0级每槽一个刻度，第l级每槽64^l个刻度；定时器按剩余刻度数放到能容纳它的最低一级，
+*               刻度走到第l级某槽的起点时把该槽的定时器重新放到低级(下放)，第0级的槽到了就执行；
+*               每级用一个64位图记录非空槽，据此直接算出下一个要处理的刻度，空的刻度整段跳过，
+*               只为它设一次esp_timer单次唤醒，不按刻度周期唤醒；
+*               回调允许启动/停止任何定时器(互斥量可重入)，周期定时器按到期时刻而不是回调时刻重装，不会漂移
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include "timer_wheel.h"
+#include "string.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+/*
+===========================
+宏定义
+===========================
+*/
+#define TW_SLOT_MASK                (TIMER_WHEEL_SLOTS - 1)
+#define TW_SHIFT(l)                 ((l) * TIMER_WHEEL_SLOT_BITS)
+#define TW_RANGE                    (1UL << TW_SHIFT(TIMER_WHEEL_LEVELS))   //可直接放下的最大刻度数
+#define TW_DETACHED                 0xFF                //已取出等待执行，不在任何槽中
+#define TW_US_TO_TICK(us)           ((uint32_t)((us) / TIMER_WHEEL_TICK_US))
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static TimerWheel_Node_t g_tw_slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+static uint64_t g_tw_bitmap[TIMER_WHEEL_LEVELS];    //非空槽
+static uint32_t g_tw_tick = 0;                      //下一个要处理的刻度，之前的都已处理
+static SemaphoreHandle_t g_tw_lock = NULL;
+static esp_timer_handle_t g_tw_wake = NULL;
+static bool g_tw_armed = 0;
+static int64_t g_tw_wake_us = 0;                    //已设定的唤醒时刻
+static bool g_tw_in_run = 0;                        //正在执行到期处理，结束时统一设定唤醒
+static TimerWheel_Stats_t g_tw_stats;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+/**
+ * 从所在链表中取下定时器，所在槽空了时清位图
+ * @param[in]   t   定时器
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_unlink(TimerWheel_Timer_t *t)
+{
+    TimerWheel_Node_t *slot;
+
+    t->node.prev->next = t->node.next;
+    t->node.next->prev = t->node.prev;
+    t->node.next = t->node.prev = &t->node;
+    if (t->level != TW_DETACHED)
+    {
+        slot = &g_tw_slot[t->level][t->slot];
+        if (slot->next == slot)
+        {
+            g_tw_bitmap[t->level] &= ~(1ULL << t->slot);
+        }
+    }
+}
+
+/**
+ * 把链表尾接上节点
+ * @param[in]   head   表头
+ * @param[in]   node   节点
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_append(TimerWheel_Node_t *head, TimerWheel_Node_t *node)
+{
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+/**
+ * 把一个槽的整条链表移到local，槽变空
+ * @param[in]   slot    槽
+ * @param[out]  local   表头
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_detach(TimerWheel_Node_t *slot, TimerWheel_Node_t *local)
+{
+    if (slot->next == slot)
+    {
+        local->next = local->prev = local;
+        return;
+    }
+    local->next = slot->next;
+    local->prev = slot->prev;
+    local->next->prev = local;
+    local->prev->next = local;
+    slot->next = slot->prev = slot;
+}
+
+/**
+ * 按相对g_tw_tick的剩余刻度把定时器放到能容纳它的最低一级；超出范围的先放在最高级的最远处，下放时再放
+ * @param[in]   t   定时器，expires已设好
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_place(TimerWheel_Timer_t *t)
+{
+    uint32_t delta = t->expires - g_tw_tick;
+    uint32_t at = t->expires;
+    uint8_t l;
+
+    if ((int32_t)delta < 0)
+    {
+        delta = 0;
+        at = g_tw_tick;
+    }
+    if (delta >= TW_RANGE)
+    {
+        at = g_tw_tick + TW_RANGE - 1;
+        l = TIMER_WHEEL_LEVELS - 1;
+    }
+    else
+    {
+        for (l = 0; l < TIMER_WHEEL_LEVELS - 1; l ++)
+        {
+            if (delta < (1UL << TW_SHIFT(l + 1)))
+            {
+                break;
+            }
+        }
+    }
+    t->level = l;
+    t->slot = (at >> TW_SHIFT(l)) & TW_SLOT_MASK;
+    tw_append(&g_tw_slot[l][t->slot], &t->node);
+    g_tw_bitmap[l] |= 1ULL << t->slot;
+}
+
+/**
+ * 找g_tw_tick起下一个有事可做的刻度:第0级非空槽的到期刻度，或高级非空槽的下放刻度，取最早的
+ * @param[out]  tick   刻度
+ * @retval      是否有定时器
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static bool tw_next(uint32_t *tick)
+{
+    uint32_t t = g_tw_tick, base, cand, span;
+    uint64_t mask;
+    uint8_t l, cur, start;
+    bool found = 0;
+
+    for (l = 0; l < TIMER_WHEEL_LEVELS; l ++)
+    {
+        if (g_tw_bitmap[l] == 0)
+        {
+            continue;
+        }
+        cur = (t >> TW_SHIFT(l)) & TW_SLOT_MASK;
+        //当前槽只有在正好处于槽起点时才还没下放
+        start = (t & ((1UL << TW_SHIFT(l)) - 1)) ? cur + 1 : cur;
+        span = 1UL << TW_SHIFT(l + 1);          //本级转一圈的刻度数
+        base = t & ~(span - 1);
+        mask = (start < TIMER_WHEEL_SLOTS) ? g_tw_bitmap[l] & (~0ULL << start) : 0;
+        if (mask)
+        {
+            cand = base + ((uint32_t)__builtin_ctzll(mask) << TW_SHIFT(l));
+        }
+        else
+        {
+            cand = base + span + ((uint32_t)__builtin_ctzll(g_tw_bitmap[l]) << TW_SHIFT(l));
+        }
+        if (!found || (int32_t)(cand - *tick) < 0)
+        {
+            *tick = cand;
+            found = 1;
+        }
+    }
+    return found;
+}
+
+/**
+ * now_tick之前(含)没有需要处理的刻度时把g_tw_tick直接移到now_tick，新启动的定时器按当前时刻放置
+ * @param[in]   now_tick   当前刻度
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ *               Ver0.0.2:
+                     Caesar, 2026/10/19, 空闲超过2^31个刻度后刻度差会变负，时间轮为空时直接对齐\n
+ */
+static void tw_catch_up(uint32_t now_tick)
+{
+    uint32_t cand;
+
+    //没有定时器时不会唤醒，g_tw_tick可能落后任意多个刻度，不能按差值的符号判断先后
+    if (!tw_next(&cand))
+    {
+        g_tw_tick = now_tick;
+        return;
+    }
+    if ((int32_t)(now_tick - g_tw_tick) > 0 && (int32_t)(cand - now_tick) > 0)
+    {
+        g_tw_tick = now_tick;
+    }
+}
+
+/**
+ * 执行一个定时器的到期:周期定时器先按到期时刻重装(来晚时跳过错过的周期)，再调用回调并统计
+ * @param[in]   t   定时器(已从链表取下)
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_fire(TimerWheel_Timer_t *t)
+{
+    int64_t now = esp_timer_get_time();
+    uint32_t late = (now > t->due_us) ? (uint32_t)(now - t->due_us) : 0;
+    uint32_t jitter, spent;
+
+    t->stats.runs ++;
+    t->stats.late_sum += late;
+    if (late > t->stats.late_max)
+    {
+        t->stats.late_max = late;
+    }
+    if (t->period_us && t->last_us)
+    {
+        jitter = (now - t->last_us > t->period_us) ? (uint32_t)(now - t->last_us - t->period_us) :
+                                                     (uint32_t)(t->period_us - (now - t->last_us));
+        if (jitter > t->stats.jitter_max)
+        {
+            t->stats.jitter_max = jitter;
+        }
+    }
+    t->last_us = now;
+
+    if (t->period_us)
+    {
+        t->due_us += t->period_us;
+        while (t->due_us <= now)
+        {
+            t->due_us += t->period_us;
+            t->stats.skipped ++;
+        }
+        t->expires = TW_US_TO_TICK(t->due_us);
+        tw_place(t);
+    }
+    else
+    {
+        t->active = 0;
+    }
+
+    t->cb(t, t->arg);
+    spent = (uint32_t)(esp_timer_get_time() - now);
+    if (spent > g_tw_stats.cb_max)
+    {
+        g_tw_stats.cb_max = spent;
+    }
+    if (spent > TIMER_WHEEL_SLOW_CB_US)
+    {
+        g_tw_stats.slow_cbs ++;
+    }
+}
+
+/**
+ * 处理一个刻度:先下放起点正好在这个刻度的高级槽，再执行第0级的槽
+ * @param[in]   tick   刻度
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_process(uint32_t tick)
+{
+    TimerWheel_Node_t local;
+    TimerWheel_Timer_t *t;
+    uint8_t l, idx;
+
+    g_tw_tick = tick;
+    for (l = 1; l < TIMER_WHEEL_LEVELS; l ++)
+    {
+        if (tick & ((1UL << TW_SHIFT(l)) - 1))
+        {
+            break;
+        }
+        idx = (tick >> TW_SHIFT(l)) & TW_SLOT_MASK;
+        tw_detach(&g_tw_slot[l][idx], &local);
+        g_tw_bitmap[l] &= ~(1ULL << idx);
+        while (local.next != &local)
+        {
+            t = (TimerWheel_Timer_t *)local.next;
+            t->level = TW_DETACHED;
+            tw_unlink(t);
+            tw_place(t);
+            g_tw_stats.cascades ++;
+        }
+    }
+
+    idx = tick & TW_SLOT_MASK;
+    tw_detach(&g_tw_slot[0][idx], &local);
+    g_tw_bitmap[0] &= ~(1ULL << idx);
+    for (t = (TimerWheel_Timer_t *)local.next; &t->node != &local; t = (TimerWheel_Timer_t *)t->node.next)
+    {
+        t->level = TW_DETACHED;
+    }
+    //回调中新启动的定时器最早放到下一个刻度
+    g_tw_tick = tick + 1;
+    //逐个取下再执行，回调停止同一批中的其他定时器也是安全的
+    while (local.next != &local)
+    {
+        t = (TimerWheel_Timer_t *)local.next;
+        tw_unlink(t);
+        tw_fire(t);
+    }
+}
+
+/**
+ * 按下一个有事可做的刻度设定esp_timer单次唤醒，没有定时器时停止
+ * @param[in]   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_arm(void)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t wake;
+    uint32_t cand;
+
+    if (!tw_next(&cand))
+    {
+        if (g_tw_armed)
+        {
+            esp_timer_stop(g_tw_wake);
+            g_tw_armed = 0;
+        }
+        return;
+    }
+    //刻度只保留了低32位，按与当前刻度的差换算回时刻
+    wake = (now / TIMER_WHEEL_TICK_US + (int32_t)(cand - TW_US_TO_TICK(now))) * TIMER_WHEEL_TICK_US;
+    if (g_tw_armed && wake == g_tw_wake_us)
+    {
+        return;
+    }
+    if (g_tw_armed)
+    {
+        esp_timer_stop(g_tw_wake);
+    }
+    g_tw_wake_us = wake;
+    g_tw_armed = 1;
+    esp_timer_start_once(g_tw_wake, (wake > now) ? wake - now : 0);
+}
+
+/**
+ * esp_timer唤醒:处理到当前时刻为止的所有刻度，再设定下一次唤醒
+ * @param[in]   arg   无
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+static void tw_wake_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+    uint32_t cand, now_tick;
+
+    (void)arg;
+    xSemaphoreTakeRecursive(g_tw_lock, portMAX_DELAY);
+    g_tw_armed = 0;
+    g_tw_stats.wakes ++;
+    if (now > g_tw_wake_us && now - g_tw_wake_us > g_tw_stats.wake_late_max)
+    {
+        g_tw_stats.wake_late_max = now - g_tw_wake_us;
+    }
+    g_tw_in_run = 1;
+    while (1)
+    {
+        now_tick = TW_US_TO_TICK(esp_timer_get_time());
+        if (!tw_next(&cand) || (int32_t)(cand - now_tick) > 0)
+        {
+            break;
+        }
+        tw_process(cand);
+    }
+    tw_catch_up(now_tick);
+    g_tw_in_run = 0;
+    tw_arm();
+    xSemaphoreGiveRecursive(g_tw_lock);
+}
+
+/**
+ * 初始化时间轮
+ * @param[in]   无
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_NO_MEM
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t TimerWheel_Init(void)
+{
+    esp_timer_create_args_t timer_args = {
+        .callback = tw_wake_cb,
+        .arg = NULL,
+        .name = "timer_wheel",
+    };
+    uint8_t l, i;
+
+    if (g_tw_lock)
+    {
+        return ESP_OK;
+    }
+    g_tw_lock = xSemaphoreCreateRecursiveMutex();
+    if (g_tw_lock == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (esp_timer_create(&timer_args, &g_tw_wake) != ESP_OK)
+    {
+        vSemaphoreDelete(g_tw_lock);
+        g_tw_lock = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    for (l = 0; l < TIMER_WHEEL_LEVELS; l ++)
+    {
+        for (i = 0; i < TIMER_WHEEL_SLOTS; i ++)
+        {
+            g_tw_slot[l][i].next = g_tw_slot[l][i].prev = &g_tw_slot[l][i];
+        }
+        g_tw_bitmap[l] = 0;
+    }
+    g_tw_tick = TW_US_TO_TICK(esp_timer_get_time());
+    memset(&g_tw_stats, 0, sizeof(g_tw_stats));
+    return ESP_OK;
+}
+
+/**
+ * 设置定时器的回调，使用前调用一次
+ * @param[out]  timer   定时器
+ * @param[in]   cb      回调
+ * @param[in]   arg     回调参数
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void TimerWheel_Setup(TimerWheel_Timer_t *timer, TimerWheel_Cb_t cb, void *arg)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->node.next = timer->node.prev = &timer->node;
+    timer->cb = cb;
+    timer->arg = arg;
+}
+
+/**
+ * 启动(或重新启动)定时器
+ * @param[in]   timer       定时器
+ * @param[in]   delay_ms    第一次到期的延时，向上取整到刻度
+ * @param[in]   period_ms   周期，0为单次
+ * @retval
+ *              - ESP_OK
+ *              - ESP_ERR_INVALID_ARG
+ *              - ESP_ERR_INVALID_STATE   没有初始化
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+esp_err_t TimerWheel_Start(TimerWheel_Timer_t *timer, uint32_t delay_ms, uint32_t period_ms)
+{
+    int64_t now;
+
+    if (timer == NULL || timer->cb == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_tw_lock == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTakeRecursive(g_tw_lock, portMAX_DELAY);
+    if (timer->active)
+    {
+        tw_unlink(timer);
+    }
+    now = esp_timer_get_time();
+    if (!g_tw_in_run)
+    {
+        tw_catch_up(TW_US_TO_TICK(now));
+    }
+    timer->due_us = (now + (int64_t)delay_ms * 1000 + TIMER_WHEEL_TICK_US - 1) / TIMER_WHEEL_TICK_US *
+                    TIMER_WHEEL_TICK_US;
+    timer->expires = TW_US_TO_TICK(timer->due_us);
+    //回调中启动时当前刻度已处理，最早到下一个刻度
+    if ((int32_t)(timer->expires - g_tw_tick) < 0)
+    {
+        timer->due_us += (int64_t)(g_tw_tick - timer->expires) * TIMER_WHEEL_TICK_US;
+        timer->expires = g_tw_tick;
+    }
+    timer->period_us = period_ms * 1000;
+    timer->last_us = 0;
+    timer->active = 1;
+    tw_place(timer);
+    if (!g_tw_in_run)
+    {
+        tw_arm();
+    }
+    xSemaphoreGiveRecursive(g_tw_lock);
+    return ESP_OK;
+}
+
+/**
+ * 停止定时器，未启动时无操作；可在回调中调用
+ * @param[in]   timer   定时器
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void TimerWheel_Stop(TimerWheel_Timer_t *timer)
+{
+    if (g_tw_lock == NULL)
+    {
+        return;
+    }
+    xSemaphoreTakeRecursive(g_tw_lock, portMAX_DELAY);
+    if (timer->active)
+    {
+        tw_unlink(timer);
+        timer->active = 0;
+        //唤醒不必提前取消，到时没有事做只会多醒一次
+    }
+    xSemaphoreGiveRecursive(g_tw_lock);
+}
+
+/**
+ * 定时器是否在运行(单次定时器执行回调时已不算运行)
+ * @param[in]   timer   定时器
+ * @retval      是否在运行
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+bool TimerWheel_Active(const TimerWheel_Timer_t *timer)
+{
+    return timer->active;
+}
+
+/**
+ * 读定时器的统计
+ * @param[in]   timer   定时器
+ * @param[out]  stats   统计
+ * @param[in]   reset   读后清零
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void TimerWheel_GetTimerStats(TimerWheel_Timer_t *timer, TimerWheel_TimerStats_t *stats, bool reset)
+{
+    xSemaphoreTakeRecursive(g_tw_lock, portMAX_DELAY);
+    *stats = timer->stats;
+    if (reset)
+    {
+        memset(&timer->stats, 0, sizeof(timer->stats));
+    }
+    xSemaphoreGiveRecursive(g_tw_lock);
+}
+
+/**
+ * 读全局统计
+ * @param[out]  stats   统计
+ * @param[in]   reset   读后清零
+ * @retval      无
+ * @par         修改日志
+ *               Ver0.0.1:
+                     Caesar, 2026/10/19, 初始化版本\n
+ */
+void TimerWheel_GetStats(TimerWheel_Stats_t *stats, bool reset)
+{
+    xSemaphoreTakeRecursive(g_tw_lock, portMAX_DELAY);
+    *stats = g_tw_stats;
+    if (reset)
+    {
+        memset(&g_tw_stats, 0, sizeof(g_tw_stats));
+    }
+    xSemaphoreGiveRecursive(g_tw_lock);
+}
@@ -0,0 +1,460 @@
+/*
+* @file         timer_wheel_test.c
+* @brief        分层时间轮在PC上的测试
+* @details      用替身的esp_timer在模拟时间上运行时间轮，刻度从32位毫秒回绕点附近开始:
+*               1. 回绕:跨过刻度2^32的定时器按到期时刻准时执行，设定的唤醒时刻不受回绕影响
+*               2. 下放:70ms、5s、300s和超出时间轮范围的定时器都经过逐级下放，在到期时刻准时执行，
+*                  唤醒次数只和下放次数有关，不按刻度唤醒
+*               3. 周期:按启动时刻+k*周期到期，回调延迟不累积，来晚超过一个周期时跳过并计数
+*               4. 随机:单次/周期定时器随机启动、停止，回调中链式启动和停止其他定时器，唤醒随机推迟0~LATE_MAX_US，
+*                  期间还会在esp_timer任务来晚的窗口里启动定时器；检查不提前执行，每次设定的唤醒不晚于最早的到期，
+*                  唤醒处理完后没有已到期未执行的定时器，esp_timer不会在已设定时被重复设定
+*               编译: gcc -O2 -I../../../tools/host_stub -I../include timer_wheel_test.c ../timer_wheel.c -o timer_wheel_test
+* @author       Caesar, 2026/10/19, 初始化版本\n
+* @par Copyright (c):
+*               Caesar,Email:792910363@qq.com
+*/
+/*
+=============
+头文件包含
+=============
+*/
+#include <stdio.h>
+#include <string.h>
+#include "timer_wheel.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+
+/*
+===========================
+宏定义
+===========================
+*/
+#define TIMERS                      64
+#define LATE_MAX_US                 3000                //唤醒延迟上限
+#define TICK_WRAP_US                (4294967296LL * TIMER_WHEEL_TICK_US)   //刻度回绕一圈的时间
+#define STRESS_SEEDS                3
+#define STRESS_WAKES                20000
+#define STRESS_ERRORS_MAX           20                  //出错这么多次后不再继续随机测试
+
+//模型中的定时器
+typedef struct {
+	TimerWheel_Timer_t t;
+	bool active;                    /*!< 是否在运行 */
+	int64_t due_us;                 /*!< 到期时刻 */
+	int64_t req_us;                 /*!< 启动时刻+延时，不能早于它执行 */
+	int64_t first_us;               /*!< 周期定时器的第一次到期时刻 */
+	uint32_t period_us;
+	uint32_t runs;
+	uint32_t skipped;
+	uint32_t late_max;
+} tw_model_t;
+
+/*
+===========================
+全局变量定义
+===========================
+*/
+static int64_t g_now;
+static int64_t g_due = -1;
+static esp_timer_cb_t g_cb;
+static uint32_t g_double_arm;                       //已设定时又被设定的次数
+static uint32_t g_seed = 7;
+static bool g_chain;                                //回调中随机链式启动/停止
+static tw_model_t g_tm[TIMERS];
+static int g_errors;
+
+/*
+===========================
+函数定义
+===========================
+*/
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("  FAILED: %s\n", what);
+        g_errors ++;
+    }
+}
+
+static uint32_t sim_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return g_seed >> 8;
+}
+
+/*
+ * 设定唤醒时检查:不晚于模型中最早的到期时刻(已过期时必须立即唤醒)
+ */
+static void check_arm(uint64_t timeout_us)
+{
+    int64_t min_due = INT64_MAX;
+    uint8_t i;
+
+    for (i = 0; i < TIMERS; i ++)
+    {
+        if (g_tm[i].active && g_tm[i].due_us < min_due)
+        {
+            min_due = g_tm[i].due_us;
+        }
+    }
+    if (min_due != INT64_MAX)
+    {
+        expect((int64_t)timeout_us <= ((min_due > g_now) ? min_due - g_now : 0), "wake not after the earliest due");
+    }
+}
+
+/*
+ * 替身
+ */
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle)
+{
+    g_cb = args->callback;
+    *handle = (esp_timer_handle_t)&g_due;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    (void)timer;
+    if (g_due >= 0)
+    {
+        g_double_arm ++;
+    }
+    check_arm(timeout_us);
+    g_due = g_now + (int64_t)timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    (void)timer;
+    g_due = -1;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return g_now;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return (SemaphoreHandle_t)&g_due;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t timeout)
+{
+    (void)sem;
+    (void)timeout;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    (void)sem;
+}
+
+static void model_start(tw_model_t *m, uint32_t delay_ms, uint32_t period_ms)
+{
+    //先从模型中去掉，重新启动到更晚时不按旧的到期时刻检查唤醒
+    m->active = 0;
+    m->req_us = g_now + (int64_t)delay_ms * 1000;
+    expect(TimerWheel_Start(&m->t, delay_ms, period_ms) == ESP_OK, "start ok");
+    expect(m->t.due_us >= m->req_us && m->t.due_us <= m->req_us + TIMER_WHEEL_TICK_US, "due rounded up to a tick");
+    m->due_us = m->t.due_us;
+    m->first_us = m->due_us;
+    m->period_us = period_ms * 1000;
+    m->active = 1;
+}
+
+static void model_stop(tw_model_t *m)
+{
+    TimerWheel_Stop(&m->t);
+    expect(!TimerWheel_Active(&m->t), "stopped timer inactive");
+    m->active = 0;
+}
+
+static uint32_t pick_delay(void)
+{
+    uint32_t r = sim_rand() % 16;
+
+    if (r == 0)
+    {
+        return sim_rand() % 3;
+    }
+    if (r < 12)
+    {
+        return sim_rand() % 100;
+    }
+    if (r < 14)
+    {
+        return sim_rand() % 5000;
+    }
+    if (r < 15)
+    {
+        return sim_rand() % 400000;
+    }
+    //超出时间轮范围
+    return 20000000 + sim_rand() % 10000000;
+}
+
+static void on_fire(TimerWheel_Timer_t *t, void *arg)
+{
+    tw_model_t *m = arg;
+    int64_t next;
+
+    expect(&m->t == t, "callback gets its timer");
+    expect(m->active, "only running timers fire");
+    expect(g_now >= m->due_us && g_now >= m->req_us, "never early");
+    if (g_now - m->due_us > m->late_max)
+    {
+        m->late_max = (uint32_t)(g_now - m->due_us);
+    }
+    m->runs ++;
+    if (m->period_us)
+    {
+        next = m->due_us + m->period_us;
+        while (next <= g_now)
+        {
+            next += m->period_us;
+            m->skipped ++;
+        }
+        expect(t->due_us == next, "period kept to its schedule");
+        expect(TimerWheel_Active(t), "periodic timer stays active");
+        m->due_us = next;
+    }
+    else
+    {
+        expect(!TimerWheel_Active(t), "one-shot timer inactive in its callback");
+        m->active = 0;
+    }
+    if (!g_chain)
+    {
+        return;
+    }
+    if (!m->period_us && sim_rand() % 4 == 0)
+    {
+        model_start(m, pick_delay(), 0);
+    }
+    if (sim_rand() % 8 == 0)
+    {
+        model_stop(&g_tm[sim_rand() % TIMERS]);
+    }
+    if (sim_rand() % 8 == 0)
+    {
+        model_start(&g_tm[sim_rand() % TIMERS], sim_rand() % 20, 0);
+    }
+}
+
+/*
+ * 在g_now送出一次唤醒，处理完后不应剩下已到期的定时器
+ */
+static void deliver(void)
+{
+    uint8_t i;
+
+    g_due = -1;
+    g_cb(NULL);
+    for (i = 0; i < TIMERS; i ++)
+    {
+        expect(!g_tm[i].active || g_tm[i].due_us > g_now, "nothing overdue after a wake");
+    }
+}
+
+/*
+ * 按设定的唤醒时刻推迟0~late_max送出唤醒，最多wakes次，定时器都停了就返回
+ */
+static void run(uint32_t wakes, uint32_t late_max)
+{
+    while (wakes -- && g_due >= 0)
+    {
+        g_now = g_due + sim_rand() % (late_max + 1);
+        deliver();
+    }
+}
+
+static void reset_models(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < TIMERS; i ++)
+    {
+        model_stop(&g_tm[i]);
+        TimerWheel_Setup(&g_tm[i].t, on_fire, &g_tm[i]);
+        memset((uint8_t *)&g_tm[i] + sizeof(g_tm[i].t), 0, sizeof(g_tm[i]) - sizeof(g_tm[i].t));
+    }
+    //停止不取消唤醒，送出剩下的那一次后应当不再设定
+    run(2, 0);
+    expect(g_due < 0, "idle wheel does not wake");
+}
+
+static void test_wrap(void)
+{
+    static const uint32_t delays[] = {2999, 3000, 3001, 3064, 4100, 70000};
+    int e = g_errors;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i ++)
+    {
+        model_start(&g_tm[i], delays[i], 0);
+    }
+    expect((uint32_t)(g_tm[0].due_us / TIMER_WHEEL_TICK_US) == 0, "timer lands on tick 2^32");
+    run(100, 0);
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i ++)
+    {
+        expect(g_tm[i].runs == 1 && g_tm[i].late_max == 0, "fired on time across the wrap");
+    }
+    expect(g_double_arm == 0, "no double arm");
+    printf("%-10s %s\n", "wrap", g_errors == e ? "ok" : "FAILED");
+    reset_models();
+}
+
+static void test_cascade(void)
+{
+    static const uint32_t delays[] = {70, 5000, 300000, 20000000};
+    int e = g_errors;
+    TimerWheel_Stats_t st;
+    uint8_t i;
+
+    TimerWheel_GetStats(&st, 1);
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i ++)
+    {
+        model_start(&g_tm[i], delays[i], 0);
+    }
+    run(1000, 0);
+    TimerWheel_GetStats(&st, 1);
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i ++)
+    {
+        expect(g_tm[i].runs == 1 && g_tm[i].late_max == 0, "fired exactly at due");
+    }
+    expect(st.cascades > 0, "timers cascaded");
+    expect(st.wakes <= 4 * TIMER_WHEEL_LEVELS * 2, "wakes only for cascades and dues");
+    expect(st.wake_late_max == 0, "no wake late");
+    printf("%-10s %s (wakes %u cascades %u)\n", "cascade", g_errors == e ? "ok" : "FAILED",
+           (unsigned)st.wakes, (unsigned)st.cascades);
+    reset_models();
+}
+
+static void test_period(void)
+{
+    int e = g_errors;
+    tw_model_t *m = &g_tm[0];
+    TimerWheel_TimerStats_t ts;
+
+    g_now += 321;
+    model_start(m, 5, 7);
+    run(500, LATE_MAX_US);
+    //esp_timer任务被占住50ms
+    g_now = g_due + 50000;
+    deliver();
+    run(500, LATE_MAX_US);
+    TimerWheel_GetTimerStats(&m->t, &ts, 0);
+    expect(m->skipped >= 6 && ts.skipped == m->skipped, "late periods skipped and counted");
+    expect(ts.runs == m->runs, "runs counted");
+    expect(m->due_us - m->first_us == (int64_t)(m->runs + m->skipped) * m->period_us, "no drift");
+    expect(ts.late_max == m->late_max && ts.late_max >= 50000 - 7000, "lateness recorded");
+    expect(ts.jitter_max >= 50000 - 7000, "jitter recorded");
+    printf("%-10s %s\n", "period", g_errors == e ? "ok" : "FAILED");
+    reset_models();
+}
+
+static void random_op(void)
+{
+    tw_model_t *m = &g_tm[sim_rand() % TIMERS];
+    uint32_t r = sim_rand() % 10;
+
+    if (r < 6)
+    {
+        model_start(m, pick_delay(), 0);
+    }
+    else if (r < 8)
+    {
+        model_start(m, sim_rand() % 100, 1 + sim_rand() % 200);
+    }
+    else
+    {
+        model_stop(m);
+    }
+}
+
+static void test_stress(void)
+{
+    int e = g_errors;
+    uint32_t seed, i, late, fired;
+    uint8_t k;
+
+    g_chain = 1;
+    for (seed = 1; seed <= STRESS_SEEDS; seed ++)
+    {
+        g_seed = seed;
+        //离下一次刻度回绕5s
+        g_now = (g_now / TICK_WRAP_US + 1) * TICK_WRAP_US - 5000000 + seed * 137;
+        for (i = 0; i < STRESS_WAKES && g_errors - e < STRESS_ERRORS_MAX; i ++)
+        {
+            late = sim_rand() % (LATE_MAX_US + 1);
+            //主任务在唤醒前或esp_timer任务来晚的窗口里操作定时器
+            while (sim_rand() % 3 == 0)
+            {
+                if (g_due >= 0 && g_now < g_due + late)
+                {
+                    g_now += sim_rand() % (g_due + late - g_now);
+                }
+                else if (g_due < 0)
+                {
+                    g_now += sim_rand() % 50000;
+                }
+                random_op();
+            }
+            if (g_due < 0)
+            {
+                continue;
+            }
+            if (g_now < g_due + late)
+            {
+                g_now = g_due + late;
+            }
+            deliver();
+        }
+        for (k = 0, fired = 0; k < TIMERS; k ++)
+        {
+            fired += g_tm[k].runs;
+        }
+        expect(fired > STRESS_WAKES / 2, "timers keep firing");
+        reset_models();
+    }
+    g_chain = 0;
+    expect(g_double_arm == 0, "no double arm");
+    printf("%-10s %s\n", "stress", g_errors == e ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    uint8_t i;
+
+    //离刻度回绕3s，不在刻度边界上
+    g_now = TICK_WRAP_US - 3000000 + 123;
+    if (TimerWheel_Init() != ESP_OK)
+    {
+        printf("init failed\n");
+        return 1;
+    }
+    for (i = 0; i < TIMERS; i ++)
+    {
+        TimerWheel_Setup(&g_tm[i].t, on_fire, &g_tm[i]);
+    }
+    test_wrap();
+    test_cascade();
+    test_period();
+    test_stress();
+    printf("%s\n", g_errors ? "FAILED" : "ok");
+    return g_errors ? 1 : 0;
+}
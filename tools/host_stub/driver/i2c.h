@@ -0,0 +1,45 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+typedef int i2c_port_t;
+#define I2C_NUM_0               0
+#define I2C_NUM_1               1
+#define I2C_NUM_MAX             2
+#define I2C_MASTER_WRITE        0
+#define I2C_MASTER_READ         1
+#define I2C_APB_CLK_FREQ        80000000
+typedef enum { I2C_MODE_SLAVE = 0, I2C_MODE_MASTER } i2c_mode_t;
+typedef struct {
+    i2c_mode_t mode;
+    int sda_io_num;
+    gpio_pullup_t sda_pullup_en;
+    int scl_io_num;
+    gpio_pullup_t scl_pullup_en;
+    struct {
+        uint32_t clk_speed;
+    } master;
+} i2c_config_t;
+typedef void *i2c_cmd_handle_t;
+i2c_cmd_handle_t i2c_cmd_link_create(void);
+void i2c_cmd_link_delete(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_start(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_stop(i2c_cmd_handle_t cmd);
+esp_err_t i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data, bool ack_en);
+esp_err_t i2c_master_write(i2c_cmd_handle_t cmd, uint8_t *data, size_t len, bool ack_en);
+esp_err_t i2c_master_read_byte(i2c_cmd_handle_t cmd, uint8_t *data, int ack);
+esp_err_t i2c_master_read(i2c_cmd_handle_t cmd, uint8_t *data, size_t len, int ack);
+esp_err_t i2c_master_cmd_begin(i2c_port_t port, i2c_cmd_handle_t cmd, TickType_t ticks);
+esp_err_t i2c_param_config(i2c_port_t port, const i2c_config_t *conf);
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode, size_t slv_rx_buf_len,
+                             size_t slv_tx_buf_len, int intr_alloc_flags);
+esp_err_t i2c_driver_delete(i2c_port_t port);
+esp_err_t i2c_set_period(i2c_port_t port, int high_period, int low_period);
+esp_err_t i2c_set_start_timing(i2c_port_t port, int setup_time, int hold_time);
+esp_err_t i2c_set_stop_timing(i2c_port_t port, int setup_time, int hold_time);
+esp_err_t i2c_set_data_timing(i2c_port_t port, int sample_time, int hold_time);
+esp_err_t i2c_set_timeout(i2c_port_t port, int timeout);
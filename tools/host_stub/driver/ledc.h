@@ -0,0 +1,20 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+typedef enum { LEDC_HIGH_SPEED_MODE = 0, LEDC_LOW_SPEED_MODE, LEDC_SPEED_MODE_MAX } ledc_mode_t;
+typedef enum { LEDC_TIMER_0 = 0, LEDC_TIMER_1, LEDC_TIMER_2, LEDC_TIMER_3 } ledc_timer_t;
+typedef enum {
+    LEDC_CHANNEL_0 = 0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, LEDC_CHANNEL_3,
+    LEDC_CHANNEL_4, LEDC_CHANNEL_5, LEDC_CHANNEL_6, LEDC_CHANNEL_7, LEDC_CHANNEL_MAX
+} ledc_channel_t;
+typedef enum { LEDC_DUTY_DIR_DECREASE = 0, LEDC_DUTY_DIR_INCREASE } ledc_duty_direction_t;
+typedef enum { LEDC_FADE_NO_WAIT = 0, LEDC_FADE_WAIT_DONE, LEDC_FADE_MAX } ledc_fade_mode_t;
+typedef void *ledc_isr_handle_t;
+esp_err_t ledc_set_fade(ledc_mode_t mode, ledc_channel_t ch, uint32_t duty, ledc_duty_direction_t dir,
+                        uint32_t step_num, uint32_t duty_cycle_num, uint32_t duty_scale);
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t ch, uint32_t duty);
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t ch);
+uint32_t ledc_get_duty(ledc_mode_t mode, ledc_channel_t ch);
+uint32_t ledc_get_freq(ledc_mode_t mode, ledc_timer_t timer);
+esp_err_t ledc_isr_register(void (*fn)(void *), void *arg, int intr_alloc_flags, ledc_isr_handle_t *handle);
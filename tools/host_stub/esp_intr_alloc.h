@@ -0,0 +1,6 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#include "esp_err.h"
+#define ESP_INTR_FLAG_IRAM              (1 << 10)
+typedef void *intr_handle_t;
+esp_err_t esp_intr_free(intr_handle_t handle);
@@ -0,0 +1,6 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#include <stdio.h>
+#define ESP_LOGE(tag, fmt, ...)     printf("E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...)     printf("W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...)     printf("I %s: " fmt "\n", tag, ##__VA_ARGS__)
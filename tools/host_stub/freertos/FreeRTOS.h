@@ -0,0 +1,23 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef int portMUX_TYPE;
+#define pdFALSE                         0
+#define pdTRUE                          1
+#define pdPASS                          1
+#define pdFAIL                          0
+#define portMAX_DELAY                   0xFFFFFFFFU
+#define portTICK_PERIOD_MS              10
+#define portTICK_RATE_MS                portTICK_PERIOD_MS
+#define configMAX_PRIORITIES            25
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)     ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)      ((void)(mux))
+#define portYIELD_FROM_ISR()            ((void)0)
@@ -0,0 +1,4 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#include <stdint.h>
+void ets_delay_us(uint32_t us);
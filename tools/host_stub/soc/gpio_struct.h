@@ -0,0 +1,19 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用(只保留输出相关寄存器) */
+#pragma once
+#include <stdint.h>
+typedef union {
+    struct {
+        uint32_t data: 8;
+        uint32_t reserved8: 24;
+    };
+    uint32_t val;
+} gpio_out1_reg_t;
+typedef volatile struct {
+    uint32_t out;
+    uint32_t out_w1ts;
+    uint32_t out_w1tc;
+    gpio_out1_reg_t out1;
+    gpio_out1_reg_t out1_w1ts;
+    gpio_out1_reg_t out1_w1tc;
+} gpio_dev_t;
+extern gpio_dev_t GPIO;
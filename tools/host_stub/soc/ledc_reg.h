@@ -0,0 +1,4 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#define LEDC_DUTY_CHNG_END_HSCH0_INT_ENA_S  8
+#define LEDC_DUTY_CHNG_END_LSCH0_INT_ENA_S  16
@@ -0,0 +1,7 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+#include <stdint.h>
+typedef struct {
+    struct { uint32_t val; } int_raw, int_st, int_ena, int_clr;
+} ledc_dev_t;
+extern volatile ledc_dev_t LEDC;
@@ -0,0 +1,32 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用(只保留软件PWM用到的寄存器) */
+#pragma once
+#include <stdint.h>
+typedef volatile struct {
+    struct {
+        union {
+            struct {
+                uint32_t reserved0: 10;
+                uint32_t alarm_en: 1;
+                uint32_t reserved11: 21;
+            };
+            uint32_t val;
+        } config;
+        uint32_t cnt_low;
+        uint32_t cnt_high;
+        uint32_t update;
+        uint32_t alarm_low;
+        uint32_t alarm_high;
+    } hw_timer[2];
+    union {
+        struct {
+            uint32_t t0: 1;
+            uint32_t t1: 1;
+            uint32_t reserved2: 30;
+        };
+        uint32_t val;
+    } int_clr_timers;
+} timg_dev_t;
+//每次取寄存器组都经过测试程序，由它推进模拟的计数并锁存到cnt_low/cnt_high
+timg_dev_t *LedFake_Timg(int group);
+#define TIMERG0                         (*LedFake_Timg(0))
+#define TIMERG1                         (*LedFake_Timg(1))
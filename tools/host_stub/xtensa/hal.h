@@ -0,0 +1,3 @@
+/* PC测试用的最小替身，供仓库内各tools目录下的程序共用 */
+#pragma once
+unsigned xthal_get_ccount(void);